@@ -25,11 +25,14 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <functional>
+#include <future>
 #include <mutex>
 #include <utility>
 
 #include <wx/datetime.h>
 #include <wx/dir.h>
+#include <wx/filefn.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 
@@ -43,6 +46,7 @@
 
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_mesh_cache.h"
 #include "3d_plugin_manager.h"
 #include "sg/scenegraph.h"
 #include "plugins/3dapi/ifsg_api.h"
@@ -53,14 +57,15 @@
 #include <paths.h>
 #include <pgm_base.h>
 #include <project.h>
+#include <reporter.h>
 #include <settings/common_settings.h>
 #include <settings/settings_manager.h>
+#include <thread_pool.h>
 #include <wx_filename.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
 
 
@@ -129,12 +134,20 @@ public:
 
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName();
+    void FreeRenderData();
 
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    std::unique_ptr<MESH_CACHE_MODEL> meshCache;  // owns renderData if it was read from the
+                                                  // mesh cache
+    bool          sceneDataDeferred;  // renderData was read from the mesh cache; sceneData
+                                      // is only loaded when asked for
+
+    std::shared_future<void> loaded;  // ready once the first load of the entry has finished
+    std::mutex               mutex;   // guards reloads and the creation of renderData
 
 private:
     // prohibit assignment and default copy constructor
@@ -149,6 +162,7 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = nullptr;
     renderData = nullptr;
+    sceneDataDeferred = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -156,9 +170,7 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
 {
     delete sceneData;
-
-    if( nullptr != renderData )
-        S3D::Destroy3DModel( &renderData );
+    FreeRenderData();
 }
 
 
@@ -173,6 +185,9 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+
+    // the cache files of a changed model are named by its new hash
+    m_CacheBaseName.clear();
 }
 
 
@@ -185,6 +200,17 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName()
 }
 
 
+void S3D_CACHE_ENTRY::FreeRenderData()
+{
+    if( meshCache )
+        meshCache.reset();
+    else if( nullptr != renderData )
+        S3D::Destroy3DModel( &renderData );
+
+    renderData = nullptr;
+}
+
+
 S3D_CACHE::S3D_CACHE()
 {
     m_FNResolver = new FILENAME_RESOLVER;
@@ -203,7 +229,7 @@ S3D_CACHE::~S3D_CACHE()
 
 
 SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, const wxString& aBasePath,
-                             S3D_CACHE_ENTRY** aCachePtr )
+                             S3D_CACHE_ENTRY** aCachePtr, bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = nullptr;
@@ -218,58 +244,101 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, const wxString& aBasePa
         return nullptr;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    CACHE_SHARD&                     shard = getShard( full3Dpath );
+    std::shared_ptr<S3D_CACHE_ENTRY> entry;
+    std::promise<void>               loading;
+    bool                             isNew = false;
+
+    // check cache if file is already loaded (or being loaded by another thread)
+    {
+        std::lock_guard<std::mutex> lock( shard.m_mutex );
+
+        auto mi = shard.m_entries.find( full3Dpath );
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+        if( mi != shard.m_entries.end() )
+        {
+            entry = mi->second;
+        }
+        else
+        {
+            entry = std::make_shared<S3D_CACHE_ENTRY>();
+            entry->loaded = loading.get_future().share();
+            shard.m_entries.emplace( full3Dpath, entry );
+            isNew = true;
+        }
+    }
 
-    if( mi != m_CacheMap.end() )
+    if( isNew )
     {
-        wxFileName fname( full3Dpath );
+        // The model is loaded without holding the shard lock so other models can be loaded
+        // at the same time; requests for this one wait on entry->loaded.
+        std::lock_guard<std::mutex> lock( entry->mutex );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool       reload = ADVANCED_CFG::GetCfg().m_Skip3DModelMemoryCache;
-            wxDateTime fmdate = fname.GetModificationTime();
+        try
+        {
+            checkCache( full3Dpath, entry.get(), aRenderDataOnly );
+        }
+        catch( ... )
+        {
+            loading.set_value();
+            throw;
+        }
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+        loading.set_value();
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+        if( nullptr != aCachePtr )
+            *aCachePtr = entry.get();
 
-            if( reload )
-            {
-                if( nullptr != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = nullptr;
-                }
+        return entry->sceneData;
+    }
+
+    entry->loaded.wait();
+
+    std::lock_guard<std::mutex> lock( entry->mutex );
+    wxFileName                  fname( full3Dpath );
+
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool       reload = ADVANCED_CFG::GetCfg().m_Skip3DModelMemoryCache;
+        wxDateTime fmdate = fname.GetModificationTime();
 
-                if( nullptr != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+        if( fmdate != entry->modTime )
+        {
+            unsigned char hashSum[20];
+            getFileHash( full3Dpath, hashSum );
+            entry->modTime = fmdate;
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
-                                                                mi->second->pluginInfo );
+            if( !isSHA1Same( hashSum, entry->sha1sum ) )
+            {
+                entry->SetSHA1( hashSum );
+                reload = true;
             }
         }
 
-        if( nullptr != aCachePtr )
-            *aCachePtr = mi->second;
+        if( reload )
+        {
+            if( nullptr != entry->sceneData )
+            {
+                S3D::DestroyNode( entry->sceneData );
+                entry->sceneData = nullptr;
+            }
+
+            entry->FreeRenderData();
+            entry->sceneDataDeferred = false;
+            entry->sceneData = m_Plugins->Load3DModel( full3Dpath, entry->pluginInfo );
+        }
+    }
 
-        return mi->second->sceneData;
+    if( entry->sceneDataDeferred && !aRenderDataOnly )
+    {
+        entry->sceneDataDeferred = false;
+        loadSceneData( full3Dpath, entry.get() );
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    if( nullptr != aCachePtr )
+        *aCachePtr = entry.get();
+
+    return entry->sceneData;
 }
 
 
@@ -279,70 +348,56 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile, const wxString& aBasePa
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aEntry,
+                                   bool aRenderDataOnly )
 {
-    if( aCachePtr )
-        *aCachePtr = nullptr;
+    unsigned char sha1sum[20];
+    wxFileName    fname( aFileName );
 
-    unsigned char    sha1sum[20];
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    aEntry->modTime = fname.GetModificationTime();
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !getFileHash( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-
-        if( m_CacheMap.emplace( aFileName, ep ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE,
-                        wxT( "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'" ),
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-        }
-
+        // or we do not have a configured cache file directory, the entry is left
+        // empty to prevent further attempts at loading the file
         return nullptr;
     }
 
-    if( m_CacheMap.emplace( aFileName, ep ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    wxT( "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'" ),
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+    aEntry->SetSHA1( sha1sum );
 
-        m_CacheList.pop_back();
-        delete ep;
+    if( aRenderDataOnly && !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache
+            && loadMeshCacheData( aEntry ) )
+    {
+        aEntry->sceneDataDeferred = true;
         return nullptr;
     }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return loadSceneData( aFileName, aEntry );
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+SCENEGRAPH* S3D_CACHE::loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aEntry )
+{
+    wxString bname = aEntry->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
     if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && wxFileName::FileExists( cachename )
-        && loadCacheData( ep ) )
-        return ep->sceneData;
+        && loadCacheData( aEntry ) )
+        return aEntry->sceneData;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aEntry->sceneData = m_Plugins->Load3DModel( aFileName, aEntry->pluginInfo );
 
-    if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && nullptr != ep->sceneData )
-        saveCacheData( ep );
+    if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && nullptr != aEntry->sceneData )
+        saveCacheData( aEntry );
 
-    return ep->sceneData;
+    return aEntry->sceneData;
+}
+
+
+S3D_CACHE::CACHE_SHARD& S3D_CACHE::getShard( const wxString& aFileName )
+{
+    return m_shards[ std::hash<wxString>{}( aFileName ) % CACHE_SHARDS ];
 }
 
 
@@ -402,6 +457,41 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
 }
 
 
+bool S3D_CACHE::getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxStructStat st;
+
+    if( m_CacheDir.empty() || wxStat( aFileName, &st ) != 0 )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    // The stamp files are named by a hash of the model file name; collisions are caught by
+    // the file name stored in the stamp.
+    size_t   hash = std::hash<std::string>()( std::string( aFileName.utf8_str() ) );
+    wxString stampName = m_CacheDir + wxString::Format( wxT( "%016llx.3di" ),
+                                                        (unsigned long long) hash );
+
+    MODEL_FILE_STAMP stamp;
+
+    stamp.m_Size = st.st_size;
+    stamp.m_ModTime = st.st_mtime;
+
+    if( ReadModelFileStamp( stampName, aFileName, stamp ) )
+    {
+        memcpy( aSHA1Sum, stamp.m_SHA1, sizeof( stamp.m_SHA1 ) );
+        return true;
+    }
+
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    memcpy( stamp.m_SHA1, aSHA1Sum, sizeof( stamp.m_SHA1 ) );
+
+    WriteModelFileStamp( stampName, aFileName, stamp );
+
+    return true;
+}
+
+
 bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     wxString bname = aCacheItem->GetCacheBaseName();
@@ -496,6 +586,45 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadMeshCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    std::unique_ptr<MESH_CACHE_MODEL> model = ReadMeshCache( m_CacheDir + bname + wxT( ".3dm" ) );
+
+    if( !model )
+        return false;
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->renderData = model->GetModel();
+    aCacheItem->meshCache = std::move( model );
+    return true;
+}
+
+
+bool S3D_CACHE::saveMeshCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( nullptr == aCacheItem->renderData )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    // Cache files are named by the model's content hash so an existing one is up to date
+    if( wxFileName::Exists( fname ) )
+        return true;
+
+    return WriteMeshCache( fname, *aCacheItem->renderData );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -568,19 +697,7 @@ bool S3D_CACHE::SetProject( PROJECT* aProject )
 
     if( m_FNResolver->SetProject( aProject, &hasChanged ) && hasChanged )
     {
-        m_CacheMap.clear();
-
-        std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
-        std::list< S3D_CACHE_ENTRY* >::iterator eL = m_CacheList.end();
-
-        while( sL != eL )
-        {
-            delete *sL;
-            ++sL;
-        }
-
-        m_CacheList.clear();
-
+        FlushCache( false );
         return true;
     }
 
@@ -608,18 +725,12 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters() const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
-    std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
-    std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
-
-    while( sCL != eCL )
+    for( CACHE_SHARD& shard : m_shards )
     {
-        delete *sCL;
-        ++sCL;
+        std::lock_guard<std::mutex> lock( shard.m_mutex );
+        shard.m_entries.clear();
     }
 
-    m_CacheList.clear();
-    m_CacheMap.clear();
-
     if( closePlugins )
         ClosePlugins();
 }
@@ -635,35 +746,63 @@ void S3D_CACHE::ClosePlugins()
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName, const wxString& aBasePath )
 {
     S3D_CACHE_ENTRY* cp = nullptr;
-    SCENEGRAPH*      sp = load( aModelFileName, aBasePath,&cp );
 
-    if( !sp )
-        return nullptr;
+    // The scene data is not needed if the render data is in the mesh cache
+    load( aModelFileName, aBasePath, &cp, true );
 
     if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    wxT( "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY" ),
-                    __FILE__, __FUNCTION__, __LINE__ );
-
         return nullptr;
-    }
 
-    if( cp->renderData )
+    std::lock_guard<std::mutex> lock( cp->mutex );
+
+    // Another thread may have reloaded the model since load() returned
+    if( cp->renderData || !cp->sceneData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    cp->renderData = S3D::GetModel( cp->sceneData );
+
+    if( cp->renderData && !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache )
+        saveMeshCacheData( cp );
+
+    return cp->renderData;
+}
+
+
+void S3D_CACHE::PreloadModels( const std::vector<std::pair<wxString, wxString>>& aModels,
+                               REPORTER* aStatusReporter )
+{
+    thread_pool&                   tp = GetKiCadThreadPool();
+    std::vector<std::future<void>> returns;
+
+    returns.reserve( aModels.size() );
 
-    return mp;
+    for( const std::pair<wxString, wxString>& model : aModels )
+    {
+        returns.emplace_back( tp.submit(
+                [this, &model]()
+                {
+                    GetModel( model.first, model.second );
+                } ) );
+    }
+
+    for( size_t ii = 0; ii < returns.size(); ++ii )
+    {
+        if( aStatusReporter )
+        {
+            // Display the short filename of the 3D model loaded:
+            // (the full name is usually too long to be displayed)
+            wxFileName fn( aModels[ii].first );
+            aStatusReporter->Report( wxString::Format( _( "Loading %s..." ), fn.GetFullName() ) );
+        }
+
+        returns[ii].wait();
+    }
 }
 
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
-    size_t        numFilesFound = 0;
+    wxArrayString fileList; // Holds list of cache files found in cache directory
 
     wxFileName thisFile;
     wxDateTime lastAccess, thresholdDate;
@@ -678,10 +817,11 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the scene, mesh and model stamp files in the cache directory
+        for( const wxString& fileSpec : { wxT( "*.3dc" ), wxT( "*.3dm" ), wxT( "*.3di" ) } )
+            dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
 
-        for( unsigned int i = 0; i < numFilesFound; i++ )
+        for( unsigned int i = 0; i < fileList.size(); i++ )
         {
             // Completes path to specific file so we can get its "last access" date
             thisFile.SetFullName( fileList[i] );
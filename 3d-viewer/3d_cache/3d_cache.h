@@ -32,13 +32,19 @@
 #include "3d_info.h"
 #include <core/typeinfo.h>
 #include "string_utils.h"
+#include <array>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
 
 class  PGM_BASE;
+class  REPORTER;
 class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
@@ -127,27 +133,48 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName, const wxString& aBasePath );
 
+    /**
+     * Load the render data for a list of models on the thread pool, so that the following
+     * GetModel() calls for them are served from memory.
+     *
+     * @param aModels is a list of model file names and the base paths to search them in.
+     * @param aStatusReporter (optional) is told about each model as it is loaded.
+     */
+    void PreloadModels( const std::vector<std::pair<wxString, wxString>>& aModels,
+                        REPORTER* aStatusReporter = nullptr );
+
     /**
      * Delete up old cache files in cache directory.
      *
-     * Deletes ".3dc" files in the cache directory that are older than \a aNumDaysOld.
+     * Deletes ".3dc", ".3dm" and ".3di" files in the cache directory that are older than
+     * \a aNumDaysOld.
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files.
+     * @param aNumDaysOld is age threshold to delete cache files.
      */
     void CleanCacheDir( int aNumDaysOld );
 
 private:
     /**
-     * Find or create cache entry for file name
+     * Fill a new cache entry for a file name.
      *
-     * Searches the cache list for the given filename and retrieves the cache data; a cache
-     * entry is created if one does not already exist.
+     * If only the render data is needed and there is a mesh cache file for the model, the
+     * render data is read from it and loading the scene data is put off until it is asked for.
+     * Otherwise the scene data is loaded by loadSceneData().
      *
-     * @param aFileName  is the file name (full or partial path).
-     * @param aCachePtr is an optional return address for cache entry pointer.
-     * @return SCENEGRAPH object associated with file name or NULL on error.
+     * @param aFileName is the full path of the model.
+     * @param aEntry is the cache entry to fill.
+     * @param aRenderDataOnly is true if the caller only needs the render data.
+     * @return SCENEGRAPH object associated with file name or NULL on error (or if the scene
+     *         data was not loaded).
+     */
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aEntry,
+                            bool aRenderDataOnly );
+
+    /**
+     * Load the scene data of a cache entry from the cache file if there is an up to date one,
+     * otherwise with the plugins (and then write the cache file).
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = nullptr );
+    SCENEGRAPH* loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aEntry );
 
     /**
      * Calculate the SHA1 hash of the given file.
@@ -158,20 +185,52 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Get the SHA1 hash of the given file.
+     *
+     * The hash is taken from the file's stamp in the cache directory if the size and
+     * modification time of the file still match the stamp.  Otherwise it is calculated by
+     * getSHA1() and the stamp is updated.
+     *
+     * @param aFileName file name (full path).
+     * @param aSHA1Sum a 20 byte character array to hold the SHA1 hash.
+     * @return true on success, otherwise false.
+     */
+    bool getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, const wxString& aBasePath, S3D_CACHE_ENTRY** aCachePtr = nullptr );
+    // load render data from a mesh cache file
+    bool loadMeshCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a mesh cache file
+    bool saveMeshCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // the real load function (can supply a cache entry pointer to member functions); the scene
+    // data may be left unloaded if aRenderDataOnly is set
+    SCENEGRAPH* load( const wxString& aModelFile, const wxString& aBasePath,
+                      S3D_CACHE_ENTRY** aCachePtr = nullptr, bool aRenderDataOnly = false );
+
+    /// Number of independently locked parts the cache map is split into
+    static constexpr size_t CACHE_SHARDS = 16;
+
+    struct CACHE_SHARD
+    {
+        std::mutex m_mutex;
+
+        /// mapping of file names to cache names and data
+        std::map< wxString, std::shared_ptr<S3D_CACHE_ENTRY>, rsort_wxString > m_entries;
+    };
 
-    /// cache entries
-    std::list< S3D_CACHE_ENTRY* > m_CacheList;
+    CACHE_SHARD& getShard( const wxString& aFileName );
 
-    /// mapping of file names to cache names and data
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString > m_CacheMap;
+    /// cache entries, split by file name hash so that distinct models can be looked up and
+    /// loaded from several threads at once
+    std::array<CACHE_SHARD, CACHE_SHARDS> m_shards;
 
     FILENAME_RESOLVER*  m_FNResolver;
 
@@ -0,0 +1,430 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "3d_mesh_cache.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <kiplatform/io.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+/*
+ * Mesh cache file layout (native byte order; the cache never leaves the machine which wrote
+ * it).  Every field is 4 bytes wide so all arrays are 4-byte aligned in the file, and so in a
+ * mapping of it:
+ *
+ *   char[8]    "KI3DMSH1"
+ *   uint32     MESH_CACHE_VERSION
+ *   uint32     material count
+ *   uint32     mesh count
+ *   materials: float[3] ambient, float[3] diffuse, float[3] emissive, float[3] specular,
+ *              float shininess, float transparency
+ *   meshes:    uint32 vertex count, uint32 index count, uint32 material index, uint32 flags
+ *   arrays, for each mesh in turn:
+ *              float[3] positions,
+ *              float[3] normals (if flags & HAS_NORMALS),
+ *              float[2] texture coordinates (if flags & HAS_TEXCOORDS),
+ *              float[3] colors (if flags & HAS_COLORS),
+ *              uint32 indices
+ *
+ * Model stamp file layout:
+ *
+ *   char[8]    "KI3DSTP1"
+ *   uint32     model file name byte count, followed by the UTF-8 model file name
+ *   int64      model file size
+ *   int64      model file modification time
+ *   uint8[20]  model file SHA1 hash
+ */
+
+static const char     MESH_CACHE_MAGIC[8] = { 'K', 'I', '3', 'D', 'M', 'S', 'H', '1' };
+static const uint32_t MESH_CACHE_VERSION = 1;
+
+static const char     STAMP_MAGIC[8] = { 'K', 'I', '3', 'D', 'S', 'T', 'P', '1' };
+
+enum MESH_FLAGS : uint32_t
+{
+    HAS_NORMALS   = 1,
+    HAS_TEXCOORDS = 2,
+    HAS_COLORS    = 4
+};
+
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "SFVEC2F must be packed" );
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "SFVEC3F must be packed" );
+static_assert( sizeof( SMATERIAL ) == 14 * sizeof( float ), "SMATERIAL must be packed" );
+
+
+namespace
+{
+
+class CACHE_READER
+{
+public:
+    CACHE_READER( const char* aData, size_t aLength ) :
+            m_pos( aData ),
+            m_end( aData + aLength )
+    { }
+
+    bool ReadBytes( void* aDest, size_t aLength )
+    {
+        if( aLength > size_t( m_end - m_pos ) )
+            return false;
+
+        memcpy( aDest, m_pos, aLength );
+        m_pos += aLength;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadValue( T& aValue )
+    {
+        return ReadBytes( &aValue, sizeof( T ) );
+    }
+
+    /**
+     * Point \a aArray at the next \a aCount elements of the data, without copying them.
+     */
+    template <typename T>
+    bool MapArray( T*& aArray, size_t aCount )
+    {
+        static_assert( alignof( T ) <= 4, "the mesh cache arrays are only 4-byte aligned" );
+
+        if( aCount > size_t( m_end - m_pos ) / sizeof( T ) )
+            return false;
+
+        aArray = reinterpret_cast<T*>( const_cast<char*>( m_pos ) );
+        m_pos += aCount * sizeof( T );
+        return true;
+    }
+
+    bool ReadString( wxString& aValue )
+    {
+        uint32_t length;
+
+        if( !ReadValue( length ) || length > size_t( m_end - m_pos ) )
+            return false;
+
+        aValue = wxString::FromUTF8( m_pos, length );
+        m_pos += length;
+        return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_end; }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+
+class CACHE_WRITER
+{
+public:
+    template <typename T>
+    void WriteValue( T aValue )
+    {
+        m_buffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+    }
+
+    template <typename T>
+    void WriteArray( const T* aArray, size_t aCount )
+    {
+        m_buffer.append( reinterpret_cast<const char*>( aArray ), aCount * sizeof( T ) );
+    }
+
+    void WriteString( const wxString& aValue )
+    {
+        wxScopedCharBuffer utf8 = aValue.utf8_str();
+
+        WriteValue( uint32_t( utf8.length() ) );
+        m_buffer.append( utf8.data(), utf8.length() );
+    }
+
+    void WriteBytes( const char* aData, size_t aLength ) { m_buffer.append( aData, aLength ); }
+
+    /**
+     * Write the buffer to \a aFileName through a temporary file, so that other processes
+     * reading the cache never see a partial file.
+     */
+    bool Save( const wxString& aFileName ) const
+    {
+        wxFileName tmpFileName = wxFileName::CreateTempFileName( aFileName );
+        bool       ok = false;
+
+        {
+            wxFFile file( tmpFileName.GetFullPath(), wxT( "wb" ) );
+
+            if( file.IsOpened() )
+            {
+                ok = file.Write( m_buffer.data(), m_buffer.size() ) == m_buffer.size();
+                ok = file.Close() && ok;
+            }
+        }
+
+        if( !ok || !wxRenameFile( tmpFileName.GetFullPath(), aFileName, true ) )
+        {
+            wxRemoveFile( tmpFileName.GetFullPath() );
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    std::string m_buffer;
+};
+
+} // namespace
+
+
+bool WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel )
+{
+    if( aModel.m_MaterialsSize && !aModel.m_Materials )
+        return false;
+
+    if( aModel.m_MeshesSize && !aModel.m_Meshes )
+        return false;
+
+    CACHE_WRITER writer;
+
+    writer.WriteBytes( MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) );
+    writer.WriteValue( MESH_CACHE_VERSION );
+    writer.WriteValue( uint32_t( aModel.m_MaterialsSize ) );
+    writer.WriteValue( uint32_t( aModel.m_MeshesSize ) );
+    writer.WriteArray( aModel.m_Materials, aModel.m_MaterialsSize );
+
+    auto vertexCount =
+            []( const SMESH& aMesh )
+            {
+                return aMesh.m_Positions ? aMesh.m_VertexSize : 0;
+            };
+
+    auto indexCount =
+            []( const SMESH& aMesh )
+            {
+                return aMesh.m_FaceIdx ? aMesh.m_FaceIdxSize : 0;
+            };
+
+    for( unsigned int ii = 0; ii < aModel.m_MeshesSize; ++ii )
+    {
+        const SMESH& mesh = aModel.m_Meshes[ii];
+        uint32_t     flags = 0;
+
+        if( mesh.m_Normals )
+            flags |= HAS_NORMALS;
+
+        if( mesh.m_Texcoords )
+            flags |= HAS_TEXCOORDS;
+
+        if( mesh.m_Color )
+            flags |= HAS_COLORS;
+
+        writer.WriteValue( uint32_t( vertexCount( mesh ) ) );
+        writer.WriteValue( uint32_t( indexCount( mesh ) ) );
+        writer.WriteValue( uint32_t( mesh.m_MaterialIdx ) );
+        writer.WriteValue( flags );
+    }
+
+    for( unsigned int ii = 0; ii < aModel.m_MeshesSize; ++ii )
+    {
+        const SMESH& mesh = aModel.m_Meshes[ii];
+        unsigned int count = vertexCount( mesh );
+
+        writer.WriteArray( mesh.m_Positions, count );
+
+        if( mesh.m_Normals )
+            writer.WriteArray( mesh.m_Normals, count );
+
+        if( mesh.m_Texcoords )
+            writer.WriteArray( mesh.m_Texcoords, count );
+
+        if( mesh.m_Color )
+            writer.WriteArray( mesh.m_Color, count );
+
+        writer.WriteArray( mesh.m_FaceIdx, indexCount( mesh ) );
+    }
+
+    return writer.Save( aFileName );
+}
+
+
+MESH_CACHE_MODEL::MESH_CACHE_MODEL( const char* aMapping, size_t aLength ) :
+        m_mapping( aMapping ),
+        m_length( aLength )
+{
+    m_model.m_MeshesSize = 0;
+    m_model.m_Meshes = nullptr;
+    m_model.m_MaterialsSize = 0;
+    m_model.m_Materials = nullptr;
+}
+
+
+MESH_CACHE_MODEL::~MESH_CACHE_MODEL()
+{
+    KIPLATFORM::IO::UnmapFile( m_mapping, m_length );
+}
+
+
+std::unique_ptr<MESH_CACHE_MODEL> ReadMeshCache( const wxString& aFileName )
+{
+    if( !wxFileName::FileExists( aFileName ) )
+        return nullptr;
+
+    size_t      length;
+    const char* mapping = KIPLATFORM::IO::MapFile( aFileName, length );
+
+    if( !mapping )
+        return nullptr;
+
+    // Owns the mapping from here on
+    std::unique_ptr<MESH_CACHE_MODEL> cache( new MESH_CACHE_MODEL( mapping, length ) );
+
+    S3DMODEL&    model = cache->m_model;
+    CACHE_READER reader( mapping, length );
+    char         magic[ sizeof( MESH_CACHE_MAGIC ) ];
+    uint32_t     version;
+    uint32_t     materialCount;
+    uint32_t     meshCount;
+
+    if( !reader.ReadBytes( magic, sizeof( magic ) )
+            || memcmp( magic, MESH_CACHE_MAGIC, sizeof( magic ) ) != 0
+            || !reader.ReadValue( version ) || version != MESH_CACHE_VERSION
+            || !reader.ReadValue( materialCount ) || !reader.ReadValue( meshCount )
+            || !reader.MapArray( model.m_Materials, materialCount ) )
+    {
+        return nullptr;
+    }
+
+    model.m_MaterialsSize = materialCount;
+
+    if( meshCount > length / ( 4 * sizeof( uint32_t ) ) )
+        return nullptr;
+
+    std::vector<uint32_t> flags( meshCount );
+
+    cache->m_meshes.resize( meshCount );
+    model.m_Meshes = cache->m_meshes.data();
+    model.m_MeshesSize = meshCount;
+
+    for( uint32_t ii = 0; ii < meshCount; ++ii )
+    {
+        SMESH& mesh = model.m_Meshes[ii];
+
+        mesh.m_Positions = nullptr;
+        mesh.m_Normals = nullptr;
+        mesh.m_Texcoords = nullptr;
+        mesh.m_Color = nullptr;
+        mesh.m_FaceIdx = nullptr;
+
+        if( !reader.ReadValue( mesh.m_VertexSize ) || !reader.ReadValue( mesh.m_FaceIdxSize )
+                || !reader.ReadValue( mesh.m_MaterialIdx ) || !reader.ReadValue( flags[ii] ) )
+        {
+            return nullptr;
+        }
+    }
+
+    for( uint32_t ii = 0; ii < meshCount; ++ii )
+    {
+        SMESH& mesh = model.m_Meshes[ii];
+        bool   ok = true;
+
+        if( mesh.m_VertexSize )
+            ok = reader.MapArray( mesh.m_Positions, mesh.m_VertexSize );
+
+        if( ok && ( flags[ii] & HAS_NORMALS ) )
+            ok = reader.MapArray( mesh.m_Normals, mesh.m_VertexSize );
+
+        if( ok && ( flags[ii] & HAS_TEXCOORDS ) )
+            ok = reader.MapArray( mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( ok && ( flags[ii] & HAS_COLORS ) )
+            ok = reader.MapArray( mesh.m_Color, mesh.m_VertexSize );
+
+        if( ok && mesh.m_FaceIdxSize )
+            ok = reader.MapArray( mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+
+        for( unsigned int jj = 0; ok && jj < mesh.m_FaceIdxSize; ++jj )
+            ok = mesh.m_FaceIdx[jj] < mesh.m_VertexSize;
+
+        if( !ok )
+            return nullptr;
+    }
+
+    if( !reader.AtEnd() )
+        return nullptr;
+
+    return cache;
+}
+
+
+void WriteModelFileStamp( const wxString& aStampFile, const wxString& aModelFile,
+                          const MODEL_FILE_STAMP& aStamp )
+{
+    CACHE_WRITER writer;
+
+    writer.WriteBytes( STAMP_MAGIC, sizeof( STAMP_MAGIC ) );
+    writer.WriteString( aModelFile );
+    writer.WriteValue( aStamp.m_Size );
+    writer.WriteValue( aStamp.m_ModTime );
+    writer.WriteArray( aStamp.m_SHA1, sizeof( aStamp.m_SHA1 ) );
+
+    writer.Save( aStampFile );
+}
+
+
+bool ReadModelFileStamp( const wxString& aStampFile, const wxString& aModelFile,
+                         MODEL_FILE_STAMP& aStamp )
+{
+    if( !wxFileName::FileExists( aStampFile ) )
+        return false;
+
+    size_t      length;
+    const char* mapping = KIPLATFORM::IO::MapFile( aStampFile, length );
+
+    if( !mapping )
+        return false;
+
+    CACHE_READER  reader( mapping, length );
+    char          magic[ sizeof( STAMP_MAGIC ) ];
+    wxString      modelFile;
+    int64_t       size;
+    int64_t       modTime;
+    unsigned char sha1[ sizeof( aStamp.m_SHA1 ) ];
+
+    // The model file name catches collisions of the hashes the stamp files are named by
+    bool ok = reader.ReadBytes( magic, sizeof( magic ) )
+                && memcmp( magic, STAMP_MAGIC, sizeof( magic ) ) == 0
+                && reader.ReadString( modelFile ) && modelFile == aModelFile
+                && reader.ReadValue( size ) && reader.ReadValue( modTime )
+                && reader.ReadBytes( sha1, sizeof( sha1 ) )
+                && reader.AtEnd();
+
+    KIPLATFORM::IO::UnmapFile( mapping, length );
+
+    if( !ok || size != aStamp.m_Size || modTime != aStamp.m_ModTime )
+        return false;
+
+    memcpy( aStamp.m_SHA1, sha1, sizeof( sha1 ) );
+    return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file 3d_mesh_cache.h
+ * Binary cache files for the 3D model cache.
+ *
+ * Mesh cache files (".3dm") hold the render data (S3DMODEL) of a model: the final vertex,
+ * normal, texture coordinate, color and index arrays of each mesh and the material table.
+ * They are laid out so that every array is aligned in the file and can be used straight from
+ * a memory mapping, which makes reading one much cheaper than loading the scene graph and
+ * converting it again.
+ *
+ * Model stamp files (".3di") remember the size, modification time and SHA1 hash of a model
+ * file so that the hash, which names the cache files, need not be computed again as long as
+ * the model file is unchanged.
+ */
+
+#ifndef MESH_CACHE_3D_H
+#define MESH_CACHE_3D_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <plugins/3dapi/c3dmodel.h>
+#include <wx/string.h>
+
+
+/**
+ * Write the render data of a model to a mesh cache file.
+ *
+ * The file is written to a temporary file first and then renamed, so that other processes
+ * never see a partial cache file.
+ *
+ * @return true on success.
+ */
+bool WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel );
+
+/**
+ * The render data of a model read from a mesh cache file.
+ *
+ * The material table and the arrays of the meshes point straight into a read-only mapping of
+ * the file, which is kept as long as this object lives.  The model must not be modified or
+ * freed with S3D::Destroy3DModel().
+ */
+class MESH_CACHE_MODEL
+{
+public:
+    ~MESH_CACHE_MODEL();
+
+    S3DMODEL* GetModel() { return &m_model; }
+
+private:
+    friend std::unique_ptr<MESH_CACHE_MODEL> ReadMeshCache( const wxString& aFileName );
+
+    MESH_CACHE_MODEL( const char* aMapping, size_t aLength );
+
+    // prohibit assignment and default copy constructor
+    MESH_CACHE_MODEL( const MESH_CACHE_MODEL& aOther ) = delete;
+    MESH_CACHE_MODEL& operator=( const MESH_CACHE_MODEL& aOther ) = delete;
+
+    const char*        m_mapping;
+    size_t             m_length;
+    std::vector<SMESH> m_meshes;
+    S3DMODEL           m_model;
+};
+
+/**
+ * Read the render data of a model from a mesh cache file.
+ *
+ * @return the model or nullptr if the file does not exist, cannot be mapped or is not a valid
+ *         mesh cache file.
+ */
+std::unique_ptr<MESH_CACHE_MODEL> ReadMeshCache( const wxString& aFileName );
+
+
+struct MODEL_FILE_STAMP
+{
+    int64_t       m_Size = 0;
+    int64_t       m_ModTime = 0;
+    unsigned char m_SHA1[20] = {};
+};
+
+/**
+ * Save the stamp of the model file \a aModelFile to \a aStampFile.  Failures are ignored:
+ * the stamp is only a cache.
+ */
+void WriteModelFileStamp( const wxString& aStampFile, const wxString& aModelFile,
+                          const MODEL_FILE_STAMP& aStamp );
+
+/**
+ * Read the hash of the model file \a aModelFile from its stamp in \a aStampFile.
+ *
+ * @param aStamp holds the current size and modification time of the model file.  Its hash is
+ *               set from the stamp file if they match the stamped ones.
+ * @return false if there is no stamp file or it is unusable, for another model file or stale.
+ */
+bool ReadModelFileStamp( const wxString& aStampFile, const wxString& aModelFile,
+                         MODEL_FILE_STAMP& aStamp );
+
+#endif  // MESH_CACHE_3D_H
@@ -413,6 +413,9 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
     items = m_ExtMap.equal_range( ext_to_find );
     std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator sL = items.first;
 
+    // The plugin loaders and the parsers behind them keep global state
+    std::lock_guard<std::mutex> lock( m_loadMutex );
+
     while( sL != items.second )
     {
         if( sL->second->CanRender() )
@@ -441,6 +444,8 @@ void S3D_PLUGIN_MANAGER::ClosePlugins( void )
     wxLogTrace( MASK_3D_PLUGINMGR, wxT( "%s:%s:%d * [INFO] closing %d extensions" ),
                 __FILE__, __FUNCTION__, __LINE__, static_cast<int>( m_Plugins.size() ) );
 
+    std::lock_guard<std::mutex> lock( m_loadMutex );
+
     while( sP != eP )
     {
         (*sP)->Close();
@@ -32,6 +32,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -53,6 +54,12 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const noexcept;
 
+    /**
+     * Load a model with the first plugin able to read it.
+     *
+     * May be called from several threads; the plugins themselves are not reentrant so calls
+     * into them are serialized.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
@@ -96,6 +103,9 @@ private:
 
     /// list of file filters
     std::list< wxString > m_FileFilters;
+
+    /// serializes calls into the plugins
+    std::mutex m_loadMutex;
 };
 
 #endif  // PLUGIN_MANAGER_3D_H
@@ -297,6 +297,10 @@ void EDA_3D_CANVAS::GetScreenshot( wxImage& aDstImage )
 
 void EDA_3D_CANVAS::ReloadRequest( BOARD* aBoard , S3D_CACHE* aCachePointer )
 {
+    // The raytracer may still be tracing the board in the background
+    if( m_3d_render_raytracing )
+        m_3d_render_raytracing->CancelRender();
+
     if( aCachePointer != nullptr )
         m_boardAdapter.Set3dCacheManager( aCachePointer );
 
@@ -482,6 +486,10 @@ void EDA_3D_CANVAS::DoRePaint()
     {
         try
         {
+            // Don't leave the raytracer tracing in the background once another renderer is used
+            if( m_3d_render != m_3d_render_raytracing && m_3d_render_raytracing )
+                m_3d_render_raytracing->CancelRender();
+
             m_3d_render->SetCurWindowSize( clientSize );
 
             bool reloadRaytracingForCalculations = false;
@@ -409,12 +409,8 @@ void MODEL_3D::EndDrawMulti()
 }
 
 
-void MODEL_3D::Draw( bool aTransparent, float aOpacity, bool aUseSelectedMaterial,
-                     SFVEC3F& aSelectionColor ) const
+void MODEL_3D::bindBuffers() const
 {
-    if( aOpacity <= FLT_EPSILON )
-        return;
-
     if( !glBindBuffer )
         throw std::runtime_error( "The OpenGL context no longer exists: unable to draw" );
 
@@ -434,6 +430,41 @@ void MODEL_3D::Draw( bool aTransparent, float aOpacity, bool aUseSelectedMateria
 
     glTexCoordPointer( 2, GL_FLOAT, sizeof( VERTEX ),
                        reinterpret_cast<const void*>( offsetof( VERTEX, m_tex_uv ) ) );
+}
+
+
+void MODEL_3D::setMaterial( const MATERIAL& aMaterial, float aOpacity, bool aUseSelectedMaterial,
+                            SFVEC3F& aSelectionColor ) const
+{
+    switch( m_materialMode )
+    {
+    case MATERIAL_MODE::NORMAL:
+        OglSetMaterial( aMaterial, aOpacity, aUseSelectedMaterial, aSelectionColor );
+        break;
+
+    case MATERIAL_MODE::DIFFUSE_ONLY:
+        OglSetDiffuseMaterial( aMaterial.m_Diffuse, aOpacity, aUseSelectedMaterial,
+                               aSelectionColor );
+        break;
+
+    case MATERIAL_MODE::CAD_MODE:
+        OglSetDiffuseMaterial( MaterialDiffuseToColorCAD( aMaterial.m_Diffuse ), aOpacity,
+                               aUseSelectedMaterial, aSelectionColor );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void MODEL_3D::Draw( bool aTransparent, float aOpacity, bool aUseSelectedMaterial,
+                     SFVEC3F& aSelectionColor ) const
+{
+    if( aOpacity <= FLT_EPSILON )
+        return;
+
+    bindBuffers();
 
     const SFVEC4F param = SFVEC4F( 1.0f, 1.0f, 1.0f, aOpacity );
 
@@ -441,35 +472,48 @@ void MODEL_3D::Draw( bool aTransparent, float aOpacity, bool aUseSelectedMateria
 
     for( const MODEL_3D::MATERIAL& mat : m_materials )
     {
-        if( ( mat.IsTransparent() != aTransparent )
-                && ( aOpacity >= 1.0f )
-                && m_materialMode != MATERIAL_MODE::DIFFUSE_ONLY )
-        {
+        if( !isDrawn( mat, aTransparent, aOpacity ) )
             continue;
-        }
 
-        switch( m_materialMode )
+        setMaterial( mat, aOpacity, aUseSelectedMaterial, aSelectionColor );
+        drawMaterial( mat );
+    }
+}
+
+
+void MODEL_3D::DrawInstances( bool aTransparent, const std::vector<INSTANCE>& aInstances,
+                              bool aUseSelectedMaterial, SFVEC3F aSelectionColor ) const
+{
+    if( aInstances.empty() )
+        return;
+
+    bindBuffers();
+
+    for( const MODEL_3D::MATERIAL& mat : m_materials )
+    {
+        float opacity = -1.0f;
+
+        for( const INSTANCE& instance : aInstances )
         {
-        case MATERIAL_MODE::NORMAL:
-            OglSetMaterial( mat, aOpacity, aUseSelectedMaterial, aSelectionColor );
-            break;
+            if( instance.m_opacity <= FLT_EPSILON || !isDrawn( mat, aTransparent,
+                                                               instance.m_opacity ) )
+            {
+                continue;
+            }
 
-        case MATERIAL_MODE::DIFFUSE_ONLY:
-            OglSetDiffuseMaterial( mat.m_Diffuse, aOpacity, aUseSelectedMaterial, aSelectionColor );
-            break;
+            if( instance.m_opacity != opacity )
+            {
+                opacity = instance.m_opacity;
 
-        case MATERIAL_MODE::CAD_MODE:
-            OglSetDiffuseMaterial( MaterialDiffuseToColorCAD( mat.m_Diffuse ), aOpacity,
-                                   aUseSelectedMaterial, aSelectionColor );
-            break;
+                const SFVEC4F param = SFVEC4F( 1.0f, 1.0f, 1.0f, opacity );
 
-        default:
-            break;
-        }
+                glTexEnvfv( GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, (const float*)&param.x );
+                setMaterial( mat, opacity, aUseSelectedMaterial, aSelectionColor );
+            }
 
-        glDrawElements( GL_TRIANGLES, mat.m_render_idx_count, m_index_buffer_type,
-                        reinterpret_cast<const void*>(
-                                static_cast<uintptr_t>( mat.m_render_idx_buffer_offset ) ) );
+            glLoadMatrixf( glm::value_ptr( instance.m_modelViewMat ) );
+            drawMaterial( mat );
+        }
     }
 }
 
@@ -66,6 +66,28 @@ public:
         Draw( true, aOpacity, aUseSelectedMaterial, aSelectionColor );
     }
 
+    /// A copy of the model to be drawn by DrawInstances()
+    struct INSTANCE
+    {
+        glm::mat4 m_modelViewMat;   ///< the model to eye coordinates transform of the copy
+        float     m_opacity;
+    };
+
+    /**
+     * Render copies of the model into the current context.
+     *
+     * The buffers of the model are bound once and each material is set once for all the
+     * copies (and again only where the opacity changes), instead of once per copy as when
+     * drawing them one by one.  The modelview matrix is left as the one of the last copy.
+     *
+     * @param aTransparent true to draw the transparent parts of the copies, false to draw
+     *                     the opaque ones.
+     * @param aInstances are the copies to draw, sorted by opacity.
+     */
+    void DrawInstances( bool aTransparent, const std::vector<INSTANCE>& aInstances,
+                        bool aUseSelectedMaterial,
+                        SFVEC3F aSelectionColor = SFVEC3F( 0.0f ) ) const;
+
     /**
      * Return true if have opaque meshes to render.
      */
@@ -162,6 +184,26 @@ private:
 
     void Draw( bool aTransparent, float aOpacity, bool aUseSelectedMaterial,
                SFVEC3F& aSelectionColor ) const;
+
+    /// Bind the vertex and index buffers of the model and set up the vertex arrays
+    void bindBuffers() const;
+
+    /// Return true if the meshes of \a aMaterial are drawn in the given pass
+    bool isDrawn( const MATERIAL& aMaterial, bool aTransparent, float aOpacity ) const
+    {
+        return aMaterial.IsTransparent() == aTransparent || aOpacity < 1.0f
+                || m_materialMode == MATERIAL_MODE::DIFFUSE_ONLY;
+    }
+
+    void setMaterial( const MATERIAL& aMaterial, float aOpacity, bool aUseSelectedMaterial,
+                      SFVEC3F& aSelectionColor ) const;
+
+    void drawMaterial( const MATERIAL& aMaterial ) const
+    {
+        glDrawElements( GL_TRIANGLES, aMaterial.m_render_idx_count, m_index_buffer_type,
+                        reinterpret_cast<const void*>(
+                                static_cast<uintptr_t>( aMaterial.m_render_idx_buffer_offset ) ) );
+    }
 };
 
 #endif // _MODEL_3D_H_
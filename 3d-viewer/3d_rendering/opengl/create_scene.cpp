@@ -34,6 +34,8 @@
 #include <eda_3d_canvas.h>
 #include <eda_3d_viewer_frame.h>
 
+#include <set>
+
 
 void RENDER_3D_OPENGL::addObjectTriangles( const FILLED_CIRCLE_2D* aFilledCircle,
                                            TRIANGLE_DISPLAY_LIST* aDstLayer, float aZtop,
@@ -919,6 +921,9 @@ void RENDER_3D_OPENGL::load3dModels( REPORTER* aStatusReporter )
         return;
     }
 
+    std::vector<std::pair<wxString, wxString>> models;
+    std::set<wxString>                         modelNames;
+
     // Go for all footprints
     for( const FOOTPRINT* footprint : m_boardAdapter.GetBoard()->Footprints() )
     {
@@ -945,35 +950,33 @@ void RENDER_3D_OPENGL::load3dModels( REPORTER* aStatusReporter )
 
         for( const FP_3DMODEL& fp_model : footprint->Models() )
         {
-            if( fp_model.m_Show && !fp_model.m_Filename.empty() )
+            // Check if the fp_model is not present in our cache map
+            // (Not already loaded in memory)
+            if( fp_model.m_Show && !fp_model.m_Filename.empty()
+                    && m_3dModelMap.find( fp_model.m_Filename ) == m_3dModelMap.end()
+                    && modelNames.insert( fp_model.m_Filename ).second )
             {
-                if( aStatusReporter )
-                {
-                    // Display the short filename of the 3D fp_model loaded:
-                    // (the full name is usually too long to be displayed)
-                    wxFileName fn( fp_model.m_Filename );
-                    aStatusReporter->Report( wxString::Format( _( "Loading %s..." ),
-                                                               fn.GetFullName() ) );
-                }
+                models.emplace_back( fp_model.m_Filename, footprintBasePath );
+            }
+        }
+    }
 
-                // Check if the fp_model is not present in our cache map
-                // (Not already loaded in memory)
-                if( m_3dModelMap.find( fp_model.m_Filename ) == m_3dModelMap.end() )
-                {
-                    // It is not present, try get it from cache
-                    const S3DMODEL* modelPtr =
-                            m_boardAdapter.Get3dCacheManager()->GetModel( fp_model.m_Filename, footprintBasePath );
+    // Load the models from the cache (or the files) in parallel
+    S3D_CACHE* cacheMgr = m_boardAdapter.Get3dCacheManager();
 
-                    // only add it if the return is not NULL
-                    if( modelPtr )
-                    {
-                        MATERIAL_MODE materialMode = m_boardAdapter.m_Cfg->m_Render.material_mode;
-                        MODEL_3D*     model        = new MODEL_3D( *modelPtr, materialMode );
+    cacheMgr->PreloadModels( models, aStatusReporter );
 
-                        m_3dModelMap[ fp_model.m_Filename ] = model;
-                    }
-                }
-            }
+    for( const auto& [ modelFile, basePath ] : models )
+    {
+        const S3DMODEL* modelPtr = cacheMgr->GetModel( modelFile, basePath );
+
+        // only add it if the return is not NULL
+        if( modelPtr )
+        {
+            MATERIAL_MODE materialMode = m_boardAdapter.m_Cfg->m_Render.material_mode;
+            MODEL_3D*     model        = new MODEL_3D( *modelPtr, materialMode );
+
+            m_3dModelMap[ modelFile ] = model;
         }
     }
 }
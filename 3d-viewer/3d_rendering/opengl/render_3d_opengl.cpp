@@ -32,6 +32,8 @@
 #include <math/util.h>      // for KiROUND
 #include <wx/log.h>
 
+#include <algorithm>
+
 #include <base_units.h>
 
 /**
@@ -859,8 +861,8 @@ bool RENDER_3D_OPENGL::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
     }
 
     // Render 3D Models (Non-transparent)
-    render3dModels( false, false );
-    render3dModels( true, false );
+    collect3dModels();
+    render3dModels( false );
 
     // Display board body
     if( m_boardAdapter.m_Cfg->m_Render.show_board_body )
@@ -922,8 +924,7 @@ bool RENDER_3D_OPENGL::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
     glTexEnvi( GL_TEXTURE_ENV, GL_SRC1_ALPHA, GL_CONSTANT );
     glTexEnvi( GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA );
 
-    render3dModels( false, true );
-    render3dModels( true, true );
+    render3dModels( true );
 
     glDisable( GL_BLEND );
     OglResetTextureState();
@@ -1058,6 +1059,7 @@ void RENDER_3D_OPENGL::freeAllLists()
     m_3dModelMap.clear();
 
     m_3dModelMatrixMap.clear();
+    m_3dModelInstances.clear();
 
     delete m_board;
     m_board = nullptr;
@@ -1143,17 +1145,29 @@ void RENDER_3D_OPENGL::renderSolderMaskLayer( PCB_LAYER_ID aLayerID, float aZPos
 }
 
 
-void RENDER_3D_OPENGL::render3dModelsSelected( bool aRenderTopOrBot, bool aRenderTransparentOnly,
-                                               bool aRenderSelectedOnly )
+void RENDER_3D_OPENGL::collect3dModels()
 {
+    for( std::pair<const MODEL_3D* const, MODEL_INSTANCES>& entry : m_3dModelInstances )
+    {
+        for( std::vector<MODEL_3D::INSTANCE>& instances : entry.second.m_instances )
+            instances.clear();
+    }
+
     if( !m_boardAdapter.GetBoard() )
         return;
 
-    MODEL_3D::BeginDrawMulti( !aRenderSelectedOnly );
+    const glm::mat4 viewMatrix = m_camera.GetViewMatrix();
+    const double    modelunit_to_3d_units_factor =
+            m_boardAdapter.BiuTo3dUnits() * UNITS3D_TO_UNITSPCB;
 
-    // Go for all footprints
-    for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
+    for( const FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
     {
+        if( fp->Models().empty()
+                || !m_boardAdapter.IsFootprintShown( (FOOTPRINT_ATTR_T) fp->GetAttributes() ) )
+        {
+            continue;
+        }
+
         bool highlight = false;
 
         if( m_boardAdapter.m_IsBoardView )
@@ -1166,66 +1180,33 @@ void RENDER_3D_OPENGL::render3dModelsSelected( bool aRenderTopOrBot, bool aRende
             {
                 highlight = true;
             }
-
-            if( aRenderSelectedOnly != highlight )
-                continue;
         }
 
-        if( !fp->Models().empty() )
+        const double zpos = m_boardAdapter.GetFootprintZPos( fp->IsFlipped() );
+        VECTOR2I     pos = fp->GetPosition();
+        glm::mat4    fpMatrix = glm::translate( viewMatrix,
+                                                SFVEC3F( pos.x * m_boardAdapter.BiuTo3dUnits(),
+                                                         -pos.y * m_boardAdapter.BiuTo3dUnits(),
+                                                         zpos ) );
+
+        if( !fp->GetOrientation().IsZero() )
         {
-            if( m_boardAdapter.IsFootprintShown( (FOOTPRINT_ATTR_T) fp->GetAttributes() ) )
-            {
-                if( aRenderTopOrBot == !fp->IsFlipped() )
-                    renderFootprint( fp, aRenderTransparentOnly, highlight );
-            }
+            fpMatrix = glm::rotate( fpMatrix, (float) fp->GetOrientation().AsRadians(),
+                                    SFVEC3F( 0.0f, 0.0f, 1.0f ) );
         }
-    }
 
-    MODEL_3D::EndDrawMulti();
-}
-
-
-void RENDER_3D_OPENGL::render3dModels( bool aRenderTopOrBot, bool aRenderTransparentOnly )
-{
-    if( m_boardAdapter.m_IsBoardView )
-        render3dModelsSelected( aRenderTopOrBot, aRenderTransparentOnly, true );
-
-    render3dModelsSelected( aRenderTopOrBot, aRenderTransparentOnly, false );
-}
-
-
-void RENDER_3D_OPENGL::renderFootprint( const FOOTPRINT* aFootprint, bool aRenderTransparentOnly,
-                                        bool aIsSelected )
-{
-    if( !aFootprint->Models().empty() )
-    {
-        const double zpos = m_boardAdapter.GetFootprintZPos( aFootprint->IsFlipped() );
-        SFVEC3F selColor = m_boardAdapter.GetColor( m_boardAdapter.m_Cfg->m_Render.opengl_selection_color );
-
-
-        glPushMatrix();
-
-        VECTOR2I pos = aFootprint->GetPosition();
-
-        glTranslatef( pos.x * m_boardAdapter.BiuTo3dUnits(), -pos.y * m_boardAdapter.BiuTo3dUnits(),
-                      zpos );
-
-        if( !aFootprint->GetOrientation().IsZero() )
-            glRotated( aFootprint->GetOrientation().AsDegrees(), 0.0, 0.0, 1.0 );
-
-        if( aFootprint->IsFlipped() )
+        if( fp->IsFlipped() )
         {
-            glRotatef( 180.0f, 0.0f, 1.0f, 0.0f );
-            glRotatef( 180.0f, 0.0f, 0.0f, 1.0f );
+            fpMatrix = glm::rotate( fpMatrix, glm::pi<float>(), SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+            fpMatrix = glm::rotate( fpMatrix, glm::pi<float>(), SFVEC3F( 0.0f, 0.0f, 1.0f ) );
         }
 
-        double modelunit_to_3d_units_factor = m_boardAdapter.BiuTo3dUnits() * UNITS3D_TO_UNITSPCB;
-
-        glScaled( modelunit_to_3d_units_factor, modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor );
+        fpMatrix = glm::scale( fpMatrix, SFVEC3F( modelunit_to_3d_units_factor,
+                                                  modelunit_to_3d_units_factor,
+                                                  modelunit_to_3d_units_factor ) );
 
         // Get the list of model files for this model
-        for( const FP_3DMODEL& sM : aFootprint->Models() )
+        for( const FP_3DMODEL& sM : fp->Models() )
         {
             if( !sM.m_Show || sM.m_Filename.empty() )
                 continue;
@@ -1233,77 +1214,109 @@ void RENDER_3D_OPENGL::renderFootprint( const FOOTPRINT* aFootprint, bool aRende
             // Check if the model is present in our cache map
             auto cache_i = m_3dModelMap.find( sM.m_Filename );
 
-            if( cache_i == m_3dModelMap.end() )
+            if( cache_i == m_3dModelMap.end() || !cache_i->second )
                 continue;
 
-            if( const MODEL_3D* modelPtr = cache_i->second )
+            const MODEL_3D* modelPtr = cache_i->second;
+            bool            opaque = sM.m_Opacity >= 1.0;
+            MODEL_INSTANCES& instances = m_3dModelInstances[modelPtr];
+
+            std::vector<double> key = { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z,
+                                        sM.m_Rotation.x, sM.m_Rotation.y, sM.m_Rotation.z,
+                                        sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z };
+
+            auto it = m_3dModelMatrixMap.find( key );
+
+            if( it == m_3dModelMatrixMap.end() )
             {
-                bool opaque = sM.m_Opacity >= 1.0;
+                glm::mat4 mtx( 1 );
+                mtx = glm::translate( mtx, { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z } );
+                mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.z ), { 0.0f, 0.0f, 1.0f } );
+                mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.y ), { 0.0f, 1.0f, 0.0f } );
+                mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.x ), { 1.0f, 0.0f, 0.0f } );
+                mtx = glm::scale( mtx, { sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z } );
+
+                it = m_3dModelMatrixMap.emplace( key, mtx ).first;
+            }
 
-                if( ( !aRenderTransparentOnly && modelPtr->HasOpaqueMeshes() && opaque ) ||
-                    ( aRenderTransparentOnly && ( modelPtr->HasTransparentMeshes() || !opaque ) ) )
-                {
-                    glPushMatrix();
+            const glm::mat4 modelViewMat = fpMatrix * it->second;
 
-                    std::vector<double> key = { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z,
-                                                sM.m_Rotation.x, sM.m_Rotation.y, sM.m_Rotation.z,
-                                                sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z };
+            if( modelPtr->HasOpaqueMeshes() && opaque )
+                instances.Get( false, highlight ).push_back( { modelViewMat, 1.0f } );
 
-                    auto it = m_3dModelMatrixMap.find( key );
+            if( modelPtr->HasTransparentMeshes() || !opaque )
+            {
+                instances.Get( true, highlight ).push_back( { modelViewMat,
+                                                              (float) sM.m_Opacity } );
+            }
+        }
+    }
 
-                    if( it != m_3dModelMatrixMap.end() )
-                    {
-                        glMultMatrixf( glm::value_ptr( it->second ) );
-                    }
-                    else
-                    {
-                        glm::mat4 mtx( 1 );
-                        mtx = glm::translate( mtx, { sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z } );
-                        mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.z ), { 0.0f, 0.0f, 1.0f } );
-                        mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.y ), { 0.0f, 1.0f, 0.0f } );
-                        mtx = glm::rotate( mtx, glm::radians( (float) -sM.m_Rotation.x ), { 1.0f, 0.0f, 0.0f } );
-                        mtx = glm::scale( mtx, { sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z } );
-                        m_3dModelMatrixMap[ key ] = mtx;
-
-                        glMultMatrixf( glm::value_ptr( mtx ) );
-                    }
+    // Copies are drawn by opacity so the materials need only be set when it changes
+    for( std::pair<const MODEL_3D* const, MODEL_INSTANCES>& entry : m_3dModelInstances )
+    {
+        for( bool highlight : { false, true } )
+        {
+            std::vector<MODEL_3D::INSTANCE>& instances = entry.second.Get( true, highlight );
 
+            std::stable_sort( instances.begin(), instances.end(),
+                              []( const MODEL_3D::INSTANCE& a, const MODEL_3D::INSTANCE& b )
+                              {
+                                  return a.m_opacity < b.m_opacity;
+                              } );
+        }
+    }
+}
 
-                    if( aRenderTransparentOnly )
-                    {
-                        modelPtr->DrawTransparent( sM.m_Opacity,
-                                                   aFootprint->IsSelected() || aIsSelected,
-                                                   selColor );
-                    }
-                    else
-                    {
-                        modelPtr->DrawOpaque( aFootprint->IsSelected() || aIsSelected, selColor );
-                    }
 
-                    if( m_boardAdapter.m_Cfg->m_Render.opengl_show_model_bbox )
-                    {
-                        glEnable( GL_BLEND );
-                        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+void RENDER_3D_OPENGL::render3dModels( bool aRenderTransparentOnly )
+{
+    if( m_3dModelInstances.empty() )
+        return;
 
-                        glDisable( GL_LIGHTING );
+    SFVEC3F selColor = m_boardAdapter.GetColor( m_boardAdapter.m_Cfg->m_Render.opengl_selection_color );
 
-                        glLineWidth( 1 );
-                        modelPtr->DrawBboxes();
+    // Highlighted footprints are drawn first, in the selection color
+    for( bool highlight : { true, false } )
+    {
+        MODEL_3D::BeginDrawMulti( !highlight );
 
-                        glLineWidth( 4 );
-                        modelPtr->DrawBbox();
+        for( const std::pair<const MODEL_3D* const, MODEL_INSTANCES>& entry : m_3dModelInstances )
+        {
+            const MODEL_3D*                        modelPtr = entry.first;
+            const std::vector<MODEL_3D::INSTANCE>& instances =
+                    entry.second.Get( aRenderTransparentOnly, highlight );
 
-                        glEnable( GL_LIGHTING );
-                        glDisable( GL_BLEND );
-                    }
+            modelPtr->DrawInstances( aRenderTransparentOnly, instances, highlight, selColor );
+
+            if( m_boardAdapter.m_Cfg->m_Render.opengl_show_model_bbox && !instances.empty() )
+            {
+                glEnable( GL_BLEND );
+                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-                    glPopMatrix();
+                glDisable( GL_LIGHTING );
+
+                for( const MODEL_3D::INSTANCE& instance : instances )
+                {
+                    glLoadMatrixf( glm::value_ptr( instance.m_modelViewMat ) );
+
+                    glLineWidth( 1 );
+                    modelPtr->DrawBboxes();
+
+                    glLineWidth( 4 );
+                    modelPtr->DrawBbox();
                 }
+
+                glEnable( GL_LIGHTING );
+                glDisable( GL_BLEND );
             }
         }
 
-        glPopMatrix();
+        MODEL_3D::EndDrawMulti();
     }
+
+    // The copies leave their own transforms behind
+    glLoadMatrixf( glm::value_ptr( m_camera.GetViewMatrix() ) );
 }
 
 
@@ -130,17 +130,18 @@ private:
     void load3dModels( REPORTER* aStatusReporter );
 
     /**
-     * @param aRenderTopOrBot true will render Top, false will render bottom
+     * Gather the copies of each model to be drawn in this frame into #m_3dModelInstances,
+     * along with their transforms for the current camera.
+     */
+    void collect3dModels();
+
+    /**
+     * Draw the copies of each model gathered by collect3dModels(), one model at a time.
+     *
      * @param aRenderTransparentOnly true will render only the transparent objects, false will
      *                               render opaque
      */
-    void render3dModels( bool aRenderTopOrBot, bool aRenderTransparentOnly );
-
-    void render3dModelsSelected( bool aRenderTopOrBot, bool aRenderTransparentOnly,
-                                 bool aRenderSelectedOnly );
-
-    void renderFootprint( const FOOTPRINT* aFootprint, bool aRenderTransparentOnly,
-                          bool aIsSelected );
+    void render3dModels( bool aRenderTransparentOnly );
 
     void setLightFront( bool enabled );
     void setLightTop( bool enabled );
@@ -208,9 +209,26 @@ private:
     OPENGL_RENDER_LIST* m_vias;
     OPENGL_RENDER_LIST* m_padHoles;
 
+    /// The copies of a model to be drawn in the current frame
+    struct MODEL_INSTANCES
+    {
+        std::vector<MODEL_3D::INSTANCE> m_instances[4];
+
+        std::vector<MODEL_3D::INSTANCE>& Get( bool aTransparent, bool aHighlighted )
+        {
+            return m_instances[ ( aTransparent ? 2 : 0 ) + ( aHighlighted ? 1 : 0 ) ];
+        }
+
+        const std::vector<MODEL_3D::INSTANCE>& Get( bool aTransparent, bool aHighlighted ) const
+        {
+            return m_instances[ ( aTransparent ? 2 : 0 ) + ( aHighlighted ? 1 : 0 ) ];
+        }
+    };
+
     // Caches
     std::map< wxString, MODEL_3D* >            m_3dModelMap;
     std::map< std::vector<double>, glm::mat4 > m_3dModelMatrixMap;
+    std::map< const MODEL_3D*, MODEL_INSTANCES > m_3dModelInstances;
 
     BOARD_ITEM*         m_currentRollOverItem;
 
@@ -59,6 +59,9 @@ public:
                        const SFVEC3F& aColor, const SFVEC3F& aHitPosition,
                        float aDepth, float aShadowAttFactor );
 
+    /// Change the color of a pixel set by SetPixelData(), e.g. to add more samples.
+    void SetPixelColor( unsigned int x, unsigned int y, const SFVEC3F& aColor );
+
     const SFVEC3F& GetColorAtNotProtected( const SFVEC2I& aPos ) const;
 
     void DebugBuffersOutputAsImages() const;
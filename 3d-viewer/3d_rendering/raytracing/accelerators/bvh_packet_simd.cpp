@@ -0,0 +1,445 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file bvh_packet_simd.cpp
+ */
+
+#include "bvh_packet_simd.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || ( defined( __i386__ ) && defined( __SSE2__ ) )
+#define RAYPACKET_SIMD_X86
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define RAYPACKET_TARGET_AVX2
+#else
+#define RAYPACKET_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#endif
+#endif
+
+
+// The box is made slightly larger than it is (by the rounding error of the slab distances)
+// so that rays grazing it are never missed.
+static const float BBOX_TMAX_SCALE = 1.0f + 4.0f * FLT_EPSILON;
+
+// Barycentric coordinates and distances of triangle hits are accepted with this margin so
+// that the kernels never miss a hit the scalar test would find.
+static const float TRIANGLE_EPSILON = 1.0e-5f;
+
+
+void RAYPACKET_SOA::Init( const RAYPACKET& aRayPacket, const HITINFO_PACKET* aHitInfoPacket )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const RAY& ray = aRayPacket.m_ray[i];
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            m_origin[axis][i] = ray.m_Origin[axis];
+            m_dir[axis][i] = ray.m_Dir[axis];
+            m_invDir[axis][i] = ray.m_InvDir[axis];
+        }
+
+        m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+    }
+}
+
+
+static unsigned int intersectBBoxScalar( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                         const BBOX_3D& aBBox )
+{
+    const SFVEC3F& bmin = aBBox.Min();
+    const SFVEC3F& bmax = aBBox.Max();
+    unsigned int   mask = 0;
+
+    for( unsigned int lane = 0; lane < RAYPACKET_SIMD_WIDTH; ++lane )
+    {
+        const unsigned int i = aFirst + lane;
+        float              tmin = -FLT_MAX;
+        float              tmax = FLT_MAX;
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const float t0 = ( bmin[axis] - aRays.m_origin[axis][i] ) * aRays.m_invDir[axis][i];
+            const float t1 = ( bmax[axis] - aRays.m_origin[axis][i] ) * aRays.m_invDir[axis][i];
+
+            tmin = std::max( tmin, std::min( t0, t1 ) );
+            tmax = std::min( tmax, std::max( t0, t1 ) );
+        }
+
+        tmax *= BBOX_TMAX_SCALE;
+
+        if( !( tmax < std::max( tmin, 0.0f ) ) && !( tmin >= aRays.m_tHit[i] ) )
+            mask |= 1 << lane;
+    }
+
+    return mask;
+}
+
+
+static unsigned int intersectTriangleScalar( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                             const TRIANGLE_PACKET_DATA& aTri )
+{
+    const float* ok = aRays.m_origin[aTri.m_k];
+    const float* oku = aRays.m_origin[aTri.m_ku];
+    const float* okv = aRays.m_origin[aTri.m_kv];
+    const float* dk = aRays.m_dir[aTri.m_k];
+    const float* dku = aRays.m_dir[aTri.m_ku];
+    const float* dkv = aRays.m_dir[aTri.m_kv];
+    unsigned int mask = 0;
+
+    for( unsigned int lane = 0; lane < RAYPACKET_SIMD_WIDTH; ++lane )
+    {
+        const unsigned int i = aFirst + lane;
+
+        const float lnd = 1.0f / ( dk[i] + aTri.m_nu * dku[i] + aTri.m_nv * dkv[i] );
+        const float t = ( aTri.m_nd - ok[i] - aTri.m_nu * oku[i] - aTri.m_nv * okv[i] ) * lnd;
+
+        if( !( ( aRays.m_tHit[i] * ( 1.0f + TRIANGLE_EPSILON ) > t ) && ( t > 0.0f ) ) )
+            continue;
+
+        const float hu = oku[i] + t * dku[i] - aTri.m_au;
+        const float hv = okv[i] + t * dkv[i] - aTri.m_av;
+        const float beta = hv * aTri.m_bnu + hu * aTri.m_bnv;
+        const float gamma = hu * aTri.m_cnu + hv * aTri.m_cnv;
+
+        if( beta >= -TRIANGLE_EPSILON && gamma >= -TRIANGLE_EPSILON
+          && beta + gamma <= 1.0f + TRIANGLE_EPSILON )
+        {
+            mask |= 1 << lane;
+        }
+    }
+
+    return mask;
+}
+
+
+#ifdef RAYPACKET_SIMD_X86
+
+static unsigned int intersectBBoxSSE( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                      const BBOX_3D& aBBox )
+{
+    const SFVEC3F& bmin = aBBox.Min();
+    const SFVEC3F& bmax = aBBox.Max();
+    unsigned int   mask = 0;
+
+    for( unsigned int half = 0; half < RAYPACKET_SIMD_WIDTH; half += 4 )
+    {
+        const unsigned int i = aFirst + half;
+        __m128             tmin = _mm_set1_ps( -FLT_MAX );
+        __m128             tmax = _mm_set1_ps( FLT_MAX );
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m128 o = _mm_load_ps( &aRays.m_origin[axis][i] );
+            const __m128 inv = _mm_load_ps( &aRays.m_invDir[axis][i] );
+            const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bmin[axis] ), o ), inv );
+            const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bmax[axis] ), o ), inv );
+
+            tmin = _mm_max_ps( tmin, _mm_min_ps( t0, t1 ) );
+            tmax = _mm_min_ps( tmax, _mm_max_ps( t0, t1 ) );
+        }
+
+        tmax = _mm_mul_ps( tmax, _mm_set1_ps( BBOX_TMAX_SCALE ) );
+
+        // Written as "not a miss" so that a NaN counts as a hit
+        const __m128 miss = _mm_or_ps( _mm_cmplt_ps( tmax, _mm_max_ps( tmin, _mm_setzero_ps() ) ),
+                                       _mm_cmpge_ps( tmin, _mm_load_ps( &aRays.m_tHit[i] ) ) );
+
+        mask |= ( ~_mm_movemask_ps( miss ) & 0xF ) << half;
+    }
+
+    return mask;
+}
+
+
+static unsigned int intersectTriangleSSE( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                          const TRIANGLE_PACKET_DATA& aTri )
+{
+    const __m128 nu = _mm_set1_ps( aTri.m_nu );
+    const __m128 nv = _mm_set1_ps( aTri.m_nv );
+    const __m128 eps = _mm_set1_ps( TRIANGLE_EPSILON );
+    unsigned int mask = 0;
+
+    for( unsigned int half = 0; half < RAYPACKET_SIMD_WIDTH; half += 4 )
+    {
+        const unsigned int i = aFirst + half;
+        const __m128       oku = _mm_load_ps( &aRays.m_origin[aTri.m_ku][i] );
+        const __m128       okv = _mm_load_ps( &aRays.m_origin[aTri.m_kv][i] );
+        const __m128       dku = _mm_load_ps( &aRays.m_dir[aTri.m_ku][i] );
+        const __m128       dkv = _mm_load_ps( &aRays.m_dir[aTri.m_kv][i] );
+
+        const __m128 nd = _mm_add_ps( _mm_add_ps( _mm_load_ps( &aRays.m_dir[aTri.m_k][i] ),
+                                                  _mm_mul_ps( nu, dku ) ),
+                                      _mm_mul_ps( nv, dkv ) );
+
+        const __m128 t = _mm_div_ps(
+                _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_set1_ps( aTri.m_nd ),
+                                                    _mm_load_ps( &aRays.m_origin[aTri.m_k][i] ) ),
+                                        _mm_mul_ps( nu, oku ) ),
+                            _mm_mul_ps( nv, okv ) ),
+                nd );
+
+        __m128 valid = _mm_and_ps(
+                _mm_cmpgt_ps( _mm_mul_ps( _mm_load_ps( &aRays.m_tHit[i] ),
+                                          _mm_set1_ps( 1.0f + TRIANGLE_EPSILON ) ),
+                              t ),
+                _mm_cmpgt_ps( t, _mm_setzero_ps() ) );
+
+        if( !_mm_movemask_ps( valid ) )
+            continue;
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( oku, _mm_mul_ps( t, dku ) ),
+                                      _mm_set1_ps( aTri.m_au ) );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( okv, _mm_mul_ps( t, dkv ) ),
+                                      _mm_set1_ps( aTri.m_av ) );
+        const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, _mm_set1_ps( aTri.m_bnu ) ),
+                                        _mm_mul_ps( hu, _mm_set1_ps( aTri.m_bnv ) ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, _mm_set1_ps( aTri.m_cnu ) ),
+                                         _mm_mul_ps( hv, _mm_set1_ps( aTri.m_cnv ) ) );
+        const __m128 minusEps = _mm_sub_ps( _mm_setzero_ps(), eps );
+
+        valid = _mm_and_ps( valid, _mm_cmpge_ps( beta, minusEps ) );
+        valid = _mm_and_ps( valid, _mm_cmpge_ps( gamma, minusEps ) );
+        valid = _mm_and_ps( valid, _mm_cmple_ps( _mm_add_ps( beta, gamma ),
+                                                 _mm_add_ps( _mm_set1_ps( 1.0f ), eps ) ) );
+
+        mask |= _mm_movemask_ps( valid ) << half;
+    }
+
+    return mask;
+}
+
+
+RAYPACKET_TARGET_AVX2
+static unsigned int intersectBBoxAVX2( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                       const BBOX_3D& aBBox )
+{
+    const SFVEC3F& bmin = aBBox.Min();
+    const SFVEC3F& bmax = aBBox.Max();
+    __m256         tmin = _mm256_set1_ps( -FLT_MAX );
+    __m256         tmax = _mm256_set1_ps( FLT_MAX );
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        const __m256 o = _mm256_load_ps( &aRays.m_origin[axis][aFirst] );
+        const __m256 inv = _mm256_load_ps( &aRays.m_invDir[axis][aFirst] );
+        const __m256 t0 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( bmin[axis] ), o ), inv );
+        const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_set1_ps( bmax[axis] ), o ), inv );
+
+        tmin = _mm256_max_ps( tmin, _mm256_min_ps( t0, t1 ) );
+        tmax = _mm256_min_ps( tmax, _mm256_max_ps( t0, t1 ) );
+    }
+
+    tmax = _mm256_mul_ps( tmax, _mm256_set1_ps( BBOX_TMAX_SCALE ) );
+
+    // Written as "not a miss" so that a NaN counts as a hit
+    const __m256 miss = _mm256_or_ps(
+            _mm256_cmp_ps( tmax, _mm256_max_ps( tmin, _mm256_setzero_ps() ), _CMP_LT_OQ ),
+            _mm256_cmp_ps( tmin, _mm256_load_ps( &aRays.m_tHit[aFirst] ), _CMP_GE_OQ ) );
+
+    return ~_mm256_movemask_ps( miss ) & 0xFF;
+}
+
+
+RAYPACKET_TARGET_AVX2
+static unsigned int intersectTriangleAVX2( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                           const TRIANGLE_PACKET_DATA& aTri )
+{
+    const __m256 nu = _mm256_set1_ps( aTri.m_nu );
+    const __m256 nv = _mm256_set1_ps( aTri.m_nv );
+    const __m256 eps = _mm256_set1_ps( TRIANGLE_EPSILON );
+    const __m256 oku = _mm256_load_ps( &aRays.m_origin[aTri.m_ku][aFirst] );
+    const __m256 okv = _mm256_load_ps( &aRays.m_origin[aTri.m_kv][aFirst] );
+    const __m256 dku = _mm256_load_ps( &aRays.m_dir[aTri.m_ku][aFirst] );
+    const __m256 dkv = _mm256_load_ps( &aRays.m_dir[aTri.m_kv][aFirst] );
+
+    const __m256 nd = _mm256_add_ps( _mm256_add_ps( _mm256_load_ps( &aRays.m_dir[aTri.m_k][aFirst] ),
+                                                    _mm256_mul_ps( nu, dku ) ),
+                                     _mm256_mul_ps( nv, dkv ) );
+
+    const __m256 t = _mm256_div_ps(
+            _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( _mm256_set1_ps( aTri.m_nd ),
+                                                         _mm256_load_ps( &aRays.m_origin[aTri.m_k][aFirst] ) ),
+                                          _mm256_mul_ps( nu, oku ) ),
+                           _mm256_mul_ps( nv, okv ) ),
+            nd );
+
+    __m256 valid = _mm256_and_ps(
+            _mm256_cmp_ps( _mm256_mul_ps( _mm256_load_ps( &aRays.m_tHit[aFirst] ),
+                                          _mm256_set1_ps( 1.0f + TRIANGLE_EPSILON ) ),
+                           t, _CMP_GT_OQ ),
+            _mm256_cmp_ps( t, _mm256_setzero_ps(), _CMP_GT_OQ ) );
+
+    if( !_mm256_movemask_ps( valid ) )
+        return 0;
+
+    const __m256 hu = _mm256_sub_ps( _mm256_add_ps( oku, _mm256_mul_ps( t, dku ) ),
+                                     _mm256_set1_ps( aTri.m_au ) );
+    const __m256 hv = _mm256_sub_ps( _mm256_add_ps( okv, _mm256_mul_ps( t, dkv ) ),
+                                     _mm256_set1_ps( aTri.m_av ) );
+    const __m256 beta = _mm256_add_ps( _mm256_mul_ps( hv, _mm256_set1_ps( aTri.m_bnu ) ),
+                                       _mm256_mul_ps( hu, _mm256_set1_ps( aTri.m_bnv ) ) );
+    const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, _mm256_set1_ps( aTri.m_cnu ) ),
+                                        _mm256_mul_ps( hv, _mm256_set1_ps( aTri.m_cnv ) ) );
+    const __m256 minusEps = _mm256_sub_ps( _mm256_setzero_ps(), eps );
+
+    valid = _mm256_and_ps( valid, _mm256_cmp_ps( beta, minusEps, _CMP_GE_OQ ) );
+    valid = _mm256_and_ps( valid, _mm256_cmp_ps( gamma, minusEps, _CMP_GE_OQ ) );
+    valid = _mm256_and_ps( valid, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ),
+                                                 _mm256_add_ps( _mm256_set1_ps( 1.0f ), eps ),
+                                                 _CMP_LE_OQ ) );
+
+    return _mm256_movemask_ps( valid );
+}
+
+
+static bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    __cpuid( info, 0 );
+
+    if( info[0] < 7 )
+        return false;
+
+    __cpuid( info, 1 );
+
+    // The OS must save the AVX registers (OSXSAVE and AVX bits, then XCR0)
+    if( ( info[2] & ( ( 1 << 27 ) | ( 1 << 28 ) ) ) != ( ( 1 << 27 ) | ( 1 << 28 ) ) )
+        return false;
+
+    if( ( _xgetbv( 0 ) & 0x6 ) != 0x6 )
+        return false;
+
+    __cpuidex( info, 7, 0 );
+
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+
+#endif // RAYPACKET_SIMD_X86
+
+
+bool IsRayPacketKernelSupported( RAYPACKET_KERNEL aKernel )
+{
+    switch( aKernel )
+    {
+#ifdef RAYPACKET_SIMD_X86
+    case RAYPACKET_KERNEL::AVX2: return cpuHasAVX2();
+    case RAYPACKET_KERNEL::SSE2: return true;
+#endif
+    case RAYPACKET_KERNEL::SCALAR: return true;
+    default: return false;
+    }
+}
+
+
+struct PACKET_KERNELS
+{
+    PACKET_KERNELS( RAYPACKET_KERNEL aKernel )
+    {
+        m_bbox = intersectBBoxScalar;
+        m_triangle = intersectTriangleScalar;
+
+#ifdef RAYPACKET_SIMD_X86
+        if( aKernel == RAYPACKET_KERNEL::AVX2 && cpuHasAVX2() )
+        {
+            m_bbox = intersectBBoxAVX2;
+            m_triangle = intersectTriangleAVX2;
+        }
+        else if( aKernel == RAYPACKET_KERNEL::SSE2 )
+        {
+            m_bbox = intersectBBoxSSE;
+            m_triangle = intersectTriangleSSE;
+        }
+#endif
+    }
+
+    unsigned int ( *m_bbox )( const RAYPACKET_SOA&, unsigned int, const BBOX_3D& );
+    unsigned int ( *m_triangle )( const RAYPACKET_SOA&, unsigned int, const TRIANGLE_PACKET_DATA& );
+};
+
+
+static RAYPACKET_KERNEL bestKernel()
+{
+    if( IsRayPacketKernelSupported( RAYPACKET_KERNEL::AVX2 ) )
+        return RAYPACKET_KERNEL::AVX2;
+    else if( IsRayPacketKernelSupported( RAYPACKET_KERNEL::SSE2 ) )
+        return RAYPACKET_KERNEL::SSE2;
+    else
+        return RAYPACKET_KERNEL::SCALAR;
+}
+
+
+static const PACKET_KERNELS s_kernels( bestKernel() );
+
+
+static const PACKET_KERNELS& getKernels( RAYPACKET_KERNEL aKernel )
+{
+    static const PACKET_KERNELS kernels[] = { PACKET_KERNELS( RAYPACKET_KERNEL::SCALAR ),
+                                              PACKET_KERNELS( RAYPACKET_KERNEL::SSE2 ),
+                                              PACKET_KERNELS( RAYPACKET_KERNEL::AVX2 ) };
+
+    return kernels[(int) aKernel];
+}
+
+
+unsigned int IntersectBBoxPacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                   const BBOX_3D& aBBox )
+{
+    return s_kernels.m_bbox( aRays, aFirst, aBBox );
+}
+
+
+unsigned int IntersectTrianglePacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                       const TRIANGLE_PACKET_DATA& aTriangle )
+{
+    return s_kernels.m_triangle( aRays, aFirst, aTriangle );
+}
+
+
+unsigned int IntersectBBoxPacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                   const BBOX_3D& aBBox, RAYPACKET_KERNEL aKernel )
+{
+    return getKernels( aKernel ).m_bbox( aRays, aFirst, aBBox );
+}
+
+
+unsigned int IntersectTrianglePacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                       const TRIANGLE_PACKET_DATA& aTriangle,
+                                       RAYPACKET_KERNEL aKernel )
+{
+    return getKernels( aKernel ).m_triangle( aRays, aFirst, aTriangle );
+}
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file bvh_packet_simd.h
+ * @brief Intersection kernels testing 8 rays of a packet at once, used by the packet
+ *        traversal of BVH_PBRT.
+ *
+ * The kernels use AVX2 or SSE2, whichever is the best the CPU supports, and plain C++ on
+ * other CPUs.  The plain C++ kernels are built everywhere so that the kernels can be tested
+ * against one another.  They are conservative: a ray can be reported as a hit in a corner case
+ * where the scalar test would miss it (so the scalar test must confirm any hit that matters),
+ * but never the other way round.
+ */
+
+#ifndef _BVH_PACKET_SIMD_H_
+#define _BVH_PACKET_SIMD_H_
+
+#include "../raypacket.h"
+#include "../hitinfo.h"
+#include "../shapes3D/bbox_3d.h"
+
+
+/// Number of rays tested at once by the kernels
+#define RAYPACKET_SIMD_WIDTH 8
+
+
+/**
+ * The rays of a packet in a structure of arrays layout, along with the distance of their
+ * closest hit so far.
+ */
+struct RAYPACKET_SOA
+{
+    void Init( const RAYPACKET& aRayPacket, const HITINFO_PACKET* aHitInfoPacket );
+
+    alignas( 32 ) float m_origin[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_dir[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDir[3][RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_tHit[RAYPACKET_RAYS_PER_PACKET];
+};
+
+
+/**
+ * The precalculated data of a triangle needed to intersect it, see TRIANGLE::GetPacketData().
+ */
+struct TRIANGLE_PACKET_DATA
+{
+    unsigned int m_k;           ///< index of the dominant axis of the normal
+    unsigned int m_ku;
+    unsigned int m_kv;
+    float        m_nu, m_nv, m_nd;
+    float        m_au, m_av;    ///< first vertex projected on the ku, kv plane
+    float        m_bnu, m_bnv;
+    float        m_cnu, m_cnv;
+};
+
+
+/// The implementations of the kernels
+enum class RAYPACKET_KERNEL
+{
+    SCALAR,
+    SSE2,   ///< x86 only
+    AVX2    ///< x86 only, when the CPU supports it
+};
+
+
+/**
+ * @return true if \a aKernel is built in and supported by the CPU.
+ */
+bool IsRayPacketKernelSupported( RAYPACKET_KERNEL aKernel );
+
+
+/**
+ * Test rays \a aFirst to \a aFirst + #RAYPACKET_SIMD_WIDTH - 1 against a bounding box.
+ *
+ * @param aFirst must be a multiple of #RAYPACKET_SIMD_WIDTH.
+ * @return a mask with bit i set if ray \a aFirst + i enters \a aBBox closer than its
+ *         current hit.
+ */
+unsigned int IntersectBBoxPacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                   const BBOX_3D& aBBox );
+
+/**
+ * Test rays \a aFirst to \a aFirst + #RAYPACKET_SIMD_WIDTH - 1 against a triangle.
+ *
+ * @param aFirst must be a multiple of #RAYPACKET_SIMD_WIDTH.
+ * @return a mask with bit i set if ray \a aFirst + i may hit the triangle closer than its
+ *         current hit.
+ */
+unsigned int IntersectTrianglePacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                       const TRIANGLE_PACKET_DATA& aTriangle );
+
+/**
+ * Same as the functions above, with \a aKernel rather than the best kernel the CPU supports.
+ * An unsupported kernel falls back to the plain C++ one.
+ */
+unsigned int IntersectBBoxPacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                   const BBOX_3D& aBBox, RAYPACKET_KERNEL aKernel );
+
+unsigned int IntersectTrianglePacket8( const RAYPACKET_SOA& aRays, unsigned int aFirst,
+                                       const TRIANGLE_PACKET_DATA& aTriangle,
+                                       RAYPACKET_KERNEL aKernel );
+
+#endif // _BVH_PACKET_SIMD_H_
@@ -28,6 +28,10 @@
  */
 
 #include "bvh_pbrt.h"
+#include "bvh_packet_simd.h"
+#include "../shapes3D/triangle_3d.h"
+
+#include <algorithm>
 
 
 #define BVH_RANGED_TRAVERSAL
@@ -44,44 +48,72 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET& aRayPacket, const BBOX_3D& aBBox,
-                                        unsigned int ia, HITINFO_PACKET* aHitInfoPacket )
+#ifdef BVH_RANGED_TRAVERSAL
+
+/**
+ * @return the mask of the rays from \a aFirst that hit \a aBBox in the group of
+ *         #RAYPACKET_SIMD_WIDTH rays holding ray \a aFirst.
+ */
+static inline unsigned int getGroupHits( const RAYPACKET_SOA& aRays, const BBOX_3D& aBBox,
+                                         unsigned int aFirst )
 {
-    float hitT;
+    const unsigned int group = aFirst & ~( RAYPACKET_SIMD_WIDTH - 1 );
 
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT )
-      && ( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit ) )
-        return ia;
+    return IntersectBBoxPacket8( aRays, group, aBBox ) & ( ~0u << ( aFirst - group ) );
+}
 
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
+
+static inline unsigned int getFirstHit( const RAYPACKET_SOA& aRays, const FRUSTUM& aFrustum,
+                                        const BBOX_3D& aBBox, unsigned int ia )
+{
+    unsigned int hits = getGroupHits( aRays, aBBox, ia );
+
+    if( !hits && !aFrustum.Intersect( aBBox ) )
         return RAYPACKET_RAYS_PER_PACKET;
 
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    for( unsigned int group = ia & ~( RAYPACKET_SIMD_WIDTH - 1 );; )
     {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT )
-          && ( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit ) )
-            return i;
-    }
+        for( unsigned int lane = 0; hits; ++lane, hits >>= 1 )
+        {
+            if( hits & 1 )
+                return group + lane;
+        }
 
-    return RAYPACKET_RAYS_PER_PACKET;
-}
+        group += RAYPACKET_SIMD_WIDTH;
 
+        if( group >= RAYPACKET_RAYS_PER_PACKET )
+            return RAYPACKET_RAYS_PER_PACKET;
 
-#ifdef BVH_RANGED_TRAVERSAL
+        hits = IntersectBBoxPacket8( aRays, group, aBBox );
+    }
+}
 
-static inline unsigned int getLastHit( const RAYPACKET& aRayPacket, const BBOX_3D& aBBox,
-                                       unsigned int ia, HITINFO_PACKET* aHitInfoPacket )
+
+static inline unsigned int getLastHit( const RAYPACKET_SOA& aRays, const BBOX_3D& aBBox,
+                                       unsigned int ia )
 {
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
+    const unsigned int first = ia & ~( RAYPACKET_SIMD_WIDTH - 1 );
+
+    for( unsigned int group = RAYPACKET_RAYS_PER_PACKET - RAYPACKET_SIMD_WIDTH; group > first;
+         group -= RAYPACKET_SIMD_WIDTH )
     {
-        float hitT;
+        if( unsigned int hits = IntersectBBoxPacket8( aRays, group, aBBox ) )
+        {
+            unsigned int ie = group;
 
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT )
-          && ( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit ) )
-            return ie + 1;
+            for( ; hits; hits >>= 1 )
+                ++ie;
+
+            return ie;
+        }
     }
 
-    return ia + 1;
+    unsigned int ie = first;
+
+    for( unsigned int hits = getGroupHits( aRays, aBBox, ia ); hits; hits >>= 1 )
+        ++ie;
+
+    return std::max( ie, ia + 1 );
 }
 
 
@@ -101,13 +133,31 @@ bool BVH_PBRT::Intersect( const RAYPACKET& aRayPacket, HITINFO_PACKET* aHitInfoP
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    RAYPACKET_SOA rays;
+    rays.Init( aRayPacket, aHitInfoPacket );
+
     unsigned int ia = 0;
 
+    auto intersectRay =
+            [&]( const OBJECT_3D* obj, unsigned int i )
+            {
+                const bool hit = obj->Intersect( aRayPacket.m_ray[i],
+                                                 aHitInfoPacket[i].m_HitInfo );
+
+                if( hit )
+                {
+                    anyHit |= hit;
+                    aHitInfoPacket[i].m_hitresult |= hit;
+                    aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                    rays.m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+                }
+            };
+
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        ia = getFirstHit( rays, aRayPacket.m_Frustum, curCell->bounds, ia );
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -121,28 +171,38 @@ bool BVH_PBRT::Intersect( const RAYPACKET& aRayPacket, HITINFO_PACKET* aHitInfoP
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket, curCell->bounds, ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = getLastHit( rays, curCell->bounds, ia );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
                     const OBJECT_3D* obj = m_primitives[curCell->primitivesOffset + j];
 
-                    if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                    if( !aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                        continue;
+
+                    if( obj->GetObjectType() == OBJECT_3D_TYPE::TRIANGLE )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
+                        // Only the rays that may hit the triangle need the full test
+                        TRIANGLE_PACKET_DATA triangle;
+                        static_cast<const TRIANGLE*>( obj )->GetPacketData( triangle );
+
+                        for( unsigned int group = ia & ~( RAYPACKET_SIMD_WIDTH - 1 ); group < ie;
+                             group += RAYPACKET_SIMD_WIDTH )
                         {
-                            const bool hit = obj->Intersect( aRayPacket.m_ray[i],
-                                                             aHitInfoPacket[i].m_HitInfo );
+                            unsigned int hits = IntersectTrianglePacket8( rays, group, triangle );
 
-                            if( hit )
+                            for( unsigned int i = group; hits; ++i, hits >>= 1 )
                             {
-                                anyHit |= hit;
-                                aHitInfoPacket[i].m_hitresult |= hit;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                                if( ( hits & 1 ) && i >= ia && i < ie )
+                                    intersectRay( obj, i );
                             }
                         }
                     }
+                    else
+                    {
+                        for( unsigned int i = ia; i < ie; ++i )
+                            intersectRay( obj, i );
+                    }
                 }
             }
         }
@@ -45,6 +45,9 @@
 #include <base_units.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
 
+#include <map>
+#include <set>
+
 /**
  * Perform an interpolation step to easy control the transparency based on the
  * gray color value and transparency.
@@ -363,6 +366,12 @@ void RENDER_3D_RAYTRACE::Reload( REPORTER* aStatusReporter, REPORTER* aWarningRe
 {
     m_reloadRequested = false;
 
+    // The blocks being traced use the scene about to be deleted
+    CancelRender();
+
+    // The image rendered so far is for the previous scene
+    m_renderState = RT_RENDER_STATE_MAX;
+
     m_modelMaterialMap.clear();
 
     OBJECT_2D_STATS::Instance().ResetStats();
@@ -1209,6 +1218,61 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
         return;
     }
 
+    S3D_CACHE*                                 cacheMgr = m_boardAdapter.Get3dCacheManager();
+    std::map<wxString, wxString>               footprintBasePaths;
+    std::vector<std::pair<wxString, wxString>> models;
+    std::set<std::pair<wxString, wxString>>    modelSet;
+
+    // Find the models and the paths to search them in first, to load them in parallel
+    for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
+    {
+        if( fp->Models().empty()
+          || !m_boardAdapter.IsFootprintShown( (FOOTPRINT_ATTR_T) fp->GetAttributes() ) )
+        {
+            continue;
+        }
+
+        wxString libraryName = fp->GetFPID().GetLibNickname();
+        auto     it = footprintBasePaths.find( libraryName );
+
+        if( it == footprintBasePaths.end() )
+        {
+            wxString footprintBasePath = wxEmptyString;
+
+            if( m_boardAdapter.GetBoard()->GetProject() )
+            {
+                try
+                {
+                    // FindRow() can throw an exception
+                    const FP_LIB_TABLE_ROW* fpRow =
+                            m_boardAdapter.GetBoard()->GetProject()->PcbFootprintLibs()->FindRow(
+                                    libraryName, false );
+
+                    if( fpRow )
+                        footprintBasePath = fpRow->GetFullURI( true );
+                }
+                catch( ... )
+                {
+                    // Do nothing if the libraryName is not found in lib table
+                }
+            }
+
+            it = footprintBasePaths.emplace( libraryName, footprintBasePath ).first;
+        }
+
+        for( const FP_3DMODEL& model : fp->Models() )
+        {
+            if( ( static_cast<float>( model.m_Opacity ) > FLT_EPSILON )
+              && ( model.m_Show && !model.m_Filename.empty() )
+              && modelSet.emplace( model.m_Filename, it->second ).second )
+            {
+                models.emplace_back( model.m_Filename, it->second );
+            }
+        }
+    }
+
+    cacheMgr->PreloadModels( models );
+
     // Go for all footprints
     for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
     {
@@ -1249,30 +1313,10 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
             BOARD_ITEM* boardItem = dynamic_cast<BOARD_ITEM*>( fp );
 
             // Get the list of model files for this model
-            S3D_CACHE* cacheMgr = m_boardAdapter.Get3dCacheManager();
-            auto       sM       = fp->Models().begin();
-            auto       eM       = fp->Models().end();
-
-            wxString                libraryName = fp->GetFPID().GetLibNickname();
-
-            wxString                footprintBasePath = wxEmptyString;
-            if( m_boardAdapter.GetBoard()->GetProject() )
-            {
-                try
-                {
-                    // FindRow() can throw an exception
-                    const FP_LIB_TABLE_ROW* fpRow =
-                            m_boardAdapter.GetBoard()->GetProject()->PcbFootprintLibs()->FindRow(
-                                    libraryName, false );
-
-                    if( fpRow )
-                        footprintBasePath = fpRow->GetFullURI( true );
-                }
-                catch( ... )
-                {
-                    // Do nothing if the libraryName is not found in lib table
-                }
-            }
+            auto            sM = fp->Models().begin();
+            auto            eM = fp->Models().end();
+            const wxString& footprintBasePath =
+                    footprintBasePaths[ fp->GetFPID().GetLibNickname() ];
 
             while( sM != eM )
             {
@@ -26,9 +26,9 @@
 
 #include <algorithm>
 #include <atomic>
-#include <chrono>
 #include <climits>
-#include <thread>
+#include <cstring>
+#include <tuple>
 
 #include "render_3d_raytrace.h"
 #include "mortoncodes.h"
@@ -36,7 +36,12 @@
 #include "3d_fastmath.h"
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
+#include <board.h>
+#include <pgm_base.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <settings/color_settings.h>
+#include <settings/settings_manager.h>
+#include <thread_pool.h>
 #include <wx/log.h>
 
 
@@ -67,6 +72,9 @@ RENDER_3D_RAYTRACE::RENDER_3D_RAYTRACE( EDA_3D_CANVAS* aCanvas, BOARD_ADAPTER& a
     m_renderState = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_renderStartTime = 0;
     m_blockRenderProgressCount = 0;
+    m_blocksPostProcessed = false;
+    m_nextBlock = 0;
+    m_cancelRender = false;
 }
 
 
@@ -74,6 +82,8 @@ RENDER_3D_RAYTRACE::~RENDER_3D_RAYTRACE()
 {
     wxLogTrace( m_logTrace, wxT( "RENDER_3D_RAYTRACE::~RENDER_3D_RAYTRACE" ) );
 
+    CancelRender();
+
     delete m_accelerator;
     m_accelerator = nullptr;
 
@@ -113,6 +123,8 @@ void RENDER_3D_RAYTRACE::SetCurWindowSize( const wxSize& aSize )
 {
     if( m_windowSize != aSize )
     {
+        CancelRender();
+
         m_windowSize = aSize;
         glViewport( 0, 0, m_windowSize.x, m_windowSize.y );
 
@@ -127,13 +139,100 @@ void RENDER_3D_RAYTRACE::restartRenderState()
 
     m_renderState = RT_RENDER_STATE_TRACING;
     m_blockRenderProgressCount = 0;
+    m_blocksPostProcessed = m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing;
+    m_isPreview = false;
+
+    getTracedScene( m_tracedScene );
+
+    // Nothing is being traced here, so the camera and the settings can be copied safely
+    m_tracingCamera = std::make_unique<TRACING_CAMERA>( m_camera );
+    m_renderSettings = m_boardAdapter.m_Cfg->m_Render;
 
     m_postShaderSsao.InitFrame();
+}
+
+
+void RENDER_3D_RAYTRACE::CancelRender()
+{
+    if( m_blockTasks.empty() )
+        return;
+
+    m_cancelRender = true;
+
+    for( std::future<void>& task : m_blockTasks )
+        task.wait();
 
-    m_blockPositionsWasProcessed.resize( m_blockPositions.size() );
+    m_blockTasks.clear();
+    m_renderedBlocks.clear();
 
-    // Mark the blocks not processed yet
-    std::fill( m_blockPositionsWasProcessed.begin(), m_blockPositionsWasProcessed.end(), 0 );
+    // The image is only partly rendered
+    m_renderState = RT_RENDER_STATE_MAX;
+}
+
+
+/**
+ * The render settings the traced image depends on: all of them but the post processing, which
+ * is applied to the traced image, and the ones not used by the raytracer.
+ */
+static auto tracedSettings( const EDA_3D_VIEWER_SETTINGS::RENDER_SETTINGS& aCfg )
+{
+    return std::tie( aCfg.material_mode, aCfg.opengl_copper_thickness,
+                     aCfg.raytrace_anti_aliasing, aCfg.raytrace_backfloor,
+                     aCfg.raytrace_procedural_textures, aCfg.raytrace_reflections,
+                     aCfg.raytrace_refractions, aCfg.raytrace_shadows,
+                     aCfg.raytrace_nrsamples_shadows, aCfg.raytrace_nrsamples_reflections,
+                     aCfg.raytrace_nrsamples_refractions, aCfg.raytrace_recursivelevel_reflections,
+                     aCfg.raytrace_recursivelevel_refractions, aCfg.raytrace_spread_shadows,
+                     aCfg.raytrace_spread_reflections, aCfg.raytrace_spread_refractions,
+                     aCfg.raytrace_lightColorCamera, aCfg.raytrace_lightColorTop,
+                     aCfg.raytrace_lightColorBottom, aCfg.raytrace_lightColor,
+                     aCfg.raytrace_lightElevation, aCfg.raytrace_lightAzimuth,
+                     aCfg.realistic, aCfg.show_adhesive, aCfg.show_board_body,
+                     aCfg.show_comments, aCfg.show_eco, aCfg.show_footprints_insert,
+                     aCfg.show_footprints_normal, aCfg.show_footprints_virtual,
+                     aCfg.show_footprints_not_in_posfile, aCfg.show_silkscreen,
+                     aCfg.show_soldermask, aCfg.show_solderpaste, aCfg.show_zones,
+                     aCfg.subtract_mask_from_silk, aCfg.clip_silk_on_via_annulus,
+                     aCfg.renderPlatedPadsAsPlated );
+}
+
+
+void RENDER_3D_RAYTRACE::getTracedScene( TRACED_SCENE& aScene ) const
+{
+    COLOR_SETTINGS* colors = Pgm().GetSettingsManager().GetColorSettings();
+
+    aScene.m_settings = m_boardAdapter.m_Cfg->m_Render;
+    aScene.m_colors.clear();
+
+    // The board layer colors and the 3D viewer colors
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        aScene.m_colors.push_back( colors->GetColor( layer ) );
+
+    for( int layer = LAYER_3D_START; layer <= LAYER_3D_END; ++layer )
+        aScene.m_colors.push_back( colors->GetColor( layer ) );
+
+    aScene.m_useStackupColors = colors->GetUseBoardStackupColors();
+    aScene.m_board = m_boardAdapter.GetBoard();
+    aScene.m_boardTimeStamp = aScene.m_board ? aScene.m_board->GetTimeStamp() : 0;
+}
+
+
+bool RENDER_3D_RAYTRACE::onlyPostProcessingChanged() const
+{
+    // Nothing traced yet, or the scene was reloaded since
+    if( m_renderState >= RT_RENDER_STATE_MAX )
+        return false;
+
+    TRACED_SCENE scene;
+    getTracedScene( scene );
+
+    return scene.m_settings.raytrace_post_processing
+                   != m_tracedScene.m_settings.raytrace_post_processing
+           && tracedSettings( scene.m_settings ) == tracedSettings( m_tracedScene.m_settings )
+           && scene.m_colors == m_tracedScene.m_colors
+           && scene.m_useStackupColors == m_tracedScene.m_useStackupColors
+           && scene.m_board == m_tracedScene.m_board
+           && scene.m_boardTimeStamp == m_tracedScene.m_boardTimeStamp;
 }
 
 
@@ -168,15 +267,36 @@ bool RENDER_3D_RAYTRACE::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
 
+    const bool was_camera_changed = m_camera.ParametersChanged();
+
+    // The image being rendered is out of date: stop rendering it right away rather than
+    // after the blocks being rendered
+    if( aIsMoving || was_camera_changed || m_windowSize != m_oldWindowsSize )
+        CancelRender();
+
     // Reload board if it was requested
     if( m_reloadRequested )
     {
-        if( aStatusReporter )
-            aStatusReporter->Report( _( "Loading..." ) );
+        if( onlyPostProcessingChanged() )
+        {
+            // The traced blocks do not depend on the post processing: keep them and only
+            // (re)do the post processing once they are all traced
+            m_reloadRequested = false;
+            m_tracedScene.m_settings.raytrace_post_processing =
+                    m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing;
+
+            if( m_renderState == RT_RENDER_STATE_FINISH )
+                m_renderState = RT_RENDER_STATE_POST_PROCESS_SHADE;
+        }
+        else
+        {
+            if( aStatusReporter )
+                aStatusReporter->Report( _( "Loading..." ) );
 
-        //aIsMoving = true;
-        requestRedraw = true;
-        Reload( aStatusReporter, aWarningReporter, false );
+            //aIsMoving = true;
+            requestRedraw = true;
+            Reload( aStatusReporter, aWarningReporter, false );
+        }
     }
 
 
@@ -208,11 +328,13 @@ bool RENDER_3D_RAYTRACE::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
     glDisable( GL_BLEND );
     glDisable( GL_MULTISAMPLE );
 
-    const bool was_camera_changed = m_camera.ParametersChanged();
-
     if( requestRedraw || aIsMoving || was_camera_changed )
+    {
+        CancelRender();
+
         m_renderState = RT_RENDER_STATE_MAX; // Set to an invalid state,
                                              // so it will restart again latter
+    }
 
     // This will only render if need, otherwise it will redraw the PBO on the screen again
     if( aIsMoving || was_camera_changed )
@@ -318,6 +440,10 @@ void RENDER_3D_RAYTRACE::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
         renderTracing( ptrPBO, aStatusReporter );
         break;
 
+    case RT_RENDER_STATE_ANTI_ALIASING:
+        renderAntiAliasing( ptrPBO, aStatusReporter );
+        break;
+
     case RT_RENDER_STATE_POST_PROCESS_SHADE:
         postProcessShading( ptrPBO, aStatusReporter );
         break;
@@ -342,68 +468,120 @@ void RENDER_3D_RAYTRACE::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 }
 
 
-void RENDER_3D_RAYTRACE::renderTracing( GLubyte* ptrPBO, REPORTER* aStatusReporter )
+bool RENDER_3D_RAYTRACE::renderBlocks( GLubyte* ptrPBO,
+                                       void ( RENDER_3D_RAYTRACE::*aRenderBlock )( GLubyte*,
+                                                                                   signed int ) )
 {
-    m_isPreview = false;
+    if( m_blockTasks.empty() && m_blockRenderProgressCount < m_blockPositions.size() )
+    {
+        thread_pool& tp = GetKiCadThreadPool();
+        size_t       taskCount = std::min<size_t>( tp.get_thread_count(),
+                                                   m_blockPositions.size() );
 
-    auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
+        m_nextBlock = 0;
+        m_cancelRender = false;
 
-    std::atomic<size_t> numBlocksRendered( 0 );
-    std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+        for( size_t ii = 0; ii < taskCount; ++ii )
+        {
+            m_blockTasks.emplace_back( tp.submit(
+                    [this, aRenderBlock]()
+                    {
+                        // Each task takes the next block in m_blockPositions, so that the
+                        // blocks are rendered from the center out whatever the number of threads
+                        for( size_t iBlock = m_nextBlock.fetch_add( 1 );
+                             iBlock < m_blockPositions.size() && !m_cancelRender;
+                             iBlock = m_nextBlock.fetch_add( 1 ) )
+                        {
+                            ( this->*aRenderBlock )( m_blockPixels.data(), iBlock );
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
+                            std::lock_guard<std::mutex> lock( m_renderedBlocksLock );
+                            m_renderedBlocks.push_back( iBlock );
+                        }
+                    } ) );
+        }
+    }
+
+    std::vector<size_t> renderedBlocks;
 
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                 iBlock < m_blockPositions.size() && !breakLoop;
-                 iBlock = currentBlock.fetch_add( 1 ) )
-            {
-                if( !m_blockPositionsWasProcessed[iBlock] )
-                {
-                    renderBlockTracing( ptrPBO, iBlock );
-                    numBlocksRendered++;
-                    m_blockPositionsWasProcessed[iBlock] = 1;
-
-                    // Check if it spend already some time render and request to exit
-                    // to display the progress
-                    if( std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
-                }
-            }
+        std::lock_guard<std::mutex> lock( m_renderedBlocksLock );
+        renderedBlocks.swap( m_renderedBlocks );
+    }
+
+    const size_t rowSize = m_realBufferSize.x * 4;
 
-            threadsFinished++;
-        } );
+    for( size_t iBlock : renderedBlocks )
+    {
+        const SFVEC2UI& blockPos = m_blockPositions[iBlock];
+        size_t          offset = blockPos.x * 4 + blockPos.y * rowSize;
 
-        t.detach();
+        for( unsigned int y = 0; y < RAYPACKET_DIM; ++y, offset += rowSize )
+            memcpy( ptrPBO + offset, m_blockPixels.data() + offset, RAYPACKET_DIM * 4 );
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    m_blockRenderProgressCount += renderedBlocks.size();
+
+    if( m_blockRenderProgressCount < m_blockPositions.size() )
+        return false;
+
+    // Every block is rendered, so the tasks are finished or about to be
+    for( std::future<void>& task : m_blockTasks )
+        task.get();
+
+    m_blockTasks.clear();
+
+    return true;
+}
+
 
-    m_blockRenderProgressCount += numBlocksRendered;
+void RENDER_3D_RAYTRACE::renderTracing( GLubyte* ptrPBO, REPORTER* aStatusReporter )
+{
+    const bool finished = renderBlocks( ptrPBO, &RENDER_3D_RAYTRACE::renderBlockTracing );
 
     if( aStatusReporter )
         aStatusReporter->Report( wxString::Format( _( "Rendering: %.0f %%" ),
                                                    (float) ( m_blockRenderProgressCount * 100 )
                                                    / (float) m_blockPositions.size() ) );
 
-    // Check if it finish the rendering and if should continue to a post processing
-    // or mark it as finished
-    if( m_blockRenderProgressCount >= m_blockPositions.size() )
+    if( !finished )
+        return;
+
+    // The whole image is displayed with one sample per pixel, now refine it
+    if( m_boardAdapter.m_Cfg->m_Render.raytrace_anti_aliasing )
     {
-        if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing )
-            m_renderState = RT_RENDER_STATE_POST_PROCESS_SHADE;
-        else
-            m_renderState = RT_RENDER_STATE_FINISH;
+        m_renderState = RT_RENDER_STATE_ANTI_ALIASING;
+        m_blockRenderProgressCount = 0;
     }
+    else
+    {
+        endTracing();
+    }
+}
+
+
+void RENDER_3D_RAYTRACE::renderAntiAliasing( GLubyte* ptrPBO, REPORTER* aStatusReporter )
+{
+    const bool finished = renderBlocks( ptrPBO, &RENDER_3D_RAYTRACE::renderBlockAntiAliasing );
+
+    if( aStatusReporter )
+        aStatusReporter->Report( wxString::Format( _( "Rendering: anti-aliasing %.0f %%" ),
+                                                   (float) ( m_blockRenderProgressCount * 100 )
+                                                   / (float) m_blockPositions.size() ) );
+
+    if( finished )
+        endTracing();
+}
+
+
+void RENDER_3D_RAYTRACE::endTracing()
+{
+    // Check if it should continue to a post processing or mark it as finished.  The blocks
+    // rendered for post processing do not have their final color yet, so they need the post
+    // processing stage too if it was disabled meanwhile.
+    if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing || m_blocksPostProcessed )
+        m_renderState = RT_RENDER_STATE_POST_PROCESS_SHADE;
+    else
+        m_renderState = RT_RENDER_STATE_FINISH;
 }
 
 
@@ -504,7 +682,7 @@ void RENDER_3D_RAYTRACE::renderAntiAliasPackets( const SFVEC3F* aBgColorY,
                                                  const HITINFO_PACKET* aHitPck_AA_X1Y1,
                                                  const RAY* aRayPck, SFVEC3F* aOutHitColor )
 {
-    const bool is_testShadow =  m_boardAdapter.m_Cfg->m_Render.raytrace_shadows;
+    const bool is_testShadow =  m_renderSettings.raytrace_shadows;
 
     for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
     {
@@ -623,13 +801,28 @@ void RENDER_3D_RAYTRACE::renderAntiAliasPackets( const SFVEC3F* aBgColorY,
 #define DISP_FACTOR 0.075f
 
 
+void RENDER_3D_RAYTRACE::blockBackgroundColors( const SFVEC2I& aBlockPos,
+                                                SFVEC3F* aBgColorY ) const
+{
+    // Calculate background gradient color
+    for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
+    {
+        const float posYfactor = (float) ( aBlockPos.y + y ) / (float) m_windowSize.y;
+
+        aBgColorY[y] = m_backgroundColorTop * SFVEC3F(posYfactor) +
+                       m_backgroundColorBottom * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
+    }
+}
+
+
 void RENDER_3D_RAYTRACE::renderBlockTracing( GLubyte* ptrPBO, signed int iBlock )
 {
     // Initialize ray packets
     const SFVEC2UI& blockPos = m_blockPositions[iBlock];
     const SFVEC2I blockPosI = SFVEC2I( blockPos.x + m_xoffset, blockPos.y + m_yoffset );
 
-    RAYPACKET blockPacket( m_camera, (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, DISP_FACTOR ),
+    RAYPACKET blockPacket( *m_tracingCamera,
+                           (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, DISP_FACTOR ),
                            SFVEC2F( DISP_FACTOR, DISP_FACTOR ) /* Displacement random factor */ );
 
 
@@ -637,43 +830,36 @@ void RENDER_3D_RAYTRACE::renderBlockTracing( GLubyte* ptrPBO, signed int iBlock
 
     HITINFO_PACKET_init( hitPacket_X0Y0 );
 
-    // Calculate background gradient color
     SFVEC3F bgColor[RAYPACKET_DIM];// Store a vertical gradient color
 
-    for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
-    {
-        const float posYfactor = (float) ( blockPosI.y + y ) / (float) m_windowSize.y;
+    blockBackgroundColors( blockPosI, bgColor );
 
-        bgColor[y] = m_backgroundColorTop * SFVEC3F(posYfactor) +
-                     m_backgroundColorBottom * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
-    }
+    // This will set the output color to be displayed
+    // If post processing is enabled, it will not reflect the final result (as the final
+    // color will be computed on post processing) but it is used for report progress
+    const bool isFinalColor = !m_blocksPostProcessed;
+
+    // The pixel data is always kept, so that the post processing can be enabled or disabled
+    // later without tracing the image again, and for the anti-aliasing pass.
 
     // Intersect ray packets (calculate the intersection with rays and objects)
     if( !m_accelerator->Intersect( blockPacket, hitPacket_X0Y0 ) )
     {
         // If block is empty then set shades and continue
-        if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing )
+        for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
         {
-            for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
-            {
-                const SFVEC3F& outColor = bgColor[y];
+            const SFVEC3F& outColor = bgColor[y];
 
-                const unsigned int yBlockPos = blockPos.y + y;
+            const unsigned int yBlockPos = blockPos.y + y;
 
-                for( unsigned int x = 0; x < RAYPACKET_DIM; ++x )
-                {
-                        m_postShaderSsao.SetPixelData( blockPos.x + x, yBlockPos,
-                                                       SFVEC3F( 0.0f ), outColor,
-                                                       SFVEC3F( 0.0f ), 0, 1.0f );
-                }
+            for( unsigned int x = 0; x < RAYPACKET_DIM; ++x )
+            {
+                    m_postShaderSsao.SetPixelData( blockPos.x + x, yBlockPos,
+                                                   SFVEC3F( 0.0f ), outColor,
+                                                   SFVEC3F( 0.0f ), 0, 1.0f );
             }
         }
 
-        // This will set the output color to be displayed
-        // If post processing is enabled, it will not reflect the final result (as the final
-        // color will be computed on post processing) but it is used for report progress
-        const bool isFinalColor = !m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing;
-
         for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
         {
             const SFVEC3F& outColor = bgColor[y];
@@ -697,144 +883,184 @@ void RENDER_3D_RAYTRACE::renderBlockTracing( GLubyte* ptrPBO, signed int iBlock
 
     // Shade original (0, 0) hits ("paint" the intersected objects)
     renderRayPackets( bgColor, blockPacket.m_ray, hitPacket_X0Y0,
-                      m_boardAdapter.m_Cfg->m_Render.raytrace_shadows, hitColor_X0Y0 );
+                      m_renderSettings.raytrace_shadows, hitColor_X0Y0 );
 
-    if( m_boardAdapter.m_Cfg->m_Render.raytrace_anti_aliasing )
-    {
-        SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
+    // Copy results to the next stage
+    GLubyte* ptr = &ptrPBO[( blockPos.x + ( blockPos.y * m_realBufferSize.x ) ) * 4];
 
-        // Intersect one blockPosI + (0.5, 0.5) used for anti aliasing calculation
-        HITINFO_PACKET hitPacket_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
-        HITINFO_PACKET_init( hitPacket_AA_X1Y1 );
+    const uint32_t ptrInc = ( m_realBufferSize.x - RAYPACKET_DIM ) * 4;
 
-        RAYPACKET blockPacket_AA_X1Y1( m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.5f, 0.5f ),
-                                       SFVEC2F( DISP_FACTOR, DISP_FACTOR ) );
+    SFVEC2I bPos;
+    bPos.y = blockPos.y;
 
-        if( !m_accelerator->Intersect( blockPacket_AA_X1Y1, hitPacket_AA_X1Y1 ) )
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        bPos.x = blockPos.x;
+
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
-            // Missed all the package
-            for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
-            {
-                const SFVEC3F& outColor = bgColor[y];
+            const SFVEC3F& hColor = hitColor_X0Y0[i];
 
-                for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
-                    hitColor_AA_X1Y1[i] = outColor;
+            if( hitPacket_X0Y0[i].m_hitresult == true )
+            {
+                m_postShaderSsao.SetPixelData( bPos.x, bPos.y,
+                                               hitPacket_X0Y0[i].m_HitInfo.m_HitNormal,
+                                               hColor,
+                                               blockPacket.m_ray[i].at(
+                                                       hitPacket_X0Y0[i].m_HitInfo.m_tHit ),
+                                               hitPacket_X0Y0[i].m_HitInfo.m_tHit,
+                                               hitPacket_X0Y0[i].m_HitInfo.m_ShadowFactor );
             }
-        }
-        else
-        {
-            renderRayPackets( bgColor, blockPacket_AA_X1Y1.m_ray, hitPacket_AA_X1Y1,
-                              m_boardAdapter.m_Cfg->m_Render.raytrace_shadows, hitColor_AA_X1Y1 );
+            else
+            {
+                m_postShaderSsao.SetPixelData( bPos.x, bPos.y, SFVEC3F( 0.0f ), hColor,
+                                               SFVEC3F( 0.0f ), 0, 1.0f );
+            }
+
+            renderFinalColor( ptr, hColor, isFinalColor );
+
+            bPos.x++;
+            ptr += 4;
         }
 
-        SFVEC3F hitColor_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
-        SFVEC3F hitColor_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
-        SFVEC3F hitColor_AA_X0Y1_half[RAYPACKET_RAYS_PER_PACKET];
+        ptr += ptrInc;
+        bPos.y++;
+    }
+}
 
-        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-        {
-            SFVEC3F color_average = ( hitColor_X0Y0[i] + hitColor_AA_X1Y1[i] ) * SFVEC3F( 0.5f );
 
-            hitColor_AA_X1Y0[i] = color_average;
-            hitColor_AA_X0Y1[i] = color_average;
-            hitColor_AA_X0Y1_half[i] = color_average;
-        }
+void RENDER_3D_RAYTRACE::renderBlockAntiAliasing( GLubyte* ptrPBO, signed int iBlock )
+{
+    const SFVEC2UI& blockPos = m_blockPositions[iBlock];
+    const SFVEC2I blockPosI = SFVEC2I( blockPos.x + m_xoffset, blockPos.y + m_yoffset );
 
-        RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
+    RAYPACKET blockPacket( *m_tracingCamera,
+                           (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, DISP_FACTOR ),
+                           SFVEC2F( DISP_FACTOR, DISP_FACTOR ) /* Displacement random factor */ );
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.5f - DISP_FACTOR, DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y0 );
+    HITINFO_PACKET hitPacket_X0Y0[RAYPACKET_RAYS_PER_PACKET];
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, 0.5f - DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X0Y1 );
+    HITINFO_PACKET_init( hitPacket_X0Y0 );
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y1_half );
+    // The first pass hits are only intersected again (not shaded) for the node hints used by
+    // the anti-aliasing rays.  Blocks of background only do not need more samples.
+    if( !m_accelerator->Intersect( blockPacket, hitPacket_X0Y0 ) )
+        return;
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X1Y0,
-                                hitColor_AA_X1Y0 );
+    SFVEC3F bgColor[RAYPACKET_DIM];// Store a vertical gradient color
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X0Y1,
-                                hitColor_AA_X0Y1 );
+    blockBackgroundColors( blockPosI, bgColor );
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                                blockRayPck_AA_X1Y1_half, hitColor_AA_X0Y1_half );
+    // The (0, 0) sample is the color shaded by the first pass
+    SFVEC3F hitColor_X0Y0[RAYPACKET_RAYS_PER_PACKET];
 
-        // Average the result
-        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
-            hitColor_X0Y0[i] = ( hitColor_X0Y0[i] + hitColor_AA_X1Y1[i] + hitColor_AA_X1Y0[i] +
-                                 hitColor_AA_X0Y1[i] + hitColor_AA_X0Y1_half[i] ) *
-                    SFVEC3F( 1.0f / 5.0f );
+            hitColor_X0Y0[i] = m_postShaderSsao.GetColorAtNotProtected(
+                    SFVEC2I( blockPos.x + x, blockPos.y + y ) );
         }
     }
 
-    // Copy results to the next stage
-    GLubyte* ptr = &ptrPBO[( blockPos.x + ( blockPos.y * m_realBufferSize.x ) ) * 4];
+    SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
-    const uint32_t ptrInc = ( m_realBufferSize.x - RAYPACKET_DIM ) * 4;
+    // Intersect one blockPosI + (0.5, 0.5) used for anti aliasing calculation
+    HITINFO_PACKET hitPacket_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
+    HITINFO_PACKET_init( hitPacket_AA_X1Y1 );
 
-    if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing )
-    {
-        SFVEC2I bPos;
-        bPos.y = blockPos.y;
+    RAYPACKET blockPacket_AA_X1Y1( *m_tracingCamera,
+                                   (SFVEC2F) blockPosI + SFVEC2F( 0.5f, 0.5f ),
+                                   SFVEC2F( DISP_FACTOR, DISP_FACTOR ) );
 
+    if( !m_accelerator->Intersect( blockPacket_AA_X1Y1, hitPacket_AA_X1Y1 ) )
+    {
+        // Missed all the package
         for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
         {
-            bPos.x = blockPos.x;
+            const SFVEC3F& outColor = bgColor[y];
 
             for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
-            {
-                const SFVEC3F& hColor = hitColor_X0Y0[i];
+                hitColor_AA_X1Y1[i] = outColor;
+        }
+    }
+    else
+    {
+        renderRayPackets( bgColor, blockPacket_AA_X1Y1.m_ray, hitPacket_AA_X1Y1,
+                          m_renderSettings.raytrace_shadows, hitColor_AA_X1Y1 );
+    }
 
-                if( hitPacket_X0Y0[i].m_hitresult == true )
-                {
-                    m_postShaderSsao.SetPixelData( bPos.x, bPos.y,
-                                                   hitPacket_X0Y0[i].m_HitInfo.m_HitNormal,
-                                                   hColor,
-                                                   blockPacket.m_ray[i].at(
-                                                           hitPacket_X0Y0[i].m_HitInfo.m_tHit ),
-                                                   hitPacket_X0Y0[i].m_HitInfo.m_tHit,
-                                                   hitPacket_X0Y0[i].m_HitInfo.m_ShadowFactor );
-                }
-                else
-                {
-                    m_postShaderSsao.SetPixelData( bPos.x, bPos.y, SFVEC3F( 0.0f ), hColor,
-                                                   SFVEC3F( 0.0f ), 0, 1.0f );
-                }
+    SFVEC3F hitColor_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
+    SFVEC3F hitColor_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
+    SFVEC3F hitColor_AA_X0Y1_half[RAYPACKET_RAYS_PER_PACKET];
 
-                renderFinalColor( ptr, hColor, false );
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        SFVEC3F color_average = ( hitColor_X0Y0[i] + hitColor_AA_X1Y1[i] ) * SFVEC3F( 0.5f );
 
-                bPos.x++;
-                ptr += 4;
-            }
+        hitColor_AA_X1Y0[i] = color_average;
+        hitColor_AA_X0Y1[i] = color_average;
+        hitColor_AA_X0Y1_half[i] = color_average;
+    }
 
-            ptr += ptrInc;
-            bPos.y++;
-        }
+    RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
+    RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
+    RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
+
+    RAYPACKET_InitRays_with2DDisplacement(
+            *m_tracingCamera, (SFVEC2F) blockPosI + SFVEC2F( 0.5f - DISP_FACTOR, DISP_FACTOR ),
+            SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y0 );
+
+    RAYPACKET_InitRays_with2DDisplacement(
+            *m_tracingCamera, (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, 0.5f - DISP_FACTOR ),
+            SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X0Y1 );
+
+    RAYPACKET_InitRays_with2DDisplacement(
+            *m_tracingCamera,
+            (SFVEC2F) blockPosI + SFVEC2F( 0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR ),
+            SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y1_half );
+
+    renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X1Y0,
+                            hitColor_AA_X1Y0 );
+
+    renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X0Y1,
+                            hitColor_AA_X0Y1 );
+
+    renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                            blockRayPck_AA_X1Y1_half, hitColor_AA_X0Y1_half );
+
+    // Average the result
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        hitColor_X0Y0[i] = ( hitColor_X0Y0[i] + hitColor_AA_X1Y1[i] + hitColor_AA_X1Y0[i] +
+                             hitColor_AA_X0Y1[i] + hitColor_AA_X0Y1_half[i] ) *
+                SFVEC3F( 1.0f / 5.0f );
     }
-    else
+
+    // Copy results to the next stage
+    GLubyte* ptr = &ptrPBO[( blockPos.x + ( blockPos.y * m_realBufferSize.x ) ) * 4];
+
+    const uint32_t ptrInc = ( m_realBufferSize.x - RAYPACKET_DIM ) * 4;
+
+    const bool isFinalColor = !m_blocksPostProcessed;
+
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
     {
-        for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
-            for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
-            {
-                renderFinalColor( ptr, hitColor_X0Y0[i], true );
-                ptr += 4;
-            }
+            m_postShaderSsao.SetPixelColor( blockPos.x + x, blockPos.y + y, hitColor_X0Y0[i] );
 
-            ptr += ptrInc;
+            renderFinalColor( ptr, hitColor_X0Y0[i], isFinalColor );
+
+            ptr += 4;
         }
+
+        ptr += ptrInc;
     }
 }
 
 
-void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* /* ptrPBO */, REPORTER* aStatusReporter )
+void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 {
     if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing )
     {
@@ -843,35 +1069,17 @@ void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* /* ptrPBO */, REPORTER* aS
 
         m_postShaderSsao.SetShadowsEnabled( m_boardAdapter.m_Cfg->m_Render.raytrace_shadows );
 
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 ); y < m_realBufferSize.y;
-                     y = nextBlock.fetch_add( 1 ) )
-                {
-                    SFVEC3F* ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
-
-                    for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
-                    {
-                        *ptr = m_postShaderSsao.Shade( SFVEC2I( x, y ) );
-                        ptr++;
-                    }
-                }
-
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
+        ParallelFor( m_realBufferSize.y,
+                     [&]( size_t y )
+                     {
+                         SFVEC3F* ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                         for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                         {
+                             *ptr = m_postShaderSsao.Shade( SFVEC2I( x, y ) );
+                             ptr++;
+                         }
+                     } );
 
         m_postShaderSsao.SetShadedBuffer( m_shaderBuffer );
 
@@ -880,63 +1088,71 @@ void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* /* ptrPBO */, REPORTER* aS
     }
     else
     {
-        // As this was an invalid state, set to finish
+        // The post processing was disabled after the blocks were rendered for it
+        renderFinalColors( ptrPBO );
         m_renderState = RT_RENDER_STATE_FINISH;
     }
 }
 
 
+void RENDER_3D_RAYTRACE::renderFinalColors( GLubyte* ptrPBO )
+{
+    ParallelFor( m_realBufferSize.y,
+                 [&]( size_t y )
+                 {
+                     GLubyte* ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
+
+                     for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                     {
+                         renderFinalColor( ptr,
+                                           m_postShaderSsao.GetColorAtNotProtected(
+                                                   SFVEC2I( x, y ) ),
+                                           true );
+                         ptr += 4;
+                     }
+                 } );
+}
+
+
 void RENDER_3D_RAYTRACE::postProcessBlurFinish( GLubyte* ptrPBO, REPORTER* /* aStatusReporter */ )
 {
     if( m_boardAdapter.m_Cfg->m_Render.raytrace_post_processing )
     {
         // Now blurs the shader result and compute the final color
-        std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        ParallelFor( m_realBufferSize.y,
+                     [&]( size_t y )
+                     {
+                         GLubyte* ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t y = nextBlock.fetch_add( 1 ); y < m_realBufferSize.y;
-                     y = nextBlock.fetch_add( 1 ) )
-                {
-                    GLubyte* ptr = &ptrPBO[ y * m_realBufferSize.x * 4 ];
-
-                    for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
-                    {
-                        const SFVEC3F bluredShadeColor = m_postShaderSsao.Blur( SFVEC2I( x, y ) );
+                         for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
+                         {
+                             const SFVEC3F bluredShadeColor =
+                                     m_postShaderSsao.Blur( SFVEC2I( x, y ) );
 
 #ifdef USE_SRGB_SPACE
-                        const SFVEC3F originColor = convertLinearToSRGB(
-                                m_postShaderSsao.GetColorAtNotProtected( SFVEC2I( x, y ) ) );
+                             const SFVEC3F originColor = convertLinearToSRGB(
+                                     m_postShaderSsao.GetColorAtNotProtected( SFVEC2I( x, y ) ) );
 #else
-                        const SFVEC3F originColor =
-                                m_postShaderSsao.GetColorAtNotProtected( SFVEC2I( x, y ) );
+                             const SFVEC3F originColor =
+                                     m_postShaderSsao.GetColorAtNotProtected( SFVEC2I( x, y ) );
 #endif
-                        const SFVEC3F shadedColor = m_postShaderSsao.ApplyShadeColor(
-                                SFVEC2I( x, y ), originColor, bluredShadeColor );
-
-                        renderFinalColor( ptr, shadedColor, false );
-
-                        ptr += 4;
-                    }
-                }
-
-                threadsFinished++;
-            } );
+                             const SFVEC3F shadedColor = m_postShaderSsao.ApplyShadeColor(
+                                     SFVEC2I( x, y ), originColor, bluredShadeColor );
 
-            t.detach();
-        }
+                             renderFinalColor( ptr, shadedColor, false );
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+                             ptr += 4;
+                         }
+                     } );
 
         // Debug code
         //m_postShaderSsao.DebugBuffersOutputAsImages();
     }
+    else
+    {
+        // The post processing was disabled after the image was shaded
+        renderFinalColors( ptrPBO );
+    }
 
     // End rendering
     m_renderState = RT_RENDER_STATE_FINISH;
@@ -946,20 +1162,10 @@ void RENDER_3D_RAYTRACE::postProcessBlurFinish( GLubyte* ptrPBO, REPORTER* /* aS
 void RENDER_3D_RAYTRACE::renderPreview( GLubyte* ptrPBO )
 {
     m_isPreview = true;
+    m_renderSettings = m_boardAdapter.m_Cfg->m_Render;
 
-    std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
-
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
-
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [&]()
-        {
-            for( size_t iBlock = nextBlock.fetch_add( 1 ); iBlock < m_blockPositionsFast.size();
-                 iBlock = nextBlock.fetch_add( 1 ) )
+    auto render_block =
+            [&]( size_t iBlock )
             {
                 const SFVEC2UI& windowPosUI = m_blockPositionsFast[ iBlock ];
                 const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
@@ -1524,16 +1730,9 @@ void RENDER_3D_RAYTRACE::renderPreview( GLubyte* ptrPBO )
                         SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
                     }
                 }
-            }
+            };
 
-            threadsFinished++;
-        } );
-
-        t.detach();
-    }
-
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    ParallelFor( m_blockPositionsFast.size(), render_block );
 }
 
 
@@ -1558,7 +1757,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
     const SFVEC3F diffuseColorObj = aHitInfo.pHitObject->GetDiffuseColor( aHitInfo );
 
 #if USE_EXPERIMENTAL_SOFT_SHADOWS
-    bool is_aa_enabled = m_boardAdapter.m_Cfg->m_Render.raytrace_anti_aliasing && !m_isPreview;
+    bool is_aa_enabled = m_renderSettings.raytrace_anti_aliasing && !m_isPreview;
 #endif
 
     float shadow_att_factor_sum = 0.0f;
@@ -1605,7 +1804,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
                 else  // Experimental softshadow calculation
                 {
                     const unsigned int shadow_number_of_samples =
-                            m_boardAdapter.m_Cfg->m_Render.raytrace_nrsamples_shadows;
+                            m_renderSettings.raytrace_nrsamples_shadows;
                     const float shadow_inc_factor = 1.0f / (float) ( shadow_number_of_samples );
 
                     for( unsigned int i = 0; i < shadow_number_of_samples; ++i )
@@ -1621,7 +1820,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
                             const SFVEC3F unifVector = UniformRandomHemisphereDirection();
                             const SFVEC3F disturbed_vector_to_light =
                                     glm::normalize( vectorToLight + unifVector *
-                                                    m_boardAdapter.m_Cfg->m_Render.raytrace_spread_shadows );
+                                                    m_renderSettings.raytrace_spread_shadows );
 
                             rayToLight.Init( hitPoint, disturbed_vector_to_light );
                         }
@@ -1666,7 +1865,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
     {
         // Reflections
         if( ( objMaterial->GetReflection() > 0.0f )
-          && m_boardAdapter.m_Cfg->m_Render.raytrace_reflections
+          && m_renderSettings.raytrace_reflections
           && ( aRecursiveLevel < objMaterial->GetReflectionRecursionCount() ) )
         {
             const unsigned int reflection_number_of_samples =
@@ -1691,7 +1890,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
                     const SFVEC3F random_reflectVector =
                             glm::normalize( reflectVector +
                                             UniformRandomHemisphereDirection() *
-                                            m_boardAdapter.m_Cfg->m_Render.raytrace_spread_reflections );
+                                            m_renderSettings.raytrace_spread_reflections );
 
                     reflectedRay.Init( hitPoint, random_reflectVector );
                 }
@@ -1717,7 +1916,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
         // Refraction
         const float objTransparency = aHitInfo.pHitObject->GetModelTransparency();
 
-        if( ( objTransparency > 0.0f ) && m_boardAdapter.m_Cfg->m_Render.raytrace_refractions
+        if( ( objTransparency > 0.0f ) && m_renderSettings.raytrace_refractions
           && ( aRecursiveLevel < objMaterial->GetRefractionRecursionCount() ) )
         {
             const float airIndex = 1.000293f;
@@ -1756,7 +1955,7 @@ SFVEC3F RENDER_3D_RAYTRACE::shadeHit( const SFVEC3F& aBgColor, const RAY& aRay,
                         const SFVEC3F randomizeRefractedVector =
                                 glm::normalize( refractedVector +
                                                 UniformRandomHemisphereDirection() *
-                                                m_boardAdapter.m_Cfg->m_Render.raytrace_spread_refractions );
+                                                m_renderSettings.raytrace_spread_refractions );
 
                         refractedRay.Init( startPoint, randomizeRefractedVector );
                     }
@@ -1853,6 +2052,8 @@ static float distance( const SFVEC2UI& a, const SFVEC2UI& b )
 
 void RENDER_3D_RAYTRACE::initializeBlockPositions()
 {
+    CancelRender();
+
     m_realBufferSize = SFVEC2UI( 0 );
 
     // Calc block positions for fast preview mode
@@ -1920,6 +2121,8 @@ void RENDER_3D_RAYTRACE::initializeBlockPositions()
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
 
+    m_blockPixels.assign( (size_t) m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
     initPbo();
 }
 
@@ -29,12 +29,20 @@
 #include "accelerators/container_3d.h"
 #include "accelerators/accelerator_3d.h"
 #include "../render_3d_base.h"
+#include "../camera.h"
 #include "light.h"
 #include "../post_shader_ssao.h"
 #include "material.h"
 #include <plugins/3dapi/c3dmodel.h>
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class BOARD;
 
 /// Vector of materials
 typedef std::vector< BLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -45,6 +53,7 @@ typedef std::map< const S3DMODEL* , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
+    RT_RENDER_STATE_ANTI_ALIASING,
     RT_RENDER_STATE_POST_PROCESS_SHADE,
     RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH,
     RT_RENDER_STATE_FINISH,
@@ -73,6 +82,15 @@ public:
 
     BOARD_ITEM *IntersectBoardItem( const RAY& aRay );
 
+    /**
+     * Stop tracing the image in the background, and wait for the blocks being traced.
+     *
+     * This must be called before the camera, the window size or the scene (including the
+     * board adapter) changes, as the tracing depends on them.  The blocks check for it one by
+     * one, so this returns after at most one block per thread.
+     */
+    void CancelRender();
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -84,12 +102,35 @@ private:
 
     void restartRenderState();
     void renderTracing( GLubyte* ptrPBO, REPORTER* aStatusReporter );
+    void renderAntiAliasing( GLubyte* ptrPBO, REPORTER* aStatusReporter );
+    void endTracing();
     void postProcessShading( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void postProcessBlurFinish( GLubyte* ptrPBO, REPORTER* aStatusReporter );
-    void renderBlockTracing( GLubyte* ptrPBO , signed int iBlock );
+
+    /**
+     * Start rendering all the blocks with \a aRenderBlock on the thread pool, from the center
+     * out, if not started yet.  Then copy the blocks rendered since the last call to \a ptrPBO
+     * and return, so that the progress is displayed and the GUI thread can handle camera moves
+     * while the blocks are rendered.
+     *
+     * @return true if all the blocks were rendered.
+     */
+    bool renderBlocks( GLubyte* ptrPBO,
+                       void ( RENDER_3D_RAYTRACE::*aRenderBlock )( GLubyte*, signed int ) );
+
+    /// Render a block with one sample per pixel
+    void renderBlockTracing( GLubyte* ptrPBO, signed int iBlock );
+
+    /// Add the anti-aliasing samples to a block rendered by renderBlockTracing()
+    void renderBlockAntiAliasing( GLubyte* ptrPBO, signed int iBlock );
+
+    void blockBackgroundColors( const SFVEC2I& aBlockPos, SFVEC3F* aBgColorY ) const;
     void renderFinalColor( GLubyte* ptrPBO, const SFVEC3F& rgbColor,
                            bool applyColorSpaceConversion );
 
+    /// Render all the pixels with their traced color, without post processing
+    void renderFinalColors( GLubyte* ptrPBO );
+
     void renderRayPackets( const SFVEC3F* bgColorY, const RAY* aRayPkt, HITINFO_PACKET* aHitPacket,
                            bool is_testShadow, SFVEC3F* aOutHitColor );
 
@@ -125,6 +166,24 @@ private:
 
     void initializeBlockPositions();
 
+    /// What the traced image depends on, to tell when it can be reused
+    struct TRACED_SCENE
+    {
+        EDA_3D_VIEWER_SETTINGS::RENDER_SETTINGS m_settings;
+        std::vector<KIGFX::COLOR4D>             m_colors;
+        bool                                    m_useStackupColors = false;
+        const BOARD*                            m_board = nullptr;
+        int                                     m_boardTimeStamp = 0;
+    };
+
+    void getTracedScene( TRACED_SCENE& aScene ) const;
+
+    /**
+     * @return true if the current image was traced for the same scene and only the post
+     *         processing option changed since, so there is no need to trace it again.
+     */
+    bool onlyPostProcessingChanged() const;
+
     void render( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void renderPreview( GLubyte* ptrPBO );
 
@@ -159,6 +218,43 @@ private:
     /// Save the number of blocks progress of the render
     size_t m_blockRenderProgressCount;
 
+    /// The post processing option when the blocks were rendered
+    bool m_blocksPostProcessed;
+
+    /// The scene of the current image
+    TRACED_SCENE m_tracedScene;
+
+    /**
+     * A copy of the view camera the blocks are traced with, as the view camera moves while
+     * they are traced in the background.
+     */
+    class TRACING_CAMERA : public CAMERA
+    {
+    public:
+        explicit TRACING_CAMERA( const CAMERA& aCamera ) :
+                CAMERA( aCamera )
+        { }
+
+        void Drag( const wxPoint& aNewMousePosition ) override { }
+        void Pan( const wxPoint& aNewMousePosition ) override { }
+        void Pan( const SFVEC3F& aDeltaOffsetInc ) override { }
+        void Pan_T1( const SFVEC3F& aDeltaOffsetInc ) override { }
+    };
+
+    std::unique_ptr<TRACING_CAMERA> m_tracingCamera;
+
+    /// The render settings the blocks are traced with, as the settings may change meanwhile
+    EDA_3D_VIEWER_SETTINGS::RENDER_SETTINGS m_renderSettings;
+
+    /// The blocks are rendered in this RGBA buffer, and copied to the PBO once rendered
+    std::vector<GLubyte> m_blockPixels;
+
+    std::vector<std::future<void>> m_blockTasks;       ///< The tasks rendering blocks
+    std::atomic<size_t>            m_nextBlock;        ///< The next block to render
+    std::atomic<bool>              m_cancelRender;     ///< Set to stop rendering blocks
+    std::mutex                     m_renderedBlocksLock;
+    std::vector<size_t>            m_renderedBlocks;   ///< Rendered but not copied to the PBO
+
     POST_SHADER_SSAO m_postShaderSsao;
 
     std::list<LIGHT*> m_lights;
@@ -189,9 +285,6 @@ private:
     ///< Encode Morton code positions.
     std::vector< SFVEC2UI > m_blockPositions;
 
-    ///< Flag if a position was already processed (cleared each new render).
-    std::vector< int > m_blockPositionsWasProcessed;
-
     ///< Encode the Morton code positions (on fast preview mode).
     std::vector< SFVEC2UI > m_blockPositionsFast;
 
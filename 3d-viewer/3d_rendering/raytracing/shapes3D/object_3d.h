@@ -93,6 +93,8 @@ public:
 
     const SFVEC3F& GetCentroid() const { return m_centroid; }
 
+    OBJECT_3D_TYPE GetObjectType() const { return m_obj_type; }
+
 protected:
     BBOX_3D m_bbox;
     SFVEC3F m_centroid;
@@ -29,6 +29,7 @@
 
 
 #include "triangle_3d.h"
+#include "../accelerators/bvh_packet_simd.h"
 
 
 void TRIANGLE::pre_calc_const()
@@ -199,6 +200,23 @@ void TRIANGLE::SetUV( const SFVEC2F& aUV1, const SFVEC2F& aUV2, const SFVEC2F& a
 static const unsigned int s_modulo[] = { 0, 1, 2, 0, 1 };
 
 
+void TRIANGLE::GetPacketData( TRIANGLE_PACKET_DATA& aData ) const
+{
+    aData.m_k = m_k;
+    aData.m_ku = s_modulo[m_k + 1];
+    aData.m_kv = s_modulo[m_k + 2];
+    aData.m_nu = m_nu;
+    aData.m_nv = m_nv;
+    aData.m_nd = m_nd;
+    aData.m_au = m_vertex[0][aData.m_ku];
+    aData.m_av = m_vertex[0][aData.m_kv];
+    aData.m_bnu = m_bnu;
+    aData.m_bnv = m_bnv;
+    aData.m_cnu = m_cnu;
+    aData.m_cnv = m_cnv;
+}
+
+
 bool TRIANGLE::Intersect( const RAY& aRay, HITINFO& aHitInfo ) const
 {
     //!TODO: precalc this, improve it
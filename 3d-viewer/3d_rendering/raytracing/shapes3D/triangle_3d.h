@@ -36,6 +36,8 @@
 
 #include "object_3d.h"
 
+struct TRIANGLE_PACKET_DATA;
+
 /**
  * A triangle object.
  */
@@ -66,6 +68,12 @@ public:
     bool Intersects( const BBOX_3D& aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO& aHitInfo ) const override;
 
+    /**
+     * Get the data needed to test the triangle against several rays at once with
+     * IntersectTrianglePacket8().
+     */
+    void GetPacketData( TRIANGLE_PACKET_DATA& aData ) const;
+
 private:
     void pre_calc_const();
 
@@ -199,6 +199,14 @@ static const wxChar V3DRT_BevelHeight_um[] = wxT( "V3DRT_BevelHeight_um" );
 static const wxChar V3DRT_BevelExtentFactor[] = wxT( "V3DRT_BevelExtentFactor" );
 
 static const wxChar UseClipper2[] = wxT( "UseClipper2" );
+
+static const wxChar IncrementalDRC[] = wxT( "IncrementalDRC" );
+
+static const wxChar IncrementalZoneFill[] = wxT( "IncrementalZoneFill" );
+
+static const wxChar FootprintCacheSize[] = wxT( "FootprintCacheSize" );
+
+static const wxChar IncrementalConnectivity[] = wxT( "IncrementalConnectivity" );
 } // namespace KEYS
 
 
@@ -329,6 +337,14 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_UseClipper2               = true;
 
+    m_IncrementalDRC            = false;
+
+    m_IncrementalZoneFill       = true;
+
+    m_FootprintCacheSize        = 256;
+
+    m_IncrementalConnectivity   = true;
+
     loadFromConfigFile();
 }
 
@@ -474,6 +490,20 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::UseClipper2,
                                                 &m_UseClipper2, m_UseClipper2 ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalDRC,
+                                                &m_IncrementalDRC, m_IncrementalDRC ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalZoneFill,
+                                                &m_IncrementalZoneFill, m_IncrementalZoneFill ) );
+
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::FootprintCacheSize,
+                                               &m_FootprintCacheSize, m_FootprintCacheSize,
+                                               0, 1000000 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalConnectivity,
+                                                &m_IncrementalConnectivity,
+                                                m_IncrementalConnectivity ) );
+
 
 
     // Special case for trace mask setting...we just grab them and set them immediately
@@ -28,6 +28,8 @@
 #include <cstdio>
 #include <cstdlib>         // bsearch()
 #include <cctype>
+#include <algorithm>
+#include <numeric>
 
 #include <dsnlexer.h>
 #include <wx/translation.h>
@@ -35,6 +37,108 @@
 #define FMT_CLIPBOARD       _( "clipboard" )
 
 
+//-----<KEYWORD_MAP>----------------------------------------------------------
+
+KEYWORD_MAP::KEYWORD_MAP( const std::pair<const char*, int>* aKeywords, size_t aCount ) :
+        m_mask( 0 ),
+        m_count( aCount )
+{
+    if( aCount == 0 )
+        return;
+
+    // Hash and displace: the keywords are split into buckets of a few keywords each, and each
+    // bucket gets a seed which sends all its keywords to free slots.
+    struct ENTRY
+    {
+        SLOT     m_Slot;
+        uint64_t m_Hash;
+    };
+
+    size_t                          bucketCount = aCount / 4 + 1;
+    std::vector<std::vector<ENTRY>> buckets( bucketCount );
+    std::vector<size_t>             order( bucketCount );
+    size_t                          tableSize = 1;
+
+    for( size_t ii = 0; ii < aCount; ++ii )
+    {
+        ENTRY entry;
+
+        entry.m_Slot.m_Name = aKeywords[ii].first;
+        entry.m_Slot.m_Length = strlen( aKeywords[ii].first );
+        entry.m_Slot.m_Token = aKeywords[ii].second;
+        entry.m_Hash = Hash( entry.m_Slot.m_Name, entry.m_Slot.m_Length );
+
+        buckets[ ( entry.m_Hash >> 32 ) % bucketCount ].push_back( entry );
+    }
+
+    // Place the biggest buckets first, while the table is emptiest
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(),
+                      [&]( size_t a, size_t b )
+                      {
+                          return buckets[a].size() > buckets[b].size();
+                      } );
+
+    // Leave some headroom, or finding seeds for the last buckets gets slow
+    while( tableSize < aCount * 5 / 4 )
+        tableSize <<= 1;
+
+    std::vector<size_t> placed;
+
+    for( ;; tableSize <<= 1 )
+    {
+        bool ok = true;
+
+        m_slots.assign( tableSize, SLOT() );
+        m_seeds.assign( bucketCount, 0 );
+        m_mask = tableSize - 1;
+
+        for( size_t bucketIdx : order )
+        {
+            const std::vector<ENTRY>& bucket = buckets[bucketIdx];
+            bool                      found = bucket.empty();
+
+            for( uint64_t seed = 1; !found && seed < 65536; ++seed )
+            {
+                found = true;
+                placed.clear();
+
+                for( const ENTRY& entry : bucket )
+                {
+                    size_t slot = mix( entry.m_Hash ^ seed ) & m_mask;
+
+                    if( m_slots[slot].m_Token >= 0
+                            || std::find( placed.begin(), placed.end(), slot ) != placed.end() )
+                    {
+                        found = false;
+                        break;
+                    }
+
+                    placed.push_back( slot );
+                }
+
+                if( found )
+                {
+                    m_seeds[bucketIdx] = seed;
+
+                    for( size_t ii = 0; ii < bucket.size(); ++ii )
+                        m_slots[placed[ii]] = bucket[ii].m_Slot;
+                }
+            }
+
+            if( !found )
+            {
+                ok = false;
+                break;
+            }
+        }
+
+        if( ok )
+            break;
+    }
+}
+
+
 //-----<DSNLEXER>-------------------------------------------------------------
 
 void DSNLEXER::init()
@@ -231,10 +335,10 @@ int DSNLEXER::findToken( const std::string& tok ) const
 {
     if( keywordsLookup != nullptr )
     {
-        KEYWORD_MAP::const_iterator it = keywordsLookup->find( tok.c_str() );
+        int token = keywordsLookup->Find( tok.data(), tok.size() );
 
-        if( it != keywordsLookup->end() )
-            return it->second;
+        if( token >= 0 )
+            return token;
     }
 
     return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
@@ -639,7 +743,7 @@ L_read:
                     case 'x':   // 1 or 2 byte hex escape sequence
                         for( i = 0; i < 2; ++i )
                         {
-                            if( !isxdigit( head[i] ) )
+                            if( head + i >= limit || !isxdigit( head[i] ) )
                                 break;
 
                             tbuf[i] = head[i];
@@ -660,7 +764,7 @@ L_read:
 
                         for( i=0; i<3; ++i )
                         {
-                            if( head[i] < '0' || head[i] > '7' )
+                            if( head + i >= limit || head[i] < '0' || head[i] > '7' )
                                 break;
 
                             tbuf[i] = head[i];
@@ -688,8 +792,14 @@ L_read:
                 }
 
                 else
-                    curText += *head++;
+                {
+                    const char* run = head;
+
+                    while( head < limit && *head != '\\' && *head != '"' )
+                        ++head;
 
+                    curText.append( run, head );
+                }
             }   // while
 
             // L_unterminated:
@@ -769,11 +879,11 @@ L_read:
     }           // specctraMode
 
     // non-quoted token, read it into curText.
-    curText.clear();
-
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
     if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
     {
@@ -35,6 +35,7 @@
 // The "official" name of the building Kicad stroke font (always existing)
 #include <font/kicad_font_name.h>
 #include "macros.h"
+#include <mutex>
 
 
 // markup_parser.h includes pegtl.hpp which includes windows.h... which leaks #define DrawText
@@ -47,6 +48,9 @@ FONT* FONT::s_defaultFont = nullptr;
 
 std::map< std::tuple<wxString, bool, bool>, FONT*> FONT::s_fontMap;
 
+// Fonts are looked up from the board loader's worker threads as well as the UI thread
+static std::recursive_mutex s_fontMapMutex;
+
 
 FONT::FONT()
 {
@@ -55,6 +59,8 @@ FONT::FONT()
 
 FONT* FONT::getDefaultFont()
 {
+    std::lock_guard<std::recursive_mutex> lock( s_fontMapMutex );
+
     if( !s_defaultFont )
         s_defaultFont = STROKE_FONT::LoadFont( wxEmptyString );
 
@@ -67,6 +73,8 @@ FONT* FONT::GetFont( const wxString& aFontName, bool aBold, bool aItalic )
     if( aFontName.empty() || aFontName.StartsWith( KICAD_FONT_NAME ) )
         return getDefaultFont();
 
+    std::lock_guard<std::recursive_mutex> lock( s_fontMapMutex );
+
     std::tuple<wxString, bool, bool> key = { aFontName, aBold, aItalic };
 
     FONT* font = s_fontMap[key];
@@ -0,0 +1,39 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_PCB_DRC_H
+#define JOB_PCB_DRC_H
+
+#include "job_rc.h"
+
+class JOB_PCB_DRC : public JOB_RC
+{
+public:
+    JOB_PCB_DRC( bool aIsCli ) :
+            JOB_RC( "drc", aIsCli ),
+            m_reportAllTrackErrors( false ),
+            m_refillZones( false )
+    {
+    }
+
+    bool m_reportAllTrackErrors;
+    bool m_refillZones;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_RC_H
+#define JOB_RC_H
+
+#include <wx/string.h>
+#include <widgets/report_severity.h>
+#include "job.h"
+
+/**
+ * Common base for the design rule (DRC) and electrical rule (ERC) checker jobs.
+ */
+class JOB_RC : public JOB
+{
+public:
+    JOB_RC( const std::string& aType, bool aIsCli ) :
+            JOB( aType, aIsCli ),
+            m_filename(),
+            m_outputFile(),
+            m_units( UNITS::MILLIMETERS ),
+            m_severity( RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING ),
+            m_format( OUTPUT_FORMAT::REPORT ),
+            m_exitCodeViolations( false ),
+            m_threads( 0 )
+    {
+    }
+
+    wxString m_filename;
+    wxString m_outputFile;
+
+    enum class UNITS
+    {
+        INCHES,
+        MILLIMETERS,
+        MILS
+    };
+
+    UNITS m_units;
+
+    /// Mask of #SEVERITY values to include in the report
+    int m_severity;
+
+    enum class OUTPUT_FORMAT
+    {
+        REPORT,
+        JSON
+    };
+
+    OUTPUT_FORMAT m_format;
+
+    /// Return a non-zero exit code when violations of error or warning severity were reported
+    bool m_exitCodeViolations;
+
+    /// Number of worker threads to use for the checks; 0 for the default
+    int m_threads;
+};
+
+#endif
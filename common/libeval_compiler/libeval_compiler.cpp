@@ -161,6 +161,14 @@ wxString UOP::Format() const
     }
         break;
 
+    case TR_UOP_VAR_EQUAL:
+        str = wxString::Format( "VAR EQUAL [%p]", m_ref.get() );
+        break;
+
+    case TR_UOP_VAR_NOT_EQUAL:
+        str = wxString::Format( "VAR NEQUAL [%p]", m_ref.get() );
+        break;
+
     case TR_OP_METHOD_CALL:
         str = wxString::Format( "MCALL" );
         break;
@@ -201,6 +209,80 @@ wxString UCODE::Dump() const
 };
 
 
+void UCODE::Optimize()
+{
+    std::vector<UOP*> code;
+
+    code.reserve( m_ucode.size() );
+
+    auto isConstant =
+            []( const UOP* aOp )
+            {
+                return aOp->m_op == TR_UOP_PUSH_VALUE && aOp->m_value;
+            };
+
+    // Evaluate the last aCount ops of the code, which compute a constant, and replace them
+    // with a push of the result.
+    auto fold =
+            [&]( size_t aCount )
+            {
+                CONTEXT                ctx;
+                std::unique_ptr<VALUE> result = std::make_unique<VALUE>();
+
+                for( size_t ii = code.size() - aCount; ii < code.size(); ++ii )
+                    code[ii]->Exec( &ctx );
+
+                result->Set( *ctx.Pop() );
+
+                for( size_t ii = 0; ii < aCount; ++ii )
+                {
+                    delete code.back();
+                    code.pop_back();
+                }
+
+                code.push_back( new UOP( TR_UOP_PUSH_VALUE, std::move( result ) ) );
+            };
+
+    for( UOP* op : m_ucode )
+    {
+        code.push_back( op );
+
+        size_t n = code.size();
+
+        if( ( op->m_op & TR_OP_BINARY_MASK ) && n >= 3 && isConstant( code[n - 3] )
+                && isConstant( code[n - 2] ) )
+        {
+            // Leave type mismatches to be reported at run time
+            if( code[n - 3]->m_value->GetType() == code[n - 2]->m_value->GetType() )
+                fold( 3 );
+        }
+        else if( ( op->m_op & TR_OP_UNARY_MASK ) && n >= 2 && isConstant( code[n - 2] ) )
+        {
+            fold( 2 );
+        }
+        else if( ( op->m_op == TR_OP_EQUAL || op->m_op == TR_OP_NOT_EQUAL ) && n >= 3
+                 && code[n - 3]->m_op == TR_UOP_PUSH_VAR && code[n - 3]->m_ref
+                 && isConstant( code[n - 2] )
+                 && code[n - 3]->m_ref->PrepareCompare( *code[n - 2]->m_value ) )
+        {
+            UOP* compare = new UOP( op->m_op == TR_OP_EQUAL ? TR_UOP_VAR_EQUAL
+                                                            : TR_UOP_VAR_NOT_EQUAL,
+                                    std::move( code[n - 3]->m_ref ) );
+
+            for( int ii = 0; ii < 3; ++ii )
+            {
+                delete code.back();
+                code.pop_back();
+            }
+
+            code.push_back( compare );
+        }
+    }
+
+    m_ucode = std::move( code );
+}
+
+
 wxString TOKENIZER::GetChars( const std::function<bool( wxUniChar )>& cond ) const
 {
     wxString rv;
@@ -658,6 +740,15 @@ void dumpNode( wxString& buf, TREE_NODE* tok, int depth = 0 )
 }
 
 
+void CONTEXT::PushBool( bool aValue )
+{
+    static VALUE s_true( 1.0 );
+    static VALUE s_false( 0.0 );
+
+    Push( aValue ? &s_true : &s_false );
+}
+
+
 void CONTEXT::ReportError( const wxString& aErrorMsg )
 {
     if( m_errorCallback )
@@ -1090,6 +1181,8 @@ bool COMPILER::generateUCode( UCODE* aCode, CONTEXT* aPreflightContext )
         stack.pop_back();
     }
 
+    aCode->Optimize();
+
     libeval_dbg(2,"dump: \n%s\n", aCode->Dump().c_str() );
 
     return true;
@@ -1117,6 +1210,19 @@ void UOP::Exec( CONTEXT* ctx )
         ctx->Push( m_value.get() );
         return;
 
+    case TR_UOP_VAR_EQUAL:
+    case TR_UOP_VAR_NOT_EQUAL:
+    {
+        // Like EQUAL and NOT_EQUAL, both are false when the variable is undefined
+        int match = m_ref->Compare( ctx );
+
+        if( match < 0 )
+            ctx->PushBool( false );
+        else
+            ctx->PushBool( ( match > 0 ) == ( m_op == TR_UOP_VAR_EQUAL ) );
+    }
+        return;
+
     case TR_OP_METHOD_CALL:
         m_func( ctx, m_ref.get() );
         return;
@@ -1202,9 +1308,17 @@ void UOP::Exec( CONTEXT* ctx )
             break;
         }
 
-        auto rp = ctx->AllocValue();
-        rp->Set( result );
-        ctx->Push( rp );
+        if( m_op == TR_OP_ADD || m_op == TR_OP_SUB || m_op == TR_OP_MUL || m_op == TR_OP_DIV )
+        {
+            auto rp = ctx->AllocValue();
+            rp->Set( result );
+            ctx->Push( rp );
+        }
+        else
+        {
+            ctx->PushBool( result != 0.0 );
+        }
+
         return;
     }
     else if( m_op & TR_OP_UNARY_MASK )
@@ -1223,9 +1337,7 @@ void UOP::Exec( CONTEXT* ctx )
             break;
         }
 
-        auto rp = ctx->AllocValue();
-        rp->Set( result );
-        ctx->Push( rp );
+        ctx->PushBool( result != 0.0 );
         return;
     }
 }
@@ -24,14 +24,27 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cmath>
+
 #include <painter.h>
 #include <gal/graphics_abstraction_layer.h>
 
 using namespace KIGFX;
 
 PAINTER::PAINTER( GAL* aGal ) :
-    m_gal( aGal )
+    m_gal( aGal ),
+    m_detailLevel( 0 )
+{
+}
+
+
+double PAINTER::GetDetailTolerance( int aLevel ) const
 {
+    if( aLevel <= 0 )
+        return 0.0;
+
+    // 1 mil at level 1, growing four-fold with each level
+    return 0.001 * pow( 4.0, aLevel - 1 ) / m_gal->GetWorldUnitLength();
 }
 
 
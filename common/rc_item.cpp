@@ -31,6 +31,8 @@
 #include <rc_item.h>
 #include <eda_item.h>
 #include <base_units.h>
+#include <settings/json_settings.h>
+#include <nlohmann/json.hpp>
 
 #define WX_DATAVIEW_WINDOW_PADDING 6
 
@@ -146,6 +148,67 @@ wxString RC_ITEM::ShowReport( UNITS_PROVIDER* aUnitsProvider, SEVERITY aSeverity
 }
 
 
+void RC_ITEM::GetJsonViolation( nlohmann::json& aViolation, UNITS_PROVIDER* aUnitsProvider,
+                                SEVERITY aSeverity,
+                                const std::map<KIID, EDA_ITEM*>& aItemMap ) const
+{
+    wxString severity;
+
+    switch( aSeverity )
+    {
+    case RPT_SEVERITY_ERROR:     severity = wxT( "error" );     break;
+    case RPT_SEVERITY_WARNING:   severity = wxT( "warning" );   break;
+    case RPT_SEVERITY_ACTION:    severity = wxT( "action" );    break;
+    case RPT_SEVERITY_INFO:      severity = wxT( "info" );      break;
+    case RPT_SEVERITY_EXCLUSION: severity = wxT( "exclusion" ); break;
+    case RPT_SEVERITY_DEBUG:     severity = wxT( "debug" );     break;
+    default:                   ;
+    };
+
+    auto toUserUnit =
+            [&]( int aValue ) -> double
+            {
+                return EDA_UNIT_UTILS::UI::ToUserUnit( aUnitsProvider->GetIuScale(),
+                                                       aUnitsProvider->GetUserUnits(), aValue );
+            };
+
+    // As with ShowReport(), these are machine-processed so don't translate them
+    aViolation["type"] = GetSettingsKey();
+    aViolation["description"] = GetErrorMessage();
+    aViolation["severity"] = severity;
+    aViolation["excluded"] = ( m_parent && m_parent->IsExcluded() );
+
+    if( !GetViolatingRuleDesc().IsEmpty() )
+        aViolation["rule"] = GetViolatingRuleDesc();
+
+    nlohmann::json items = nlohmann::json::array();
+
+    for( const KIID& id : m_ids )
+    {
+        if( id == niluuid )
+            continue;
+
+        nlohmann::json item;
+        item["uuid"] = id.AsString();
+
+        auto ii = aItemMap.find( id );
+
+        if( ii != aItemMap.end() )
+        {
+            EDA_ITEM* edaItem = ii->second;
+
+            item["description"] = edaItem->GetSelectMenuText( aUnitsProvider );
+            item["pos"] = { { "x", toUserUnit( edaItem->GetPosition().x ) },
+                            { "y", toUserUnit( edaItem->GetPosition().y ) } };
+        }
+
+        items.push_back( item );
+    }
+
+    aViolation["items"] = items;
+}
+
+
 KIID RC_TREE_MODEL::ToUUID( wxDataViewItem aItem )
 {
     const RC_TREE_NODE* node = RC_TREE_MODEL::ToNode( aItem );
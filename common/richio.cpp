@@ -30,7 +30,10 @@
 #include <richio.h>
 #include <errno.h>
 
+#include <kiplatform/io.h>
+
 #include <wx/file.h>
+#include <wx/ffile.h>
 #include <wx/translation.h>
 
 
@@ -305,6 +308,125 @@ char* STRING_LINE_READER::ReadLine()
 }
 
 
+const char* STRING_LINE_READER::ReadLineInPlace( unsigned* aLength )
+{
+    size_t  nlOffset = m_lines.find( '\n', m_ndx );
+    size_t  begin = m_ndx;
+
+    unsigned new_length;
+
+    if( nlOffset == std::string::npos )
+        new_length = m_lines.length() - m_ndx;
+    else
+        new_length = nlOffset - m_ndx + 1;     // include the newline, so +1
+
+    if( new_length >= m_maxLineLength )
+        THROW_IO_ERROR( _("Line length exceeded") );
+
+    m_length = new_length;
+    m_ndx += m_length;
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+
+    *aLength = m_length;
+    return m_lines.data() + begin;
+}
+
+
+BUFFER_LINE_READER::BUFFER_LINE_READER( const char* aBuffer, size_t aLength,
+                                        const wxString& aSource, unsigned aStartingLineNumber ) :
+    LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+    m_buffer( aBuffer ),
+    m_bufferLength( aLength ),
+    m_ndx( 0 )
+{
+    m_source  = aSource;
+    m_lineNum = aStartingLineNumber;
+}
+
+
+char* BUFFER_LINE_READER::ReadLine()
+{
+    const char* begin = m_buffer + m_ndx;
+    size_t      remaining = m_bufferLength - m_ndx;
+    const char* nl = (const char*) memchr( begin, '\n', remaining );
+    unsigned    new_length = nl ? unsigned( nl - begin + 1 ) : unsigned( remaining );
+
+    if( new_length )
+    {
+        if( new_length >= m_maxLineLength )
+            THROW_IO_ERROR( _("Line length exceeded") );
+
+        if( new_length+1 > m_capacity )   // +1 for terminating nul
+            expandCapacity( new_length+1 );
+
+        memcpy( m_line, begin, new_length );
+        m_ndx += new_length;
+    }
+
+    m_length = new_length;
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+    m_line[m_length] = 0;
+
+    return m_length ? m_line : nullptr;
+}
+
+
+const char* BUFFER_LINE_READER::ReadLineInPlace( unsigned* aLength )
+{
+    const char* begin = m_buffer + m_ndx;
+    size_t      remaining = m_bufferLength - m_ndx;
+    const char* nl = (const char*) memchr( begin, '\n', remaining );
+    unsigned    new_length = nl ? unsigned( nl - begin + 1 ) : unsigned( remaining );
+
+    if( new_length >= m_maxLineLength )
+        THROW_IO_ERROR( _("Line length exceeded") );
+
+    m_length = new_length;
+    m_ndx += m_length;
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+
+    *aLength = m_length;
+    return begin;
+}
+
+
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName ) :
+    BUFFER_LINE_READER( nullptr, 0, aFileName ),
+    m_mapping( nullptr )
+{
+    m_mapping = KIPLATFORM::IO::MapFile( aFileName, m_bufferLength );
+
+    if( m_mapping )
+    {
+        m_buffer = m_mapping;
+        return;
+    }
+
+    wxFFile file( aFileName, wxT( "rb" ) );
+
+    if( !file.IsOpened() )
+    {
+        wxString msg = wxString::Format( _( "Unable to open %s for reading." ),
+                                         aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    m_contents.resize( file.Length() );
+
+    if( file.Read( m_contents.data(), m_contents.size() ) != m_contents.size() )
+        THROW_IO_ERROR( wxString::Format( _( "Error reading file %s." ), aFileName ) );
+
+    m_buffer = m_contents.data();
+    m_bufferLength = m_contents.size();
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+    KIPLATFORM::IO::UnmapFile( m_mapping, m_bufferLength );
+}
+
+
 INPUTSTREAM_LINE_READER::INPUTSTREAM_LINE_READER( wxInputStream* aStream,
                                                   const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
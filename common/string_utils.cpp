@@ -743,27 +743,20 @@ bool WildCompareString( const wxString& pattern, const wxString& string_to_tst,
                         bool case_sensitive )
 {
     const wxChar* cp = nullptr, * mp = nullptr;
-    const wxChar* wild, * str;
-    wxString      _pattern, _string_to_tst;
+    const wxChar* wild = pattern.GetData();
+    const wxChar* str = string_to_tst.GetData();
 
-    if( case_sensitive )
-    {
-        wild = pattern.GetData();
-        str = string_to_tst.GetData();
-    }
-    else
-    {
-        _pattern = pattern;
-        _pattern.MakeUpper();
-        _string_to_tst = string_to_tst;
-        _string_to_tst.MakeUpper();
-        wild   = _pattern.GetData();
-        str = _string_to_tst.GetData();
-    }
+    // Compare characters in place rather than upper-casing copies of both strings; this is
+    // called for every item tested by a DRC rule with a wildcard.
+    auto same =
+            [case_sensitive]( wxChar a, wxChar b )
+            {
+                return case_sensitive ? a == b : wxToupper( a ) == wxToupper( b );
+            };
 
     while( ( *str ) && ( *wild != '*' ) )
     {
-        if( ( *wild != *str ) && ( *wild != '?' ) )
+        if( !same( *wild, *str ) && ( *wild != '?' ) )
             return false;
 
         wild++;
@@ -779,7 +772,7 @@ bool WildCompareString( const wxString& pattern, const wxString& string_to_tst,
             mp = wild;
             cp = str + 1;
         }
-        else if( ( *wild == *str ) || ( *wild == '?' ) )
+        else if( same( *wild, *str ) || ( *wild == '?' ) )
         {
             wild++;
             str++;
@@ -24,6 +24,14 @@
 
 #include <thread_pool.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 // Under mingw, there is a problem with the destructor when creating a static instance
 // of a thread_pool: probably the DTOR is called too late, and the application hangs.
 // so we create it on the heap.
@@ -39,3 +47,235 @@ thread_pool& GetKiCadThreadPool()
 
     return *tp;
 }
+
+
+namespace
+{
+
+/**
+ * The part of a ParallelFor() range owned by one thread.  Kept in separate cache lines as
+ * each is hammered by its own thread.
+ */
+struct alignas( 64 ) PARALLEL_FOR_SHARE
+{
+    std::mutex m_lock;
+    size_t     m_begin = 0;
+    size_t     m_end = 0;
+};
+
+
+struct PARALLEL_FOR_STATE
+{
+    PARALLEL_FOR_STATE( size_t aShareCount, size_t aCount ) :
+            m_shares( aShareCount )
+    {
+        for( size_t ii = 0; ii < aShareCount; ++ii )
+        {
+            m_shares[ii].m_begin = aCount * ii / aShareCount;
+            m_shares[ii].m_end = aCount * ( ii + 1 ) / aShareCount;
+        }
+    }
+
+    /**
+     * Take the next block of items for the thread owning \a aShare, stealing from another
+     * share if needed.
+     *
+     * @return false if there is nothing left to take.
+     */
+    bool takeBlock( size_t aShare, size_t& aBegin, size_t& aEnd )
+    {
+        PARALLEL_FOR_SHARE& own = m_shares[aShare];
+
+        {
+            std::lock_guard<std::mutex> lock( own.m_lock );
+
+            if( own.m_begin < own.m_end )
+            {
+                aBegin = own.m_begin;
+                aEnd = aBegin + blockSize( own.m_end - own.m_begin );
+                own.m_begin = aEnd;
+                return true;
+            }
+        }
+
+        for( size_t ii = 1; ii < m_shares.size(); ++ii )
+        {
+            PARALLEL_FOR_SHARE& victim = m_shares[( aShare + ii ) % m_shares.size()];
+            size_t              begin;
+            size_t              end;
+
+            {
+                std::lock_guard<std::mutex> lock( victim.m_lock );
+                size_t                      remaining = victim.m_end - victim.m_begin;
+
+                if( remaining == 0 )
+                    continue;
+
+                end = victim.m_end;
+                begin = end - ( remaining <= m_minBlockSize ? remaining : remaining / 2 );
+                victim.m_end = begin;
+            }
+
+            aBegin = begin;
+            aEnd = begin + blockSize( end - begin );
+
+            if( aEnd < end )
+            {
+                std::lock_guard<std::mutex> lock( own.m_lock );
+                own.m_begin = aEnd;
+                own.m_end = end;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Blocks shrink as a share runs down so that the tail of the range can be balanced
+     * between threads.
+     */
+    size_t blockSize( size_t aRemaining ) const
+    {
+        return std::min( aRemaining, std::max( m_minBlockSize, aRemaining / 4 ) );
+    }
+
+    void run( size_t aShare )
+    {
+        size_t begin;
+        size_t end;
+
+        while( !m_cancelled && takeBlock( aShare, begin, end ) )
+        {
+            size_t ii = begin;
+
+            try
+            {
+                while( ii < end && !m_cancelled.load( std::memory_order_relaxed ) )
+                    ( *m_func )( ii++ );
+            }
+            catch( ... )
+            {
+                // An exception must not escape a pool thread.  Keep the first one to rethrow
+                // it from the calling thread, and skip the items not started yet.
+                std::lock_guard<std::mutex> lock( m_latchLock );
+
+                if( !m_exception )
+                    m_exception = std::current_exception();
+
+                m_cancelled = true;
+            }
+
+            m_done.fetch_add( ii - begin );
+        }
+    }
+
+    const std::function<void( size_t )>* m_func = nullptr;
+    size_t                               m_minBlockSize = 1;
+    std::vector<PARALLEL_FOR_SHARE>      m_shares;
+    std::atomic<size_t>                  m_done{ 0 };
+    std::atomic<bool>                    m_cancelled{ false };
+
+    // The completion latch.  Pool tasks which start after the caller has returned (m_finished)
+    // must not touch anything but this state, which they share ownership of.
+    std::mutex                           m_latchLock;
+    std::condition_variable              m_latch;
+    size_t                               m_started = 0;
+    size_t                               m_active = 0;
+    std::exception_ptr                   m_exception;
+    bool                                 m_finished = false;
+};
+
+} // namespace
+
+
+size_t ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                    const std::function<bool( size_t )>& aWaitCallback, size_t aMinBlockSize )
+{
+    if( aCount == 0 )
+        return 0;
+
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       minBlockSize = std::max<size_t>( aMinBlockSize, 1 );
+    size_t       blockCount = ( aCount + minBlockSize - 1 ) / minBlockSize;
+    size_t       taskCount = std::min<size_t>( tp.get_thread_count(), blockCount );
+
+    // Without a wait callback the calling thread has a share of its own.
+    size_t shareCount = aWaitCallback ? std::max<size_t>( taskCount, 1 ) : taskCount + 1;
+
+    auto state = std::make_shared<PARALLEL_FOR_STATE>( shareCount, aCount );
+    state->m_func = &aFunc;
+    state->m_minBlockSize = minBlockSize;
+
+    for( size_t ii = 0; ii < taskCount; ++ii )
+    {
+        tp.push_task(
+                [state, ii]()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock( state->m_latchLock );
+
+                        if( state->m_finished )
+                            return;
+
+                        state->m_started++;
+                        state->m_active++;
+                    }
+
+                    state->run( ii );
+
+                    std::lock_guard<std::mutex> lock( state->m_latchLock );
+
+                    if( --state->m_active == 0 )
+                        state->m_latch.notify_all();
+                } );
+    }
+
+    auto isDone =
+            [&]()
+            {
+                return state->m_active == 0 && ( state->m_cancelled || state->m_done == aCount );
+            };
+
+    if( !aWaitCallback )
+    {
+        state->run( shareCount - 1 );
+
+        std::unique_lock<std::mutex> lock( state->m_latchLock );
+        state->m_latch.wait( lock, isDone );
+        state->m_finished = true;
+    }
+    else
+    {
+        while( true )
+        {
+            bool nothingStarted;
+
+            {
+                std::unique_lock<std::mutex> lock( state->m_latchLock );
+
+                if( state->m_latch.wait_for( lock, std::chrono::milliseconds( 250 ), isDone ) )
+                {
+                    state->m_finished = true;
+                    break;
+                }
+
+                nothingStarted = state->m_started == 0;
+            }
+
+            if( !aWaitCallback( state->m_done ) )
+                state->m_cancelled = true;
+
+            // If the pool is tied up (for instance when called from one of its own threads)
+            // none of the tasks may ever start.  Do the work here rather than wait on them.
+            if( nothingStarted && !state->m_cancelled )
+                state->run( 0 );
+        }
+    }
+
+    if( state->m_exception )
+        std::rethrow_exception( state->m_exception );
+
+    return state->m_done;
+}
@@ -41,6 +41,7 @@
 #include <painter.h>
 
 #include <profile.h>
+#include <thread_pool.h>
 
 #ifdef KICAD_GAL_PROFILE
 #include <wx/log.h>
@@ -94,17 +95,48 @@ private:
      * Return number of the group id for the given layer, or -1 in case it was not cached before.
      *
      * @param aLayer is the layer number for which group id is queried.
+     * @param aDetail is the requested level of detail.  The group of the coarsest level cached
+     *                which is no coarser than this is returned.
      * @return group id or -1 in case there is no group id (ie. item is not cached).
      */
-    int getGroup( int aLayer ) const
+    int getGroup( int aLayer, int aDetail = 0 ) const
     {
+        int group = -1;
+        int groupDetail = -1;
+
+        for( int i = 0; i < m_groupsSize; ++i )
+        {
+            const GROUP& g = m_groups[i];
+
+            if( g.m_Layer == aLayer && g.m_Id >= 0 && g.m_Detail <= aDetail
+                    && g.m_Detail > groupDetail )
+            {
+                group = g.m_Id;
+                groupDetail = g.m_Detail;
+            }
+        }
+
+        return group;
+    }
+
+    /**
+     * Return the ids of the groups cached for a layer at all levels of detail.
+     *
+     * @param aLayer is the layer number for which group ids are queried.
+     * @param aGroups is filled with up to PAINTER::DETAIL_LEVELS group ids.
+     * @return the number of group ids.
+     */
+    int getGroups( int aLayer, int* aGroups ) const
+    {
+        int count = 0;
+
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            if( m_groups[i].first == aLayer )
-                return m_groups[i].second;
+            if( m_groups[i].m_Layer == aLayer && m_groups[i].m_Id >= 0 )
+                aGroups[count++] = m_groups[i].m_Id;
         }
 
-        return -1;
+        return count;
     }
 
     /**
@@ -112,21 +144,22 @@ private:
      *
      * @param aLayer is the layer number.
      * @param aGroup is the group id.
+     * @param aDetail is the level of detail the group was drawn at.
      */
-    void setGroup( int aLayer, int aGroup )
+    void setGroup( int aLayer, int aGroup, int aDetail = 0 )
     {
         // Look if there is already an entry for the layer
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            if( m_groups[i].first == aLayer )
+            if( m_groups[i].m_Layer == aLayer && m_groups[i].m_Detail == aDetail )
             {
-                m_groups[i].second = aGroup;
+                m_groups[i].m_Id = aGroup;
                 return;
             }
         }
 
         // If there was no entry for the given layer - create one
-        std::pair<int, int>* newGroups = new std::pair<int, int>[m_groupsSize + 1];
+        GROUP* newGroups = new GROUP[m_groupsSize + 1];
 
         if( m_groupsSize > 0 )
         {
@@ -135,7 +168,24 @@ private:
         }
 
         m_groups = newGroups;
-        newGroups[m_groupsSize++] = { aLayer, aGroup };
+        newGroups[m_groupsSize++] = { aLayer, aDetail, aGroup };
+    }
+
+    /**
+     * Delete the groups of a layer at all levels of detail from the GAL and forget them.
+     */
+    void releaseGroups( int aLayer, GAL* aGal )
+    {
+        for( int i = 0; i < m_groupsSize; ++i )
+        {
+            if( m_groups[i].m_Layer == aLayer )
+            {
+                if( m_groups[i].m_Id >= 0 )
+                    aGal->DeleteGroup( m_groups[i].m_Id );
+
+                m_groups[i].m_Id = -1;
+            }
+        }
     }
 
 
@@ -172,13 +222,13 @@ private:
     {
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            int orig_layer = m_groups[i].first;
+            int orig_layer = m_groups[i].m_Layer;
             int new_layer = orig_layer;
 
             if( aReorderMap.count( orig_layer ) )
                 new_layer = aReorderMap.at( orig_layer );
 
-            m_groups[i].first = new_layer;
+            m_groups[i].m_Layer = new_layer;
         }
     }
 
@@ -230,8 +280,15 @@ private:
     int                  m_requiredUpdate;   ///< Flag required for updating
     int                  m_drawPriority;     ///< Order to draw this item in a layer, lowest first
 
-    std::pair<int, int>* m_groups;           ///< layer_number:group_id pairs for each layer the
-                                             ///< item occupies.
+    struct GROUP
+    {
+        int m_Layer;
+        int m_Detail;                        ///< Level of detail, 0 being the full detail
+        int m_Id;
+    };
+
+    GROUP*               m_groups;           ///< group ids for each layer the item occupies
+                                             ///< and each level of detail it is cached at.
     int                  m_groupsSize;
 
     std::vector<int>     m_layers;           /// Stores layer numbers used by the item.
@@ -263,7 +320,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_detailLevel( 0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -372,10 +430,7 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         MarkTargetDirty( l.target );
 
         // Clear the GAL cache
-        int prevGroup = viewData->getGroup( layers[i] );
-
-        if( prevGroup >= 0 )
-            m_gal->DeleteGroup( prevGroup );
+        viewData->releaseGroups( layers[i], m_gal );
     }
 
     viewData->deleteGroups();
@@ -720,10 +775,11 @@ struct VIEW::UPDATE_COLOR_VISITOR
     {
         // Obtain the color that should be used for coloring the item
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
-        int           group = aItem->viewPrivData()->getGroup( layer );
+        int           groups[PAINTER::DETAIL_LEVELS];
+        int           groups_count = aItem->viewPrivData()->getGroups( layer, groups );
 
-        if( group >= 0 )
-            gal->ChangeGroupColor( group, color );
+        for( int i = 0; i < groups_count; ++i )
+            gal->ChangeGroupColor( groups[i], color );
 
         return true;
     }
@@ -774,10 +830,11 @@ void VIEW::UpdateAllLayersColor()
             for( int i = 0; i < layers_count; ++i )
             {
                 const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
-                int           group = viewData->getGroup( layers[i] );
+                int           groups[PAINTER::DETAIL_LEVELS];
+                int           groups_count = viewData->getGroups( layers[i], groups );
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupColor( group, color );
+                for( int j = 0; j < groups_count; ++j )
+                    m_gal->ChangeGroupColor( groups[j], color );
             }
         }
     }
@@ -797,10 +854,11 @@ struct VIEW::UPDATE_DEPTH_VISITOR
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        int group = aItem->viewPrivData()->getGroup( layer );
+        int groups[PAINTER::DETAIL_LEVELS];
+        int groups_count = aItem->viewPrivData()->getGroups( layer, groups );
 
-        if( group >= 0 )
-            gal->ChangeGroupDepth( group, depth );
+        for( int i = 0; i < groups_count; ++i )
+            gal->ChangeGroupDepth( groups[i], depth );
 
         return true;
     }
@@ -906,10 +964,11 @@ void VIEW::UpdateAllLayersOrder()
 
             for( int i = 0; i < layers_count; ++i )
             {
-                int group = viewData->getGroup( layers[i] );
+                int groups[PAINTER::DETAIL_LEVELS];
+                int groups_count = viewData->getGroups( layers[i], groups );
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+                for( int j = 0; j < groups_count; ++j )
+                    m_gal->ChangeGroupDepth( groups[j], m_layers[layers[i]].renderingOrder );
             }
         }
     }
@@ -978,6 +1037,15 @@ struct VIEW::DRAW_ITEM_VISITOR
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    // Use the coarsest level of detail which is still accurate to half a pixel
+    m_detailLevel = 0;
+
+    while( m_detailLevel + 1 < PAINTER::DETAIL_LEVELS
+            && m_painter->GetDetailTolerance( m_detailLevel + 1 ) * m_gal->GetWorldScale() <= 0.5 )
+    {
+        m_detailLevel++;
+    }
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
@@ -1019,7 +1087,7 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
-        int group = viewData->getGroup( aLayer );
+        int group = viewData->getGroup( aLayer, m_detailLevel );
 
         if( group >= 0 )
             m_gal->DrawGroup( group );
@@ -1075,13 +1143,8 @@ struct VIEW::RECACHE_ITEM_VISITOR
         if( !viewData )
             return false;
 
-        // Remove previously cached group
-        int group = viewData->getGroup( layer );
-
-        if( group >= 0 )
-            gal->DeleteGroup( group );
-
-        viewData->setGroup( layer, -1 );
+        // Remove previously cached groups
+        viewData->releaseGroups( layer, gal );
         view->Update( aItem );
 
         return true;
@@ -1264,11 +1327,12 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 
     // Obtain the color that should be used for coloring the item on the specific layerId
     const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
-    int group = viewData->getGroup( aLayer );
+    int groups[PAINTER::DETAIL_LEVELS];
+    int groups_count = viewData->getGroups( aLayer, groups );
 
-    // Change the color, only if it has group assigned
-    if( group >= 0 )
-        m_gal->ChangeGroupColor( group, color );
+    // Change the color, only if it has groups assigned
+    for( int i = 0; i < groups_count; ++i )
+        m_gal->ChangeGroupColor( groups[i], color );
 }
 
 
@@ -1287,18 +1351,25 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     m_gal->SetLayerDepth( l.renderingOrder );
 
     // Redraw the item from scratch
-    int group = viewData->getGroup( aLayer );
+    viewData->releaseGroups( aLayer, m_gal );
 
-    if( group >= 0 )
-        m_gal->DeleteGroup( group );
+    // Large items also get simplified versions for drawing at low zoom levels
+    int detailLevels = m_painter->HasDetailLevels( aItem, aLayer ) ? PAINTER::DETAIL_LEVELS : 1;
+
+    for( int detail = 0; detail < detailLevels; ++detail )
+    {
+        m_painter->SetDetailLevel( detail );
 
-    group = m_gal->BeginGroup();
-    viewData->setGroup( aLayer, group );
+        int group = m_gal->BeginGroup();
+        viewData->setGroup( aLayer, group, detail );
 
-    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
-        aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+        if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+            aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
-    m_gal->EndGroup();
+        m_gal->EndGroup();
+    }
+
+    m_painter->SetDetailLevel( 0 );
 }
 
 
@@ -1338,13 +1409,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
         if( IsCached( l.id ) )
         {
             // Redraw the item from scratch
-            int prevGroup = viewData->getGroup( layers[i] );
-
-            if( prevGroup >= 0 )
-            {
-                m_gal->DeleteGroup( prevGroup );
-                viewData->setGroup( l.id, -1 );
-            }
+            viewData->releaseGroups( layers[i], m_gal );
         }
     }
 
@@ -1400,8 +1465,8 @@ void VIEW::UpdateItems()
     if( !m_gal->IsVisible() )
         return;
 
-    unsigned int cntGeomUpdate = 0;
-    bool         anyUpdated = false;
+    unsigned int            cntGeomUpdate = 0;
+    std::vector<VIEW_ITEM*> toUpdate;
 
     for( VIEW_ITEM* item : *m_allItems )
     {
@@ -1412,7 +1477,7 @@ void VIEW::UpdateItems()
 
         if( vpd->m_requiredUpdate != NONE )
         {
-            anyUpdated = true;
+            toUpdate.push_back( item );
 
             if( vpd->m_requiredUpdate & ( GEOMETRY | LAYERS ) )
             {
@@ -1421,6 +1486,8 @@ void VIEW::UpdateItems()
         }
     }
 
+    bool anyUpdated = !toUpdate.empty();
+
     unsigned int cntTotal = m_allItems->size();
 
     double ratio = (double) cntGeomUpdate / (double) cntTotal;
@@ -1459,9 +1526,11 @@ void VIEW::UpdateItems()
 
     if( anyUpdated )
     {
+        prepareItems( toUpdate );
+
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
-        for( VIEW_ITEM* item : *m_allItems.get() )
+        for( VIEW_ITEM* item : toUpdate )
         {
             if( item->viewPrivData() && item->viewPrivData()->m_requiredUpdate != NONE )
             {
@@ -1476,6 +1545,54 @@ void VIEW::UpdateItems()
 }
 
 
+void VIEW::prepareItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    // Below this the thread pool hand-off costs more than it saves
+    const size_t MIN_PARALLEL_ITEMS = 64;
+
+    if( !m_painter || aItems.size() < MIN_PARALLEL_ITEMS )
+        return;
+
+    PROF_TIMER              timer;
+    std::vector<VIEW_ITEM*> toRedraw;
+
+    // Only the items redrawn on a cached layer are drawn by invalidateItem(); the others only
+    // have their color or bbox updated, or are drawn on the fly by redrawRect().
+    for( VIEW_ITEM* item : aItems )
+    {
+        VIEW_ITEM_DATA* vpd = item->viewPrivData();
+
+        if( !( vpd->m_requiredUpdate & ( GEOMETRY | LAYERS | REPAINT | INITIAL_ADD ) ) )
+            continue;
+
+        int layers[VIEW_MAX_LAYERS], layers_count;
+        item->ViewGetLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            if( IsCached( layers[i] ) )
+            {
+                toRedraw.push_back( item );
+                break;
+            }
+        }
+    }
+
+    if( toRedraw.size() < MIN_PARALLEL_ITEMS )
+        return;
+
+    ParallelFor( toRedraw.size(),
+                 [&]( size_t aIdx )
+                 {
+                     m_painter->PrepareDraw( toRedraw[aIdx] );
+                 },
+                 nullptr, 16 );
+
+    KI_TRACE( traceGalProfile, "View prepare: %u of %u items in %0.3f ms\n",
+              (unsigned) toRedraw.size(), (unsigned) aItems.size(), timer.msecs() );
+}
+
+
 void VIEW::UpdateAllItems( int aUpdateFlags )
 {
     for( VIEW_ITEM* item : *m_allItems )
@@ -164,6 +164,7 @@ const std::string MacrosFileExtension( "mcr" );
 const std::string DrillFileExtension( "drl" );
 const std::string SVGFileExtension( "svg" );
 const std::string ReportFileExtension( "rpt" );
+const std::string JsonFileExtension( "json" );
 const std::string FootprintPlaceFileExtension( "pos" );
 
 const std::string KiCadFootprintLibPathExtension( "pretty" );   // this is a directory
@@ -462,9 +462,11 @@ void CONNECTION_GRAPH::Reset()
     m_bus_name_to_code_map.clear();
     m_net_code_to_subgraphs_map.clear();
     m_net_name_to_subgraphs_map.clear();
+    m_connection_key_map.clear();
     m_item_to_subgraph_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_tracked_items.clear();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
@@ -476,8 +478,31 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 {
     PROF_TIMER recalc_time( "CONNECTION_GRAPH::Recalculate" );
 
-    if( aUnconditional )
-        Reset();
+    if( aUnconditional || !recalculateAffected( aSheetList, aChangedItemHandler ) )
+        recalculateAll( aSheetList, aChangedItemHandler );
+
+    recalc_time.Stop();
+
+    if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
+        recalc_time.Show();
+
+#ifndef DEBUG
+    // Pressure relief valve for release builds
+    const double max_recalc_time_msecs = 250.;
+
+    if( m_allowRealTime && ADVANCED_CFG::GetCfg().m_RealTimeConnectivity &&
+        recalc_time.msecs() > max_recalc_time_msecs )
+    {
+        m_allowRealTime = false;
+    }
+#endif
+}
+
+
+void CONNECTION_GRAPH::recalculateAll( const SCH_SHEET_LIST& aSheetList,
+                                       std::function<void( SCH_ITEM* )>* aChangedItemHandler )
+{
+    Reset();
 
     PROF_TIMER update_items( "updateItemConnectivity" );
 
@@ -492,7 +517,7 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 
         for( SCH_ITEM* item : sheet.LastScreen()->Items() )
         {
-            if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
+            if( item->IsConnectable() )
                 items.push_back( item );
 
             // Ensure the hierarchy info stored in SCREENS is built and up to date
@@ -535,38 +560,728 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
 
     if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
         build_graph.Show();
+}
 
-    recalc_time.Stop();
+
+bool CONNECTION_GRAPH::recalculateAffected( const SCH_SHEET_LIST& aSheetList,
+                                            std::function<void( SCH_ITEM* )>* aChangedItemHandler )
+{
+    wxCHECK( m_schematic, false );
+
+    // Sheet paths are part of the names of local nets, so the hierarchy must be unchanged
+    if( m_tracked_items.empty() || aSheetList.size() != m_sheetList.size() )
+        return false;
+
+    for( size_t ii = 0; ii < aSheetList.size(); ++ii )
+    {
+        if( aSheetList[ii] != m_sheetList[ii] )
+            return false;
+    }
+
+    // And so must the bus aliases, which can change the members of any bus
+    std::unordered_set<BUS_ALIAS*> aliases;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        for( const std::shared_ptr<BUS_ALIAS>& alias : sheet.LastScreen()->GetBusAliases() )
+        {
+            auto it = m_bus_alias_cache.find( alias->GetName() );
+
+            if( it == m_bus_alias_cache.end() || it->second != alias )
+                return false;
+
+            aliases.insert( alias.get() );
+        }
+    }
+
+    if( aliases.size() != m_bus_alias_cache.size() )
+        return false;
+
+    PROF_TIMER find_changes( "findChangedItems" );
+
+    unsigned scan = ++m_last_scan;
+
+    std::unordered_set<SCH_SCREEN*>                         scannedScreens;
+    std::unordered_map<SCH_SCREEN*, std::vector<SCH_ITEM*>> changedItems;
+    std::vector<SCH_ITEM*>                                  removedItems;
+    size_t                                                  changedCount = 0;
+
+    // The graph items of changed and removed items.  They may have been deleted, so they are
+    // only ever compared against.
+    std::unordered_set<SCH_ITEM*> staleItems;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+
+        if( !scannedScreens.insert( screen ).second )
+            continue;
+
+        for( SCH_ITEM* item : screen->Items() )
+        {
+            if( !item->IsConnectable() )
+                continue;
+
+            auto it = m_tracked_items.find( item );
+            bool changed = item->IsConnectivityDirty();
+
+            if( it == m_tracked_items.end() )
+            {
+                changed = true;
+            }
+            else
+            {
+                it->second.m_Scan = scan;
+                changed |= it->second.m_Uuid != item->m_Uuid || it->second.m_Screen != screen;
+            }
+
+            if( item->Type() == SCH_SHEET_T )
+            {
+                for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+                    changed |= pin->IsConnectivityDirty();
+
+                // Sheets take part in the names of every net below them
+                if( changed )
+                    return false;
+            }
+
+            if( !changed )
+                continue;
+
+            changedItems[ screen ].push_back( item );
+            changedCount++;
+
+            if( it != m_tracked_items.end() )
+                staleItems.insert( it->second.m_GraphItems.begin(), it->second.m_GraphItems.end() );
+        }
+    }
+
+    std::unordered_set<SCH_SCREEN*> danglingScreens;
+
+    for( const auto& [ item, tracked ] : m_tracked_items )
+    {
+        if( tracked.m_Scan != scan )
+        {
+            removedItems.push_back( item );
+            danglingScreens.insert( tracked.m_Screen );
+            staleItems.insert( tracked.m_GraphItems.begin(), tracked.m_GraphItems.end() );
+        }
+    }
+
+    if( changedCount == 0 && removedItems.empty() )
+        return true;
+
+    // Rebuilding everything is quicker when most of the schematic changed (for instance after
+    // SCH_SCREEN::SetConnectivityDirty())
+    if( ( changedCount + removedItems.size() ) * 2 > m_tracked_items.size() )
+        return false;
+
+    for( const auto& [ screen, items ] : changedItems )
+        danglingScreens.insert( screen );
+
+    // Seed the recalculation with the subgraphs holding the stale items and the items the
+    // changed items now touch
+    std::unordered_set<SCH_ITEM*> seedItems( staleItems );
+
+    auto addNeighbor =
+            [&]( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet, const VECTOR2I& aPoint )
+            {
+                if( aItem->Type() == SCH_SYMBOL_T )
+                {
+                    for( SCH_PIN* pin : static_cast<SCH_SYMBOL*>( aItem )->GetPins( &aSheet ) )
+                    {
+                        if( pin->GetPosition() == aPoint )
+                            seedItems.insert( pin );
+                    }
+                }
+                else if( aItem->Type() == SCH_SHEET_T )
+                {
+                    for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( aItem )->GetPins() )
+                    {
+                        if( pin->GetTextPos() == aPoint )
+                            seedItems.insert( pin );
+                    }
+                }
+                else
+                {
+                    seedItems.insert( aItem );
+                }
+            };
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+        auto        it = changedItems.find( screen );
+
+        if( it == changedItems.end() )
+            continue;
+
+        for( SCH_ITEM* item : it->second )
+        {
+            for( const VECTOR2I& pt : item->GetConnectionPoints() )
+            {
+                for( SCH_ITEM* other : screen->Items().Overlapping( pt ) )
+                {
+                    if( other == item || !other->IsConnectable() )
+                        continue;
+
+                    if( other->IsConnected( pt )
+                            || ( other->Type() == SCH_LINE_T && other->HitTest( pt ) ) )
+                    {
+                        addNeighbor( other, sheet, pt );
+                    }
+                }
+
+                // Bus entries don't need to land on the end of a bus
+                if( item->Type() == SCH_BUS_WIRE_ENTRY_T || item->Type() == SCH_BUS_BUS_ENTRY_T )
+                {
+                    if( SCH_LINE* bus = screen->GetBus( pt ) )
+                        seedItems.insert( bus );
+                }
+            }
+
+            // Labels and bus entries can also connect to the middle of a line
+            if( item->Type() == SCH_LINE_T )
+            {
+                for( SCH_ITEM* other : screen->Items().Overlapping( item->GetBoundingBox() ) )
+                {
+                    if( other == item || !other->IsConnectable() )
+                        continue;
+
+                    for( const VECTOR2I& pt : other->GetConnectionPoints() )
+                    {
+                        if( item->HitTest( pt ) )
+                            addNeighbor( other, sheet, pt );
+                    }
+                }
+            }
+        }
+    }
 
     if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
-        recalc_time.Show();
+        find_changes.Show();
 
-#ifndef DEBUG
-    // Pressure relief valve for release builds
-    const double max_recalc_time_msecs = 250.;
+    PROF_TIMER find_affected( "findAffectedSubgraphs" );
 
-    if( m_allowRealTime && ADVANCED_CFG::GetCfg().m_RealTimeConnectivity &&
-        recalc_time.msecs() > max_recalc_time_msecs )
+    // Subgraphs can also be joined by name: labels, power pins, sheet pins and bus members.
+    // They are found through m_connection_key_map.
+    std::unordered_set<wxString>                                    visitedKeys;
+    std::unordered_set<CONNECTION_SUBGRAPH*>                        affected;
+    std::vector<CONNECTION_SUBGRAPH*>                               queue;
+    std::vector<wxString>                                           keys;
+
+    auto addSubgraph =
+            [&]( CONNECTION_SUBGRAPH* aSubgraph )
+            {
+                if( aSubgraph && affected.insert( aSubgraph ).second )
+                    queue.push_back( aSubgraph );
+            };
+
+    auto addKeys =
+            [&]()
+            {
+                for( const wxString& key : keys )
+                {
+                    if( !visitedKeys.insert( key ).second )
+                        continue;
+
+                    auto it = m_connection_key_map.find( key );
+
+                    if( it != m_connection_key_map.end() )
+                    {
+                        for( CONNECTION_SUBGRAPH* subgraph : it->second )
+                            addSubgraph( subgraph );
+                    }
+                }
+
+                keys.clear();
+            };
+
+    auto addNet =
+            [&]( const wxString& aName )
+            {
+                auto it = m_net_name_to_subgraphs_map.find( aName );
+
+                if( it != m_net_name_to_subgraphs_map.end() )
+                {
+                    for( CONNECTION_SUBGRAPH* subgraph : it->second )
+                        addSubgraph( subgraph );
+                }
+            };
+
+    // The driver of a subgraph may have been deleted, but all its items share its connection
+    auto liveConnection =
+            [&]( CONNECTION_SUBGRAPH* aSubgraph ) -> SCH_CONNECTION*
+            {
+                if( aSubgraph->m_absorbed )
+                    return nullptr;
+
+                if( aSubgraph->m_driver && !staleItems.count( aSubgraph->m_driver ) )
+                    return aSubgraph->m_driver_connection;
+
+                for( SCH_ITEM* item : aSubgraph->m_items )
+                {
+                    if( !staleItems.count( item ) )
+                    {
+                        if( SCH_CONNECTION* connection = item->Connection( &aSubgraph->m_sheet ) )
+                            return connection;
+                    }
+                }
+
+                return nullptr;
+            };
+
+    size_t totalItemCount = 0;
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
     {
-        m_allowRealTime = false;
+        if( !subgraph->m_absorbed )
+            totalItemCount += subgraph->m_items.size();
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( seedItems.count( item ) )
+                addSubgraph( subgraph );
+        }
     }
-#endif
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        auto it = changedItems.find( sheet.LastScreen() );
+
+        if( it == changedItems.end() )
+            continue;
+
+        for( SCH_ITEM* item : it->second )
+            collectConnectionKeys( item, sheet, keys );
+
+        addKeys();
+    }
+
+    while( !queue.empty() )
+    {
+        CONNECTION_SUBGRAPH* subgraph = queue.back();
+        queue.pop_back();
+
+        addSubgraph( subgraph->m_absorbed_by );
+        addSubgraph( subgraph->m_hier_parent );
+
+        for( const auto& [ member, neighbors ] : subgraph->m_bus_neighbors )
+        {
+            for( CONNECTION_SUBGRAPH* neighbor : neighbors )
+                addSubgraph( neighbor );
+        }
+
+        for( const auto& [ member, parents ] : subgraph->m_bus_parents )
+        {
+            for( CONNECTION_SUBGRAPH* parent : parents )
+                addSubgraph( parent );
+        }
+
+        // The rest of the net, wherever it is in the hierarchy
+        if( SCH_CONNECTION* connection = liveConnection( subgraph ) )
+        {
+            addNet( connection->Name() );
+
+            for( const std::shared_ptr<SCH_CONNECTION>& member : connection->AllMembers() )
+                addNet( member->Name() );
+        }
+
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( !staleItems.count( item ) )
+                collectConnectionKeys( item, subgraph->m_sheet, keys );
+        }
+
+        // Names of drivers which may no longer exist
+        for( const auto& [ driver, name ] : subgraph->m_driver_name_cache )
+            collectNameKeys( name, keys );
+
+        addKeys();
+    }
+
+    // Absorbed subgraphs go along with the subgraph which absorbed them
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        CONNECTION_SUBGRAPH* absorber = subgraph->m_absorbed_by;
+
+        while( absorber && absorber->m_absorbed_by )
+            absorber = absorber->m_absorbed_by;
+
+        if( absorber && affected.count( absorber ) )
+            affected.insert( subgraph );
+    }
+
+    size_t affectedItemCount = 0;
+
+    for( CONNECTION_SUBGRAPH* subgraph : affected )
+    {
+        if( !subgraph->m_absorbed )
+            affectedItemCount += subgraph->m_items.size();
+    }
+
+    if( affectedItemCount * 2 > totalItemCount )
+        return false;
+
+    // Collect the live items of the affected subgraphs, on the sheets they are affected on
+    std::unordered_set<long>           affectedCodes;
+    std::unordered_set<SCH_SHEET_PATH> sheets( aSheetList.begin(), aSheetList.end() );
+    std::unordered_set<SCH_ITEM*>      removedGraphItems( staleItems );
+
+    std::unordered_map<SCH_SHEET_PATH, std::vector<SCH_ITEM*>> sheetItems;
+
+    for( CONNECTION_SUBGRAPH* subgraph : affected )
+        affectedCodes.insert( subgraph->m_code );
+
+    for( CONNECTION_SUBGRAPH* subgraph : affected )
+    {
+        for( SCH_ITEM* item : subgraph->m_items )
+        {
+            if( staleItems.count( item ) || !removedGraphItems.insert( item ).second )
+                continue;
+
+            for( const auto& [ sheet, connection ] : item->m_connection_map )
+            {
+                if( affectedCodes.count( connection->SubgraphCode() ) && sheets.count( sheet ) )
+                    sheetItems[ sheet ].push_back( item );
+            }
+        }
+    }
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        auto it = changedItems.find( sheet.LastScreen() );
+
+        if( it != changedItems.end() )
+        {
+            std::vector<SCH_ITEM*>& items = sheetItems[ sheet ];
+            items.insert( items.end(), it->second.begin(), it->second.end() );
+        }
+    }
+
+    wxLogTrace( ConnTrace, "Recalculating %zu of %zu subgraphs for %zu changed and %zu removed "
+                           "items", affected.size(), m_subgraphs.size(), changedCount,
+                removedItems.size() );
+
+    if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
+        find_affected.Show();
+
+    // The net class assignments of the affected nets are made again when they are rebuilt
+    std::shared_ptr<NET_SETTINGS>& netSettings = m_schematic->Prj().GetProjectFile().m_NetSettings;
+
+    for( CONNECTION_SUBGRAPH* subgraph : affected )
+    {
+        if( SCH_CONNECTION* connection = liveConnection( subgraph ) )
+        {
+            netSettings->m_NetClassLabelAssignments.erase( connection->Name() );
+
+            for( const std::shared_ptr<SCH_CONNECTION>& member : connection->AllMembers() )
+                netSettings->m_NetClassLabelAssignments.erase( member->Name() );
+        }
+    }
+
+    for( SCH_ITEM* item : removedItems )
+        m_tracked_items.erase( item );
+
+    for( const auto& [ screen, items ] : changedItems )
+    {
+        for( SCH_ITEM* item : items )
+            m_tracked_items.erase( item );
+    }
+
+    removeSubgraphs( affected, removedGraphItems );
+
+    PROF_TIMER update_items( "updateItemConnectivity" );
+
+    // Build the affected part of the schematic on its own, using our net codes so that the
+    // nets which are rebuilt keep them
+    CONNECTION_GRAPH partial( m_schematic );
+
+    partial.m_sheetList = aSheetList;
+    std::swap( partial.m_net_name_to_code_map, m_net_name_to_code_map );
+    std::swap( partial.m_bus_name_to_code_map, m_bus_name_to_code_map );
+    partial.m_last_net_code = m_last_net_code;
+    partial.m_last_bus_code = m_last_bus_code;
+    partial.m_last_subgraph_code = m_last_subgraph_code;
+
+    for( const SCH_SHEET_PATH& sheet : aSheetList )
+    {
+        SCH_SCREEN* screen = sheet.LastScreen();
+        auto        it = sheetItems.find( sheet );
+
+        // Store current unit value, to regenerate it after calculations
+        std::vector<std::pair<SCH_SYMBOL*, int>> symbolsChanged;
+
+        if( it != sheetItems.end() )
+        {
+            for( SCH_ITEM* item : it->second )
+            {
+                SCH_SYMBOL* symbol = nullptr;
+
+                if( item->Type() == SCH_SYMBOL_T )
+                    symbol = static_cast<SCH_SYMBOL*>( item );
+                else if( item->Type() == SCH_PIN_T )
+                    symbol = static_cast<SCH_PIN*>( item )->GetParentSymbol();
+
+                if( symbol )
+                {
+                    int new_unit = symbol->GetUnitSelection( &sheet );
+
+                    if( symbol->GetUnit() != new_unit )
+                        symbolsChanged.push_back( { symbol, symbol->GetUnit() } );
+
+                    symbol->UpdateUnit( new_unit );
+                }
+            }
+
+            partial.updateItemConnectivity( sheet, it->second );
+        }
+
+        // UpdateDanglingState() also adds connected items for SCH_TEXT
+        if( it != sheetItems.end() || danglingScreens.count( screen ) )
+            screen->TestDanglingEnds( &sheet, aChangedItemHandler );
+
+        for( auto& item : symbolsChanged )
+            item.first->UpdateUnit( item.second );
+    }
+
+    if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
+        update_items.Show();
+
+    PROF_TIMER build_graph( "buildConnectionGraph" );
+
+    partial.buildConnectionGraph( aChangedItemHandler, false );
+
+    merge( partial );
+
+    if( wxLog::IsAllowedTraceMask( ConnProfileMask ) )
+        build_graph.Show();
+
+    return true;
 }
 
 
-void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
-                                               const std::vector<SCH_ITEM*>& aItemList )
+void CONNECTION_GRAPH::collectNameKeys( const wxString& aName, std::vector<wxString>& aKeys )
 {
-    std::map<VECTOR2I, std::vector<SCH_ITEM*>> connection_map;
+    if( aName.IsEmpty() )
+        return;
 
-    for( SCH_ITEM* item : aItemList )
+    // Bus members are matched to nets by their local names
+    if( SCH_CONNECTION::MightBeBusLabel( aName ) || GetBusAlias( aName ) )
     {
-        std::vector<VECTOR2I> points = item->GetConnectionPoints();
-        item->ConnectedItems( aSheet ).clear();
+        SCH_CONNECTION connection( this );
+        connection.ConfigureFromLabel( aName );
 
-        if( item->Type() == SCH_SHEET_T )
+        aKeys.push_back( connection.Name( true ) );
+
+        for( const std::shared_ptr<SCH_CONNECTION>& member : connection.AllMembers() )
+            aKeys.push_back( member->Name( true ) );
+    }
+    else
+    {
+        aKeys.push_back( aName );
+    }
+}
+
+
+void CONNECTION_GRAPH::collectConnectionKeys( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet,
+                                              std::vector<wxString>& aKeys )
+{
+    switch( aItem->Type() )
+    {
+    case SCH_SYMBOL_T:
+        for( SCH_PIN* pin : static_cast<SCH_SYMBOL*>( aItem )->GetPins( &aSheet ) )
+            collectConnectionKeys( pin, aSheet, aKeys );
+
+        break;
+
+    case SCH_SHEET_T:
+        for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( aItem )->GetPins() )
+            collectConnectionKeys( pin, aSheet, aKeys );
+
+        break;
+
+    case SCH_PIN_T:
+    {
+        SCH_PIN* pin = static_cast<SCH_PIN*>( aItem );
+
+        // Other pins only ever drive nets named after themselves
+        if( pin->IsPowerConnection() )
+            collectNameKeys( pin->GetDefaultNetName( aSheet ), aKeys );
+
+        break;
+    }
+
+    case SCH_LABEL_T:
+    case SCH_GLOBAL_LABEL_T:
+    case SCH_HIER_LABEL_T:
+    case SCH_SHEET_PIN_T:
+        collectNameKeys( EscapeString( static_cast<SCH_TEXT*>( aItem )->GetShownText(),
+                                       CTX_NETNAME ), aKeys );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void CONNECTION_GRAPH::removeSubgraphs( const std::unordered_set<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                                        const std::unordered_set<SCH_ITEM*>& aItems )
+{
+    auto isRemoved =
+            [&]( const CONNECTION_SUBGRAPH* aSubgraph ) -> bool
+            {
+                return aSubgraphs.count( const_cast<CONNECTION_SUBGRAPH*>( aSubgraph ) ) > 0;
+            };
+
+    auto purge =
+            [&]( auto& aMap )
+            {
+                for( auto it = aMap.begin(); it != aMap.end(); )
+                {
+                    alg::delete_if( it->second, isRemoved );
+
+                    if( it->second.empty() )
+                        it = aMap.erase( it );
+                    else
+                        ++it;
+                }
+            };
+
+    alg::delete_if( m_items,
+                    [&]( SCH_ITEM* aItem ) -> bool
+                    {
+                        return aItems.count( aItem ) > 0;
+                    } );
+
+    alg::delete_if( m_invisible_power_pins,
+                    [&]( const std::pair<SCH_SHEET_PATH, SCH_PIN*>& aPin ) -> bool
+                    {
+                        return aItems.count( aPin.second ) > 0;
+                    } );
+
+    alg::delete_if( m_subgraphs, isRemoved );
+    alg::delete_if( m_driver_subgraphs, isRemoved );
+
+    purge( m_sheet_to_subgraphs_map );
+    purge( m_net_name_to_subgraphs_map );
+    purge( m_net_code_to_subgraphs_map );
+    purge( m_connection_key_map );
+    purge( m_local_label_cache );
+    purge( m_global_label_cache );
+
+    for( auto it = m_item_to_subgraph_map.begin(); it != m_item_to_subgraph_map.end(); )
+    {
+        if( isRemoved( it->second ) )
+            it = m_item_to_subgraph_map.erase( it );
+        else
+            ++it;
+    }
+
+    // The remaining subgraphs should not link to removed ones, but make sure no pointers dangle
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        if( isRemoved( subgraph->m_hier_parent ) )
+            subgraph->m_hier_parent = nullptr;
+
+        for( auto& [ member, neighbors ] : subgraph->m_bus_neighbors )
         {
-            for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            for( CONNECTION_SUBGRAPH* removed : aSubgraphs )
+                neighbors.erase( removed );
+        }
+
+        for( auto& [ member, parents ] : subgraph->m_bus_parents )
+        {
+            for( CONNECTION_SUBGRAPH* removed : aSubgraphs )
+                parents.erase( removed );
+        }
+    }
+
+    for( CONNECTION_SUBGRAPH* subgraph : aSubgraphs )
+        delete subgraph;
+}
+
+
+void CONNECTION_GRAPH::merge( CONNECTION_GRAPH& aGraph )
+{
+    auto setGraph =
+            [&]( SCH_CONNECTION* aConnection )
+            {
+                aConnection->SetGraph( this );
+
+                for( const std::shared_ptr<SCH_CONNECTION>& member : aConnection->AllMembers() )
+                    member->SetGraph( this );
+            };
+
+    auto append =
+            []( auto& aTo, const auto& aFrom )
+            {
+                aTo.insert( aTo.end(), aFrom.begin(), aFrom.end() );
+            };
+
+    auto appendMap =
+            [&]( auto& aTo, const auto& aFrom )
+            {
+                for( const auto& [ key, value ] : aFrom )
+                    append( aTo[ key ], value );
+            };
+
+    for( SCH_ITEM* item : aGraph.m_items )
+    {
+        for( const auto& [ sheet, connection ] : item->m_connection_map )
+            setGraph( connection );
+    }
+
+    for( CONNECTION_SUBGRAPH* subgraph : aGraph.m_subgraphs )
+    {
+        subgraph->m_graph = this;
+
+        for( const auto& [ member, neighbors ] : subgraph->m_bus_neighbors )
+            setGraph( member.get() );
+
+        for( const auto& [ member, parents ] : subgraph->m_bus_parents )
+            setGraph( member.get() );
+    }
+
+    append( m_items, aGraph.m_items );
+    append( m_subgraphs, aGraph.m_subgraphs );
+    append( m_driver_subgraphs, aGraph.m_driver_subgraphs );
+    append( m_invisible_power_pins, aGraph.m_invisible_power_pins );
+
+    appendMap( m_sheet_to_subgraphs_map, aGraph.m_sheet_to_subgraphs_map );
+    appendMap( m_net_name_to_subgraphs_map, aGraph.m_net_name_to_subgraphs_map );
+    appendMap( m_net_code_to_subgraphs_map, aGraph.m_net_code_to_subgraphs_map );
+    appendMap( m_connection_key_map, aGraph.m_connection_key_map );
+    appendMap( m_local_label_cache, aGraph.m_local_label_cache );
+    appendMap( m_global_label_cache, aGraph.m_global_label_cache );
+
+    for( const auto& [ item, subgraph ] : aGraph.m_item_to_subgraph_map )
+        m_item_to_subgraph_map[ item ] = subgraph;
+
+    for( auto& [ item, tracked ] : aGraph.m_tracked_items )
+        m_tracked_items[ item ] = std::move( tracked );
+
+    // aGraph started from our net codes, so it has all of them
+    std::swap( m_net_name_to_code_map, aGraph.m_net_name_to_code_map );
+    std::swap( m_bus_name_to_code_map, aGraph.m_bus_name_to_code_map );
+    m_last_net_code = aGraph.m_last_net_code;
+    m_last_bus_code = aGraph.m_last_bus_code;
+    m_last_subgraph_code = aGraph.m_last_subgraph_code;
+
+    // The subgraphs are ours now
+    aGraph.m_subgraphs.clear();
+    aGraph.Reset();
+}
+
+
+void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
+                                               const std::vector<SCH_ITEM*>& aItemList )
+{
+    std::map<VECTOR2I, std::vector<SCH_ITEM*>> connection_map;
+
+    auto addSheetPin =
+            [&]( SCH_SHEET_PIN* pin )
             {
                 pin->InitializeConnection( aSheet, this );
 
@@ -574,13 +1289,10 @@ void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
 
                 connection_map[ pin->GetTextPos() ].push_back( pin );
                 m_items.emplace_back( pin );
-            }
-        }
-        else if( item->Type() == SCH_SYMBOL_T )
-        {
-            SCH_SYMBOL* symbol = static_cast<SCH_SYMBOL*>( item );
+            };
 
-            for( SCH_PIN* pin : symbol->GetPins( &aSheet ) )
+    auto addSymbolPin =
+            [&]( SCH_PIN* pin )
             {
                 pin->InitializeConnection( aSheet, this );
 
@@ -597,10 +1309,60 @@ void CONNECTION_GRAPH::updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
 
                 connection_map[ pos ].push_back( pin );
                 m_items.emplace_back( pin );
+            };
+
+    auto trackItem =
+            [&]( SCH_ITEM* aItem, SCH_ITEM* aGraphItem )
+            {
+                TRACKED_ITEM& tracked = m_tracked_items[ aItem ];
+
+                tracked.m_Uuid = aItem->m_Uuid;
+                tracked.m_Screen = aSheet.LastScreen();
+
+                if( aGraphItem && !alg::contains( tracked.m_GraphItems, aGraphItem ) )
+                    tracked.m_GraphItems.push_back( aGraphItem );
+            };
+
+    for( SCH_ITEM* item : aItemList )
+    {
+        std::vector<VECTOR2I> points = item->GetConnectionPoints();
+        item->ConnectedItems( aSheet ).clear();
+
+        if( item->Type() == SCH_SHEET_T )
+        {
+            trackItem( item, nullptr );
+
+            for( SCH_SHEET_PIN* pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            {
+                addSheetPin( pin );
+                trackItem( item, pin );
+            }
+        }
+        else if( item->Type() == SCH_SYMBOL_T )
+        {
+            SCH_SYMBOL* symbol = static_cast<SCH_SYMBOL*>( item );
+
+            trackItem( item, nullptr );
+
+            for( SCH_PIN* pin : symbol->GetPins( &aSheet ) )
+            {
+                addSymbolPin( pin );
+                trackItem( item, pin );
             }
         }
+        else if( item->Type() == SCH_SHEET_PIN_T )
+        {
+            // Pins are only passed on their own when part of the graph is recalculated
+            addSheetPin( static_cast<SCH_SHEET_PIN*>( item ) );
+        }
+        else if( item->Type() == SCH_PIN_T )
+        {
+            addSymbolPin( static_cast<SCH_PIN*>( item ) );
+        }
         else
         {
+            trackItem( item, item );
+
             m_items.emplace_back( item );
             SCH_CONNECTION* conn = item->InitializeConnection( aSheet, this );
 
@@ -1411,7 +2173,8 @@ void CONNECTION_GRAPH::processSubGraphs()
 //     on some portion of the items.
 
 
-void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* aChangedItemHandler )
+void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* aChangedItemHandler,
+                                             bool aUnconditional )
 {
     // Recache all bus aliases for later use
     wxCHECK_RET( m_schematic, wxT( "Connection graph cannot be built without schematic pointer" ) );
@@ -1685,10 +2448,34 @@ void CONNECTION_GRAPH::buildConnectionGraph( std::function<void( SCH_ITEM* )>* a
         m_net_name_to_subgraphs_map[subgraph->m_driver_connection->Name()].push_back( subgraph );
     }
 
+    m_connection_key_map.clear();
+
+    std::vector<wxString> keys;
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+    {
+        if( subgraph->m_absorbed )
+            continue;
+
+        for( SCH_ITEM* item : subgraph->m_items )
+            collectConnectionKeys( item, subgraph->m_sheet, keys );
+
+        for( const wxString& key : keys )
+        {
+            std::vector<CONNECTION_SUBGRAPH*>& indexed = m_connection_key_map[ key ];
+
+            if( indexed.empty() || indexed.back() != subgraph )
+                indexed.push_back( subgraph );
+        }
+
+        keys.clear();
+    }
+
     std::shared_ptr<NET_SETTINGS>& netSettings = m_schematic->Prj().GetProjectFile().m_NetSettings;
     std::map<wxString, wxString>   oldAssignments = netSettings->m_NetClassLabelAssignments;
 
-    netSettings->m_NetClassLabelAssignments.clear();
+    if( aUnconditional )
+        netSettings->m_NetClassLabelAssignments.clear();
 
     auto dirtySubgraphs =
             [&]( const std::vector<CONNECTION_SUBGRAPH*>& subgraphs )
@@ -23,6 +23,7 @@
 #define _CONNECTION_GRAPH_H
 
 #include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <erc_settings.h>
@@ -41,6 +42,7 @@ class SCHEMATIC;
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -276,6 +278,7 @@ public:
               m_last_net_code( 1 ),
               m_last_bus_code( 1 ),
               m_last_subgraph_code( 1 ),
+              m_last_scan( 0 ),
               m_schematic( aSchematic )
     {}
 
@@ -294,6 +297,11 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless \a aUnconditional is set, only the subgraphs affected by items which were added,
+     * removed or marked connectivity dirty since the last update are recalculated, along with
+     * every subgraph they may share a net with.  A full recalculation is done instead if the
+     * hierarchy or the bus aliases changed, or if most of the graph would be recalculated anyway.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      * @param aChangedItemHandler an optional handler to receive any changed items
@@ -386,6 +394,48 @@ private:
     void updateItemConnectivity( const SCH_SHEET_PATH& aSheet,
                                  const std::vector<SCH_ITEM*>& aItemList );
 
+    /**
+     * Rebuild the graph from all the connectable items of \a aSheetList.
+     */
+    void recalculateAll( const SCH_SHEET_LIST& aSheetList,
+                         std::function<void( SCH_ITEM* )>* aChangedItemHandler );
+
+    /**
+     * Recalculate only the subgraphs affected by the items which changed since the last update.
+     *
+     * The affected subgraphs are removed from the graph, their items are rebuilt into a
+     * separate graph along with the changed items, and the result is merged back in.
+     *
+     * @return false (without modifying the graph) if a full recalculation is needed instead.
+     */
+    bool recalculateAffected( const SCH_SHEET_LIST& aSheetList,
+                              std::function<void( SCH_ITEM* )>* aChangedItemHandler );
+
+    /**
+     * Add the names through which \a aItem can connect to items it doesn't touch (label text,
+     * power pin names and the members of the buses they name) to \a aKeys.
+     */
+    void collectConnectionKeys( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet,
+                                std::vector<wxString>& aKeys );
+
+    /**
+     * Add the net names a driver called \a aName can connect to, which are all the members of
+     * \a aName if it is a bus, to \a aKeys.
+     */
+    void collectNameKeys( const wxString& aName, std::vector<wxString>& aKeys );
+
+    /**
+     * Delete \a aSubgraphs and remove them and \a aItems from all the caches.
+     */
+    void removeSubgraphs( const std::unordered_set<CONNECTION_SUBGRAPH*>& aSubgraphs,
+                          const std::unordered_set<SCH_ITEM*>& aItems );
+
+    /**
+     * Take over the items and subgraphs of \a aGraph, which was built from items which aren't
+     * part of this graph.  \a aGraph is left empty.
+     */
+    void merge( CONNECTION_GRAPH& aGraph );
+
     /**
      * Generates the connection graph (after all item connectivity has been updated)
      *
@@ -398,8 +448,12 @@ private:
      * the driver is first selected by CONNECTION_SUBGRAPH::ResolveDrivers(),
      * and then the connection for the chosen driver is propagated to all the
      * other items in the subgraph.
+     *
+     * @param aUnconditional is false if the graph only holds part of the schematic, in which
+     *                       case the net class assignments of other nets are left alone.
      */
-    void buildConnectionGraph( std::function<void( SCH_ITEM* )>* aChangedItemHandler );
+    void buildConnectionGraph( std::function<void( SCH_ITEM* )>* aChangedItemHandler,
+                               bool aUnconditional = true );
 
     /**
      * Generates individual item subgraphs on a per-sheet basis
@@ -605,6 +659,10 @@ private:
 
     std::unordered_map<wxString, std::vector<CONNECTION_SUBGRAPH*>> m_net_name_to_subgraphs_map;
 
+    // The (unabsorbed) subgraphs by the names their items can connect through, see
+    // collectConnectionKeys().  Kept up to date for recalculateAffected().
+    std::unordered_map<wxString, std::vector<CONNECTION_SUBGRAPH*>> m_connection_key_map;
+
     std::unordered_map<SCH_ITEM*, CONNECTION_SUBGRAPH*> m_item_to_subgraph_map;
 
     NET_MAP m_net_code_to_subgraphs_map;
@@ -615,6 +673,21 @@ private:
 
     int m_last_subgraph_code;
 
+    /// The graph items (itself, or its pins) of a connectable item on a sheet
+    struct TRACKED_ITEM
+    {
+        KIID                   m_Uuid;
+        SCH_SCREEN*            m_Screen = nullptr;
+        std::vector<SCH_ITEM*> m_GraphItems;
+        unsigned               m_Scan = 0;
+    };
+
+    /// Every connectable screen item in the graph, used to find what changed since the last
+    /// update.  Removed items are only ever used as keys.
+    std::unordered_map<SCH_ITEM*, TRACKED_ITEM> m_tracked_items;
+
+    unsigned m_last_scan;
+
     SCHEMATIC* m_schematic;     ///< The schematic this graph represents
 };
 
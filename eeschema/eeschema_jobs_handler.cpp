@@ -26,12 +26,14 @@
 #include <jobs/job_export_sch_svg.h>
 #include <jobs/job_sym_export_svg.h>
 #include <jobs/job_sym_upgrade.h>
+#include <jobs/job_sch_erc.h>
 #include <pgm_base.h>
 #include <sch_plotter.h>
 #include <schematic.h>
 #include <wx/crt.h>
 #include <wx/dir.h>
 #include <wx/file.h>
+#include <wx/ffile.h>
 #include <memory>
 #include <connection_graph.h>
 #include "eeschema_helpers.h"
@@ -54,6 +56,12 @@
 #include <netlist_exporter_spice_model.h>
 #include <netlist_exporter_kicad.h>
 #include <netlist_exporter_xml.h>
+#include <build_version.h>
+#include <erc_item.h>
+#include <sch_marker.h>
+#include <string_utils.h>
+#include <thread_pool.h>
+#include <nlohmann/json.hpp>
 
 
 EESCHEMA_JOBS_HANDLER::EESCHEMA_JOBS_HANDLER()
@@ -70,6 +78,8 @@ EESCHEMA_JOBS_HANDLER::EESCHEMA_JOBS_HANDLER()
               std::bind( &EESCHEMA_JOBS_HANDLER::JobSymUpgrade, this, std::placeholders::_1 ) );
     Register( "symsvg",
               std::bind( &EESCHEMA_JOBS_HANDLER::JobSymExportSvg, this, std::placeholders::_1 ) );
+    Register( "erc",
+              std::bind( &EESCHEMA_JOBS_HANDLER::JobRunErc, this, std::placeholders::_1 ) );
 }
 
 
@@ -535,3 +545,263 @@ int EESCHEMA_JOBS_HANDLER::JobSymUpgrade( JOB* aJob )
 
     return CLI::EXIT_CODES::OK;
 }
+
+
+int EESCHEMA_JOBS_HANDLER::JobRunErc( JOB* aJob )
+{
+    JOB_SCH_ERC* ercJob = dynamic_cast<JOB_SCH_ERC*>( aJob );
+
+    if( !ercJob )
+        return CLI::EXIT_CODES::ERR_UNKNOWN;
+
+    // Each kiface has its own pool, so the thread count must be applied from here
+    if( ercJob->m_threads > 0 )
+        GetKiCadThreadPool().reset( ercJob->m_threads );
+
+    if( aJob->IsCli() )
+        wxPrintf( _( "Loading schematic\n" ) );
+
+    SCHEMATIC* sch = EESCHEMA_HELPERS::LoadSchematic( ercJob->m_filename, SCH_IO_MGR::SCH_KICAD );
+
+    if( sch == nullptr )
+    {
+        wxFprintf( stderr, _( "Failed to load schematic file\n" ) );
+        return CLI::EXIT_CODES::ERR_INVALID_INPUT_FILE;
+    }
+
+    if( ercJob->m_outputFile.IsEmpty() )
+    {
+        wxFileName fn = sch->GetFileName();
+        fn.SetName( fn.GetName() + wxS( "-erc" ) );
+
+        if( ercJob->m_format == JOB_SCH_ERC::OUTPUT_FORMAT::JSON )
+            fn.SetExt( JsonFileExtension );
+        else
+            fn.SetExt( ReportFileExtension );
+
+        ercJob->m_outputFile = fn.GetFullName();
+    }
+
+    EDA_UNITS   units;
+    std::string unitsName;
+
+    switch( ercJob->m_units )
+    {
+    case JOB_SCH_ERC::UNITS::INCHES: units = EDA_UNITS::INCHES;      unitsName = "in";   break;
+    case JOB_SCH_ERC::UNITS::MILS:   units = EDA_UNITS::MILS;        unitsName = "mils"; break;
+    default:                         units = EDA_UNITS::MILLIMETRES; unitsName = "mm";   break;
+    }
+
+    if( aJob->IsCli() )
+        wxPrintf( _( "Running ERC\n" ) );
+
+    // This follows DIALOG_ERC::testErc(), minus the parts that need a frame or a canvas
+    sch->GetSheets().AnnotatePowerSymbols();
+
+    SCH_REFERENCE_LIST referenceList;
+    sch->GetSheets().GetSymbols( referenceList );
+
+    referenceList.CheckAnnotation(
+            []( ERCE_T aType, const wxString& aMsg, SCH_REFERENCE* aItemA, SCH_REFERENCE* aItemB )
+            {
+                std::shared_ptr<ERC_ITEM> ercItem = ERC_ITEM::Create( aType );
+                ercItem->SetErrorMessage( aMsg );
+
+                if( aItemB )
+                    ercItem->SetItems( aItemA->GetSymbol(), aItemB->GetSymbol() );
+                else
+                    ercItem->SetItems( aItemA->GetSymbol() );
+
+                SCH_MARKER* marker = new SCH_MARKER( ercItem, aItemA->GetSymbol()->GetPosition() );
+                aItemA->GetSheetPath().LastScreen()->Append( marker );
+            } );
+
+    ERC_SETTINGS& settings = sch->ErcSettings();
+    ERC_TESTER    tester( sch );
+
+    if( settings.IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
+        tester.TestDuplicateSheetNames( true );
+
+    if( settings.IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
+        tester.TestConflictingBusAliases();
+
+    sch->ConnectionGraph()->RunERC();
+
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
+        tester.TestMultiunitFootprints();
+
+    if( settings.IsTestEnabled( ERCE_MISSING_UNIT )
+            || settings.IsTestEnabled( ERCE_MISSING_INPUT_PIN )
+            || settings.IsTestEnabled( ERCE_MISSING_POWER_INPUT_PIN )
+            || settings.IsTestEnabled( ERCE_MISSING_BIDI_PIN ) )
+    {
+        tester.TestMissingUnits();
+    }
+
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
+        tester.TestMultUnitPinConflicts();
+
+    if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_ERROR )
+            || settings.IsTestEnabled( ERCE_POWERPIN_NOT_DRIVEN )
+            || settings.IsTestEnabled( ERCE_PIN_NOT_DRIVEN ) )
+    {
+        tester.TestPinToPin();
+    }
+
+    if( settings.IsTestEnabled( ERCE_SIMILAR_LABELS ) )
+        tester.TestSimilarLabels();
+
+    // There is no drawing sheet view without a canvas, so only the schematic items are tested
+    if( settings.IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
+        tester.TestTextVars( nullptr );
+
+    if( settings.IsTestEnabled( ERCE_SIMULATION_MODEL ) )
+        tester.TestSimModelIssues();
+
+    if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED ) )
+        tester.TestNoConnectPins();
+
+    if( settings.IsTestEnabled( ERCE_LIB_SYMBOL_ISSUES ) )
+        tester.TestLibSymbolIssues();
+
+    // No canvas means no user grid; use the default schematic grid
+    if( settings.IsTestEnabled( ERCE_ENDPOINT_OFF_GRID ) )
+        tester.TestOffGridEndpoints( schIUScale.MilsToIU( 50 ) );
+
+    // Flag excluded markers.  Exclusions which no longer match a violation aren't reported.
+    for( SCH_MARKER* orphan : sch->ResolveERCExclusions() )
+        delete orphan;
+
+    UNITS_PROVIDER            unitsProvider( schIUScale, units );
+    std::map<KIID, EDA_ITEM*> itemMap;
+    SCH_SHEET_LIST            sheetList = sch->GetSheets();
+
+    sheetList.FillItemMap( itemMap );
+
+    int errors = 0;
+    int warnings = 0;
+
+    // Returns the markers of a sheet to report, updating the error and warning counts
+    auto reportedMarkers =
+            [&]( const SCH_SHEET_PATH& aSheet ) -> std::vector<SCH_MARKER*>
+            {
+                std::vector<SCH_MARKER*> markers;
+
+                for( SCH_ITEM* item : aSheet.LastScreen()->Items().OfType( SCH_MARKER_T ) )
+                {
+                    SCH_MARKER* marker = static_cast<SCH_MARKER*>( item );
+
+                    if( marker->GetMarkerType() != MARKER_BASE::MARKER_ERC )
+                        continue;
+
+                    SEVERITY severity = marker->IsExcluded()
+                                            ? RPT_SEVERITY_EXCLUSION
+                                            : settings.GetSeverity( marker->GetRCItem()->GetErrorCode() );
+
+                    if( !( severity & ercJob->m_severity ) )
+                        continue;
+
+                    if( severity == RPT_SEVERITY_ERROR )
+                        errors++;
+                    else if( severity == RPT_SEVERITY_WARNING )
+                        warnings++;
+
+                    markers.push_back( marker );
+                }
+
+                return markers;
+            };
+
+    auto markerSeverity =
+            [&]( const SCH_MARKER* aMarker ) -> SEVERITY
+            {
+                if( aMarker->IsExcluded() )
+                    return RPT_SEVERITY_EXCLUSION;
+
+                return settings.GetSeverity( aMarker->GetRCItem()->GetErrorCode() );
+            };
+
+    wxFFile file( ercJob->m_outputFile, wxT( "wt" ) );
+
+    if( !file.IsOpened() )
+    {
+        wxFprintf( stderr, _( "Unable to open report file %s\n" ), ercJob->m_outputFile );
+        return CLI::EXIT_CODES::ERR_INVALID_OUTPUT_CONFLICT;
+    }
+
+    if( ercJob->m_format == JOB_SCH_ERC::OUTPUT_FORMAT::JSON )
+    {
+        nlohmann::json report;
+
+        report["$schema"] = "https://schemas.kicad.org/erc.v1.json";
+        report["source"] = TO_UTF8( sch->GetFileName() );
+        report["date"] = TO_UTF8( wxDateTime::Now().FormatISOCombined() );
+        report["kicad_version"] = TO_UTF8( GetMajorMinorVersion() );
+        report["coordinate_units"] = unitsName;
+
+        nlohmann::json sheets = nlohmann::json::array();
+
+        for( const SCH_SHEET_PATH& sheet : sheetList )
+        {
+            nlohmann::json jsonSheet;
+            nlohmann::json violations = nlohmann::json::array();
+
+            jsonSheet["path"] = TO_UTF8( sheet.PathHumanReadable() );
+            jsonSheet["uuid_path"] = TO_UTF8( sheet.Path().AsString() );
+
+            for( SCH_MARKER* marker : reportedMarkers( sheet ) )
+            {
+                nlohmann::json violation;
+                marker->GetRCItem()->GetJsonViolation( violation, &unitsProvider,
+                                                       markerSeverity( marker ), itemMap );
+                violations.push_back( violation );
+            }
+
+            jsonSheet["violations"] = violations;
+            sheets.push_back( jsonSheet );
+        }
+
+        report["sheets"] = sheets;
+
+        file.Write( wxString::FromUTF8( report.dump( 2 ) ) + wxS( "\n" ) );
+    }
+    else
+    {
+        wxString msg = wxString::Format( _( "ERC report (%s, Encoding UTF8)\n" ), DateAndTime() );
+
+        for( const SCH_SHEET_PATH& sheet : sheetList )
+        {
+            msg << wxString::Format( _( "\n***** Sheet %s\n" ), sheet.PathHumanReadable() );
+
+            for( SCH_MARKER* marker : reportedMarkers( sheet ) )
+            {
+                msg << marker->GetRCItem()->ShowReport( &unitsProvider, markerSeverity( marker ),
+                                                        itemMap );
+            }
+        }
+
+        msg << wxString::Format( _( "\n ** ERC messages: %d  Errors %d  Warnings %d\n" ),
+                                 errors + warnings, errors, warnings );
+
+        file.Write( msg );
+    }
+
+    file.Close();
+
+    if( aJob->IsCli() )
+    {
+        wxPrintf( _( "Found %d violations (%d errors, %d warnings)\n" ),
+                  errors + warnings, errors, warnings );
+        wxPrintf( _( "Saved ERC Report to %s\n" ), ercJob->m_outputFile );
+    }
+
+    if( ercJob->m_exitCodeViolations )
+    {
+        if( errors > 0 )
+            return CLI::EXIT_CODES::ERR_RC_VIOLATIONS_ERROR;
+        else if( warnings > 0 )
+            return CLI::EXIT_CODES::ERR_RC_VIOLATIONS_WARNING;
+    }
+
+    return CLI::EXIT_CODES::OK;
+}
@@ -1472,7 +1472,10 @@ void SCH_EDIT_FRAME::RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags )
                 GetCanvas()->GetView()->Update( aChangedItem, KIGFX::REPAINT );
             };
 
-    Schematic().ConnectionGraph()->Recalculate( list, true, &changeHandler );
+    Schematic().ConnectionGraph()->Recalculate( list,
+                                                aCleanupFlags == GLOBAL_CLEANUP
+                                                || !ADVANCED_CFG::GetCfg().m_IncrementalConnectivity,
+                                                &changeHandler );
 
     GetCanvas()->GetView()->UpdateAllItemsConditionally(
             []( KIGFX::VIEW_ITEM* aItem ) -> int
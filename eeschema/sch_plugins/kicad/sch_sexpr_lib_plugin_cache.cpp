@@ -66,7 +66,7 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading sexpr symbol library file '%s'",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    MAPPED_FILE_LINE_READER reader( m_libFileName.GetFullPath() );
 
     SCH_SEXPR_PARSER parser( &reader );
 
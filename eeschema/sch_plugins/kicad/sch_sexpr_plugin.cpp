@@ -294,7 +294,7 @@ void SCH_SEXPR_PLUGIN::loadHierarchy( const SCH_SHEET_PATH& aParentSheetPath, SC
 
 void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
 {
-    FILE_LINE_READER reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     size_t lineCount = 0;
 
@@ -305,10 +305,7 @@ void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
         if( !m_progressReporter->KeepRefreshing() )
             THROW_IO_ERROR( ( "Open cancelled by user." ) );
 
-        while( reader.ReadLine() )
-            lineCount++;
-
-        reader.Rewind();
+        lineCount = std::count( reader.Buffer(), reader.Buffer() + reader.BufferLength(), '\n' );
     }
 
     SCH_SEXPR_PARSER parser( &reader, m_progressReporter, lineCount, m_rootSheet, m_appending );
@@ -296,6 +296,9 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
         else if( status == UNDO_REDO::DELETED )
         {
             // deleted items are re-inserted on undo
+            if( SCH_ITEM* item = dynamic_cast<SCH_ITEM*>( eda_item ) )
+                item->SetConnectivityDirty();
+
             AddToScreen( eda_item, screen );
             aList->SetPickedItemStatus( UNDO_REDO::NEWITEM, ii );
         }
@@ -359,6 +362,9 @@ void SCH_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
                 sym->UpdatePins();
             }
 
+            // The connection graph only updates the items it finds dirty (or added or removed)
+            item->SetConnectivityDirty();
+
             if( item != &Schematic().Root() )
                 AddToScreen( item, screen );
         }
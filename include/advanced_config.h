@@ -244,6 +244,29 @@ public:
      */
     bool m_UseClipper2;
 
+    /**
+     * Re-run the incremental-capable DRC providers on the items touched by each board commit
+     * (and their neighbours) once a full DRC has been run.
+     */
+    bool m_IncrementalDRC;
+
+    /**
+     * Reuse a zone's previous fill when none of the items it depends on have changed.
+     */
+    bool m_IncrementalZoneFill;
+
+    /**
+     * The number of parsed footprints each KiCad footprint library keeps in memory.  Others
+     * are parsed again from their files when needed.  0 keeps every footprint once parsed.
+     */
+    int m_FootprintCacheSize;
+
+    /**
+     * Only recalculate the parts of the schematic connection graph affected by an edit instead
+     * of rebuilding it for the whole hierarchy.
+     */
+    bool m_IncrementalConnectivity;
+
 
 private:
     ADVANCED_CFG();
@@ -32,6 +32,10 @@ namespace CLI
         static const int ERR_UNKNOWN = 2;
         static const int  ERR_INVALID_INPUT_FILE = 3;
         static const int  ERR_INVALID_OUTPUT_CONFLICT = 4;
+        ///< Rules check reported violations of error severity
+        static const int  ERR_RC_VIOLATIONS_ERROR = 5;
+        ///< Rules check reported violations of warning severity (but no errors)
+        static const int  ERR_RC_VIOLATIONS_WARNING = 6;
     };
 }
 
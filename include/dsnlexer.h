@@ -430,6 +430,13 @@ public:
      */
     const char* CurLine() const
     {
+        // Readers which don't copy their lines don't nul terminate them either
+        if( start != reader->Line() )
+        {
+            curLine.assign( start, reader->Length() );
+            return curLine.c_str();
+        }
+
         return (const char*)(*reader);
     }
 
@@ -462,13 +469,11 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
-
-            unsigned len = reader->Length();
+            unsigned len;
 
-            // start may have changed in ReadLine(), which can resize and
-            // relocate reader's line buffer.
-            start = reader->Line();
+            // The line is either in the reader's line buffer, which ReadLine() can resize and
+            // relocate, or left in place in the reader's input.
+            start = reader->ReadLineInPlace( &len );
 
             next  = start;
             limit = next + len;
@@ -548,10 +553,11 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    mutable std::string curLine;                ///< nul terminated copy of an in-place line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    const KEYWORD_MAP*  keywordsLookup;         ///< fast, specialized "C string" hashtable
+    const KEYWORD_MAP*  keywordsLookup;         ///< perfect hash of the keywords
 #endif // SWIG
 };
 
@@ -27,6 +27,7 @@
 #ifndef OUTLINE_FONT_H_
 #define OUTLINE_FONT_H_
 
+#include <mutex>
 #include <gal/graphics_abstraction_layer.h>
 #include <geometry/shape_poly_set.h>
 #ifdef _MSC_VER
@@ -129,6 +130,10 @@ private:
     FT_Face           m_face;
     const int         m_faceSize;
 
+    // A FreeType face can only be used by one thread at a time.  Recursive because overbarred
+    // text fetches the underscore glyph from inside getTextAsGlyphs().
+    mutable std::recursive_mutex m_faceLock;
+
     // cache for glyphs converted to straight segments
     // key is glyph index (FT_GlyphSlot field glyph_index)
     std::map<unsigned int, GLYPH_POINTS_LIST> m_contourCache;
@@ -563,6 +563,11 @@ public:
      */
     void SetWorldUnitLength( double aWorldUnitLength ) { m_worldUnitLength = aWorldUnitLength; }
 
+    /**
+     * @return the length of one world unit in inches.
+     */
+    double GetWorldUnitLength() const { return m_worldUnitLength; }
+
     void SetScreenSize( const VECTOR2I& aSize ) { m_screenSize = aSize; }
 
     /**
@@ -25,41 +25,15 @@
 #ifndef HASHTABLES_H_
 #define HASHTABLES_H_
 
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <wx/string.h>
 
-// First some utility classes and functions
-
-/// Equality test for "const char*" type used in very specialized KEYWORD_MAP below
-struct iequal_to
-{
-    bool operator()( const char* x, const char* y ) const
-    {
-        return !strcmp( x, y );
-    }
-};
-
-
-/// Very fast and efficient hash function for "const char*" type, used in specialized
-/// KEYWORD_MAP below.
-/// taken from: http://www.boost.org/doc/libs/1_53_0/libs/unordered/examples/fnv1.hpp
-struct fnv_1a
-{
-    std::size_t operator()( const char* it ) const
-    {
-        std::size_t hash = 2166136261u;
-
-        for( ; *it; ++it )
-        {
-            hash ^= (unsigned char) *it;
-            hash *= 16777619;
-        }
-        return hash;
-    }
-};
-
-
 #ifdef SWIG
 /// Declare a std::unordered_map and also the swig %template in unison
 #define DECL_HASH_FOR_SWIG( TypeName, KeyType, ValueType )          \
@@ -75,24 +49,92 @@ struct fnv_1a
 #endif
 
 
+#ifndef SWIG
 /**
- * A hashtable made of a const char* and an int.
+ * A read-only map from keyword to token, used by #DSNLEXER to recognize keywords.
  *
- * @note The use of this type outside very specific circumstances is foolish since there is
- *       no storage provided for the actual C string itself.
+ * The map is built once from the keyword table generated by CMake and is a perfect hash:
+ * every lookup hashes the text once and compares it against a single candidate keyword,
+ * whether or not the text turns out to be a keyword.
  *
- * This type assumes use with type #KEYWORD that is created by CMake and that table creates
- * *constant* storage for C strings (and pointers to those C strings).  Here we are only
- * interested in the C strings themselves and only the pointers are duplicated within the
- * hashtable.  If the strings were not constant and fixed, this type would not work.  Also
- * note that normally a hashtable (i.e. unordered_map) using a const char* key would simply
- * compare the 32 bit or 64 bit pointers themselves, rather than the C strings which they
- * are known to point to in this context.  I force the latter behavior by supplying both
- * "hash" and "equality" overloads to the hashtable (unordered_map) template.
- *
- * @author Dick Hollenbeck
+ * @note Only the pointers to the keyword strings are stored, so the strings must be constant
+ *       and outlive the map, as those in the generated #KEYWORD tables do.
  */
-typedef std::unordered_map< const char*, int, fnv_1a, iequal_to > KEYWORD_MAP;
+class KEYWORD_MAP
+{
+public:
+    KEYWORD_MAP( std::initializer_list<std::pair<const char*, int>> aKeywords ) :
+            KEYWORD_MAP( aKeywords.begin(), aKeywords.size() )
+    {}
+
+    KEYWORD_MAP( const std::vector<std::pair<const char*, int>>& aKeywords ) :
+            KEYWORD_MAP( aKeywords.data(), aKeywords.size() )
+    {}
+
+    KEYWORD_MAP( const std::pair<const char*, int>* aKeywords, size_t aCount );
+
+    /**
+     * @return the token of the keyword \a aText of \a aLength bytes (which need not be nul
+     *         terminated), or -1 if \a aText is not a keyword.
+     */
+    int Find( const char* aText, size_t aLength ) const
+    {
+        if( m_slots.empty() )
+            return -1;
+
+        uint64_t    hash = Hash( aText, aLength );
+        uint64_t    seed = m_seeds[ ( hash >> 32 ) % m_seeds.size() ];
+        const SLOT& slot = m_slots[ mix( hash ^ seed ) & m_mask ];
+
+        if( slot.m_Length == aLength && memcmp( slot.m_Name, aText, aLength ) == 0 )
+            return slot.m_Token;
+
+        return -1;
+    }
+
+    size_t size() const { return m_count; }
+
+    /**
+     * 64 bit FNV-1a hash of \a aLength bytes of \a aText.
+     */
+    static uint64_t Hash( const char* aText, size_t aLength )
+    {
+        uint64_t hash = 14695981039346656037ULL;
+
+        for( size_t ii = 0; ii < aLength; ++ii )
+        {
+            hash ^= (unsigned char) aText[ii];
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+private:
+    /// The 64 bit finalizer from MurmurHash3, used to derive a slot from a seeded hash.
+    static uint64_t mix( uint64_t aValue )
+    {
+        aValue ^= aValue >> 33;
+        aValue *= 0xff51afd7ed558ccdULL;
+        aValue ^= aValue >> 33;
+        aValue *= 0xc4ceb9fe1a85ec53ULL;
+        aValue ^= aValue >> 33;
+        return aValue;
+    }
+
+    struct SLOT
+    {
+        const char* m_Name = "";
+        size_t      m_Length = (size_t) -1;     ///< Never matches in an empty slot
+        int         m_Token = -1;
+    };
+
+    std::vector<uint64_t> m_seeds;              ///< Per bucket seed, see Find()
+    std::vector<SLOT>     m_slots;              ///< Power of two sized
+    uint64_t              m_mask;
+    size_t                m_count;
+};
+#endif // SWIG
 
 
 #endif // HASHTABLES_H_
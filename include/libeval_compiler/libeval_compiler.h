@@ -55,6 +55,8 @@
 #define TR_OP_METHOD_CALL 25
 #define TR_UOP_PUSH_VAR 1
 #define TR_UOP_PUSH_VALUE 2
+#define TR_UOP_VAR_EQUAL 3
+#define TR_UOP_VAR_NOT_EQUAL 4
 
 // This namespace is used for the lemon parser
 namespace LIBEVAL
@@ -241,6 +243,8 @@ public:
 
     VAR_TYPE_T GetType() const { return m_type; };
 
+    bool StringIsWildcard() const { return m_stringIsWildcard; }
+
     void Set( double aValue )
     {
         m_type = VT_NUMERIC;
@@ -297,6 +301,24 @@ public:
 
     virtual VAR_TYPE_T GetType() const = 0;
     virtual VALUE* GetValue( CONTEXT* aCtx ) = 0;
+
+    /**
+     * Prepare a typed comparison of the variable with the constant \a aValue.  The compiler
+     * uses this to turn "var == 'constant'" and "var != 'constant'" into a single opcode which
+     * compares the variable in place rather than fetching it as a VALUE.
+     *
+     * @return false if the variable has no typed comparison with \a aValue.
+     */
+    virtual bool PrepareCompare( const VALUE& aValue ) { return false; }
+
+    /**
+     * Compare the variable with the constant given to PrepareCompare().  Must be safe to call
+     * from several threads at once.
+     *
+     * @return 1 if the variable matches the constant, 0 if it doesn't and -1 if the variable
+     *         is undefined for \a aCtx.
+     */
+    virtual int Compare( CONTEXT* aCtx ) const { return -1; }
 };
 
 
@@ -307,7 +329,6 @@ public:
         m_stack(),
         m_stackPtr( 0 )
     {
-        m_ownedValues.reserve( 20 );
     }
 
     virtual ~CONTEXT()
@@ -335,6 +356,12 @@ public:
         m_stack[ m_stackPtr++ ] = v;
     }
 
+    /**
+     * Push the result of a comparison or logical operator.  These are shared constants so
+     * evaluating a condition doesn't allocate its intermediate results.
+     */
+    void PushBool( bool aValue );
+
     VALUE* Pop()
     {
         if( m_stackPtr == 0 )
@@ -382,6 +409,13 @@ public:
     VALUE* Run( CONTEXT* ctx );
     wxString Dump() const;
 
+    /**
+     * Fold operators whose operands are all constants and replace comparisons of a variable
+     * with a constant by the variable's typed comparison, when it has one.  Called by the
+     * compiler once the code has been generated.
+     */
+    void Optimize();
+
     virtual std::unique_ptr<VAR_REF> CreateVarRef( const wxString& var, const wxString& field )
     {
         return nullptr;
@@ -429,6 +463,8 @@ public:
     wxString Format() const;
 
 private:
+    friend class UCODE;
+
     int                      m_op;
 
     FUNC_CALL_REF            m_func;
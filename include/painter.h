@@ -95,10 +95,46 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Build any geometry \a aItem caches for drawing (shapes, triangulations, text glyphs)
+     * ahead of Draw().
+     *
+     * The VIEW calls this from worker threads for batches of items it is about to recache, so
+     * that the expensive part of drawing is done in parallel and only the GAL calls are left
+     * for the main thread.  Implementations must not touch the GAL.  An item is only ever
+     * prepared by one thread at a time.
+     *
+     * @param aItem is the item which is going to be drawn.
+     */
+    virtual void PrepareDraw( const VIEW_ITEM* aItem ) {}
+
+    /// Number of levels of detail an item can be cached at; level 0 is the full detail one.
+    static constexpr int DETAIL_LEVELS = 4;
+
+    /**
+     * Return true if \a aItem is large enough on \a aLayer to be worth caching at lower
+     * levels of detail for drawing at low zoom levels.
+     */
+    virtual bool HasDetailLevels( const VIEW_ITEM* aItem, int aLayer ) const { return false; }
+
+    /**
+     * Return the maximum deviation, in world units, of the geometry drawn at detail level
+     * \a aLevel from the full detail geometry.
+     */
+    double GetDetailTolerance( int aLevel ) const;
+
+    /**
+     * Set the level of detail used by the following Draw() calls.
+     */
+    void SetDetailLevel( int aLevel ) { m_detailLevel = aLevel; }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
     GAL* m_gal;
+
+    /// Level of detail to draw items which have detail levels at
+    int  m_detailLevel;
 };
 
 } // namespace KIGFX
@@ -133,6 +133,16 @@ public:
     virtual wxString ShowReport( UNITS_PROVIDER* aUnitsProvider, SEVERITY aSeverity,
                                  const std::map<KIID, EDA_ITEM*>& aItemMap ) const;
 
+    /**
+     * Translate this object into a JSON object suitable for machine-readable reports.  As with
+     * ShowReport(), the type is reported by its (untranslated) settings key.
+     *
+     * @param aViolation is the JSON object to fill in.
+     */
+    virtual void GetJsonViolation( nlohmann::json& aViolation, UNITS_PROVIDER* aUnitsProvider,
+                                   SEVERITY aSeverity,
+                                   const std::map<KIID, EDA_ITEM*>& aItemMap ) const;
+
     int GetErrorCode() const { return m_errorCode; }
     void SetErrorCode( int aCode ) { m_errorCode = aCode; }
 
@@ -100,6 +100,24 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Read a line of text like ReadLine(), but without copying it into the line buffer if
+     * the reader holds all of its input in memory.
+     *
+     * The returned text is not nul terminated, Line() does not necessarily return it and it
+     * is only valid until the next read.
+     *
+     * @param aLength is set to the length of the line, which is 0 at the end of the input.
+     * @return the beginning of the read line.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineInPlace( unsigned* aLength )
+    {
+        ReadLine();
+        *aLength = m_length;
+        return m_line;
+    }
+
     /**
      * Returns the name of the source of the lines in an abstract sense.
      *
@@ -265,6 +283,67 @@ public:
     STRING_LINE_READER( const STRING_LINE_READER& aStartingPoint );
 
     char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned* aLength ) override;
+};
+
+
+/**
+ * A #LINE_READER that reads from a block of text held in memory by the caller, such as a
+ * whole file read in one go.  The text is not copied and must outlive the reader.
+ */
+class BUFFER_LINE_READER : public LINE_READER
+{
+public:
+    /**
+     * @param aBuffer is the text to read; it does not need to be nul terminated.
+     * @param aLength is the number of bytes in \a aBuffer.
+     * @param aSource describes the source of the text for error reporting purposes.
+     * @param aStartingLineNumber is the line number of the line before the first line of
+     *                            \a aBuffer, for when the buffer is a section of a larger text.
+     */
+    BUFFER_LINE_READER( const char* aBuffer, size_t aLength, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
+
+    char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned* aLength ) override;
+
+    const char* Buffer() const { return m_buffer; }
+    size_t BufferLength() const { return m_bufferLength; }
+
+    /**
+     * @return the offset in the buffer of the start of the current line.
+     */
+    size_t LineOffset() const { return m_ndx - m_length; }
+
+protected:
+    const char* m_buffer;
+    size_t      m_bufferLength;
+    size_t      m_ndx;
+};
+
+
+/**
+ * A #LINE_READER that reads a whole file through a memory mapping, so that #DSNLEXER can
+ * tokenize the file in place without copying any of it.
+ *
+ * Files which can't be mapped (such as empty files) are read into memory instead.
+ */
+class MAPPED_FILE_LINE_READER : public BUFFER_LINE_READER
+{
+public:
+    /**
+     * @param aFileName is the name of the file to read.
+     * @throw IO_ERROR if the file can't be opened or read.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName );
+
+    ~MAPPED_FILE_LINE_READER();
+
+protected:
+    const char* m_mapping;
+    std::string m_contents;     ///< The file contents when it can't be mapped
 };
 
 
@@ -27,6 +27,8 @@
 
 #include <bs_thread_pool.hpp>
 
+#include <functional>
+
 using thread_pool = BS::thread_pool;
 
 /**
@@ -39,4 +41,28 @@ using thread_pool = BS::thread_pool;
 thread_pool& GetKiCadThreadPool();
 
 
+/**
+ * Call \a aFunc( ii ) for each ii in [0, \a aCount) on the KiCad thread pool.
+ *
+ * Unlike submitting a task per item, the range is split into one share per pool thread.
+ * Each thread takes blocks of decreasing size from its own share and, once that is exhausted,
+ * steals the back half of another thread's remaining share.  The calling thread waits on a
+ * single latch.
+ *
+ * @param aCount is the number of items.
+ * @param aFunc is called once for each item, from any thread.
+ * @param aWaitCallback if set, is called from the calling thread about every 250ms with the
+ *                      number of items completed so far (e.g. to update a progress reporter).
+ *                      Returning false cancels the items which have not been started.  If not
+ *                      set, the calling thread works through the items too.
+ * @param aMinBlockSize is the smallest number of items handed to a thread at once.
+ * @return the number of items processed, which is less than \a aCount if cancelled.
+ * @throw the first exception thrown by \a aFunc, once every started item has finished.  The
+ *        items which have not been started are cancelled.
+ */
+size_t ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                    const std::function<bool( size_t )>& aWaitCallback = nullptr,
+                    size_t aMinBlockSize = 1 );
+
+
 #endif /* INCLUDE_THREAD_POOL_H_ */
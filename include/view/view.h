@@ -809,6 +809,13 @@ protected:
     ///< Update all information needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Let the painter build the drawing caches of the items of \a aItems which are going to be
+     * redrawn on a cached layer, on the thread pool before they are redrawn on the main thread.
+     * Does nothing for small batches.
+     */
+    void prepareItems( const std::vector<VIEW_ITEM*>& aItems );
+
     ///< Update bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -881,6 +888,9 @@ protected:
 
     ///< Flag to reverse the draw order when using draw priority.
     bool m_reverseDrawOrder;
+
+    ///< Level of detail cached items are drawn at for the current zoom (see PAINTER).
+    int m_detailLevel;
 };
 } // namespace KIGFX
 
@@ -152,6 +152,7 @@ extern const std::string FootprintAssignmentFileExtension;
 extern const std::string DrillFileExtension;
 extern const std::string SVGFileExtension;
 extern const std::string ReportFileExtension;
+extern const std::string JsonFileExtension;
 extern const std::string FootprintPlaceFileExtension;
 extern const std::string KiCadFootprintFileExtension;
 extern const std::string KiCadFootprintLibPathExtension;
@@ -0,0 +1,60 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "command_pcb_drc.h"
+#include <cli/exit_codes.h>
+#include "jobs/job_pcb_drc.h"
+#include <kiface_base.h>
+#include <wx/crt.h>
+
+#include <macros.h>
+
+#define ARG_ALL_TRACK_ERRORS "--all-track-errors"
+#define ARG_REFILL_ZONES "--refill-zones"
+
+CLI::PCB_DRC_COMMAND::PCB_DRC_COMMAND() : RC_BASE_COMMAND( "drc" )
+{
+    m_argParser.add_argument( ARG_ALL_TRACK_ERRORS )
+            .help( UTF8STDSTR( _( "Report all errors for each track" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_REFILL_ZONES )
+            .help( UTF8STDSTR( _( "Refill zones before running DRC" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+}
+
+
+int CLI::PCB_DRC_COMMAND::Perform( KIWAY& aKiway )
+{
+    std::unique_ptr<JOB_PCB_DRC> drcJob( new JOB_PCB_DRC( true ) );
+
+    int exitCode = fillRcJob( drcJob.get(), _( "Board" ) );
+
+    if( exitCode != EXIT_CODES::OK )
+        return exitCode;
+
+    drcJob->m_reportAllTrackErrors = m_argParser.get<bool>( ARG_ALL_TRACK_ERRORS );
+    drcJob->m_refillZones = m_argParser.get<bool>( ARG_REFILL_ZONES );
+
+    exitCode = aKiway.ProcessJob( KIWAY::FACE_PCB, drcJob.get() );
+
+    return exitCode;
+}
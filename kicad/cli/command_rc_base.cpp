@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "command_rc_base.h"
+#include <cli/exit_codes.h>
+#include "jobs/job_rc.h"
+#include <wx/crt.h>
+#include <wx/file.h>
+
+#include <macros.h>
+
+#define ARG_FORMAT "--format"
+#define ARG_UNITS "--units"
+#define ARG_SEVERITY_ALL "--severity-all"
+#define ARG_SEVERITY_ERROR "--severity-error"
+#define ARG_SEVERITY_WARNING "--severity-warning"
+#define ARG_SEVERITY_EXCLUSIONS "--severity-exclusions"
+#define ARG_EXIT_CODE_VIOLATIONS "--exit-code-violations"
+#define ARG_THREADS "--threads"
+
+CLI::RC_BASE_COMMAND::RC_BASE_COMMAND( const std::string& aName ) :
+        EXPORT_PCB_BASE_COMMAND( aName )
+{
+    m_argParser.add_argument( ARG_FORMAT )
+            .default_value( std::string( "report" ) )
+            .help( UTF8STDSTR( _( "Output file format, options: json, report" ) ) );
+
+    m_argParser.add_argument( ARG_UNITS )
+            .default_value( std::string( "mm" ) )
+            .help( UTF8STDSTR( _( "Report units; valid options: in, mm, mils" ) ) );
+
+    m_argParser.add_argument( ARG_SEVERITY_ALL )
+            .help( UTF8STDSTR( _( "Report all violations, including warnings and exclusions" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_SEVERITY_ERROR )
+            .help( UTF8STDSTR( _( "Report error level violations" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_SEVERITY_WARNING )
+            .help( UTF8STDSTR( _( "Report warning level violations" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_SEVERITY_EXCLUSIONS )
+            .help( UTF8STDSTR( _( "Report excluded violations" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_EXIT_CODE_VIOLATIONS )
+            .help( UTF8STDSTR( _( "Return a non-zero exit code if errors (5) or warnings (6) "
+                                  "are reported" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+
+    m_argParser.add_argument( ARG_THREADS )
+            .default_value( 0 )
+            .scan<'i', int>()
+            .help( UTF8STDSTR( _( "Number of worker threads to use; 0 for all available cores" ) ) );
+}
+
+
+int CLI::RC_BASE_COMMAND::fillRcJob( JOB_RC* aJob, const wxString& aFileDescription )
+{
+    aJob->m_filename = FROM_UTF8( m_argParser.get<std::string>( ARG_INPUT ).c_str() );
+    aJob->m_outputFile = FROM_UTF8( m_argParser.get<std::string>( ARG_OUTPUT ).c_str() );
+
+    if( !wxFile::Exists( aJob->m_filename ) )
+    {
+        wxFprintf( stderr, _( "%s file does not exist or is not accessible\n" ), aFileDescription );
+        return EXIT_CODES::ERR_INVALID_INPUT_FILE;
+    }
+
+    wxString format = FROM_UTF8( m_argParser.get<std::string>( ARG_FORMAT ).c_str() );
+
+    if( format == "report" )
+    {
+        aJob->m_format = JOB_RC::OUTPUT_FORMAT::REPORT;
+    }
+    else if( format == "json" )
+    {
+        aJob->m_format = JOB_RC::OUTPUT_FORMAT::JSON;
+    }
+    else
+    {
+        wxFprintf( stderr, _( "Invalid report format\n" ) );
+        return EXIT_CODES::ERR_ARGS;
+    }
+
+    wxString units = FROM_UTF8( m_argParser.get<std::string>( ARG_UNITS ).c_str() );
+
+    if( units == "mm" )
+    {
+        aJob->m_units = JOB_RC::UNITS::MILLIMETERS;
+    }
+    else if( units == "in" )
+    {
+        aJob->m_units = JOB_RC::UNITS::INCHES;
+    }
+    else if( units == "mils" )
+    {
+        aJob->m_units = JOB_RC::UNITS::MILS;
+    }
+    else
+    {
+        wxFprintf( stderr, _( "Invalid units specified\n" ) );
+        return EXIT_CODES::ERR_ARGS;
+    }
+
+    int severity = 0;
+
+    if( m_argParser.get<bool>( ARG_SEVERITY_ALL ) )
+        severity = RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING | RPT_SEVERITY_EXCLUSION;
+
+    if( m_argParser.get<bool>( ARG_SEVERITY_ERROR ) )
+        severity |= RPT_SEVERITY_ERROR;
+
+    if( m_argParser.get<bool>( ARG_SEVERITY_WARNING ) )
+        severity |= RPT_SEVERITY_WARNING;
+
+    if( m_argParser.get<bool>( ARG_SEVERITY_EXCLUSIONS ) )
+        severity |= RPT_SEVERITY_EXCLUSION;
+
+    // Default to errors and warnings when nothing was asked for
+    if( severity != 0 )
+        aJob->m_severity = severity;
+
+    aJob->m_exitCodeViolations = m_argParser.get<bool>( ARG_EXIT_CODE_VIOLATIONS );
+
+    aJob->m_threads = m_argParser.get<int>( ARG_THREADS );
+
+    if( aJob->m_threads < 0 )
+    {
+        wxFprintf( stderr, _( "Invalid thread count\n" ) );
+        return EXIT_CODES::ERR_ARGS;
+    }
+
+    return EXIT_CODES::OK;
+}
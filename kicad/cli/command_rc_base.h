@@ -0,0 +1,47 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMAND_RC_BASE_H
+#define COMMAND_RC_BASE_H
+
+#include "command_export_pcb_base.h"
+
+class JOB_RC;
+
+namespace CLI
+{
+/**
+ * Arguments shared by the rule checker commands (pcb drc and sch erc).
+ */
+class RC_BASE_COMMAND : public EXPORT_PCB_BASE_COMMAND
+{
+public:
+    RC_BASE_COMMAND( const std::string& aName );
+
+protected:
+    /**
+     * Fill in the common job fields from the parsed arguments.
+     *
+     * @return EXIT_CODES::OK or the exit code to return on an argument error.
+     */
+    int fillRcJob( JOB_RC* aJob, const wxString& aFileDescription );
+};
+} // namespace CLI
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "command_sch_erc.h"
+#include <cli/exit_codes.h>
+#include "jobs/job_sch_erc.h"
+#include <kiface_base.h>
+#include <wx/crt.h>
+
+#include <macros.h>
+
+CLI::SCH_ERC_COMMAND::SCH_ERC_COMMAND() : RC_BASE_COMMAND( "erc" )
+{
+}
+
+
+int CLI::SCH_ERC_COMMAND::Perform( KIWAY& aKiway )
+{
+    std::unique_ptr<JOB_SCH_ERC> ercJob( new JOB_SCH_ERC( true ) );
+
+    int exitCode = fillRcJob( ercJob.get(), _( "Schematic" ) );
+
+    if( exitCode != EXIT_CODES::OK )
+        return exitCode;
+
+    exitCode = aKiway.ProcessJob( KIWAY::FACE_SCH, ercJob.get() );
+
+    return exitCode;
+}
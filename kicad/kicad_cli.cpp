@@ -48,6 +48,7 @@
 #include <kiplatform/environment.h>
 
 #include "cli/command_pcb.h"
+#include "cli/command_pcb_drc.h"
 #include "cli/command_pcb_export.h"
 #include "cli/command_export_pcb_drill.h"
 #include "cli/command_export_pcb_dxf.h"
@@ -66,6 +67,7 @@
 #include "cli/command_fp_export_svg.h"
 #include "cli/command_fp_upgrade.h"
 #include "cli/command_sch.h"
+#include "cli/command_sch_erc.h"
 #include "cli/command_sch_export.h"
 #include "cli/command_sym.h"
 #include "cli/command_sym_export.h"
@@ -129,8 +131,10 @@ static CLI::EXPORT_PCB_GERBER_COMMAND    exportPcbGerberCmd{};
 static CLI::EXPORT_PCB_GERBERS_COMMAND   exportPcbGerbersCmd{};
 static CLI::EXPORT_PCB_COMMAND           exportPcbCmd{};
 static CLI::PCB_COMMAND                  pcbCmd{};
+static CLI::PCB_DRC_COMMAND              pcbDrcCmd{};
 static CLI::EXPORT_SCH_COMMAND           exportSchCmd{};
 static CLI::SCH_COMMAND                  schCmd{};
+static CLI::SCH_ERC_COMMAND              schErcCmd{};
 static CLI::EXPORT_SCH_PYTHONBOM_COMMAND exportSchPythonBomCmd{};
 static CLI::EXPORT_SCH_NETLIST_COMMAND   exportSchNetlistCmd{};
 static CLI::EXPORT_SCH_PDF_COMMAND       exportSchPdfCmd{};
@@ -162,6 +166,9 @@ static std::vector<COMMAND_ENTRY> commandStack = {
     {
         &pcbCmd,
         {
+            {
+                &pcbDrcCmd
+            },
             {
                 &exportPcbCmd,
                 {
@@ -180,6 +187,9 @@ static std::vector<COMMAND_ENTRY> commandStack = {
     {
         &schCmd,
         {
+            {
+                &schErcCmd
+            },
             {
                 &exportSchCmd,
                 {
@@ -40,6 +40,7 @@
 
 #include <clipper.hpp>                  // for ClipType, PolyTree (ptr only)
 #include <clipper2/clipper.h>
+#include <geometry/geometry_utils.h>    // for ERROR_LOC
 #include <geometry/seg.h>               // for SEG
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
@@ -513,6 +514,17 @@ public:
     void CacheTriangulation( bool aPartition = true, bool aSimplify = false );
     bool IsTriangulationUpToDate() const;
 
+    /**
+     * Return a triangulated approximation of the polygon set whose contours deviate from it
+     * by no more than \a aMaxError.  Contours smaller than \a aMaxError are replaced by their
+     * bounding box (outlines) or dropped (holes).
+     *
+     * Used to draw large polygons at low zoom levels.  Approximations are cached per error
+     * value and rebuilt when the polygon set changes.  Returns the polygon set itself if it
+     * cannot be approximated.
+     */
+    const SHAPE_POLY_SET& GetLODApproximation( int aMaxError ) const;
+
     MD5_HASH GetHash() const;
 
     virtual bool HasIndexableSubshapes() const override;
@@ -953,6 +965,56 @@ public:
         PM_STRICTLY_SIMPLE = false
     };
 
+    /**
+     * A collection of simple primitives (circles, oblong segments and arc-free polygons) to be
+     * merged into a polygon set in a single boolean pass.
+     *
+     * The primitives are tessellated straight into the clipper's path format, so there is no
+     * per-shape SHAPE_LINE_CHAIN or SHAPE_POLY_SET to build, no arc bookkeeping, and no
+     * intermediate boolean ops.  Used to accumulate large numbers of knockouts (eg: track and
+     * via clearances when filling zones).
+     */
+    class PRIMITIVE_BATCH
+    {
+    public:
+        PRIMITIVE_BATCH() {}
+
+        /**
+         * Add a circle approximated with the same segment count and error handling as
+         * TransformCircleToPolygon().
+         */
+        void AddCircle( const VECTOR2I& aCenter, int aRadius, int aError, ERROR_LOC aErrorLoc );
+
+        /**
+         * Add an oblong segment (ie: a straight track) of the given width, approximated as
+         * TransformOvalToPolygon() does.
+         */
+        void AddSegment( const VECTOR2I& aStart, const VECTOR2I& aEnd, int aWidth, int aError,
+                         ERROR_LOC aErrorLoc, int aMinSegCount = 0 );
+
+        /**
+         * Add a closed outline.  Arcs are added as their polyline approximation.
+         */
+        void AddPolygon( const SHAPE_LINE_CHAIN& aOutline );
+
+        /**
+         * Add the outlines and holes of a polygon set, for shapes which have no primitive of
+         * their own.
+         */
+        void Append( const SHAPE_POLY_SET& aPolySet );
+
+        int  PathCount() const { return (int) m_paths.size(); }
+        bool IsEmpty() const { return m_paths.empty(); }
+        void Clear() { m_paths.clear(); }
+
+    private:
+        friend class SHAPE_POLY_SET;
+
+        void addPath( Clipper2Lib::Path64&& aPath, bool aIsHole = false );
+
+        Clipper2Lib::Paths64 m_paths;
+    };
+
     ///< Perform boolean polyset union
     ///< For \a aFastMode meaning, see function booleanOp
     void BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode );
@@ -965,6 +1027,17 @@ public:
     ///< For \a aFastMode meaning, see function booleanOp
     void BooleanIntersection( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode );
 
+    /**
+     * Merge a batch of primitives into this polygon set.  The result is simplified, ie: the
+     * same as appending the primitives and calling Simplify(), but done in a single pass.
+     *
+     * Arcs in this polygon set are not supported; call ClearArcs() first.
+     */
+    void BooleanAdd( const PRIMITIVE_BATCH& aBatch );
+
+    ///< Subtract a batch of primitives from this polygon set in a single pass.
+    void BooleanSubtract( const PRIMITIVE_BATCH& aBatch );
+
     ///< Perform boolean polyset union between a and b, store the result in it self
     ///< For \a aFastMode meaning, see function booleanOp
     void BooleanAdd( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
@@ -1422,6 +1495,10 @@ private:
 
     void booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SET& aOtherShape );
 
+    void booleanOp( ClipperLib::ClipType aType, const PRIMITIVE_BATCH& aBatch );
+
+    void booleanOp( Clipper2Lib::ClipType aType, const PRIMITIVE_BATCH& aBatch );
+
     void booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SET& aShape,
                     const SHAPE_POLY_SET& aOtherShape );
 
@@ -1480,6 +1557,15 @@ private:
 
     bool     m_triangulationValid = false;
     MD5_HASH m_hash;
+
+    struct LOD_APPROXIMATION
+    {
+        int                             m_MaxError;
+        MD5_HASH                        m_Hash;      ///< Hash of the polygon set it was built from
+        std::unique_ptr<SHAPE_POLY_SET> m_Poly;
+    };
+
+    mutable std::vector<LOD_APPROXIMATION> m_lodCache;
 };
 
 #endif // __SHAPE_POLY_SET_H
@@ -57,6 +57,7 @@
 #include <hash.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_circle.h>
+#include <trigo.h>
 
 // Do not keep this for release.  Only for testing clipper
 #include <advanced_config.h>
@@ -832,6 +833,287 @@ void SHAPE_POLY_SET::booleanOp( Clipper2Lib::ClipType aType, const SHAPE_POLY_SE
 }
 
 
+/**
+ * Clip a convex polygon to the half-plane where aSign * coordinate <= aLimit.  The coordinate
+ * is selected by aCoord (&VECTOR2I::x or &VECTOR2I::y).
+ */
+static void clipConvexPolygon( std::vector<VECTOR2I>& aPts, int VECTOR2I::*aCoord, int aLimit,
+                               int aSign )
+{
+    int VECTOR2I::*other = ( aCoord == &VECTOR2I::x ) ? &VECTOR2I::y : &VECTOR2I::x;
+
+    std::vector<VECTOR2I> clipped;
+    clipped.reserve( aPts.size() + 2 );
+
+    for( size_t ii = 0; ii < aPts.size(); ++ii )
+    {
+        const VECTOR2I& a = aPts[ii];
+        const VECTOR2I& b = aPts[( ii + 1 ) % aPts.size()];
+        bool            aInside = aSign * a.*aCoord <= aLimit;
+        bool            bInside = aSign * b.*aCoord <= aLimit;
+
+        if( aInside )
+            clipped.push_back( a );
+
+        if( aInside != bInside )
+        {
+            int      edge = aSign * aLimit;
+            double   t = double( edge - a.*aCoord ) / double( b.*aCoord - a.*aCoord );
+            VECTOR2I pt;
+
+            pt.*aCoord = edge;
+            pt.*other = KiROUND( a.*other + t * ( b.*other - a.*other ) );
+            clipped.push_back( pt );
+        }
+    }
+
+    aPts = std::move( clipped );
+}
+
+
+void SHAPE_POLY_SET::PRIMITIVE_BATCH::addPath( Clipper2Lib::Path64&& aPath, bool aIsHole )
+{
+    if( aPath.size() < 3 )
+        return;
+
+    // Same orientation convention as SHAPE_LINE_CHAIN::convertToClipper2(): outlines must
+    // have a positive area and holes a negative one for the non-zero fill rule to merge
+    // overlapping primitives.
+    if( ( Clipper2Lib::Area( aPath ) >= 0 ) == aIsHole )
+        std::reverse( aPath.begin(), aPath.end() );
+
+    m_paths.push_back( std::move( aPath ) );
+}
+
+
+void SHAPE_POLY_SET::PRIMITIVE_BATCH::AddCircle( const VECTOR2I& aCenter, int aRadius,
+                                                 int aError, ERROR_LOC aErrorLoc )
+{
+    int numSegs = GetArcToSegmentCount( aRadius, aError, FULL_CIRCLE );
+
+    // Keep in sync with TransformCircleToPolygon()
+    if( numSegs & 1 )
+        numSegs++;
+
+    EDA_ANGLE delta = ANGLE_360 / numSegs;
+    int       radius = aRadius;
+
+    if( aErrorLoc == ERROR_OUTSIDE )
+    {
+        int actual_delta_radius = CircleToEndSegmentDeltaRadius( radius, numSegs );
+        radius += GetCircleToPolyCorrection( actual_delta_radius );
+    }
+
+    Clipper2Lib::Path64 path;
+    path.reserve( numSegs + 1 );
+
+    for( EDA_ANGLE angle = ANGLE_0; angle < ANGLE_360; angle += delta )
+    {
+        VECTOR2I corner( radius, 0 );
+        RotatePoint( corner, angle );
+        corner += aCenter;
+        path.emplace_back( corner.x, corner.y );
+    }
+
+    addPath( std::move( path ) );
+}
+
+
+void SHAPE_POLY_SET::PRIMITIVE_BATCH::AddSegment( const VECTOR2I& aStart, const VECTOR2I& aEnd,
+                                                  int aWidth, int aError, ERROR_LOC aErrorLoc,
+                                                  int aMinSegCount )
+{
+    // Keep in sync with TransformOvalToPolygon(), except that the rounded ends are trimmed to
+    // the segment width directly rather than by a boolean intersection.
+    int radius  = aWidth / 2;
+    int numSegs = GetArcToSegmentCount( radius, aError, FULL_CIRCLE );
+    numSegs = std::max( aMinSegCount, numSegs );
+
+    EDA_ANGLE delta = ANGLE_360 / numSegs;
+
+    if( aErrorLoc == ERROR_OUTSIDE )
+    {
+        int actual_delta_radius = CircleToEndSegmentDeltaRadius( radius, numSegs );
+        radius += GetCircleToPolyCorrection( actual_delta_radius );
+    }
+
+    VECTOR2I endp = aEnd - aStart;
+    VECTOR2I startp = aStart;
+
+    if( endp.x < 0 )
+    {
+        endp    = aStart - aEnd;
+        startp  = aEnd;
+    }
+
+    EDA_ANGLE delta_angle( endp );
+    int       seg_len = KiROUND( EuclideanNorm( endp ) );
+
+    // Build the shape of the equivalent horizontal segment from {0,0} to {seg_len,0}
+    std::vector<VECTOR2I> pts;
+    pts.reserve( numSegs + 6 );
+
+    for( EDA_ANGLE angle = ANGLE_0; angle < ANGLE_180; angle += delta )
+    {
+        VECTOR2I corner( 0, radius );
+        RotatePoint( corner, angle );
+        corner.x += seg_len;
+        pts.push_back( corner );
+    }
+
+    pts.emplace_back( seg_len, -radius );
+
+    for( EDA_ANGLE angle = ANGLE_0; angle < ANGLE_180; angle += delta )
+    {
+        VECTOR2I corner( 0, -radius );
+        RotatePoint( corner, angle );
+        pts.push_back( corner );
+    }
+
+    pts.emplace_back( 0, radius );
+
+    if( radius > aWidth / 2 )
+    {
+        clipConvexPolygon( pts, &VECTOR2I::y, aWidth / 2, 1 );
+        clipConvexPolygon( pts, &VECTOR2I::y, aWidth / 2, -1 );
+    }
+
+    Clipper2Lib::Path64 path;
+    path.reserve( pts.size() );
+
+    for( VECTOR2I& pt : pts )
+    {
+        RotatePoint( pt, -delta_angle );
+        pt += startp;
+        path.emplace_back( pt.x, pt.y );
+    }
+
+    addPath( std::move( path ) );
+}
+
+
+void SHAPE_POLY_SET::PRIMITIVE_BATCH::AddPolygon( const SHAPE_LINE_CHAIN& aOutline )
+{
+    Clipper2Lib::Path64 path;
+    path.reserve( aOutline.PointCount() );
+
+    for( const VECTOR2I& pt : aOutline.CPoints() )
+        path.emplace_back( pt.x, pt.y );
+
+    addPath( std::move( path ) );
+}
+
+
+void SHAPE_POLY_SET::PRIMITIVE_BATCH::Append( const SHAPE_POLY_SET& aPolySet )
+{
+    for( const POLYGON& poly : aPolySet.m_polys )
+    {
+        for( size_t ii = 0; ii < poly.size(); ii++ )
+        {
+            Clipper2Lib::Path64 path;
+            path.reserve( poly[ii].PointCount() );
+
+            for( const VECTOR2I& pt : poly[ii].CPoints() )
+                path.emplace_back( pt.x, pt.y );
+
+            addPath( std::move( path ), ii > 0 );
+        }
+    }
+}
+
+
+void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const PRIMITIVE_BATCH& aBatch )
+{
+    if( ArcCount() > 0 )
+    {
+        wxFAIL_MSG( wxT( "Boolean ops on curved polygons are not supported. You should call "
+                         "ClearArcs() before carrying out the boolean operation." ) );
+    }
+
+    ClipperLib::Clipper c;
+
+    // The primitives carry no arc information: they all refer to the first (default) z-value
+    std::vector<CLIPPER_Z_VALUE> zValues( 1 );
+    std::vector<SHAPE_ARC>       arcBuffer;
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( size_t i = 0; i < poly.size(); i++ )
+        {
+            c.AddPath( poly[i].convertToClipper( i == 0, zValues, arcBuffer ),
+                       ClipperLib::ptSubject, true );
+        }
+    }
+
+    for( const Clipper2Lib::Path64& path : aBatch.m_paths )
+    {
+        ClipperLib::Path clip;
+        clip.reserve( path.size() );
+
+        for( const Clipper2Lib::Point64& pt : path )
+            clip.emplace_back( pt.x, pt.y, 0 );
+
+        c.AddPath( clip, ClipperLib::ptClip, true );
+    }
+
+    ClipperLib::PolyTree solution;
+
+    c.Execute( aType, solution, ClipperLib::pftNonZero, ClipperLib::pftNonZero );
+
+    importTree( &solution, zValues, arcBuffer );
+}
+
+
+void SHAPE_POLY_SET::booleanOp( Clipper2Lib::ClipType aType, const PRIMITIVE_BATCH& aBatch )
+{
+    if( ArcCount() > 0 )
+    {
+        wxFAIL_MSG( wxT( "Boolean ops on curved polygons are not supported. You should call "
+                         "ClearArcs() before carrying out the boolean operation." ) );
+    }
+
+    Clipper2Lib::Clipper64 c;
+
+    // The primitives carry no arc information: they all refer to the first (default) z-value
+    std::vector<CLIPPER_Z_VALUE> zValues( 1 );
+    std::vector<SHAPE_ARC>       arcBuffer;
+    Clipper2Lib::Paths64         paths;
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( size_t i = 0; i < poly.size(); i++ )
+            paths.push_back( poly[i].convertToClipper2( i == 0, zValues, arcBuffer ) );
+    }
+
+    c.AddSubject( paths );
+    c.AddClip( aBatch.m_paths );
+
+    Clipper2Lib::PolyTree64 solution;
+
+    c.Execute( aType, Clipper2Lib::FillRule::NonZero, solution );
+
+    importTree( solution, zValues, arcBuffer );
+}
+
+
+void SHAPE_POLY_SET::BooleanAdd( const PRIMITIVE_BATCH& aBatch )
+{
+    if( ADVANCED_CFG::GetCfg().m_UseClipper2 )
+        booleanOp( Clipper2Lib::ClipType::Union, aBatch );
+    else
+        booleanOp( ClipperLib::ctUnion, aBatch );
+}
+
+
+void SHAPE_POLY_SET::BooleanSubtract( const PRIMITIVE_BATCH& aBatch )
+{
+    if( ADVANCED_CFG::GetCfg().m_UseClipper2 )
+        booleanOp( Clipper2Lib::ClipType::Difference, aBatch );
+    else
+        booleanOp( ClipperLib::ctDifference, aBatch );
+}
+
+
 void SHAPE_POLY_SET::BooleanAdd( const SHAPE_POLY_SET& b, POLYGON_MODE aFastMode )
 {
     if( ADVANCED_CFG::GetCfg().m_UseClipper2 )
@@ -2606,6 +2888,7 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 
     m_hash = aOther.m_hash;
     m_triangulationValid = aOther.m_triangulationValid;
+    m_lodCache.clear();
 
     return *this;
 }
@@ -2811,6 +3094,155 @@ void SHAPE_POLY_SET::CacheTriangulation( bool aPartition, bool aSimplify )
 }
 
 
+/**
+ * Douglas-Peucker simplification of a closed contour.
+ */
+static SHAPE_LINE_CHAIN simplifyContour( const SHAPE_LINE_CHAIN& aContour, int aMaxError )
+{
+    const std::vector<VECTOR2I>& pts = aContour.CPoints();
+    const int                    n = (int) pts.size();
+
+    SHAPE_LINE_CHAIN result;
+    result.SetClosed( true );
+
+    if( n < 4 )
+    {
+        for( const VECTOR2I& pt : pts )
+            result.Append( pt );
+
+        return result;
+    }
+
+    const SEG::ecoord maxErrorSq = SEG::Square( aMaxError );
+    std::vector<bool> keep( n, false );
+    std::vector<std::pair<int, int>> stack;
+
+    // Split the contour at its first point and the point farthest from it.  Index n stands
+    // for the first point again when closing the contour.
+    int         farthest = 0;
+    SEG::ecoord farthestDistSq = 0;
+
+    for( int ii = 1; ii < n; ++ii )
+    {
+        SEG::ecoord distSq = ( pts[ii] - pts[0] ).SquaredEuclideanNorm();
+
+        if( distSq > farthestDistSq )
+        {
+            farthest = ii;
+            farthestDistSq = distSq;
+        }
+    }
+
+    keep[0] = true;
+    keep[farthest] = true;
+    stack.emplace_back( 0, farthest );
+    stack.emplace_back( farthest, n );
+
+    while( !stack.empty() )
+    {
+        auto [first, last] = stack.back();
+        stack.pop_back();
+
+        SEG         chord( pts[first], pts[last % n] );
+        int         worst = -1;
+        SEG::ecoord worstDistSq = maxErrorSq;
+
+        for( int ii = first + 1; ii < last; ++ii )
+        {
+            SEG::ecoord distSq = chord.SquaredDistance( pts[ii] );
+
+            if( distSq > worstDistSq )
+            {
+                worst = ii;
+                worstDistSq = distSq;
+            }
+        }
+
+        if( worst >= 0 )
+        {
+            keep[worst] = true;
+            stack.emplace_back( first, worst );
+            stack.emplace_back( worst, last );
+        }
+    }
+
+    for( int ii = 0; ii < n; ++ii )
+    {
+        if( keep[ii] )
+            result.Append( pts[ii] );
+    }
+
+    return result;
+}
+
+
+const SHAPE_POLY_SET& SHAPE_POLY_SET::GetLODApproximation( int aMaxError ) const
+{
+    MD5_HASH hash = checksum();
+
+    // Approximations of a previous state of the polygon set are of no further use
+    m_lodCache.erase( std::remove_if( m_lodCache.begin(), m_lodCache.end(),
+                                      [&]( const LOD_APPROXIMATION& aLOD )
+                                      {
+                                          return aLOD.m_Hash != hash;
+                                      } ),
+                      m_lodCache.end() );
+
+    for( const LOD_APPROXIMATION& lod : m_lodCache )
+    {
+        if( lod.m_MaxError == aMaxError )
+            return lod.m_Poly ? *lod.m_Poly : *this;
+    }
+
+    auto lod = std::make_unique<SHAPE_POLY_SET>();
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( size_t ii = 0; ii < poly.size(); ++ii )
+        {
+            const SHAPE_LINE_CHAIN& contour = poly[ii];
+            BOX2I                   bbox = contour.BBox();
+            SHAPE_LINE_CHAIN        simplified;
+
+            if( bbox.GetWidth() <= aMaxError && bbox.GetHeight() <= aMaxError )
+            {
+                // Holes this small aren't visible; outlines are still drawn so that a field of
+                // small islands doesn't disappear
+                if( ii > 0 || bbox.GetWidth() == 0 || bbox.GetHeight() == 0 )
+                    continue;
+
+                simplified.Append( bbox.GetOrigin() );
+                simplified.Append( VECTOR2I( bbox.GetRight(), bbox.GetTop() ) );
+                simplified.Append( bbox.GetEnd() );
+                simplified.Append( VECTOR2I( bbox.GetLeft(), bbox.GetBottom() ) );
+                simplified.SetClosed( true );
+            }
+            else
+            {
+                simplified = simplifyContour( contour, aMaxError );
+
+                if( simplified.PointCount() < 3 )
+                    simplified = contour;
+            }
+
+            if( ii == 0 )
+                lod->AddOutline( simplified );
+            else if( lod->OutlineCount() > 0 )
+                lod->AddHole( simplified );
+        }
+    }
+
+    lod->CacheTriangulation( false );
+
+    if( !lod->m_triangulationValid )
+        lod.reset();
+
+    m_lodCache.push_back( { aMaxError, hash, std::move( lod ) } );
+
+    return m_lodCache.back().m_Poly ? *m_lodCache.back().m_Poly : *this;
+}
+
+
 MD5_HASH SHAPE_POLY_SET::checksum() const
 {
     MD5_HASH hash;
@@ -0,0 +1,49 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIPLATFORM_IO_H_
+#define KIPLATFORM_IO_H_
+
+#include <cstddef>
+
+class wxString;
+
+namespace KIPLATFORM
+{
+    namespace IO
+    {
+        /**
+         * Map a file into memory for reading.
+         *
+         * @param aPath is the file to map.
+         * @param aLength is set to the length of the file.
+         *
+         * @return the start of the mapped file, or nullptr if the file could not be mapped
+         *         (empty files can't be mapped on every platform).
+         */
+        const char* MapFile( const wxString& aPath, size_t& aLength );
+
+        /**
+         * Release a mapping made by MapFile().
+         */
+        void UnmapFile( const char* aData, size_t aLength );
+    }
+}
+
+#endif // KIPLATFORM_IO_H_
@@ -0,0 +1,66 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <kiplatform/io.h>
+
+#include <wx/string.h>
+
+#include <windows.h>
+
+
+const char* KIPLATFORM::IO::MapFile( const wxString& aPath, size_t& aLength )
+{
+    aLength = 0;
+
+    HANDLE file = CreateFileW( aPath.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+
+    if( file == INVALID_HANDLE_VALUE )
+        return nullptr;
+
+    LARGE_INTEGER size;
+    HANDLE        mapping = nullptr;
+    const char*   data = nullptr;
+
+    if( GetFileSizeEx( file, &size ) && size.QuadPart > 0 )
+        mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+    // The file mapping object holds the file open
+    CloseHandle( file );
+
+    if( !mapping )
+        return nullptr;
+
+    data = static_cast<const char*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+
+    // A mapped view holds the mapping object open, so the handle isn't needed past this point
+    CloseHandle( mapping );
+
+    if( data )
+        aLength = static_cast<size_t>( size.QuadPart );
+
+    return data;
+}
+
+
+void KIPLATFORM::IO::UnmapFile( const char* aData, size_t aLength )
+{
+    if( aData )
+        UnmapViewOfFile( aData );
+}
@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Shared by the GTK and macOS builds: both map files through POSIX mmap().
+ */
+
+#include <kiplatform/io.h>
+
+#include <wx/string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+const char* KIPLATFORM::IO::MapFile( const wxString& aPath, size_t& aLength )
+{
+    int fd = open( aPath.fn_str(), O_RDONLY );
+
+    aLength = 0;
+
+    if( fd < 0 )
+        return nullptr;
+
+    struct stat st;
+    void*       data = MAP_FAILED;
+
+    if( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0 )
+    {
+        data = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( data != MAP_FAILED )
+        {
+            aLength = st.st_size;
+
+            // The file is read once from start to end
+            madvise( data, aLength, MADV_SEQUENTIAL );
+        }
+    }
+
+    // An established mapping stays valid after its descriptor is closed (see mmap(2))
+    close( fd );
+
+    return data == MAP_FAILED ? nullptr : static_cast<const char*>( data );
+}
+
+
+void KIPLATFORM::IO::UnmapFile( const char* aData, size_t aLength )
+{
+    if( aData )
+        munmap( const_cast<char*>( aData ), aLength );
+}
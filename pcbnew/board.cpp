@@ -671,40 +671,24 @@ void BOARD::CacheTriangulation( PROGRESS_REPORTER* aReporter, const std::vector<
     if( aReporter )
         aReporter->Report( _( "Tessellating copper zones..." ) );
 
-    thread_pool& tp = GetKiCadThreadPool();
-    std::vector<std::future<size_t>> returns;
+    std::function<bool( size_t )> report_progress;
 
-    returns.reserve( zones.size() );
-
-    auto cache_zones = [aReporter]( ZONE* aZone ) -> size_t
-            {
-                if( aReporter && aReporter->IsCancelled() )
-                    return 0;
-
-                aZone->CacheTriangulation();
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-
-                return 1;
-            };
-
-    for( ZONE* zone : zones )
-        returns.emplace_back( tp.submit( cache_zones, zone ) );
-
-    // Finalize the triangulation threads
-    for( const std::future<size_t>& ret : returns )
+    if( aReporter )
     {
-        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-
-        while( status != std::future_status::ready )
-        {
-            if( aReporter )
-                aReporter->KeepRefreshing();
-
-            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-        }
+        report_progress =
+                [&]( size_t aDone ) -> bool
+                {
+                    aReporter->SetCurrentProgress( (double) aDone / zones.size() );
+                    return aReporter->KeepRefreshing();
+                };
     }
+
+    ParallelFor( zones.size(),
+                 [&]( size_t aZone )
+                 {
+                     zones[aZone]->CacheTriangulation();
+                 },
+                 report_progress );
 }
 
 
@@ -29,6 +29,7 @@
 #include <tool/tool_manager.h>
 #include <tools/pcb_selection_tool.h>
 #include <tools/zone_filler_tool.h>
+#include <tools/drc_tool.h>
 #include <view/view.h>
 #include <board_commit.h>
 #include <tools/pcb_tool_base.h>
@@ -171,6 +172,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
     bool                itemsDeselected = false;
     bool                solderMaskDirty = false;
     bool                autofillZones = false;
+    DRC_TOOL*           incrementalDrcTool = nullptr;
 
     if( Empty() )
         return;
@@ -196,6 +198,14 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
             zone->CacheBoundingBox();
     }
 
+    if( m_isBoardEditor )
+    {
+        DRC_TOOL* drcTool = m_toolMgr->GetTool<DRC_TOOL>();
+
+        if( drcTool && drcTool->CanRunIncrementalTests() )
+            incrementalDrcTool = drcTool;
+    }
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
@@ -244,6 +254,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
             solderMaskDirty = true;
         }
 
+        if( incrementalDrcTool && boardItem->Type() != PCB_MARKER_T )
+            incrementalDrcTool->DirtyItem( boardItem );
+
         switch( changeType )
         {
         case CHT_ADD:
@@ -570,6 +583,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, int aCommitFlags )
     if( autofillZones )
         m_toolMgr->RunAction( PCB_ACTIONS::zoneFillDirty );
 
+    if( incrementalDrcTool )
+        m_toolMgr->RunAction( PCB_ACTIONS::runIncrementalDRC );
+
     if( frame )
     {
         if( !( aCommitFlags & SKIP_SET_DIRTY ) )
@@ -217,12 +217,13 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
     for( CN_ITEM* item : garbage )
         delete item;
 
+    m_itemList.UpdateIndex();
+
 #ifdef PROFILE
     garbage_collection.Show();
     PROF_TIMER search_basic( "search-basic" );
 #endif
 
-    thread_pool& tp = GetKiCadThreadPool();
     std::vector<CN_ITEM*> dirtyItems;
     std::copy_if( m_itemList.begin(), m_itemList.end(), std::back_inserter( dirtyItems ),
                   [] ( CN_ITEM* aItem )
@@ -240,42 +241,27 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-
-        std::vector<std::future<size_t>> returns( dirtyItems.size() );
-
         auto conn_lambda =
-                [&dirtyItems]( size_t aItem, CN_LIST* aItemList,
-                               PROGRESS_REPORTER* aReporter) -> size_t
+                [&]( size_t aItem )
                 {
-                    if( aReporter && aReporter->IsCancelled() )
-                        return 0;
-
                     CN_VISITOR visitor( dirtyItems[aItem] );
-                    aItemList->FindNearby( dirtyItems[aItem], visitor );
-
-                    if( aReporter )
-                        aReporter->AdvanceProgress();
-
-                    return 1;
+                    m_itemList.FindNearby( dirtyItems[aItem], visitor );
                 };
 
-        for( size_t ii = 0; ii < dirtyItems.size(); ++ii )
-            returns[ii] = tp.submit( conn_lambda, ii, &m_itemList, m_progressReporter );
+        std::function<bool( size_t )> report_progress;
 
-        for( const std::future<size_t>& ret : returns )
+        if( m_progressReporter )
         {
-            // Here we balance returns with a 250ms timeout to allow UI updating
-            std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-
-            while( status != std::future_status::ready )
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
-
-                status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-            }
+            report_progress =
+                    [&]( size_t aDone ) -> bool
+                    {
+                        m_progressReporter->SetCurrentProgress( (double) aDone / dirtyItems.size() );
+                        return m_progressReporter->KeepRefreshing();
+                    };
         }
 
+        ParallelFor( dirtyItems.size(), conn_lambda, report_progress );
+
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
     }
@@ -462,40 +448,25 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 
     // Generate RTrees for CN_ZONE_LAYER items (in parallel)
     //
-    thread_pool& tp = GetKiCadThreadPool();
-    std::vector<std::future<size_t>> returns( zitems.size() );
-
-    auto cache_zones =
-            [aReporter]( CN_ZONE_LAYER* aZoneLayer ) -> size_t
-            {
-                if( aReporter && aReporter->IsCancelled() )
-                    return 0;
+    std::function<bool( size_t )> report_zones;
 
-                aZoneLayer->BuildRTree();
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-
-                return 1;
-            };
-
-    for( size_t ii = 0; ii < zitems.size(); ++ii )
-        returns[ii] = tp.submit( cache_zones, zitems[ii] );
-
-    for( const std::future<size_t>& ret : returns )
+    if( aReporter )
     {
-        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-
-        while( status != std::future_status::ready )
-        {
-            if( aReporter )
-                aReporter->KeepRefreshing();
-
-            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
-        }
-
+        report_zones =
+                [&]( size_t aDone ) -> bool
+                {
+                    aReporter->SetCurrentProgress( aDone / size );
+                    return aReporter->KeepRefreshing();
+                };
     }
 
+    ParallelFor( zitems.size(),
+                 [&]( size_t aZoneLayer )
+                 {
+                     zitems[aZoneLayer]->BuildRTree();
+                 },
+                 report_zones );
+
     // Add CN_ZONE_LAYERS, tracks, and pads to connectivity
     //
     int ii = zitems.size();
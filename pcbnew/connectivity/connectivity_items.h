@@ -445,6 +445,12 @@ public:
 
     void RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage );
 
+    /**
+     * Make items added since the last call visible to FindNearby().  Must be called before
+     * searching and not concurrently with it.
+     */
+    void UpdateIndex() { m_index.Commit(); }
+
     void ClearDirtyFlags()
     {
         for( CN_ITEM* item : m_items )
@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <connectivity/connectivity_rtree.h>
+
+#include <cmath>
+#include <numeric>
+
+
+std::vector<uint32_t> CN_STATIC_RTREE::Build( const std::vector<BOX>& aBoxes )
+{
+    Clear();
+
+    std::vector<uint32_t> order( aBoxes.size() );
+    std::iota( order.begin(), order.end(), 0 );
+
+    m_size = aBoxes.size();
+
+    if( aBoxes.empty() )
+        return order;
+
+    // Sort-Tile-Recursive packing of the items: sort by x into vertical slices of whole
+    // nodes, then sort each slice by y.  Alternate slices run in opposite directions so
+    // that consecutive nodes stay close to one another, which keeps the upper levels
+    // (built from consecutive nodes) tight as well.
+    auto center =
+            [&]( uint32_t aIdx, int aAxis ) -> int64_t
+            {
+                return int64_t( aBoxes[aIdx].m_Min[aAxis] ) + aBoxes[aIdx].m_Max[aAxis];
+            };
+
+    std::sort( order.begin(), order.end(),
+               [&]( uint32_t a, uint32_t b )
+               {
+                   return center( a, 1 ) < center( b, 1 );
+               } );
+
+    size_t nodes = ( aBoxes.size() + FANOUT - 1 ) / FANOUT;
+    size_t slices = std::max<size_t>( 1, (size_t) std::ceil( std::sqrt( (double) nodes ) ) );
+    size_t sliceSize = ( ( nodes + slices - 1 ) / slices ) * FANOUT;
+
+    for( size_t start = 0, ii = 0; start < order.size(); start += sliceSize, ++ii )
+    {
+        auto first = order.begin() + start;
+        auto last = order.begin() + std::min( start + sliceSize, order.size() );
+        bool up = ii % 2;
+
+        std::sort( first, last,
+                   [&]( uint32_t a, uint32_t b )
+                   {
+                       return up ? center( b, 2 ) < center( a, 2 ) : center( a, 2 ) < center( b, 2 );
+                   } );
+    }
+
+    auto initLevel =
+            [this]( size_t aCount ) -> LEVEL&
+            {
+                size_t padded = ( ( aCount + FANOUT - 1 ) / FANOUT ) * FANOUT;
+                LEVEL& level = m_levels.emplace_back();
+
+                level.m_count = aCount;
+
+                for( int d = 0; d < 3; ++d )
+                {
+                    level.m_min[d].assign( padded, INT_MAX );
+                    level.m_max[d].assign( padded, INT_MIN );
+                }
+
+                return level;
+            };
+
+    LEVEL& items = initLevel( aBoxes.size() );
+
+    for( size_t slot = 0; slot < order.size(); ++slot )
+    {
+        for( int d = 0; d < 3; ++d )
+        {
+            items.m_min[d][slot] = aBoxes[order[slot]].m_Min[d];
+            items.m_max[d][slot] = aBoxes[order[slot]].m_Max[d];
+        }
+    }
+
+    while( m_levels.back().m_count > FANOUT )
+    {
+        size_t count = ( m_levels.back().m_count + FANOUT - 1 ) / FANOUT;
+        LEVEL& parent = initLevel( count );
+        LEVEL& child = m_levels[m_levels.size() - 2];
+
+        for( size_t ii = 0; ii < count; ++ii )
+        {
+            for( int d = 0; d < 3; ++d )
+            {
+                for( size_t jj = ii * FANOUT; jj < ( ii + 1 ) * FANOUT; ++jj )
+                {
+                    parent.m_min[d][ii] = std::min( parent.m_min[d][ii], child.m_min[d][jj] );
+                    parent.m_max[d][ii] = std::max( parent.m_max[d][ii], child.m_max[d][jj] );
+                }
+            }
+        }
+    }
+
+    return order;
+}
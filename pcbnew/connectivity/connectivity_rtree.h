@@ -24,23 +24,259 @@
 #ifndef PCBNEW_CONNECTIVITY_RTREE_H_
 #define PCBNEW_CONNECTIVITY_RTREE_H_
 
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
 #include <math/box2.h>
 #include <router/pns_layerset.h>
 
 #include <geometry/rtree.h>
 
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define CN_RTREE_AVX2
+#endif
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define CN_RTREE_SSE2
+#endif
+
+
+/**
+ * A static, bulk-loaded R-tree of boxes in { layer, x, y } space.
+ *
+ * The tree is packed with Sort-Tile-Recursive loading and is implicit: entry e of level k + 1
+ * bounds entries [ 8e, 8e + 8 ) of level k, and level 0 holds the items themselves.  Bounds
+ * are stored as structure-of-arrays int32 so that the 8 entries of a node are tested against
+ * a query box together (with AVX2 or SSE2 when the build targets them).
+ */
+class CN_STATIC_RTREE
+{
+public:
+    static constexpr int FANOUT = 8;
+
+    /// The ways of testing the entries of a node against a query box
+    enum class KERNEL
+    {
+        SCALAR,
+        SSE2,   ///< Only when CN_RTREE_SSE2 is defined
+        AVX2    ///< Only when CN_RTREE_AVX2 is defined
+    };
+
+#if defined( CN_RTREE_AVX2 )
+    static constexpr KERNEL DEFAULT_KERNEL = KERNEL::AVX2;
+#elif defined( CN_RTREE_SSE2 )
+    static constexpr KERNEL DEFAULT_KERNEL = KERNEL::SSE2;
+#else
+    static constexpr KERNEL DEFAULT_KERNEL = KERNEL::SCALAR;
+#endif
+
+    struct BOX
+    {
+        int m_Min[3];
+        int m_Max[3];
+    };
+
+    CN_STATIC_RTREE() :
+            m_size( 0 )
+    { }
+
+    /**
+     * Bulk load the tree, replacing its contents.
+     *
+     * @return the order of the items in the tree: slot s holds item return[s].
+     */
+    std::vector<uint32_t> Build( const std::vector<BOX>& aBoxes );
+
+    void Clear()
+    {
+        m_levels.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @return the number of slots (including removed ones).
+     */
+    size_t Size() const { return m_size; }
+
+    /**
+     * Remove the item in \a aSlot by emptying its bounds.  The tree is not repacked.
+     */
+    void Remove( uint32_t aSlot )
+    {
+        LEVEL& items = m_levels[0];
+
+        for( int d = 0; d < 3; ++d )
+        {
+            items.m_min[d][aSlot] = INT_MAX;
+            items.m_max[d][aSlot] = INT_MIN;
+        }
+    }
+
+    /**
+     * Call \a aFunc( slot ) for each item whose bounds overlap [ \a aMin, \a aMax ].
+     *
+     * @tparam K is the kernel testing the entries of each node; the others than the default one
+     *           are only there to test them against one another.
+     * @return false if \a aFunc returned false to stop the search.
+     */
+    template <KERNEL K = DEFAULT_KERNEL, class Func>
+    bool Query( const int aMin[3], const int aMax[3], Func&& aFunc ) const
+    {
+        if( m_levels.empty() )
+            return true;
+
+        // Depth-first; each level adds at most FANOUT entries to the stack.
+        struct NODE
+        {
+            uint32_t m_level;
+            uint32_t m_group;
+        };
+
+        NODE stack[ FANOUT * 16 ];
+        int  sp = 0;
+
+        stack[sp++] = { (uint32_t) m_levels.size() - 1, 0 };
+
+        while( sp > 0 )
+        {
+            NODE         node = stack[--sp];
+            const LEVEL& level = m_levels[node.m_level];
+            unsigned     hits = level.Overlaps<K>( node.m_group, aMin, aMax );
+
+            for( int ii = 0; hits; ++ii, hits >>= 1 )
+            {
+                if( !( hits & 1 ) )
+                    continue;
+
+                uint32_t entry = node.m_group * FANOUT + ii;
+
+                if( entry >= level.m_count )
+                    break;
+
+                if( node.m_level == 0 )
+                {
+                    if( !aFunc( entry ) )
+                        return false;
+                }
+                else
+                {
+                    stack[sp++] = { node.m_level - 1, entry };
+                }
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct LEVEL
+    {
+        /**
+         * @return a bit mask of the entries of group \a aGroup which overlap the query box.
+         */
+        template <KERNEL K>
+        unsigned Overlaps( size_t aGroup, const int aMin[3], const int aMax[3] ) const
+        {
+            size_t base = aGroup * FANOUT;
+
+#if defined( CN_RTREE_AVX2 )
+            if constexpr( K == KERNEL::AVX2 )
+            {
+                __m256i miss = _mm256_setzero_si256();
+
+                for( int d = 0; d < 3; ++d )
+                {
+                    __m256i lo = _mm256_loadu_si256( (const __m256i*) &m_min[d][base] );
+                    __m256i hi = _mm256_loadu_si256( (const __m256i*) &m_max[d][base] );
+
+                    miss = _mm256_or_si256( miss, _mm256_cmpgt_epi32( lo, _mm256_set1_epi32( aMax[d] ) ) );
+                    miss = _mm256_or_si256( miss, _mm256_cmpgt_epi32( _mm256_set1_epi32( aMin[d] ), hi ) );
+                }
+
+                return ~_mm256_movemask_ps( _mm256_castsi256_ps( miss ) ) & 0xFF;
+            }
+#endif
+
+#if defined( CN_RTREE_SSE2 )
+            if constexpr( K == KERNEL::SSE2 )
+            {
+                __m128i missA = _mm_setzero_si128();
+                __m128i missB = _mm_setzero_si128();
+
+                for( int d = 0; d < 3; ++d )
+                {
+                    __m128i qmin = _mm_set1_epi32( aMin[d] );
+                    __m128i qmax = _mm_set1_epi32( aMax[d] );
+                    __m128i loA = _mm_loadu_si128( (const __m128i*) &m_min[d][base] );
+                    __m128i loB = _mm_loadu_si128( (const __m128i*) &m_min[d][base + 4] );
+                    __m128i hiA = _mm_loadu_si128( (const __m128i*) &m_max[d][base] );
+                    __m128i hiB = _mm_loadu_si128( (const __m128i*) &m_max[d][base + 4] );
+
+                    missA = _mm_or_si128( missA, _mm_cmpgt_epi32( loA, qmax ) );
+                    missA = _mm_or_si128( missA, _mm_cmpgt_epi32( qmin, hiA ) );
+                    missB = _mm_or_si128( missB, _mm_cmpgt_epi32( loB, qmax ) );
+                    missB = _mm_or_si128( missB, _mm_cmpgt_epi32( qmin, hiB ) );
+                }
+
+                unsigned miss = _mm_movemask_ps( _mm_castsi128_ps( missA ) )
+                                | ( _mm_movemask_ps( _mm_castsi128_ps( missB ) ) << 4 );
+
+                return ~miss & 0xFF;
+            }
+#endif
+
+            unsigned hits = 0;
+
+            for( int ii = 0; ii < FANOUT; ++ii )
+            {
+                bool hit = true;
+
+                for( int d = 0; d < 3; ++d )
+                {
+                    hit &= m_min[d][base + ii] <= aMax[d];
+                    hit &= aMin[d] <= m_max[d][base + ii];
+                }
+
+                hits |= (unsigned) hit << ii;
+            }
+
+            return hits;
+        }
+
+        uint32_t             m_count = 0;   ///< Number of entries; the arrays are padded to
+                                            ///< a multiple of FANOUT with empty bounds.
+        std::vector<int32_t> m_min[3];
+        std::vector<int32_t> m_max[3];
+    };
+
+    std::vector<LEVEL> m_levels;
+    size_t             m_size;
+};
+
 
 /**
  * CN_RTREE -
  * Implements an R-tree for fast spatial indexing of connectivity items.
  * Non-owning.
+ *
+ * Most items live in a CN_STATIC_RTREE built in bulk.  Items inserted afterwards are held
+ * back until Commit(), which either adds them to a small dynamic R-tree overlay or, once the
+ * overlay or the number of items removed from the static tree gets too large, rebuilds the
+ * static tree from everything.
  */
 template< class T >
 class CN_RTREE
 {
 public:
 
-    CN_RTREE()
+    CN_RTREE() :
+            m_dynamicCount( 0 ),
+            m_staticRemoved( 0 )
     {
         this->m_tree = new RTree<T, int, 3, double>();
     }
@@ -53,16 +289,11 @@ public:
     /**
      * Function Insert()
      * Inserts an item into the tree. Item's bounding box is taken via its BBox() method.
+     * The item is not visible to Query() until the next Commit().
      */
     void Insert( T aItem )
     {
-        const BOX2I&        bbox    = aItem->BBox();
-        const LAYER_RANGE   layers  = aItem->Layers();
-
-        const int           mmin[3] = { layers.Start(), bbox.GetX(), bbox.GetY() };
-        const int           mmax[3] = { layers.End(), bbox.GetRight(), bbox.GetBottom() };
-
-        m_tree->Insert( mmin, mmax, aItem );
+        m_pending.push_back( aItem );
     }
 
     /**
@@ -72,12 +303,48 @@ public:
      */
     void Remove( T aItem )
     {
+        int mmin[3];
+        int mmax[3];
 
-        // First, attempt to remove the item using its given BBox
-        const BOX2I&        bbox    = aItem->BBox();
-        const LAYER_RANGE   layers  = aItem->Layers();
-        const int           mmin[3] = { layers.Start(), bbox.GetX(), bbox.GetY() };
-        const int           mmax[3] = { layers.End(), bbox.GetRight(), bbox.GetBottom() };
+        getBounds( aItem, mmin, mmax );
+
+        // Most items are in the static tree.  Items are immutable once indexed, so their
+        // bounding box still finds them.
+        int32_t slot = -1;
+
+        m_static.Query( mmin, mmax,
+                        [&]( uint32_t aSlot ) -> bool
+                        {
+                            if( m_staticItems[aSlot] != aItem )
+                                return true;
+
+                            slot = aSlot;
+                            return false;
+                        } );
+
+        if( slot < 0 )
+        {
+            auto it = std::find( m_staticItems.begin(), m_staticItems.end(), aItem );
+
+            if( it != m_staticItems.end() )
+                slot = it - m_staticItems.begin();
+        }
+
+        if( slot >= 0 )
+        {
+            m_static.Remove( slot );
+            m_staticItems[slot] = nullptr;
+            m_staticRemoved++;
+            return;
+        }
+
+        auto pending = std::find( m_pending.begin(), m_pending.end(), aItem );
+
+        if( pending != m_pending.end() )
+        {
+            m_pending.erase( pending );
+            return;
+        }
 
         // If we are not successful ( 1 == not found ), then we expand
         // the search to the full tree
@@ -88,8 +355,12 @@ public:
             // delete it from the tree
             const int       mmin2[3] = { INT_MIN, INT_MIN, INT_MIN };
             const int       mmax2[3] = { INT_MAX, INT_MAX, INT_MAX };
-            m_tree->Remove( mmin2, mmax2, aItem );
+
+            if( m_tree->Remove( mmin2, mmax2, aItem ) )
+                return;
         }
+
+        m_dynamicCount--;
     }
 
     /**
@@ -99,6 +370,84 @@ public:
     void RemoveAll( )
     {
         m_tree->RemoveAll();
+        m_dynamicCount = 0;
+        m_static.Clear();
+        m_staticItems.clear();
+        m_staticRemoved = 0;
+        m_pending.clear();
+    }
+
+    /**
+     * Bulk load the index with \a aItems, replacing its contents.
+     */
+    void Build( const std::vector<T>& aItems )
+    {
+        std::vector<CN_STATIC_RTREE::BOX> boxes( aItems.size() );
+
+        for( size_t ii = 0; ii < aItems.size(); ++ii )
+            getBounds( aItems[ii], boxes[ii].m_Min, boxes[ii].m_Max );
+
+        std::vector<uint32_t> order = m_static.Build( boxes );
+
+        m_staticItems.resize( aItems.size() );
+
+        for( size_t ii = 0; ii < order.size(); ++ii )
+            m_staticItems[ii] = aItems[order[ii]];
+
+        m_staticRemoved = 0;
+        m_tree->RemoveAll();
+        m_dynamicCount = 0;
+        m_pending.clear();
+    }
+
+    /**
+     * Make the items inserted since the last call visible to Query().  Must not be called
+     * concurrently with Query().
+     */
+    void Commit()
+    {
+        size_t live = m_staticItems.size() - m_staticRemoved;
+        size_t overlay = m_dynamicCount + m_pending.size();
+
+        if( overlay > std::max<size_t>( 256, live / 8 ) || m_staticRemoved > live / 4 + 256 )
+        {
+            std::vector<T> items;
+            items.reserve( live + overlay );
+
+            for( T item : m_staticItems )
+            {
+                if( item )
+                    items.push_back( item );
+            }
+
+            const int mmin[3] = { INT_MIN, INT_MIN, INT_MIN };
+            const int mmax[3] = { INT_MAX, INT_MAX, INT_MAX };
+
+            auto collect =
+                    [&items]( T aItem ) -> bool
+                    {
+                        items.push_back( aItem );
+                        return true;
+                    };
+
+            m_tree->Search( mmin, mmax, collect );
+            items.insert( items.end(), m_pending.begin(), m_pending.end() );
+
+            Build( items );
+            return;
+        }
+
+        for( T item : m_pending )
+        {
+            int mmin[3];
+            int mmax[3];
+
+            getBounds( item, mmin, mmax );
+            m_tree->Insert( mmin, mmax, item );
+            m_dynamicCount++;
+        }
+
+        m_pending.clear();
     }
 
     /**
@@ -106,18 +455,47 @@ public:
      * Executes a function object aVisitor for each item whose bounding box intersects
      * with aBounds.
      */
-    template <class Visitor>
+    template <CN_STATIC_RTREE::KERNEL K = CN_STATIC_RTREE::DEFAULT_KERNEL, class Visitor>
     void Query( const BOX2I& aBounds, const LAYER_RANGE& aRange, Visitor& aVisitor ) const
     {
+        assert( m_pending.empty() );
+
         const int   mmin[3] = { aRange.Start(), aBounds.GetX(), aBounds.GetY() };
         const int   mmax[3] = { aRange.End(), aBounds.GetRight(), aBounds.GetBottom() };
 
-        m_tree->Search( mmin, mmax, aVisitor );
+        bool finished = m_static.Query<K>( mmin, mmax,
+                                           [&]( uint32_t aSlot ) -> bool
+                                           {
+                                               T item = m_staticItems[aSlot];
+                                               return !item || aVisitor( item );
+                                           } );
+
+        if( finished && m_dynamicCount > 0 )
+            m_tree->Search( mmin, mmax, aVisitor );
     }
 
 private:
+    static void getBounds( T aItem, int aMin[3], int aMax[3] )
+    {
+        const BOX2I&        bbox    = aItem->BBox();
+        const LAYER_RANGE   layers  = aItem->Layers();
+
+        aMin[0] = layers.Start();
+        aMin[1] = bbox.GetX();
+        aMin[2] = bbox.GetY();
+        aMax[0] = layers.End();
+        aMax[1] = bbox.GetRight();
+        aMax[2] = bbox.GetBottom();
+    }
+
+    CN_STATIC_RTREE           m_static;
+    std::vector<T>            m_staticItems;    // By slot; nullptr once removed
+    size_t                    m_staticRemoved;
+
+    RTree<T, int, 3, double>* m_tree;           // Overlay of items added since the last Build()
+    size_t                    m_dynamicCount;
 
-    RTree<T, int, 3, double>* m_tree;
+    std::vector<T>            m_pending;        // Inserted but not yet committed
 };
 
 
@@ -22,6 +22,7 @@
  */
 
 #include <common.h>
+#include <core/kicad_algo.h>
 #include <board_design_settings.h>
 #include <footprint.h>
 #include <thread_pool.h>
@@ -31,6 +32,18 @@
 #include <drc/drc_rtree.h>
 #include <drc/drc_cache_generator.h>
 
+#include <bitset>
+
+
+static const std::vector<KICAD_T> s_copperItemTypes = {
+    PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T,
+    PCB_PAD_T,
+    PCB_SHAPE_T, PCB_FP_SHAPE_T,
+    PCB_TEXT_T, PCB_FP_TEXT_T, PCB_TEXTBOX_T, PCB_FP_TEXTBOX_T,
+    PCB_DIMENSION_T
+};
+
+
 bool DRC_CACHE_GENERATOR::Run()
 {
     m_board = m_drcEngine->GetBoard();
@@ -103,45 +116,24 @@ bool DRC_CACHE_GENERATOR::Run()
                 return true;
             };
 
-    auto addToCopperTree =
+    auto addItem =
             [&]( BOARD_ITEM* item ) -> bool
             {
                 if( !reportProgress( ii++, count, progressDelta ) )
                     return false;
 
-                LSET layers = item->GetLayerSet();
-
-                // Special-case pad holes which pierce all the copper layers
-                if( item->Type() == PCB_PAD_T )
-                {
-                    PAD* pad = static_cast<PAD*>( item );
-
-                    if( pad->HasHole() )
-                        layers |= LSET::AllCuMask();
-                }
-
-                for( PCB_LAYER_ID layer : layers.Seq() )
-                {
-                    if( IsCopperLayer( layer ) )
-                        m_board->m_CopperItemRTreeCache->Insert( item, layer, m_largestClearance );
-                }
-
+                addToCopperTree( item );
                 return true;
             };
 
     if( !reportPhase( _( "Gathering copper items..." ) ) )
         return false;   // DRC cancelled
 
-    static const std::vector<KICAD_T> itemTypes = {
-        PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T,
-        PCB_PAD_T,
-        PCB_SHAPE_T, PCB_FP_SHAPE_T,
-        PCB_TEXT_T, PCB_FP_TEXT_T, PCB_TEXTBOX_T, PCB_FP_TEXTBOX_T,
-        PCB_DIMENSION_T
-    };
+    // Keep track of the items' entries for incremental runs (see Update())
+    m_board->m_CopperItemRTreeCache->EnableRemove();
 
-    forEachGeometryItem( itemTypes, LSET::AllCuMask(), countItems );
-    forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
+    forEachGeometryItem( s_copperItemTypes, LSET::AllCuMask(), countItems );
+    forEachGeometryItem( s_copperItemTypes, LSET::AllCuMask(), addItem );
 
     if( !reportPhase( _( "Tessellating copper zones..." ) ) )
         return false;   // DRC cancelled
@@ -164,24 +156,8 @@ bool DRC_CACHE_GENERATOR::Run()
                 if( m_drcEngine->IsCancelled() )
                     return 0;
 
-                aZone->CacheBoundingBox();
-                aZone->CacheTriangulation();
-
-                if( !aZone->GetIsRuleArea() && aZone->IsOnCopperLayer() )
-                {
-                   std::unique_ptr<DRC_RTREE> rtree = std::make_unique<DRC_RTREE>();
-
-                   for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
-                   {
-                       if( IsCopperLayer( layer ) )
-                           rtree->Insert( aZone, layer );
-                   }
-
-                   std::unique_lock<std::mutex> cacheLock( m_board->m_CachesMutex );
-                   m_board->m_CopperZoneRTreeCache[ aZone ] = std::move( rtree );
-
-                   done.fetch_add( 1 );
-                }
+                if( cacheZone( aZone ) )
+                    done.fetch_add( 1 );
 
                 return 1;
             };
@@ -203,3 +179,161 @@ bool DRC_CACHE_GENERATOR::Run()
     return !m_drcEngine->IsCancelled();
 }
 
+
+
+void DRC_CACHE_GENERATOR::addToCopperTree( BOARD_ITEM* aItem )
+{
+    LSET layers = aItem->GetLayerSet();
+
+    // Special-case pad holes which pierce all the copper layers
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        PAD* pad = static_cast<PAD*>( aItem );
+
+        if( pad->HasHole() )
+            layers |= LSET::AllCuMask();
+    }
+
+    for( PCB_LAYER_ID layer : layers.Seq() )
+    {
+        if( IsCopperLayer( layer ) )
+            m_board->m_CopperItemRTreeCache->Insert( aItem, layer, m_board->m_DRCMaxClearance );
+    }
+}
+
+
+bool DRC_CACHE_GENERATOR::cacheZone( ZONE* aZone )
+{
+    aZone->CacheBoundingBox();
+    aZone->CacheTriangulation();
+
+    if( aZone->GetIsRuleArea() || !aZone->IsOnCopperLayer() )
+        return false;
+
+    std::unique_ptr<DRC_RTREE> rtree = std::make_unique<DRC_RTREE>();
+
+    for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
+    {
+        if( IsCopperLayer( layer ) )
+            rtree->Insert( aZone, layer );
+    }
+
+    std::unique_lock<std::mutex> cacheLock( m_board->m_CachesMutex );
+    m_board->m_CopperZoneRTreeCache[ aZone ] = std::move( rtree );
+
+    return true;
+}
+
+
+bool DRC_CACHE_GENERATOR::CanUpdate( const std::unordered_set<const BOARD_ITEM*>& aScope )
+{
+    m_board = m_drcEngine->GetBoard();
+
+    // The copper items are indexed with the largest clearance; if an item needs a larger one
+    // every item has to be indexed again
+    for( const BOARD_ITEM* item : aScope )
+    {
+        int localClearance = 0;
+
+        if( item->Type() == PCB_PAD_T )
+            localClearance = static_cast<const PAD*>( item )->GetLocalClearance();
+        else if( item->Type() == PCB_ZONE_T || item->Type() == PCB_FP_ZONE_T )
+            localClearance = static_cast<const ZONE*>( item )->GetLocalClearance();
+
+        if( localClearance > m_board->m_DRCMaxClearance )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool DRC_CACHE_GENERATOR::Update( const std::unordered_set<const BOARD_ITEM*>& aScope,
+                                  const std::unordered_set<const BOARD_ITEM*>& aStaleItems )
+{
+    m_board = m_drcEngine->GetBoard();
+
+    if( !reportPhase( _( "Gathering copper items..." ) ) )
+        return false;   // DRC cancelled
+
+    {
+        std::unique_lock<std::mutex> cacheLock( m_board->m_CachesMutex );
+
+        // The answers involving the changed items may have changed
+        m_board->m_IntersectsAreaCache.clear();
+        m_board->m_EnclosedByAreaCache.clear();
+        m_board->m_IntersectsCourtyardCache.clear();
+        m_board->m_IntersectsFCourtyardCache.clear();
+        m_board->m_IntersectsBCourtyardCache.clear();
+
+        // The stale items may have been deleted, so they're only used as keys
+        auto isStale =
+                [&]( const ZONE* aZone )
+                {
+                    return aStaleItems.count( aZone ) > 0;
+                };
+
+        alg::delete_if( m_board->m_DRCZones, isStale );
+        alg::delete_if( m_board->m_DRCCopperZones, isStale );
+
+        for( auto it = m_board->m_CopperZoneRTreeCache.begin();
+             it != m_board->m_CopperZoneRTreeCache.end(); )
+        {
+            if( isStale( it->first ) )
+                it = m_board->m_CopperZoneRTreeCache.erase( it );
+            else
+                ++it;
+        }
+
+        for( auto it = m_board->m_ZoneBBoxCache.begin(); it != m_board->m_ZoneBBoxCache.end(); )
+        {
+            if( isStale( it->first ) )
+                it = m_board->m_ZoneBBoxCache.erase( it );
+            else
+                ++it;
+        }
+    }
+
+    for( const BOARD_ITEM* item : aStaleItems )
+        m_board->m_CopperItemRTreeCache->Remove( item );
+
+    std::bitset<MAX_STRUCT_TYPE_ID> copperTypes;
+
+    for( KICAD_T type : s_copperItemTypes )
+        copperTypes[ type ] = true;
+
+    for( const BOARD_ITEM* scopeItem : aScope )
+    {
+        BOARD_ITEM* item = const_cast<BOARD_ITEM*>( scopeItem );
+
+        if( item->Type() == PCB_FOOTPRINT_T )
+        {
+            static_cast<FOOTPRINT*>( item )->BuildCourtyardCaches();
+        }
+        else if( item->Type() == PCB_ZONE_T || item->Type() == PCB_FP_ZONE_T )
+        {
+            ZONE* zone = static_cast<ZONE*>( item );
+
+            if( !zone->GetIsRuleArea() )
+            {
+                m_board->m_DRCZones.push_back( zone );
+
+                if( ( zone->GetLayerSet() & LSET::AllCuMask() ).any() )
+                    m_board->m_DRCCopperZones.push_back( zone );
+            }
+
+            cacheZone( zone );
+        }
+        else if( copperTypes[ item->Type() ] || BaseType( item->Type() ) == PCB_DIMENSION_T )
+        {
+            // Careful: if a pad has a hole then it pierces all layers
+            if( ( item->Type() == PCB_PAD_T && item->HasHole() )
+                    || ( item->GetLayerSet() & LSET::AllCuMask() ).any() )
+            {
+                addToCopperTree( item );
+            }
+        }
+    }
+
+    return !m_drcEngine->IsCancelled();
+}
@@ -29,6 +29,8 @@
 
 #include <drc/drc_test_provider_clearance_base.h>
 
+#include <unordered_set>
+
 
 class DRC_CACHE_GENERATOR : public DRC_TEST_PROVIDER_CLEARANCE_BASE
 {
@@ -43,6 +45,34 @@ public:
     }
 
     virtual bool Run() override;
+
+    /**
+     * @return true if the caches built by Run() can be brought up to date by Update() after
+     *         the items of \a aScope have changed.
+     */
+    bool CanUpdate( const std::unordered_set<const BOARD_ITEM*>& aScope );
+
+    /**
+     * Bring the caches built by Run() up to date after some items have changed, without
+     * touching the rest of the board.
+     *
+     * @param aScope are the changed items which are still on the board.
+     * @param aStaleItems are the items whose cached data must be dropped: the changed items,
+     *                    some of which may have been deleted since.  They're only used as keys.
+     */
+    bool Update( const std::unordered_set<const BOARD_ITEM*>& aScope,
+                 const std::unordered_set<const BOARD_ITEM*>& aStaleItems );
+
+private:
+    void addToCopperTree( BOARD_ITEM* aItem );
+
+    /**
+     * Cache the bounding box and triangulation of a zone, and its R-tree if it is a copper
+     * zone.
+     *
+     * @return true if the zone is a copper zone.
+     */
+    bool cacheZone( ZONE* aZone );
 };
 
 
@@ -38,7 +38,9 @@
 #include <drc/drc_cache_generator.h>
 #include <footprint.h>
 #include <pad.h>
+#include <pcb_group.h>
 #include <pcb_track.h>
+#include <pcb_expr_evaluator.h>
 #include <thread_pool.h>
 #include <zone.h>
 
@@ -63,6 +65,10 @@ void drcPrintDebugMessage( int level, const wxString& msg, const char *function,
 }
 
 
+// Shared by all engines so that a generation is never reused, even by a new engine.
+static std::atomic<int> s_rulesGeneration( 0 );
+
+
 DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     UNITS_PROVIDER( pcbIUScale, EDA_UNITS::MILLIMETRES ),
     m_designSettings ( aSettings ),
@@ -70,8 +76,12 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_drawingSheet( nullptr ),
     m_schematicNetlist( nullptr ),
     m_rulesValid( false ),
+    m_rulesGeneration( 0 ),
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
+    m_constraintCacheTimeStamp( -1 ),
+    m_hasTestScope( false ),
+    m_cachesTimeStamp( -1 ),
     m_reporter( nullptr ),
     m_progressReporter( nullptr )
 {
@@ -508,6 +518,164 @@ void DRC_ENGINE::compileRules()
             m_constraintMap[ constraint.m_Type ]->push_back( engineConstraint );
         }
     }
+
+    // Work out which constraints can be resolved through the constraint cache.  A condition
+    // qualifies only if everything it references goes into the cache key.  Disallow and
+    // hole-to-hole constraints also look at item properties directly, so are never cached.
+    clearConstraintCache();
+    m_constraintCacheAttrs.clear();
+
+    for( const auto& [ type, ruleset ] : m_constraintMap )
+    {
+        if( type == DISALLOW_CONSTRAINT || type == HOLE_TO_HOLE_CONSTRAINT )
+            continue;
+
+        int  attrs = 0;
+        bool anyCacheable = false;
+
+        for( DRC_ENGINE_CONSTRAINT* c : *ruleset )
+        {
+            int conditionAttrs = c->condition ? c->condition->GetReferencedAttrs() : 0;
+
+            c->cacheable = !( conditionAttrs & PCB_EXPR_UCODE::REF_OTHER );
+
+            if( c->cacheable )
+            {
+                attrs |= conditionAttrs;
+                anyCacheable = true;
+            }
+        }
+
+        if( anyCacheable )
+            m_constraintCacheAttrs[ type ] = attrs;
+    }
+}
+
+
+bool DRC_ENGINE::CONSTRAINT_CACHE_KEY::operator==( const CONSTRAINT_CACHE_KEY& aOther ) const
+{
+    for( int ii = 0; ii < 2; ++ii )
+    {
+        if( m_Present[ii] != aOther.m_Present[ii]
+                || m_NonCopper[ii] != aOther.m_NonCopper[ii]
+                || m_ItemType[ii] != aOther.m_ItemType[ii]
+                || m_NetCode[ii] != aOther.m_NetCode[ii]
+                || m_NetClass[ii] != aOther.m_NetClass[ii] )
+        {
+            return false;
+        }
+    }
+
+    return m_Type == aOther.m_Type && m_Layer == aOther.m_Layer;
+}
+
+
+std::size_t DRC_ENGINE::CONSTRAINT_CACHE_KEY_HASH::operator()( const CONSTRAINT_CACHE_KEY& aKey ) const
+{
+    std::size_t seed = 0xa82de1c0;
+
+    hash_combine( seed, static_cast<int>( aKey.m_Type ), static_cast<int>( aKey.m_Layer ) );
+
+    for( int ii = 0; ii < 2; ++ii )
+    {
+        hash_combine( seed, aKey.m_Present[ii], aKey.m_NonCopper[ii],
+                      static_cast<int>( aKey.m_ItemType[ii] ), aKey.m_NetCode[ii],
+                      aKey.m_NetClass[ii] );
+    }
+
+    return seed;
+}
+
+
+bool DRC_ENGINE::makeConstraintCacheKey( DRC_CONSTRAINT_T aConstraintType, const BOARD_ITEM* a,
+                                         const BOARD_ITEM* b, PCB_LAYER_ID aLayer,
+                                         bool aNonCopperA, bool aNonCopperB,
+                                         CONSTRAINT_CACHE_KEY& aKey ) const
+{
+    auto it = m_constraintCacheAttrs.find( aConstraintType );
+
+    if( it == m_constraintCacheAttrs.end() )
+        return false;
+
+    const int         attrs = it->second;
+    const BOARD_ITEM* items[2] = { a, b };
+
+    aKey.m_Type = aConstraintType;
+    aKey.m_Layer = aLayer;
+    aKey.m_NonCopper[0] = aNonCopperA;
+    aKey.m_NonCopper[1] = aNonCopperB;
+
+    for( int ii = 0; ii < 2; ++ii )
+    {
+        const BOARD_ITEM* item = items[ii];
+
+        if( !item )
+            continue;
+
+        aKey.m_Present[ii] = true;
+
+        if( attrs & PCB_EXPR_UCODE::REF_TYPE )
+            aKey.m_ItemType[ii] = item->Type();
+
+        if( item->IsConnected() )
+        {
+            const BOARD_CONNECTED_ITEM* citem = static_cast<const BOARD_CONNECTED_ITEM*>( item );
+
+            if( attrs & PCB_EXPR_UCODE::REF_NETNAME )
+                aKey.m_NetCode[ii] = citem->GetNetCode();
+
+            if( attrs & PCB_EXPR_UCODE::REF_NETCLASS )
+                aKey.m_NetClass[ii] = citem->GetEffectiveNetClass();
+        }
+    }
+
+    return true;
+}
+
+
+std::shared_ptr<const std::vector<bool>>
+DRC_ENGINE::getCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey )
+{
+    {
+        std::shared_lock<std::shared_mutex> readLock( m_constraintCacheLock );
+
+        if( m_constraintCacheTimeStamp == m_board->GetTimeStamp() )
+        {
+            auto it = m_constraintCache.find( aKey );
+
+            return it != m_constraintCache.end() ? it->second : nullptr;
+        }
+    }
+
+    // The board has been modified since the cache was filled
+    std::unique_lock<std::shared_mutex> writeLock( m_constraintCacheLock );
+
+    if( m_constraintCacheTimeStamp != m_board->GetTimeStamp() )
+    {
+        m_constraintCache.clear();
+        m_constraintCacheTimeStamp = m_board->GetTimeStamp();
+    }
+
+    return nullptr;
+}
+
+
+void DRC_ENGINE::setCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey,
+                                      std::shared_ptr<const std::vector<bool>> aApplied )
+{
+    std::unique_lock<std::shared_mutex> writeLock( m_constraintCacheLock );
+
+    if( m_constraintCacheTimeStamp == m_board->GetTimeStamp() )
+        m_constraintCache[ aKey ] = std::move( aApplied );
+}
+
+
+void DRC_ENGINE::clearConstraintCache()
+{
+    std::unique_lock<std::shared_mutex> writeLock( m_constraintCacheLock );
+
+    m_constraintCache.clear();
+    m_constraintCacheTimeStamp = -1;
 }
 
 
@@ -523,6 +691,7 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
 
     m_rules.clear();
     m_rulesValid = false;
+    m_rulesGeneration = ++s_rulesGeneration;
 
     for( std::pair<DRC_CONSTRAINT_T, std::vector<DRC_ENGINE_CONSTRAINT*>*> pair : m_constraintMap )
     {
@@ -533,6 +702,8 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
     }
 
     m_constraintMap.clear();
+    m_constraintCacheAttrs.clear();
+    clearConstraintCache();
 
     m_board->IncrementTimeStamp();  // Clear board-level caches
 
@@ -583,18 +754,46 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
 
     DRC_TEST_PROVIDER::Init();
 
-    m_board->IncrementTimeStamp();      // Invalidate all caches...
-
     DRC_CACHE_GENERATOR cacheGenerator;
     cacheGenerator.SetDRCEngine( this );
 
-    if( !cacheGenerator.Run() )         // ... and regenerate them.
-        return;
+    if( m_hasTestScope && m_cachesTimeStamp == m_board->GetTimeStamp()
+            && cacheGenerator.CanUpdate( m_testScope ) )
+    {
+        // Only the scope has changed since the caches were built
+        std::unordered_set<const BOARD_ITEM*> staleItems = m_staleItems;
+
+        staleItems.insert( m_testScope.begin(), m_testScope.end() );
+
+        if( !cacheGenerator.Update( m_testScope, staleItems ) )
+        {
+            m_cachesTimeStamp = -1;
+            return;
+        }
+    }
+    else
+    {
+        m_board->IncrementTimeStamp();  // Invalidate all caches...
+
+        if( !cacheGenerator.Run() )     // ... and regenerate them.
+        {
+            m_cachesTimeStamp = -1;
+            return;
+        }
+
+        m_cachesTimeStamp = m_board->GetTimeStamp();
+    }
+
+    if( m_hasTestScope )
+        buildTestNeighbourhood();
 
     int timestamp = m_board->GetTimeStamp();
 
     for( DRC_TEST_PROVIDER* provider : m_testProviders )
     {
+        if( m_hasTestScope && !provider->SupportsTestScope() )
+            continue;
+
         ReportAux( wxString::Format( wxT( "Run DRC provider: '%s'" ), provider->GetName() ) );
 
         if( !provider->RunTests( aUnits ) )
@@ -607,6 +806,79 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
 }
 
 
+void DRC_ENGINE::SetTestScope( const std::vector<BOARD_ITEM*>& aDirtyItems,
+                               const std::unordered_set<const BOARD_ITEM*>& aStaleItems )
+{
+    std::function<void( BOARD_ITEM* )> addItem =
+            [&]( BOARD_ITEM* aItem )
+            {
+                m_testScope.insert( aItem );
+
+                if( aItem->Type() == PCB_FOOTPRINT_T )
+                    static_cast<FOOTPRINT*>( aItem )->RunOnChildren( addItem );
+                else if( aItem->Type() == PCB_GROUP_T )
+                    static_cast<PCB_GROUP*>( aItem )->RunOnChildren( addItem );
+            };
+
+    m_testScope.clear();
+    m_testNeighbourhood.clear();
+    m_staleItems = aStaleItems;
+    m_hasTestScope = true;
+
+    for( BOARD_ITEM* item : aDirtyItems )
+        addItem( item );
+}
+
+
+void DRC_ENGINE::ClearTestScope()
+{
+    m_testScope.clear();
+    m_testNeighbourhood.clear();
+    m_staleItems.clear();
+    m_hasTestScope = false;
+}
+
+
+void DRC_ENGINE::buildTestNeighbourhood()
+{
+    m_testNeighbourhood = m_testScope;
+
+    for( const BOARD_ITEM* scopeItem : m_testScope )
+    {
+        BOARD_ITEM* item = const_cast<BOARD_ITEM*>( scopeItem );
+        LSET        layers = item->GetLayerSet();
+
+        if( item->Type() == PCB_FOOTPRINT_T || item->Type() == PCB_GROUP_T )
+            continue;   // children are already in the scope
+
+        // Pad holes pierce all the copper layers (see DRC_CACHE_GENERATOR)
+        if( item->Type() == PCB_PAD_T && static_cast<PAD*>( item )->HasHole() )
+            layers |= LSET::AllCuMask();
+
+        for( PCB_LAYER_ID layer : LSET( layers & LSET::AllCuMask() ).Seq() )
+        {
+            m_board->m_CopperItemRTreeCache->QueryColliding( item, layer, layer,
+                    // Filter:
+                    [&]( BOARD_ITEM* other ) -> bool
+                    {
+                        return m_testNeighbourhood.count( other ) == 0;
+                    },
+                    // Visitor:
+                    [&]( BOARD_ITEM* other ) -> bool
+                    {
+                        m_testNeighbourhood.insert( other );
+                        return true;
+                    },
+                    m_board->m_DRCMaxClearance );
+        }
+    }
+
+    ReportAux( wxString::Format( wxT( "Incremental DRC: %d items in scope, %d in neighbourhood" ),
+                                 (int) m_testScope.size(),
+                                 (int) m_testNeighbourhood.size() ) );
+}
+
+
 #define REPORT( s ) { if( aReporter ) { aReporter->Report( s ); } }
 
 DRC_CONSTRAINT DRC_ENGINE::EvalZoneConnection( const BOARD_ITEM* a, const BOARD_ITEM* b,
@@ -862,6 +1134,39 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintType, const BO
                 }
             };
 
+    bool applied = false;   // Set whenever a constraint is applied; see constraint cache
+
+    auto applyConstraint =
+            [&]( const DRC_ENGINE_CONSTRAINT* c )
+            {
+                if( !c->condition || c->condition->GetExpression().IsEmpty() )
+                {
+                    constraint = c->constraint;
+                }
+                else
+                {
+                    if( c->constraint.m_Value.HasMin() )
+                        constraint.m_Value.SetMin( c->constraint.m_Value.Min() );
+
+                    if( c->constraint.m_Value.HasOpt() )
+                        constraint.m_Value.SetOpt( c->constraint.m_Value.Opt() );
+
+                    if( c->constraint.m_Value.HasMax() )
+                        constraint .m_Value.SetMax( c->constraint.m_Value.Max() );
+
+                    // While the expectation would be to OR the disallow flags, we've already
+                    // masked them down to aItem's type -- so we're really only looking for a
+                    // boolean here.
+                    constraint.m_DisallowFlags = c->constraint.m_DisallowFlags;
+
+                    constraint.m_ZoneConnection = c->constraint.m_ZoneConnection;
+
+                    constraint.SetParentRule( c->constraint.GetParentRule() );
+                }
+
+                applied = true;
+            };
+
     auto processConstraint =
             [&]( const DRC_ENGINE_CONSTRAINT* c ) -> bool
             {
@@ -1204,7 +1509,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintType, const BO
                         }
                     }
 
-                    constraint = c->constraint;
+                    applyConstraint( c );
                     return true;
                 }
                 else
@@ -1238,24 +1543,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintType, const BO
                             }
                         }
 
-                        if( c->constraint.m_Value.HasMin() )
-                            constraint.m_Value.SetMin( c->constraint.m_Value.Min() );
-
-                        if( c->constraint.m_Value.HasOpt() )
-                            constraint.m_Value.SetOpt( c->constraint.m_Value.Opt() );
-
-                        if( c->constraint.m_Value.HasMax() )
-                            constraint .m_Value.SetMax( c->constraint.m_Value.Max() );
-
-                        // While the expectation would be to OR the disallow flags, we've already
-                        // masked them down to aItem's type -- so we're really only looking for a
-                        // boolean here.
-                        constraint.m_DisallowFlags = c->constraint.m_DisallowFlags;
-
-                        constraint.m_ZoneConnection = c->constraint.m_ZoneConnection;
-
-                        constraint.SetParentRule( c->constraint.GetParentRule() );
-
+                        applyConstraint( c );
                         return true;
                     }
                     else
@@ -1271,9 +1559,45 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRules( DRC_CONSTRAINT_T aConstraintType, const BO
     if( m_constraintMap.count( aConstraintType ) )
     {
         std::vector<DRC_ENGINE_CONSTRAINT*>* ruleset = m_constraintMap[ aConstraintType ];
+        CONSTRAINT_CACHE_KEY                 cacheKey;
 
-        for( int ii = 0; ii < (int) ruleset->size(); ++ii )
-            processConstraint( ruleset->at( ii ) );
+        // Resolution reports are built up as we go, so they never come from the cache
+        if( !aReporter && makeConstraintCacheKey( aConstraintType, a, b, aLayer, a_is_non_copper,
+                                                  b_is_non_copper, cacheKey ) )
+        {
+            std::shared_ptr<const std::vector<bool>> cached = getCachedConstraint( cacheKey );
+
+            if( cached )
+            {
+                for( int ii = 0; ii < (int) ruleset->size(); ++ii )
+                {
+                    const DRC_ENGINE_CONSTRAINT* c = ruleset->at( ii );
+
+                    if( !c->cacheable )
+                        processConstraint( c );
+                    else if( ( *cached )[ii] )
+                        applyConstraint( c );
+                }
+            }
+            else
+            {
+                auto appliedList = std::make_shared<std::vector<bool>>( ruleset->size(), false );
+
+                for( int ii = 0; ii < (int) ruleset->size(); ++ii )
+                {
+                    applied = false;
+                    processConstraint( ruleset->at( ii ) );
+                    ( *appliedList )[ii] = applied;
+                }
+
+                setCachedConstraint( cacheKey, appliedList );
+            }
+        }
+        else
+        {
+            for( int ii = 0; ii < (int) ruleset->size(); ++ii )
+                processConstraint( ruleset->at( ii ) );
+        }
     }
 
     if( constraint.GetParentRule() && !constraint.GetParentRule()->m_Implicit )
@@ -1541,15 +1865,13 @@ bool DRC_ENGINE::IsErrorLimitExceeded( int error_code )
 void DRC_ENGINE::ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, const VECTOR2I& aPos,
                                   int aMarkerLayer )
 {
-    static std::mutex globalLock;
+    // Providers may report from worker threads
+    std::lock_guard<std::mutex> guard( m_violationLock );
 
     m_errorLimits[ aItem->GetErrorCode() ] -= 1;
 
     if( m_violationHandler )
-    {
-        std::lock_guard<std::mutex> guard( globalLock );
         m_violationHandler( aItem, aPos, aMarkerLayer );
-    }
 
     if( m_reporter )
     {
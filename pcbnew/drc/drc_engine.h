@@ -25,8 +25,11 @@
 #define DRC_ENGINE_H
 
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <units_provider.h>
 #include <geometry/shape.h>
@@ -85,7 +88,12 @@ public:
     DRC_ENGINE( BOARD* aBoard = nullptr, BOARD_DESIGN_SETTINGS* aSettings = nullptr );
     virtual ~DRC_ENGINE();
 
-    void SetBoard( BOARD* aBoard ) { m_board = aBoard; }
+    void SetBoard( BOARD* aBoard )
+    {
+        m_board = aBoard;
+        m_cachesTimeStamp = -1;
+    }
+
     BOARD* GetBoard() const { return m_board; }
 
     void SetDesignSettings( BOARD_DESIGN_SETTINGS* aSettings ) { m_designSettings = aSettings; }
@@ -144,6 +152,52 @@ public:
      */
     void RunTests( EDA_UNITS aUnits,  bool aReportAllTrackErrors, bool aTestFootprints );
 
+    /**
+     * Restrict the next RunTests() to the given (dirty) items.  Footprints and groups stand
+     * for their children.
+     *
+     * Providers which support a test scope then only test pairs with at least one item in the
+     * scope, which requires visiting the scope's neighbourhood: every copper item within the
+     * board's maximum clearance of an item in the scope.  The neighbourhood is gathered once
+     * the caches have been brought up to date.  Providers which don't support a test scope are
+     * skipped, so their markers are left untouched.
+     *
+     * If the board's caches were built by the last RunTests() and the board's timestamp hasn't
+     * moved since, only the cached data of the scope and of \a aStaleItems is rebuilt.  The
+     * timestamp is left alone, so the caches keyed on it (such as the resolved constraints)
+     * are kept.
+     *
+     * @param aStaleItems are the other items changed since the last run (such as deleted
+     *                    items, and the former children of the dirty footprints and groups).
+     *                    They're only used as keys, so they may have been deleted.
+     */
+    void SetTestScope( const std::vector<BOARD_ITEM*>& aDirtyItems,
+                       const std::unordered_set<const BOARD_ITEM*>& aStaleItems = {} );
+
+    void ClearTestScope();
+
+    bool HasTestScope() const { return m_hasTestScope; }
+
+    /**
+     * @return true if pairs involving \a aItem should be tested (always the case when there is
+     *         no scope).
+     */
+    bool IsInTestScope( const BOARD_ITEM* aItem ) const
+    {
+        return !m_hasTestScope || m_testScope.count( aItem ) > 0;
+    }
+
+    /**
+     * @return true if \a aItem might form a pair with an item in the test scope, and so needs
+     *         to be visited (always the case when there is no scope).
+     */
+    bool IsNearTestScope( const BOARD_ITEM* aItem ) const
+    {
+        return !m_hasTestScope || m_testNeighbourhood.count( aItem ) > 0;
+    }
+
+    const std::unordered_set<const BOARD_ITEM*>& GetTestScope() const { return m_testScope; }
+
     bool IsErrorLimitExceeded( int error_code );
 
     DRC_CONSTRAINT EvalRules( DRC_CONSTRAINT_T aConstraintType, const BOARD_ITEM* a,
@@ -164,6 +218,12 @@ public:
 
     bool RulesValid() { return m_rulesValid; }
 
+    /**
+     * Return a value which changes (process-wide) each time the rules are (re)loaded.  Allows
+     * caches of rule-dependent results to be keyed on the rules they were computed with.
+     */
+    int GetRulesGeneration() const { return m_rulesGeneration; }
+
     void ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, const VECTOR2I& aPos,
                           int aMarkerLayer );
 
@@ -222,11 +282,60 @@ private:
         DRC_RULE_CONDITION*        condition;
         std::shared_ptr<DRC_RULE>  parentRule;
         DRC_CONSTRAINT             constraint;
+        bool                       cacheable = false;   // see CONSTRAINT_CACHE_KEY
+    };
+
+    /**
+     * Key for the resolved-constraint cache used by EvalRules().
+     *
+     * Whether a cacheable constraint applies to a pair of items depends only on the fields
+     * below.  Item attributes which none of the cacheable conditions for the constraint type
+     * reference are left at their defaults, so that items differing only in those attributes
+     * share a cache entry.
+     */
+    struct CONSTRAINT_CACHE_KEY
+    {
+        DRC_CONSTRAINT_T m_Type = NULL_CONSTRAINT;
+        PCB_LAYER_ID     m_Layer = UNDEFINED_LAYER;
+        bool             m_Present[2] = { false, false };
+        bool             m_NonCopper[2] = { false, false };
+        KICAD_T          m_ItemType[2] = { TYPE_NOT_INIT, TYPE_NOT_INIT };
+        int              m_NetCode[2] = { -1, -1 };
+        const NETCLASS*  m_NetClass[2] = { nullptr, nullptr };
+
+        bool operator==( const CONSTRAINT_CACHE_KEY& aOther ) const;
+    };
+
+    struct CONSTRAINT_CACHE_KEY_HASH
+    {
+        std::size_t operator()( const CONSTRAINT_CACHE_KEY& aKey ) const;
     };
 
+    /**
+     * Fill in \a aKey for the given items.
+     *
+     * @return false if the constraint type can't be cached.
+     */
+    bool makeConstraintCacheKey( DRC_CONSTRAINT_T aConstraintType, const BOARD_ITEM* a,
+                                 const BOARD_ITEM* b, PCB_LAYER_ID aLayer, bool aNonCopperA,
+                                 bool aNonCopperB, CONSTRAINT_CACHE_KEY& aKey ) const;
+
+    /**
+     * @return which of the constraints of the key's type were applied, or nullptr if the key
+     *         isn't in the cache (or the board has changed since it was filled).
+     */
+    std::shared_ptr<const std::vector<bool>> getCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey );
+
+    void setCachedConstraint( const CONSTRAINT_CACHE_KEY& aKey,
+                              std::shared_ptr<const std::vector<bool>> aApplied );
+
+    void clearConstraintCache();
+
     void loadImplicitRules();
     std::shared_ptr<DRC_RULE> createImplicitRule( const wxString& name );
 
+    void buildTestNeighbourhood();
+
 protected:
     BOARD_DESIGN_SETTINGS*     m_designSettings;
     BOARD*                     m_board;
@@ -235,6 +344,7 @@ protected:
 
     std::vector<std::shared_ptr<DRC_RULE>>  m_rules;
     bool                                    m_rulesValid;
+    int                                     m_rulesGeneration;
     std::vector<DRC_TEST_PROVIDER*>         m_testProviders;
 
     std::vector<int>           m_errorLimits;
@@ -244,7 +354,27 @@ protected:
     // constraint -> rule -> provider
     std::map<DRC_CONSTRAINT_T, std::vector<DRC_ENGINE_CONSTRAINT*>*> m_constraintMap;
 
+    // Resolved-constraint cache.  m_constraintCacheAttrs holds, for each cacheable constraint
+    // type, the item attributes (PCB_EXPR_UCODE::REFERENCED_ATTR) its cacheable conditions
+    // reference.  The cache is flushed on rule reload and whenever the board's timestamp moves.
+    std::map<DRC_CONSTRAINT_T, int>                     m_constraintCacheAttrs;
+    std::unordered_map<CONSTRAINT_CACHE_KEY, std::shared_ptr<const std::vector<bool>>,
+                       CONSTRAINT_CACHE_KEY_HASH>       m_constraintCache;
+    int                                                 m_constraintCacheTimeStamp;
+    std::shared_mutex                                   m_constraintCacheLock;
+
+    // Items to be re-tested by an incremental run, and the items near them (which include
+    // the scope itself).  See SetTestScope().
+    bool                                  m_hasTestScope;
+    std::unordered_set<const BOARD_ITEM*> m_testScope;
+    std::unordered_set<const BOARD_ITEM*> m_testNeighbourhood;
+    std::unordered_set<const BOARD_ITEM*> m_staleItems;
+
+    // The board timestamp when the last RunTests() built the board's caches, or -1.
+    int                                   m_cachesTimeStamp;
+
     DRC_VIOLATION_HANDLER      m_violationHandler;
+    std::mutex                 m_violationLock;
     REPORTER*                  m_reporter;
     PROGRESS_REPORTER*         m_progressReporter;
 
@@ -29,6 +29,7 @@
 #include <pad.h>
 #include <fp_text.h>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <vector>
@@ -85,6 +86,7 @@ public:
             m_tree[layer] = new drc_rtree();
 
         m_count = 0;
+        m_removable = false;
     }
 
     ~DRC_RTREE()
@@ -141,6 +143,9 @@ public:
 
             m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
             m_count++;
+
+            if( m_removable )
+                m_entries[aItem].push_back( { aTargetLayer, bbox, itemShape } );
         }
 
         if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
@@ -157,9 +162,49 @@ public:
             m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
             m_count++;
 
+            if( m_removable )
+                m_entries[aItem].push_back( { aTargetLayer, bbox, itemShape } );
         }
     }
 
+    /**
+     * Keep track of the entries of each item so that they can be removed with Remove().
+     * Must be called while the tree is empty.
+     */
+    void EnableRemove()
+    {
+        wxCHECK( m_count == 0, /* void */ );
+
+        m_removable = true;
+    }
+
+    /**
+     * Remove all the entries of an item from a tree on which EnableRemove() was called.
+     *
+     * @param aItem is only used as a key, so it can be an item which has since been deleted.
+     */
+    void Remove( const BOARD_ITEM* aItem )
+    {
+        wxCHECK( m_removable, /* void */ );
+
+        auto it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        for( const ENTRY& entry : it->second )
+        {
+            const int mmin[2] = { entry.bbox.GetX(), entry.bbox.GetY() };
+            const int mmax[2] = { entry.bbox.GetRight(), entry.bbox.GetBottom() };
+
+            m_tree[entry.layer]->Remove( mmin, mmax, entry.itemShape );
+            delete entry.itemShape;
+            m_count--;
+        }
+
+        m_entries.erase( it );
+    }
+
     /**
      * Remove all items from the RTree.
      */
@@ -169,6 +214,7 @@ public:
             tree->RemoveAll();
 
         m_count = 0;
+        m_entries.clear();
     }
 
     bool CheckColliding( SHAPE* aRefShape, PCB_LAYER_ID aTargetLayer, int aClearance = 0,
@@ -570,8 +616,18 @@ public:
 
 
 private:
+    struct ENTRY
+    {
+        PCB_LAYER_ID     layer;
+        BOX2I            bbox;
+        ITEM_WITH_SHAPE* itemShape;
+    };
+
     drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
     size_t      m_count;
+
+    bool                                                      m_removable;
+    std::unordered_map<const BOARD_ITEM*, std::vector<ENTRY>> m_entries;
 };
 
 
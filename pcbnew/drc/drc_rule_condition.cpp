@@ -86,6 +86,12 @@ bool DRC_RULE_CONDITION::EvaluateFor( const BOARD_ITEM* aItemA, const BOARD_ITEM
 }
 
 
+int DRC_RULE_CONDITION::GetReferencedAttrs() const
+{
+    return m_ucode ? m_ucode->GetReferencedAttrs() : 0;
+}
+
+
 bool DRC_RULE_CONDITION::Compile( REPORTER* aReporter, int aSourceLine, int aSourceOffset )
 {
     PCB_EXPR_COMPILER compiler( new PCB_UNIT_RESOLVER() );
@@ -46,6 +46,12 @@ public:
     void SetExpression( const wxString& aExpression ) { m_expression = aExpression; }
     wxString GetExpression() const { return m_expression; }
 
+    /**
+     * @return the item attributes referenced by the compiled expression, as a mask of
+     *         PCB_EXPR_UCODE::REFERENCED_ATTR flags.
+     */
+    int GetReferencedAttrs() const;
+
 private:
     wxString                        m_expression;
     std::unique_ptr<PCB_EXPR_UCODE> m_ucode;
@@ -83,6 +83,20 @@ void DRC_TEST_PROVIDER::reportViolation( std::shared_ptr<DRC_ITEM>& item,
 }
 
 
+void DRC_TEST_PROVIDER::reportDeferredViolations( std::vector<DEFERRED_VIOLATION>& aViolations )
+{
+    for( DEFERRED_VIOLATION& violation : aViolations )
+    {
+        if( m_drcEngine->IsErrorLimitExceeded( violation.m_Item->GetErrorCode() ) )
+            continue;
+
+        reportViolation( violation.m_Item, violation.m_Pos, violation.m_Layer );
+    }
+
+    aViolations.clear();
+}
+
+
 bool DRC_TEST_PROVIDER::reportProgress( int aCount, int aSize, int aDelta )
 {
     if( ( aCount % aDelta ) == 0 || aCount == aSize -  1 )
@@ -115,6 +129,8 @@ void DRC_TEST_PROVIDER::reportAux( wxString fmt, ... )
 
 void DRC_TEST_PROVIDER::accountCheck( const DRC_RULE* ruleToTest )
 {
+    std::lock_guard<std::mutex> guard( m_statsLock );
+
     auto it = m_stats.find( ruleToTest );
 
     if( it == m_stats.end() )
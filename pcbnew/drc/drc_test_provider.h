@@ -29,6 +29,7 @@
 #include <pcb_marker.h>
 
 #include <functional>
+#include <mutex>
 #include <set>
 
 class DRC_ENGINE;
@@ -99,7 +100,25 @@ public:
     virtual const wxString GetName() const;
     virtual const wxString GetDescription() const;
 
+    /**
+     * Return true if this provider restricts itself to the engine's test scope (see
+     * DRC_ENGINE::SetTestScope()).  Providers which don't are skipped by incremental runs.
+     */
+    virtual bool SupportsTestScope() const { return false; }
+
 protected:
+    /**
+     * A violation found on a worker thread.  Multi-threaded providers collect these into
+     * per-work-unit lists and report them from the calling thread in work-unit order, so that
+     * the final report does not depend on thread scheduling.
+     */
+    struct DEFERRED_VIOLATION
+    {
+        std::shared_ptr<DRC_ITEM> m_Item;
+        VECTOR2I                  m_Pos;
+        int                       m_Layer;
+    };
+
     int forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
                              const std::function<bool(BOARD_ITEM*)>& aFunc );
 
@@ -109,6 +128,12 @@ protected:
     virtual bool reportProgress( int aCount, int aSize, int aDelta );
     virtual bool reportPhase( const wxString& aStageName );
 
+    /**
+     * Report (and clear) a list of violations collected by a worker thread.  Error limits are
+     * applied here as they are not decremented while the workers are running.
+     */
+    void reportDeferredViolations( std::vector<DEFERRED_VIOLATION>& aViolations );
+
     virtual void reportRuleStatistics();
     virtual void accountCheck( const DRC_RULE* ruleToTest );
     virtual void accountCheck( const DRC_CONSTRAINT& constraintToTest );
@@ -127,6 +152,7 @@ protected:
 protected:
     DRC_ENGINE* m_drcEngine;
     std::unordered_map<const DRC_RULE*, int> m_stats;
+    std::mutex  m_statsLock;
     bool        m_isRuleDriven = true;
 };
 
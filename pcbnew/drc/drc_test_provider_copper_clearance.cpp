@@ -21,7 +21,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
 #include <common.h>
+#include <core/kicad_algo.h>
 #include <math_for_graphics.h>
 #include <board_design_settings.h>
 #include <footprint.h>
@@ -40,6 +45,7 @@
 #include <drc/drc_rule.h>
 #include <drc/drc_test_provider_clearance_base.h>
 #include <pcb_dimension.h>
+#include <thread_pool.h>
 
 /*
     Copper clearance test. Checks all copper items (pads, vias, tracks, drawings, zones) for their
@@ -78,6 +84,11 @@ public:
         return wxT( "Tests copper item clearance" );
     }
 
+    virtual bool SupportsTestScope() const override
+    {
+        return true;
+    }
+
 private:
     /**
      * Checks for track/via/hole <-> clearance
@@ -85,20 +96,34 @@ private:
      * @param trackShape Primitive track shape
      * @param layer Which layer to test (in case of vias this can be multiple
      * @param other item against which to test the track item
+     * @param aViolations list to collect any violations found into
      * @return false if there is a clearance violation reported, true if there is none
      */
     bool testTrackAgainstItem( PCB_TRACK* track, SHAPE* trackShape, PCB_LAYER_ID layer,
-                               BOARD_ITEM* other );
+                               BOARD_ITEM* other, std::vector<DEFERRED_VIOLATION>& aViolations );
 
     void testTrackClearances();
 
-    bool testPadAgainstItem( PAD* pad, SHAPE* padShape, PCB_LAYER_ID layer, BOARD_ITEM* other );
+    bool testPadAgainstItem( PAD* pad, SHAPE* padShape, PCB_LAYER_ID layer, BOARD_ITEM* other,
+                             std::vector<DEFERRED_VIOLATION>& aViolations );
 
     void testPadClearances();
 
     void testZonesToZones();
 
-    void testItemAgainstZone( BOARD_ITEM* aItem, ZONE* aZone, PCB_LAYER_ID aLayer );
+    void testItemAgainstZone( BOARD_ITEM* aItem, ZONE* aZone, PCB_LAYER_ID aLayer,
+                              std::vector<DEFERRED_VIOLATION>& aViolations );
+
+    /**
+     * Run \a aUnitCount work units on the thread pool, reporting progress until they have all
+     * completed.  Each unit collects its violations into its own list; these are reported in
+     * unit order once all units are done so that the report is independent of scheduling.
+     *
+     * @return false if DRC was cancelled.
+     */
+    bool runWorkUnits( size_t aUnitCount,
+                       const std::function<void( size_t aUnit,
+                                                 std::vector<DEFERRED_VIOLATION>& aViolations )>& aWorker );
 
     typedef struct checked
     {
@@ -113,6 +138,9 @@ private:
     } layers_checked;
 
 private:
+    // Number of tracks or pads handled by a single thread-pool work unit
+    static constexpr size_t WORK_UNIT_SIZE = 64;
+
     int m_drcEpsilon;
 };
 
@@ -183,7 +211,8 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
 
 bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track, SHAPE* trackShape,
                                                                PCB_LAYER_ID layer,
-                                                               BOARD_ITEM* other )
+                                                               BOARD_ITEM* other,
+                                                               std::vector<DEFERRED_VIOLATION>& aViolations )
 {
     bool           testClearance = !m_drcEngine->IsErrorLimitExceeded( DRCE_CLEARANCE );
     bool           testHoles = !m_drcEngine->IsErrorLimitExceeded( DRCE_HOLE_CLEARANCE );
@@ -223,7 +252,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
                 drcItem->SetItems( track, other );
                 drcItem->SetViolatingRule( constraint.GetParentRule() );
 
-                reportViolation( drcItem, *intersection, layer );
+                aViolations.push_back( { drcItem, *intersection, layer } );
 
                 return false;
             }
@@ -248,7 +277,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
                 drce->SetItems( track, other );
                 drce->SetViolatingRule( constraint.GetParentRule() );
 
-                reportViolation( drce, pos, layer );
+                aViolations.push_back( { drce, pos, layer } );
                 has_error = true;
 
                 if( !m_drcEngine->GetReportAllTrackErrors() )
@@ -304,7 +333,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
                     drce->SetItems( a[ii], b[ii] );
                     drce->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drce, pos, layer );
+                    aViolations.push_back( { drce, pos, layer } );
                     return false;
                 }
             }
@@ -316,7 +345,8 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( PCB_TRACK* track,
 
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZone( BOARD_ITEM* aItem, ZONE* aZone,
-                                                              PCB_LAYER_ID aLayer )
+                                                              PCB_LAYER_ID aLayer,
+                                                              std::vector<DEFERRED_VIOLATION>& aViolations )
 {
     if( !aZone->GetLayerSet().test( aLayer ) )
         return;
@@ -341,11 +371,14 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZone( BOARD_ITEM* aItem,
     if( !testClearance && !testHoles )
         return;
 
-    DRC_RTREE*  zoneTree = m_board->m_CopperZoneRTreeCache[ aZone ].get();
+    // Use find() rather than operator[]; we may be running on several threads at once
+    auto treeIt = m_board->m_CopperZoneRTreeCache.find( aZone );
 
-    if( !zoneTree )
+    if( treeIt == m_board->m_CopperZoneRTreeCache.end() || !treeIt->second )
         return;
 
+    DRC_RTREE*  zoneTree = treeIt->second.get();
+
     DRC_CONSTRAINT constraint;
     int            clearance = -1;
     int            actual;
@@ -384,7 +417,7 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZone( BOARD_ITEM* aItem,
             drce->SetItems( aItem, aZone );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, pos, aLayer );
+            aViolations.push_back( { drce, pos, aLayer } );
         }
     }
 
@@ -423,7 +456,7 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZone( BOARD_ITEM* aItem,
                     drce->SetItems( aItem, aZone );
                     drce->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drce, pos, aLayer );
+                    aViolations.push_back( { drce, pos, aLayer } );
                 }
             }
         }
@@ -431,116 +464,213 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZone( BOARD_ITEM* aItem,
 }
 
 
-void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearances()
+bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::runWorkUnits( size_t aUnitCount,
+        const std::function<void( size_t, std::vector<DEFERRED_VIOLATION>& )>& aWorker )
 {
-    // This is the number of tests between 2 calls to the progress bar
-    const int progressDelta = 100;
-    int       ii = 0;
+    thread_pool&                                 tp = GetKiCadThreadPool();
+    std::vector<std::future<size_t>>             returns;
+    std::vector<std::vector<DEFERRED_VIOLATION>> violations( aUnitCount );
+    std::atomic<size_t>                          done( 0 );
 
-    reportAux( wxT( "Testing %d tracks & vias..." ), m_board->Tracks().size() );
+    returns.reserve( aUnitCount );
 
-    std::map<BOARD_ITEM*, int>                            freePadsUsageMap;
-    std::unordered_map<PTR_PTR_CACHE_KEY, layers_checked> checkedPairs;
+    for( size_t unit = 0; unit < aUnitCount; ++unit )
+    {
+        returns.emplace_back( tp.submit(
+                [&]( size_t aUnit ) -> size_t
+                {
+                    if( m_drcEngine->IsCancelled() )
+                        return 0;
+
+                    aWorker( aUnit, violations[ aUnit ] );
+                    done.fetch_add( 1 );
+                    return 1;
+                },
+                unit ) );
+    }
 
-    for( PCB_TRACK* track : m_board->Tracks() )
+    for( const std::future<size_t>& ret : returns )
     {
-        if( !reportProgress( ii++, m_board->Tracks().size(), progressDelta ) )
-            break;
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
 
-        for( PCB_LAYER_ID layer : LSET( track->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+        while( status != std::future_status::ready )
         {
-            std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
-
-            m_board->m_CopperItemRTreeCache->QueryColliding( track, layer, layer,
-                    // Filter:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
+            m_drcEngine->ReportProgress( static_cast<double>( done ) / aUnitCount );
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+    }
 
-                        if( otherCItem && otherCItem->GetNetCode() == track->GetNetCode() )
-                            return false;
+    if( m_drcEngine->IsCancelled() )
+        return false;
 
-                        BOARD_ITEM* a = track;
-                        BOARD_ITEM* b = other;
+    for( std::vector<DEFERRED_VIOLATION>& unitViolations : violations )
+        reportDeferredViolations( unitViolations );
 
-                        // store canonical order so we don't collide in both directions
-                        // (a:b and b:a)
-                        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                            std::swap( a, b );
+    return true;
+}
 
-                        auto it = checkedPairs.find( { a, b } );
 
-                        if( it != checkedPairs.end() && ( it->second.layers.test( layer )
-                                || ( it->second.has_error && !m_drcEngine->GetReportAllTrackErrors() ) ) )
-                        {
-                            return false;
-                        }
-                        else
-                        {
-                            checkedPairs[ { a, b } ].layers.set( layer );
-                            return true;
-                        }
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        if( other->Type() == PCB_PAD_T && static_cast<PAD*>( other )->IsFreePad() )
-                        {
-                            if( other->GetEffectiveShape( layer )->Collide( trackShape.get() ) )
-                            {
-                                auto it = freePadsUsageMap.find( other );
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearances()
+{
+    std::vector<PCB_TRACK*> tracks( m_board->Tracks().begin(), m_board->Tracks().end() );
 
-                                if( it == freePadsUsageMap.end() )
-                                {
-                                    freePadsUsageMap[ other ] = track->GetNetCode();
-                                    return false;
-                                }
-                                else if( it->second == track->GetNetCode() )
-                                {
-                                    return false;
-                                }
-                            }
-                        }
+    reportAux( wxT( "Testing %d tracks & vias..." ), tracks.size() );
 
-                        BOARD_ITEM* a = track;
-                        BOARD_ITEM* b = other;
+    // A track:track pair is found from both of its tracks; the one earlier in the list owns
+    // the test so that each pair is tested once no matter which worker gets there first.
+    // (With a test scope the tracks near the scope are all visited, so this still holds for
+    // the pairs involving an item in the scope.)
+    std::unordered_map<const BOARD_ITEM*, size_t> trackIndex;
 
-                        // store canonical order so we don't collide in both directions
-                        // (a:b and b:a)
-                        if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                            std::swap( a, b );
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+        trackIndex[ tracks[ii] ] = ii;
 
-                        auto it = checkedPairs.find( { a, b } );
+    // A free pad takes on the net of the first track (of another net) which touches it, and is
+    // not then tested against tracks of that net.  Resolve this up front so that the workers
+    // don't depend on the order in which tracks are visited.
+    std::unordered_map<const BOARD_ITEM*, int> freePadNets;
 
-                        // If we get an error, mark the pair as having a clearance error already
-                        // Only continue if we are reporting all track errors
-                        if( !testTrackAgainstItem( track, trackShape.get(), layer, other ) )
-                        {
-                            if( it != checkedPairs.end() )
-                                it->second.has_error = true;
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( !pad->IsFreePad() )
+                continue;
 
-                            return m_drcEngine->GetReportAllTrackErrors() && !m_drcEngine->IsCancelled();
-                        }
+            LSET   layers = pad->GetLayerSet();
+            size_t first = tracks.size();
 
-                        return !m_drcEngine->IsCancelled();
-                    },
-                    m_board->m_DRCMaxClearance );
+            // Pad holes pierce all the copper layers (see DRC_CACHE_GENERATOR)
+            if( pad->HasHole() )
+                layers |= LSET::AllCuMask();
 
-            for( ZONE* zone : m_board->m_DRCCopperZones )
+            for( PCB_LAYER_ID layer : LSET( layers & LSET::AllCuMask() ).Seq() )
             {
-                testItemAgainstZone( track, zone, layer );
+                m_board->m_CopperItemRTreeCache->QueryColliding( pad, layer, layer,
+                        // Filter:
+                        [&]( BOARD_ITEM* other ) -> bool
+                        {
+                            auto it = trackIndex.find( other );
 
-                if( m_drcEngine->IsCancelled() )
-                    break;
+                            return it != trackIndex.end()
+                                    && tracks[ it->second ]->GetNetCode() != pad->GetNetCode();
+                        },
+                        // Visitor:
+                        [&]( BOARD_ITEM* other ) -> bool
+                        {
+                            first = std::min( first, trackIndex[ other ] );
+                            return true;
+                        } );
             }
+
+            if( first < tracks.size() )
+                freePadNets[ pad ] = tracks[ first ]->GetNetCode();
         }
     }
+
+    auto testTracks =
+            [&]( size_t aUnit, std::vector<DEFERRED_VIOLATION>& aViolations )
+            {
+                size_t last = std::min( tracks.size(), ( aUnit + 1 ) * WORK_UNIT_SIZE );
+
+                for( size_t ii = aUnit * WORK_UNIT_SIZE; ii < last; ++ii )
+                {
+                    PCB_TRACK* track = tracks[ii];
+                    LSET       layers = track->GetLayerSet() & LSET::AllCuMask();
+
+                    if( !m_drcEngine->IsNearTestScope( track ) )
+                        continue;
+
+                    std::unordered_map<BOARD_ITEM*, layers_checked> checkedPairs;
+
+                    for( PCB_LAYER_ID layer : layers.Seq() )
+                    {
+                        std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
+
+                        m_board->m_CopperItemRTreeCache->QueryColliding( track, layer, layer,
+                                // Filter:
+                                [&]( BOARD_ITEM* other ) -> bool
+                                {
+                                    auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
+
+                                    if( otherCItem && otherCItem->GetNetCode() == track->GetNetCode() )
+                                        return false;
+
+                                    if( !m_drcEngine->IsInTestScope( track )
+                                            && !m_drcEngine->IsInTestScope( other ) )
+                                    {
+                                        return false;
+                                    }
+
+                                    auto idx = trackIndex.find( other );
+
+                                    if( idx != trackIndex.end() && idx->second < ii )
+                                        return false;
+
+                                    auto it = checkedPairs.find( other );
+
+                                    if( it != checkedPairs.end() && ( it->second.layers.test( layer )
+                                            || ( it->second.has_error && !m_drcEngine->GetReportAllTrackErrors() ) ) )
+                                    {
+                                        return false;
+                                    }
+                                    else
+                                    {
+                                        checkedPairs[ other ].layers.set( layer );
+                                        return true;
+                                    }
+                                },
+                                // Visitor:
+                                [&]( BOARD_ITEM* other ) -> bool
+                                {
+                                    auto freePadIt = freePadNets.find( other );
+
+                                    if( freePadIt != freePadNets.end()
+                                            && freePadIt->second == track->GetNetCode()
+                                            && other->GetEffectiveShape( layer )->Collide( trackShape.get() ) )
+                                    {
+                                        return false;
+                                    }
+
+                                    // If we get an error, mark the pair as having a clearance
+                                    // error already.  Only continue if we are reporting all
+                                    // track errors.
+                                    if( !testTrackAgainstItem( track, trackShape.get(), layer, other,
+                                                               aViolations ) )
+                                    {
+                                        checkedPairs[ other ].has_error = true;
+
+                                        return m_drcEngine->GetReportAllTrackErrors()
+                                                    && !m_drcEngine->IsCancelled();
+                                    }
+
+                                    return !m_drcEngine->IsCancelled();
+                                },
+                                m_board->m_DRCMaxClearance );
+
+                        for( ZONE* zone : m_board->m_DRCCopperZones )
+                        {
+                            if( m_drcEngine->IsInTestScope( track )
+                                    || m_drcEngine->IsInTestScope( zone ) )
+                            {
+                                testItemAgainstZone( track, zone, layer, aViolations );
+                            }
+
+                            if( m_drcEngine->IsCancelled() )
+                                return;
+                        }
+                    }
+                }
+            };
+
+    runWorkUnits( ( tracks.size() + WORK_UNIT_SIZE - 1 ) / WORK_UNIT_SIZE, testTracks );
 }
 
 
 bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* padShape,
                                                              PCB_LAYER_ID aLayer,
-                                                             BOARD_ITEM* other )
+                                                             BOARD_ITEM* other,
+                                                             std::vector<DEFERRED_VIOLATION>& aViolations )
 {
     bool testClearance = !m_drcEngine->IsErrorLimitExceeded( DRCE_CLEARANCE );
     bool testShorting = !m_drcEngine->IsErrorLimitExceeded( DRCE_SHORTING_ITEMS );
@@ -637,7 +767,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
             drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
             drce->SetItems( pad, otherPad );
 
-            reportViolation( drce, otherPad->GetPosition(), aLayer );
+            aViolations.push_back( { drce, otherPad->GetPosition(), aLayer } );
         }
 
         return !m_drcEngine->IsCancelled();
@@ -670,7 +800,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
                     drce->SetItems( pad, other );
                     drce->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drce, pos, aLayer );
+                    aViolations.push_back( { drce, pos, aLayer } );
                     testHoles = false;  // No need for multiple violations
                 }
             }
@@ -702,7 +832,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
             drce->SetItems( pad, other );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, pos, aLayer );
+            aViolations.push_back( { drce, pos, aLayer } );
             testHoles = false;  // No need for multiple violations
         }
     }
@@ -723,7 +853,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
             drce->SetItems( pad, other );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, pos, aLayer );
+            aViolations.push_back( { drce, pos, aLayer } );
             testHoles = false;  // No need for multiple violations
         }
     }
@@ -744,7 +874,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
             drce->SetItems( pad, otherVia );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, pos, aLayer );
+            aViolations.push_back( { drce, pos, aLayer } );
         }
     }
 
@@ -754,260 +884,433 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( PAD* pad, SHAPE* pa
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearances( )
 {
-    const int progressDelta = 100;
-    size_t    count = 0;
-    int       ii = 0;
+    std::vector<PAD*> pads;
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
-        count += footprint->Pads().size();
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( m_drcEngine->IsNearTestScope( pad ) )
+                pads.push_back( pad );
+        }
+    }
 
-    reportAux( wxT( "Testing %d pads..." ), count );
+    reportAux( wxT( "Testing %d pads..." ), pads.size() );
 
-    std::unordered_map<PTR_PTR_CACHE_KEY, int> checkedPairs;
+    // A pad:pad pair is found from both of its pads, but is only tested by whichever pad (and
+    // layer) found it first in board order.  So we first gather each pad's candidates on the
+    // thread pool, then resolve the duplicates in pad order, and then run the actual tests on
+    // the thread pool again.  A pair the first pad skips (see testPads below) is then tested
+    // from the other pad, as it would be had the first pad never found it.
+    struct PAD_CANDIDATES
+    {
+        std::vector<BOARD_ITEM*>                        visited;   // in filter order
+        std::vector<std::pair<PCB_LAYER_ID, BOARD_ITEM*>> tests;   // nullptr item: test zones
+        std::vector<std::pair<PCB_LAYER_ID, BOARD_ITEM*>> deferred; // left to the other pad
+        std::vector<BOARD_ITEM*>                        skipped;
+    };
 
-    for( FOOTPRINT* footprint : m_board->Footprints() )
+    std::vector<PAD_CANDIDATES> candidates( pads.size() );
+    size_t                      unitCount = ( pads.size() + WORK_UNIT_SIZE - 1 ) / WORK_UNIT_SIZE;
+
+    auto gatherCandidates =
+            [&]( size_t aUnit, std::vector<DEFERRED_VIOLATION>& aViolations )
+            {
+                size_t last = std::min( pads.size(), ( aUnit + 1 ) * WORK_UNIT_SIZE );
+
+                for( size_t ii = aUnit * WORK_UNIT_SIZE; ii < last; ++ii )
+                {
+                    PAD*                            pad = pads[ii];
+                    PAD_CANDIDATES&                 padCandidates = candidates[ii];
+                    std::unordered_set<BOARD_ITEM*> visited;
+
+                    for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
+                    {
+                        m_board->m_CopperItemRTreeCache->QueryColliding( pad, layer, layer,
+                                // Filter:
+                                [&]( BOARD_ITEM* other ) -> bool
+                                {
+                                    if( !m_drcEngine->IsInTestScope( pad )
+                                            && !m_drcEngine->IsInTestScope( other ) )
+                                    {
+                                        return false;
+                                    }
+
+                                    if( !visited.insert( other ).second )
+                                        return false;
+
+                                    padCandidates.visited.push_back( other );
+                                    return true;
+                                },
+                                // Visitor
+                                [&]( BOARD_ITEM* other ) -> bool
+                                {
+                                    padCandidates.tests.emplace_back( layer, other );
+                                    return true;
+                                },
+                                m_board->m_DRCMaxClearance );
+
+                        padCandidates.tests.emplace_back( layer, nullptr );
+                    }
+                }
+            };
+
+    if( !runWorkUnits( unitCount, gatherCandidates ) )
+        return;
+
+    std::unordered_set<PTR_PTR_CACHE_KEY> checkedPairs;
+
+    for( size_t ii = 0; ii < pads.size(); ++ii )
     {
-        for( PAD* pad : footprint->Pads() )
+        std::unordered_set<BOARD_ITEM*> checkedElsewhere;
+
+        for( BOARD_ITEM* other : candidates[ii].visited )
         {
-            for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
+            BOARD_ITEM* a = pads[ii];
+            BOARD_ITEM* b = other;
+
+            // store canonical order so we don't collide in both directions (a:b and b:a)
+            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                std::swap( a, b );
+
+            if( !checkedPairs.insert( PTR_PTR_CACHE_KEY{ a, b } ).second )
+                checkedElsewhere.insert( other );
+        }
+
+        if( !checkedElsewhere.empty() )
+        {
+            alg::delete_if( candidates[ii].tests,
+                    [&]( const std::pair<PCB_LAYER_ID, BOARD_ITEM*>& aTest )
+                    {
+                        if( !aTest.second || !checkedElsewhere.count( aTest.second ) )
+                            return false;
+
+                        candidates[ii].deferred.push_back( aTest );
+                        return true;
+                    } );
+        }
+
+        candidates[ii].visited.clear();
+    }
+
+    auto testPads =
+            [&]( size_t aUnit, std::vector<DEFERRED_VIOLATION>& aViolations )
             {
-                std::shared_ptr<SHAPE> padShape = pad->GetEffectiveShape( layer );
+                size_t last = std::min( pads.size(), ( aUnit + 1 ) * WORK_UNIT_SIZE );
 
-                m_board->m_CopperItemRTreeCache->QueryColliding( pad, layer, layer,
-                        // Filter:
-                        [&]( BOARD_ITEM* other ) -> bool
-                        {
-                            BOARD_ITEM* a = pad;
-                            BOARD_ITEM* b = other;
+                for( size_t ii = aUnit * WORK_UNIT_SIZE; ii < last; ++ii )
+                {
+                    PAD*                   pad = pads[ii];
+                    PCB_LAYER_ID           shapeLayer = UNDEFINED_LAYER;
+                    PCB_LAYER_ID           stoppedLayer = UNDEFINED_LAYER;
+                    std::shared_ptr<SHAPE> padShape;
 
-                            // store canonical order so we don't collide in both directions
-                            // (a:b and b:a)
-                            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
-                                std::swap( a, b );
+                    for( const auto& [ layer, other ] : candidates[ii].tests )
+                    {
+                        if( m_drcEngine->IsCancelled() )
+                            return;
 
-                            if( checkedPairs.find( { a, b } ) != checkedPairs.end() )
+                        if( other )
+                        {
+                            // As for the collision query this replaces, a false return skips
+                            // the remaining items on the layer (but not the zones)
+                            if( layer == stoppedLayer )
                             {
-                                return false;
+                                candidates[ii].skipped.push_back( other );
+                                continue;
                             }
-                            else
+
+                            if( layer != shapeLayer )
                             {
-                                checkedPairs[ { a, b } ] = 1;
-                                return true;
+                                padShape = pad->GetEffectiveShape( layer );
+                                shapeLayer = layer;
                             }
-                        },
-                        // Visitor
-                        [&]( BOARD_ITEM* other ) -> bool
+
+                            if( !testPadAgainstItem( pad, padShape.get(), layer, other,
+                                                     aViolations ) )
+                            {
+                                stoppedLayer = layer;
+                            }
+                        }
+                        else
                         {
-                            return testPadAgainstItem( pad, padShape.get(), layer, other );
-                        },
-                        m_board->m_DRCMaxClearance );
+                            for( ZONE* zone : m_board->m_DRCCopperZones )
+                            {
+                                if( m_drcEngine->IsInTestScope( pad )
+                                        || m_drcEngine->IsInTestScope( zone ) )
+                                {
+                                    testItemAgainstZone( pad, zone, layer, aViolations );
+                                }
+                            }
+                        }
+                    }
+                }
+            };
 
-                for( ZONE* zone : m_board->m_DRCCopperZones )
-                {
-                    testItemAgainstZone( pad, zone, layer );
+    if( !runWorkUnits( unitCount, testPads ) )
+        return;
 
-                    if( m_drcEngine->IsCancelled() )
-                        return;
-                }
-            }
+    std::unordered_set<PTR_PTR_CACHE_KEY> skippedPairs;
 
-            if( !reportProgress( ii++, count, progressDelta ) )
-                return;
+    for( size_t ii = 0; ii < pads.size(); ++ii )
+    {
+        for( BOARD_ITEM* other : candidates[ii].skipped )
+        {
+            BOARD_ITEM* a = pads[ii];
+            BOARD_ITEM* b = other;
+
+            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                std::swap( a, b );
+
+            skippedPairs.insert( PTR_PTR_CACHE_KEY{ a, b } );
         }
+    }
 
-        if( m_drcEngine->IsCancelled() )
-            return;
+    if( skippedPairs.empty() )
+        return;
+
+    bool retest = false;
+
+    for( size_t ii = 0; ii < pads.size(); ++ii )
+    {
+        PAD_CANDIDATES& padCandidates = candidates[ii];
+
+        padCandidates.tests.clear();
+        padCandidates.skipped.clear();
+
+        for( const auto& [ layer, other ] : padCandidates.deferred )
+        {
+            BOARD_ITEM* a = pads[ii];
+            BOARD_ITEM* b = other;
+
+            if( static_cast<void*>( a ) > static_cast<void*>( b ) )
+                std::swap( a, b );
+
+            if( skippedPairs.count( PTR_PTR_CACHE_KEY{ a, b } ) )
+            {
+                padCandidates.tests.emplace_back( layer, other );
+                retest = true;
+            }
+        }
     }
+
+    if( retest )
+        runWorkUnits( unitCount, testPads );
 }
 
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZonesToZones()
 {
-    const int progressDelta = 50;
-
     bool      testClearance = !m_drcEngine->IsErrorLimitExceeded( DRCE_CLEARANCE );
     bool      testIntersects = !m_drcEngine->IsErrorLimitExceeded( DRCE_ZONES_INTERSECT );
 
     SHAPE_POLY_SET  buffer;
     SHAPE_POLY_SET* boardOutline = nullptr;
-    DRC_CONSTRAINT  constraint;
-    int             zone2zoneClearance;
 
     if( m_board->GetBoardPolygonOutlines( buffer ) )
         boardOutline = &buffer;
 
+    std::vector<ZONE*>&       zones = m_board->m_DRCCopperZones;
+    std::vector<PCB_LAYER_ID> layers;
+
+    // An incremental run only needs the zone pairs involving a zone in the test scope
+    if( std::none_of( zones.begin(), zones.end(),
+                      [&]( ZONE* zone )
+                      {
+                          return m_drcEngine->IsInTestScope( zone );
+                      } ) )
+    {
+        return;
+    }
+
     for( int layer_id = F_Cu; layer_id <= B_Cu; ++layer_id )
     {
         PCB_LAYER_ID layer = static_cast<PCB_LAYER_ID>( layer_id );
-        std::vector<SHAPE_POLY_SET> smoothed_polys;
-        smoothed_polys.resize( m_board->m_DRCCopperZones.size() );
 
         // Skip over layers not used on the current board
-        if( !m_board->IsLayerEnabled( layer ) )
-            continue;
+        if( m_board->IsLayerEnabled( layer ) )
+            layers.push_back( layer );
+    }
 
-        for( size_t ii = 0; ii < m_board->m_DRCCopperZones.size(); ii++ )
-        {
-            if( m_board->m_DRCCopperZones[ii]->IsOnLayer( layer ) )
-            {
-                m_board->m_DRCCopperZones[ii]->BuildSmoothedPoly( smoothed_polys[ii], layer,
-                                                                  boardOutline );
-            }
-        }
+    // smoothed_polys[ layer index ][ zone index ]
+    std::vector<std::vector<SHAPE_POLY_SET>> smoothed_polys( layers.size() );
 
-        // iterate through all areas
-        for( size_t ia = 0; ia < m_board->m_DRCCopperZones.size(); ia++ )
-        {
-            if( !reportProgress( layer_id * m_board->m_DRCCopperZones.size() + ia,
-                                 B_Cu * m_board->m_DRCCopperZones.size(), progressDelta ) )
-            {
-                return;     // DRC cancelled
-            }
+    for( std::vector<SHAPE_POLY_SET>& layerPolys : smoothed_polys )
+        layerPolys.resize( zones.size() );
 
-            ZONE* zoneA = m_board->m_DRCCopperZones[ia];
+    // Work units are ( layer, zone ) pairs, both for building the smoothed polygons and for
+    // testing a zone against the zones after it in the list.
+    size_t unitCount = layers.size() * zones.size();
 
-            if( !zoneA->IsOnLayer( layer ) )
-                continue;
+    auto buildSmoothedPolys =
+            [&]( size_t aUnit, std::vector<DEFERRED_VIOLATION>& aViolations )
+            {
+                size_t       layerIdx = aUnit / zones.size();
+                size_t       ii = aUnit % zones.size();
+                PCB_LAYER_ID layer = layers[ layerIdx ];
+
+                if( zones[ii]->IsOnLayer( layer ) )
+                    zones[ii]->BuildSmoothedPoly( smoothed_polys[ layerIdx ][ ii ], layer, boardOutline );
+            };
 
-            for( size_t ia2 = ia + 1; ia2 < m_board->m_DRCCopperZones.size(); ia2++ )
+    auto testZone =
+            [&]( size_t aUnit, std::vector<DEFERRED_VIOLATION>& aViolations )
             {
-                ZONE* zoneB = m_board->m_DRCCopperZones[ia2];
+                size_t                       layerIdx = aUnit / zones.size();
+                size_t                       ia = aUnit % zones.size();
+                PCB_LAYER_ID                 layer = layers[ layerIdx ];
+                std::vector<SHAPE_POLY_SET>& layerPolys = smoothed_polys[ layerIdx ];
+                ZONE*                        zoneA = zones[ia];
+                DRC_CONSTRAINT               constraint;
+                int                          zone2zoneClearance;
+
+                if( !zoneA->IsOnLayer( layer ) )
+                    return;
 
-                // test for same layer
-                if( !zoneB->IsOnLayer( layer ) )
-                    continue;
+                for( size_t ia2 = ia + 1; ia2 < zones.size(); ia2++ )
+                {
+                    ZONE* zoneB = zones[ia2];
 
-                // Test for same net
-                if( zoneA->GetNetCode() == zoneB->GetNetCode() && zoneA->GetNetCode() >= 0 )
-                    continue;
+                    if( !m_drcEngine->IsInTestScope( zoneA ) && !m_drcEngine->IsInTestScope( zoneB ) )
+                        continue;
 
-                // test for different priorities
-                if( zoneA->GetAssignedPriority() != zoneB->GetAssignedPriority() )
-                    continue;
+                    // test for same layer
+                    if( !zoneB->IsOnLayer( layer ) )
+                        continue;
 
-                // rule areas may overlap at will
-                if( zoneA->GetIsRuleArea() || zoneB->GetIsRuleArea() )
-                    continue;
+                    // Test for same net
+                    if( zoneA->GetNetCode() == zoneB->GetNetCode() && zoneA->GetNetCode() >= 0 )
+                        continue;
 
-                // Examine a candidate zone: compare zoneB to zoneA
+                    // test for different priorities
+                    if( zoneA->GetAssignedPriority() != zoneB->GetAssignedPriority() )
+                        continue;
 
-                // Get clearance used in zone to zone test.
-                constraint = m_drcEngine->EvalRules( CLEARANCE_CONSTRAINT, zoneA, zoneB, layer );
-                zone2zoneClearance = constraint.GetValue().Min();
+                    // rule areas may overlap at will
+                    if( zoneA->GetIsRuleArea() || zoneB->GetIsRuleArea() )
+                        continue;
 
-                if( constraint.GetSeverity() == RPT_SEVERITY_IGNORE )
-                    continue;
+                    // Examine a candidate zone: compare zoneB to zoneA
 
-                if( testIntersects )
-                {
-                    // test for some corners of zoneA inside zoneB
-                    for( auto it = smoothed_polys[ia].IterateWithHoles(); it; it++ )
-                    {
-                        VECTOR2I currentVertex = *it;
-                        wxPoint pt( currentVertex.x, currentVertex.y );
+                    // Get clearance used in zone to zone test.
+                    constraint = m_drcEngine->EvalRules( CLEARANCE_CONSTRAINT, zoneA, zoneB, layer );
+                    zone2zoneClearance = constraint.GetValue().Min();
 
-                        if( smoothed_polys[ia2].Contains( currentVertex ) )
+                    if( constraint.GetSeverity() == RPT_SEVERITY_IGNORE )
+                        continue;
+
+                    if( testIntersects )
+                    {
+                        // test for some corners of zoneA inside zoneB
+                        for( auto it = layerPolys[ia].IterateWithHoles(); it; it++ )
                         {
-                            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                            drce->SetItems( zoneA, zoneB );
-                            drce->SetViolatingRule( constraint.GetParentRule() );
+                            VECTOR2I currentVertex = *it;
 
-                            reportViolation( drce, pt, layer );
-                        }
-                    }
+                            if( layerPolys[ia2].Contains( currentVertex ) )
+                            {
+                                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                                drce->SetItems( zoneA, zoneB );
+                                drce->SetViolatingRule( constraint.GetParentRule() );
 
-                    // test for some corners of zoneB inside zoneA
-                    for( auto it = smoothed_polys[ia2].IterateWithHoles(); it; it++ )
-                    {
-                        VECTOR2I currentVertex = *it;
-                        wxPoint pt( currentVertex.x, currentVertex.y );
+                                aViolations.push_back( { drce, currentVertex, layer } );
+                            }
+                        }
 
-                        if( smoothed_polys[ia].Contains( currentVertex ) )
+                        // test for some corners of zoneB inside zoneA
+                        for( auto it = layerPolys[ia2].IterateWithHoles(); it; it++ )
                         {
-                            std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                            drce->SetItems( zoneB, zoneA );
-                            drce->SetViolatingRule( constraint.GetParentRule() );
+                            VECTOR2I currentVertex = *it;
+
+                            if( layerPolys[ia].Contains( currentVertex ) )
+                            {
+                                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                                drce->SetItems( zoneB, zoneA );
+                                drce->SetViolatingRule( constraint.GetParentRule() );
 
-                            reportViolation( drce, pt, layer );
+                                aViolations.push_back( { drce, currentVertex, layer } );
+                            }
                         }
                     }
-                }
-
-                // Iterate through all the segments of refSmoothedPoly
-                std::map<VECTOR2I, int> conflictPoints;
 
-                for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
-                {
-                    // Build ref segment
-                    SEG refSegment = *refIt;
+                    // Iterate through all the segments of refSmoothedPoly
+                    std::map<VECTOR2I, int> conflictPoints;
 
-                    // Iterate through all the segments in smoothed_polys[ia2]
-                    for( auto it = smoothed_polys[ia2].IterateSegmentsWithHoles(); it; it++ )
+                    for( auto refIt = layerPolys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
                     {
-                        // Build test segment
-                        SEG testSegment = *it;
-                        VECTOR2I pt;
-
-                        int ax1, ay1, ax2, ay2;
-                        ax1 = refSegment.A.x;
-                        ay1 = refSegment.A.y;
-                        ax2 = refSegment.B.x;
-                        ay2 = refSegment.B.y;
-
-                        int bx1, by1, bx2, by2;
-                        bx1 = testSegment.A.x;
-                        by1 = testSegment.A.y;
-                        bx2 = testSegment.B.x;
-                        by2 = testSegment.B.y;
-
-                        int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2, 0,
-                                                             ax1, ay1, ax2, ay2, 0,
-                                                             zone2zoneClearance, &pt.x, &pt.y );
-
-                        if( d < zone2zoneClearance )
+                        // Build ref segment
+                        SEG refSegment = *refIt;
+
+                        // Iterate through all the segments in layerPolys[ia2]
+                        for( auto it = layerPolys[ia2].IterateSegmentsWithHoles(); it; it++ )
                         {
-                            if( conflictPoints.count( pt ) )
-                                conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
-                            else
-                                conflictPoints[ pt ] = d;
+                            // Build test segment
+                            SEG testSegment = *it;
+                            VECTOR2I pt;
+
+                            int ax1, ay1, ax2, ay2;
+                            ax1 = refSegment.A.x;
+                            ay1 = refSegment.A.y;
+                            ax2 = refSegment.B.x;
+                            ay2 = refSegment.B.y;
+
+                            int bx1, by1, bx2, by2;
+                            bx1 = testSegment.A.x;
+                            by1 = testSegment.A.y;
+                            bx2 = testSegment.B.x;
+                            by2 = testSegment.B.y;
+
+                            int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2, 0,
+                                                                 ax1, ay1, ax2, ay2, 0,
+                                                                 zone2zoneClearance, &pt.x, &pt.y );
+
+                            if( d < zone2zoneClearance )
+                            {
+                                if( conflictPoints.count( pt ) )
+                                    conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
+                                else
+                                    conflictPoints[ pt ] = d;
+                            }
                         }
                     }
-                }
 
-                for( const std::pair<const VECTOR2I, int>& conflict : conflictPoints )
-                {
-                    int actual = conflict.second;
-                    std::shared_ptr<DRC_ITEM> drce;
-
-                    if( actual <= 0 && testIntersects )
-                    {
-                        drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                    }
-                    else if( testClearance )
+                    for( const std::pair<const VECTOR2I, int>& conflict : conflictPoints )
                     {
-                        drce = DRC_ITEM::Create( DRCE_CLEARANCE );
-                        wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
-                                                  constraint.GetName(),
-                                                  zone2zoneClearance,
-                                                  std::max( actual, 0 ) );
+                        int actual = conflict.second;
+                        std::shared_ptr<DRC_ITEM> drce;
 
-                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
-                    }
+                        if( actual <= 0 && testIntersects )
+                        {
+                            drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                        }
+                        else if( testClearance )
+                        {
+                            drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+                            wxString msg = formatMsg( _( "(%s clearance %s; actual %s)" ),
+                                                      constraint.GetName(),
+                                                      zone2zoneClearance,
+                                                      std::max( actual, 0 ) );
 
-                    if( drce )
-                    {
-                        drce->SetItems( zoneA, zoneB );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
+                            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
+                        }
 
-                        reportViolation( drce, conflict.first, layer );
+                        if( drce )
+                        {
+                            drce->SetItems( zoneA, zoneB );
+                            drce->SetViolatingRule( constraint.GetParentRule() );
+
+                            aViolations.push_back( { drce, conflict.first, layer } );
+                        }
                     }
+
+                    if( m_drcEngine->IsCancelled() )
+                        return;
                 }
+            };
 
-                if( m_drcEngine->IsCancelled() )
-                    return;
-            }
-        }
-    }
+    if( !runWorkUnits( unitCount, buildSmoothedPolys ) )
+        return;
+
+    runWorkUnits( unitCount, testZone );
 }
 
 
@@ -25,6 +25,7 @@
 #include <dialogs/html_message_box.h>
 #include <footprint.h>
 #include <footprint_info.h>
+#include <footprint_library_index.h>
 #include <fp_lib_table.h>
 #include <kiway.h>
 #include <locale_io.h>
@@ -130,6 +131,7 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
     m_list.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_queue_indexed.clear();
 
     if( aNickname )
     {
@@ -168,8 +170,53 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
 }
 
 
+bool FOOTPRINT_LIST_IMPL::loadIndexedLib( const wxString& aNickname )
+{
+    const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( aNickname, true );
+
+    if( !row || row->GetType() != IO_MGR::ShowType( IO_MGR::KICAD_SEXP ) )
+        return false;
+
+    wxString libPath = row->GetFullURI( true );
+
+    if( !wxFileName::DirExists( libPath ) )
+        return false;
+
+    FOOTPRINT_LIBRARY_INDEX index( libPath );
+
+    // Errors are reported once the footprints which did parse have been listed.
+    wxString errors;
+
+    try
+    {
+        index.Update( &m_cancelled );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        errors = ioe.What();
+    }
+
+    for( const FOOTPRINT_LIBRARY_INDEX::ENTRY& entry : index.GetEntries() )
+    {
+        auto* fpinfo = new FOOTPRINT_INFO_IMPL( aNickname, entry.m_Name, entry.m_Description,
+                                                entry.m_Keywords, 0, entry.m_PadCount,
+                                                entry.m_UniquePadCount );
+
+        m_queue_indexed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+    }
+
+    if( !errors.IsEmpty() )
+        THROW_IO_ERROR( errors );
+
+    return true;
+}
+
+
 void FOOTPRINT_LIST_IMPL::loadLibs()
 {
+    // Indexed libraries are parsed here, which requires changing the (global) locale before
+    // the threads are created.  See loadFootprints().
+    LOCALE_IO    toggle_locale;
     thread_pool& tp = GetKiCadThreadPool();
     size_t num_returns = m_queue_in.size();
     std::vector<std::future<size_t>> returns( num_returns );
@@ -184,8 +231,11 @@ void FOOTPRINT_LIST_IMPL::loadLibs()
                 {
                     if( CatchErrors( [this, &nickname]()
                                      {
-                                         m_lib_table->PrefetchLib( nickname );
-                                         m_queue_out.push( nickname );
+                                         if( !loadIndexedLib( nickname ) )
+                                         {
+                                             m_lib_table->PrefetchLib( nickname );
+                                             m_queue_out.push( nickname );
+                                         }
                                      } ) && m_progress_reporter )
                     {
                         m_progress_reporter->AdvanceProgress();
@@ -287,6 +337,9 @@ void FOOTPRINT_LIST_IMPL::loadFootprints()
     while( queue_parsed.pop( fpi ) )
         m_list.push_back( std::move( fpi ) );
 
+    while( m_queue_indexed.pop( fpi ) )
+        m_list.push_back( std::move( fpi ) );
+
     std::sort( m_list.begin(), m_list.end(),
                []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
                    std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
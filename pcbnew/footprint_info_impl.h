@@ -105,8 +105,18 @@ private:
      */
     bool CatchErrors( const std::function<void()>& aFunc );
 
+    /**
+     * Read the footprint information of a KiCad (.pretty) library from its persistent
+     * FOOTPRINT_LIBRARY_INDEX, parsing only the footprint files which changed since the index
+     * was last saved.
+     *
+     * @return false if the library is not a KiCad library and must be loaded by its plugin.
+     */
+    bool loadIndexedLib( const wxString& aNickname );
+
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
+    SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> m_queue_indexed;
     long long                m_list_timestamp;
     PROGRESS_REPORTER*       m_progress_reporter;
     std::atomic_bool         m_cancelled;
@@ -0,0 +1,372 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <footprint_library_index.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include <footprint.h>
+#include <paths.h>
+#include <plugins/kicad/pcb_parser.h>
+#include <richio.h>
+#include <wildcards_and_files_ext.h>
+#include <wx_filename.h>
+
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+/*
+ * Index file layout (native byte order; the index never leaves the machine which wrote it):
+ *
+ *   char[8]    "KIFPIDX1"
+ *   uint32     INDEX_VERSION
+ *   string     library path
+ *   uint32     entry count
+ *   entries:   int64 mtime, int64 size, uint32 pad count, uint32 unique pad count,
+ *              string name, string keywords, string description
+ *
+ * Strings are stored as a uint32 byte count followed by UTF-8 text.
+ */
+
+static const char     INDEX_MAGIC[8] = { 'K', 'I', 'F', 'P', 'I', 'D', 'X', '1' };
+static const uint32_t INDEX_VERSION = 1;
+
+
+namespace
+{
+
+class INDEX_READER
+{
+public:
+    INDEX_READER( const char* aData, size_t aLength ) :
+            m_pos( aData ),
+            m_end( aData + aLength )
+    { }
+
+    bool ReadBytes( void* aDest, size_t aLength )
+    {
+        if( aLength > size_t( m_end - m_pos ) )
+            return false;
+
+        memcpy( aDest, m_pos, aLength );
+        m_pos += aLength;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadValue( T& aValue )
+    {
+        return ReadBytes( &aValue, sizeof( T ) );
+    }
+
+    bool ReadString( wxString& aValue )
+    {
+        uint32_t length;
+
+        if( !ReadValue( length ) || length > size_t( m_end - m_pos ) )
+            return false;
+
+        aValue = wxString::FromUTF8( m_pos, length );
+        m_pos += length;
+        return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_end; }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+
+class INDEX_WRITER
+{
+public:
+    template <typename T>
+    void WriteValue( T aValue )
+    {
+        m_buffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+    }
+
+    void WriteString( const wxString& aValue )
+    {
+        wxScopedCharBuffer utf8 = aValue.utf8_str();
+
+        WriteValue( uint32_t( utf8.length() ) );
+        m_buffer.append( utf8.data(), utf8.length() );
+    }
+
+    void WriteBytes( const char* aData, size_t aLength ) { m_buffer.append( aData, aLength ); }
+
+    const std::string& GetBuffer() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+} // namespace
+
+
+FOOTPRINT_LIBRARY_INDEX::FOOTPRINT_LIBRARY_INDEX( const wxString& aLibraryPath,
+                                                  const wxString& aIndexDir ) :
+        m_libraryPath( aLibraryPath ),
+        m_indexDir( aIndexDir )
+{
+}
+
+
+wxString FOOTPRINT_LIBRARY_INDEX::GetIndexFileName() const
+{
+    wxFileName fn;
+
+    if( m_indexDir.IsEmpty() )
+    {
+        fn.AssignDir( PATHS::GetUserCachePath() );
+        fn.AppendDir( wxT( "fp-index" ) );
+    }
+    else
+    {
+        fn.AssignDir( m_indexDir );
+    }
+
+    // Hash collisions are caught by the library path stored in the index.
+    size_t hash = std::hash<std::string>()( std::string( m_libraryPath.utf8_str() ) );
+
+    fn.SetFullName( wxString::Format( wxT( "%016llx.fpidx" ), (unsigned long long) hash ) );
+
+    return fn.GetFullPath();
+}
+
+
+void FOOTPRINT_LIBRARY_INDEX::Update( const std::atomic_bool* aCancelled )
+{
+    std::map<wxString, ENTRY> saved;
+
+    m_entries.clear();
+    read( saved );
+
+    wxDir dir( m_libraryPath );
+
+    if( !dir.IsOpened() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Footprint library '%s' not found." ),
+                                          m_libraryPath ) );
+    }
+
+    wxString fullName;
+    wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+    wxString errors;
+    size_t   reused = 0;
+    bool     dirty = false;
+
+    // wxFileName construction is egregiously slow.  Construct it once and just swap out
+    // the filename thereafter.
+    WX_FILENAME fn( m_libraryPath, wxT( "dummyName" ) );
+
+    for( bool more = dir.GetFirst( &fullName, fileSpec ); more; more = dir.GetNext( &fullName ) )
+    {
+        if( aCancelled && *aCancelled )
+            return;
+
+        fn.SetFullName( fullName );
+
+        wxString     path = fn.GetFullPath();
+        wxStructStat st;
+
+        if( wxStat( path, &st ) != 0 )
+            continue;
+
+        ENTRY entry;
+        entry.m_Name = fn.GetName();
+        entry.m_ModTime = st.st_mtime;
+        entry.m_Size = st.st_size;
+
+        auto it = saved.find( entry.m_Name );
+
+        if( it != saved.end() && it->second.m_ModTime == entry.m_ModTime
+                && it->second.m_Size == entry.m_Size )
+        {
+            m_entries.push_back( it->second );
+            reused++;
+            continue;
+        }
+
+        dirty = true;
+
+        // Queue I/O errors so only files that fail to parse are left out.  They aren't indexed
+        // so they will be tried again next time.
+        try
+        {
+            parseFootprint( path, entry );
+            m_entries.push_back( entry );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            if( !errors.IsEmpty() )
+                errors += wxT( "\n\n" );
+
+            errors += ioe.What();
+        }
+    }
+
+    // Footprints which have been deleted from the library
+    if( reused < saved.size() )
+        dirty = true;
+
+    if( dirty )
+        write();
+
+    if( !errors.IsEmpty() )
+        THROW_IO_ERROR( errors );
+}
+
+
+void FOOTPRINT_LIBRARY_INDEX::parseFootprint( const wxString& aFileName, ENTRY& aEntry ) const
+{
+    MAPPED_FILE_LINE_READER     reader( aFileName );
+    PCB_PARSER                  parser( &reader, nullptr, nullptr );
+    std::unique_ptr<BOARD_ITEM> item( parser.Parse() );
+    FOOTPRINT*                  footprint = dynamic_cast<FOOTPRINT*>( item.get() );
+
+    if( !footprint )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "File '%s' does not contain a footprint." ),
+                                          aFileName ) );
+    }
+
+    aEntry.m_PadCount = footprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+    aEntry.m_UniquePadCount = footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+    aEntry.m_Keywords = footprint->GetKeywords();
+    aEntry.m_Description = footprint->GetDescription();
+}
+
+
+bool FOOTPRINT_LIBRARY_INDEX::read( std::map<wxString, ENTRY>& aEntries ) const
+{
+    wxString indexFileName = GetIndexFileName();
+
+    if( !wxFileName::FileExists( indexFileName ) )
+        return false;
+
+    try
+    {
+        MAPPED_FILE_LINE_READER file( indexFileName );
+        INDEX_READER            reader( file.Buffer(), file.BufferLength() );
+        char                    magic[ sizeof( INDEX_MAGIC ) ];
+        uint32_t                version;
+        wxString                libraryPath;
+        uint32_t                count;
+
+        if( !reader.ReadBytes( magic, sizeof( magic ) )
+                || memcmp( magic, INDEX_MAGIC, sizeof( magic ) ) != 0
+                || !reader.ReadValue( version ) || version != INDEX_VERSION
+                || !reader.ReadString( libraryPath ) || libraryPath != m_libraryPath
+                || !reader.ReadValue( count ) )
+        {
+            return false;
+        }
+
+        for( uint32_t ii = 0; ii < count; ++ii )
+        {
+            ENTRY   entry;
+            int64_t modTime;
+            int64_t size;
+
+            if( !reader.ReadValue( modTime ) || !reader.ReadValue( size )
+                    || !reader.ReadValue( entry.m_PadCount )
+                    || !reader.ReadValue( entry.m_UniquePadCount )
+                    || !reader.ReadString( entry.m_Name )
+                    || !reader.ReadString( entry.m_Keywords )
+                    || !reader.ReadString( entry.m_Description ) )
+            {
+                aEntries.clear();
+                return false;
+            }
+
+            entry.m_ModTime = modTime;
+            entry.m_Size = size;
+            aEntries.emplace( entry.m_Name, entry );
+        }
+
+        if( !reader.AtEnd() )
+        {
+            aEntries.clear();
+            return false;
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        aEntries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void FOOTPRINT_LIBRARY_INDEX::write() const
+{
+    wxFileName indexFileName( GetIndexFileName() );
+
+    if( !PATHS::EnsurePathExists( indexFileName.GetPath() ) )
+        return;
+
+    INDEX_WRITER writer;
+
+    writer.WriteBytes( INDEX_MAGIC, sizeof( INDEX_MAGIC ) );
+    writer.WriteValue( INDEX_VERSION );
+    writer.WriteString( m_libraryPath );
+    writer.WriteValue( uint32_t( m_entries.size() ) );
+
+    for( const ENTRY& entry : m_entries )
+    {
+        writer.WriteValue( int64_t( entry.m_ModTime ) );
+        writer.WriteValue( int64_t( entry.m_Size ) );
+        writer.WriteValue( uint32_t( entry.m_PadCount ) );
+        writer.WriteValue( uint32_t( entry.m_UniquePadCount ) );
+        writer.WriteString( entry.m_Name );
+        writer.WriteString( entry.m_Keywords );
+        writer.WriteString( entry.m_Description );
+    }
+
+    wxFileName tmpFileName = wxFileName::CreateTempFileName( indexFileName.GetFullPath() );
+    bool       ok = false;
+
+    {
+        wxFFile file( tmpFileName.GetFullPath(), wxT( "wb" ) );
+
+        if( file.IsOpened() )
+        {
+            const std::string& buffer = writer.GetBuffer();
+            ok = file.Write( buffer.data(), buffer.size() ) == buffer.size();
+            ok = file.Close() && ok;
+        }
+    }
+
+    // Several footprint lists may be rebuilding the same library at once; the last one to
+    // finish wins, which is fine since they all index the same files.
+    if( !ok || !wxRenameFile( tmpFileName.GetFullPath(), indexFileName.GetFullPath(), true ) )
+        wxRemoveFile( tmpFileName.GetFullPath() );
+}
@@ -0,0 +1,104 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FOOTPRINT_LIBRARY_INDEX_H
+#define FOOTPRINT_LIBRARY_INDEX_H
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * A binary index of the footprints in a KiCad footprint library (.pretty) directory.
+ *
+ * The index holds the information shown by the footprint chooser for each footprint along with
+ * the size and modification time of its file.  It is kept in the user cache directory so that
+ * only footprint files which were added or changed since the index was last written need to be
+ * parsed when the footprint list is rebuilt.
+ */
+class FOOTPRINT_LIBRARY_INDEX
+{
+public:
+    struct ENTRY
+    {
+        wxString     m_Name;             ///< Footprint name (the file name without extension).
+        long long    m_ModTime = 0;      ///< Footprint file modification time.
+        long long    m_Size = 0;         ///< Footprint file size.
+        unsigned int m_PadCount = 0;
+        unsigned int m_UniquePadCount = 0;
+        wxString     m_Keywords;
+        wxString     m_Description;
+    };
+
+    /**
+     * @param aLibraryPath is the library (.pretty) directory.
+     * @param aIndexDir is the directory the index is saved to; the "fp-index" directory of the
+     *                  user cache directory if empty.
+     */
+    FOOTPRINT_LIBRARY_INDEX( const wxString& aLibraryPath,
+                             const wxString& aIndexDir = wxEmptyString );
+
+    /**
+     * Read the saved index, revalidate it against the library directory and parse any new or
+     * changed footprint files.  The index is saved again if anything changed.
+     *
+     * Footprint parsing is locale dependent; the caller must hold a LOCALE_IO.
+     *
+     * @param aCancelled if not null, is polled between footprint files.
+     * @throw IO_ERROR if the library cannot be read or some of its footprint files fail to
+     *        parse.  The entries for the footprints which did parse are still available.
+     */
+    void Update( const std::atomic_bool* aCancelled = nullptr );
+
+    const std::vector<ENTRY>& GetEntries() const { return m_entries; }
+
+    /**
+     * @return the file the index of this library is saved to.
+     */
+    wxString GetIndexFileName() const;
+
+private:
+    /**
+     * Read the saved index into \a aEntries, keyed by footprint name.
+     *
+     * @return false if there is no saved index or it is unusable (in which case it is ignored).
+     */
+    bool read( std::map<wxString, ENTRY>& aEntries ) const;
+
+    /**
+     * Save the index.  Failures are ignored: the index is only a cache.
+     */
+    void write() const;
+
+    /**
+     * Parse a footprint file and fill in the footprint information of \a aEntry.
+     *
+     * @throw IO_ERROR if the file cannot be read or does not hold a footprint.
+     */
+    void parseFootprint( const wxString& aFileName, ENTRY& aEntry ) const;
+
+    wxString           m_libraryPath;
+    wxString           m_indexDir;
+    std::vector<ENTRY> m_entries;
+};
+
+#endif // FOOTPRINT_LIBRARY_INDEX_H
@@ -269,7 +269,7 @@ void KICAD_NETLIST_PARSER::parseNet()
                     wxString msg;
                     msg.Printf( _( "Cannot find component with ref '%s' in netlist." ),
                                 reference );
-                    THROW_PARSE_ERROR( msg, m_lineReader->GetSource(), m_lineReader->Line(),
+                    THROW_PARSE_ERROR( msg, m_lineReader->GetSource(), CurLine(),
                                        m_lineReader->LineNumber(), m_lineReader->Length() );
                 }
 
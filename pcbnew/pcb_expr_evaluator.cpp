@@ -26,6 +26,8 @@
 #include <memory>
 #include <board.h>
 #include <board_connected_item.h>
+#include <netinfo.h>
+#include <string_utils.h>
 #include <pcb_expr_evaluator.h>
 #include <drc/drc_engine.h>
 
@@ -43,6 +45,38 @@ BOARD_ITEM* PCB_EXPR_VAR_REF::GetObject( const LIBEVAL::CONTEXT* aCtx ) const
 }
 
 
+static bool layerMatches( BOARD* aBoard, const wxString& aLayerName, PCB_LAYER_ID aLayer )
+{
+    // For boards with user-defined layer names there will be 2 entries for each layer
+    // in the ENUM_MAP: one for the canonical layer name and one for the user layer name.
+    // We need to check against both.
+
+    wxPGChoices&                 layerMap = ENUM_MAP<PCB_LAYER_ID>::Instance().Choices();
+    std::unique_lock<std::mutex> cacheLock( aBoard->m_CachesMutex );
+    auto                         i = aBoard->m_LayerExpressionCache.find( aLayerName );
+    LSET                         mask;
+
+    if( i == aBoard->m_LayerExpressionCache.end() )
+    {
+        for( unsigned ii = 0; ii < layerMap.GetCount(); ++ii )
+        {
+            wxPGChoiceEntry& entry = layerMap[ii];
+
+            if( entry.GetText().Matches( aLayerName ) )
+                mask.set( ToLAYER_ID( entry.GetValue() ) );
+        }
+
+        aBoard->m_LayerExpressionCache[ aLayerName ] = mask;
+    }
+    else
+    {
+        mask = i->second;
+    }
+
+    return mask.Contains( aLayer );
+}
+
+
 class PCB_LAYER_VALUE : public LIBEVAL::VALUE
 {
 public:
@@ -53,35 +87,9 @@ public:
 
     virtual bool EqualTo( LIBEVAL::CONTEXT* aCtx, const VALUE* b ) const override
     {
-        // For boards with user-defined layer names there will be 2 entries for each layer
-        // in the ENUM_MAP: one for the canonical layer name and one for the user layer name.
-        // We need to check against both.
-
-        wxPGChoices&                 layerMap = ENUM_MAP<PCB_LAYER_ID>::Instance().Choices();
-        const wxString&              layerName = b->AsString();
-        BOARD*                       board = static_cast<PCB_EXPR_CONTEXT*>( aCtx )->GetBoard();
-        std::unique_lock<std::mutex> cacheLock( board->m_CachesMutex );
-        auto                         i = board->m_LayerExpressionCache.find( layerName );
-        LSET                         mask;
-
-        if( i == board->m_LayerExpressionCache.end() )
-        {
-            for( unsigned ii = 0; ii < layerMap.GetCount(); ++ii )
-            {
-                wxPGChoiceEntry& entry = layerMap[ii];
-
-                if( entry.GetText().Matches( layerName ) )
-                    mask.set( ToLAYER_ID( entry.GetValue() ) );
-            }
-
-            board->m_LayerExpressionCache[ layerName ] = mask;
-        }
-        else
-        {
-            mask = i->second;
-        }
+        BOARD* board = static_cast<PCB_EXPR_CONTEXT*>( aCtx )->GetBoard();
 
-        return mask.Contains( m_layer );
+        return layerMatches( board, b->AsString(), m_layer );
     }
 
 protected:
@@ -144,6 +152,42 @@ LIBEVAL::VALUE* PCB_EXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 }
 
 
+bool PCB_EXPR_VAR_REF::setCompareValue( const LIBEVAL::VALUE& aValue )
+{
+    if( aValue.GetType() != LIBEVAL::VT_STRING )
+        return false;
+
+    m_compareValue = aValue.AsString();
+    m_compareIsWildcard = aValue.StringIsWildcard();
+    return true;
+}
+
+
+bool PCB_EXPR_VAR_REF::matchesCompareValue( const wxString& aString ) const
+{
+    if( m_compareIsWildcard )
+        return WildCompareString( m_compareValue, aString, false );
+    else
+        return aString.IsSameAs( m_compareValue, false );
+}
+
+
+bool PCB_EXPR_VAR_REF::PrepareCompare( const LIBEVAL::VALUE& aValue )
+{
+    // Only the layer under test has a typed comparison; properties are fetched through the
+    // property manager.
+    return m_itemIndex == 2 && setCompareValue( aValue );
+}
+
+
+int PCB_EXPR_VAR_REF::Compare( LIBEVAL::CONTEXT* aCtx ) const
+{
+    PCB_EXPR_CONTEXT* context = static_cast<PCB_EXPR_CONTEXT*>( aCtx );
+
+    return layerMatches( context->GetBoard(), m_compareValue, context->GetLayer() ) ? 1 : 0;
+}
+
+
 LIBEVAL::VALUE* PCB_EXPR_NETCLASS_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 {
     BOARD_CONNECTED_ITEM* item = dynamic_cast<BOARD_CONNECTED_ITEM*>( GetObject( aCtx ) );
@@ -155,6 +199,23 @@ LIBEVAL::VALUE* PCB_EXPR_NETCLASS_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 }
 
 
+bool PCB_EXPR_NETCLASS_REF::PrepareCompare( const LIBEVAL::VALUE& aValue )
+{
+    return setCompareValue( aValue );
+}
+
+
+int PCB_EXPR_NETCLASS_REF::Compare( LIBEVAL::CONTEXT* aCtx ) const
+{
+    BOARD_CONNECTED_ITEM* item = dynamic_cast<BOARD_CONNECTED_ITEM*>( GetObject( aCtx ) );
+
+    if( !item )
+        return -1;
+
+    return matchesCompareValue( item->GetEffectiveNetClass()->GetName() ) ? 1 : 0;
+}
+
+
 LIBEVAL::VALUE* PCB_EXPR_NETNAME_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 {
     BOARD_CONNECTED_ITEM* item = dynamic_cast<BOARD_CONNECTED_ITEM*>( GetObject( aCtx ) );
@@ -166,6 +227,27 @@ LIBEVAL::VALUE* PCB_EXPR_NETNAME_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 }
 
 
+bool PCB_EXPR_NETNAME_REF::PrepareCompare( const LIBEVAL::VALUE& aValue )
+{
+    return setCompareValue( aValue );
+}
+
+
+int PCB_EXPR_NETNAME_REF::Compare( LIBEVAL::CONTEXT* aCtx ) const
+{
+    BOARD_CONNECTED_ITEM* item = dynamic_cast<BOARD_CONNECTED_ITEM*>( GetObject( aCtx ) );
+
+    if( !item )
+        return -1;
+
+    // BOARD_CONNECTED_ITEM::GetNetname() returns a copy
+    if( !item->GetNet() )
+        return matchesCompareValue( wxEmptyString ) ? 1 : 0;
+
+    return matchesCompareValue( item->GetNet()->GetNetname() ) ? 1 : 0;
+}
+
+
 LIBEVAL::VALUE* PCB_EXPR_TYPE_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 {
     BOARD_ITEM* item = GetObject( aCtx );
@@ -177,10 +259,46 @@ LIBEVAL::VALUE* PCB_EXPR_TYPE_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 }
 
 
+bool PCB_EXPR_TYPE_REF::PrepareCompare( const LIBEVAL::VALUE& aValue )
+{
+    if( !setCompareValue( aValue ) )
+        return false;
+
+    // Resolve the type names matching the constant now so that items are compared by
+    // their KICAD_T alone.
+    ENUM_MAP<KICAD_T>& typeMap = ENUM_MAP<KICAD_T>::Instance();
+
+    m_typeMatches.resize( MAX_STRUCT_TYPE_ID );
+
+    for( int type = 0; type < MAX_STRUCT_TYPE_ID; ++type )
+        m_typeMatches[type] = matchesCompareValue( typeMap.ToString( (KICAD_T) type ) );
+
+    return true;
+}
+
+
+int PCB_EXPR_TYPE_REF::Compare( LIBEVAL::CONTEXT* aCtx ) const
+{
+    BOARD_ITEM* item = GetObject( aCtx );
+
+    if( !item )
+        return -1;
+
+    KICAD_T type = item->Type();
+
+    if( type >= 0 && type < (int) m_typeMatches.size() )
+        return m_typeMatches[type] ? 1 : 0;
+
+    return matchesCompareValue( ENUM_MAP<KICAD_T>::Instance().ToString( type ) ) ? 1 : 0;
+}
+
+
 LIBEVAL::FUNC_CALL_REF PCB_EXPR_UCODE::CreateFuncCall( const wxString& aName )
 {
     PCB_EXPR_BUILTIN_FUNCTIONS& registry = PCB_EXPR_BUILTIN_FUNCTIONS::Instance();
 
+    m_referencedAttrs |= REF_OTHER;
+
     return registry.Get( aName.Lower() );
 }
 
@@ -195,6 +313,8 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCB_EXPR_UCODE::CreateVarRef( const wxString&
 
     if( aField.CmpNoCase( wxT( "NetClass" ) ) == 0 )
     {
+        m_referencedAttrs |= REF_NETCLASS;
+
         if( aVar == wxT( "A" ) )
             return std::make_unique<PCB_EXPR_NETCLASS_REF>( 0 );
         else if( aVar == wxT( "B" ) )
@@ -204,6 +324,8 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCB_EXPR_UCODE::CreateVarRef( const wxString&
     }
     else if( aField.CmpNoCase( wxT( "NetName" ) ) == 0 )
     {
+        m_referencedAttrs |= REF_NETNAME;
+
         if( aVar == wxT( "A" ) )
             return std::make_unique<PCB_EXPR_NETNAME_REF>( 0 );
         else if( aVar == wxT( "B" ) )
@@ -213,6 +335,8 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCB_EXPR_UCODE::CreateVarRef( const wxString&
     }
     else if( aField.CmpNoCase( wxT( "Type" ) ) == 0 )
     {
+        m_referencedAttrs |= REF_TYPE;
+
         if( aVar == wxT( "A" ) )
             return std::make_unique<PCB_EXPR_TYPE_REF>( 0 );
         else if( aVar == wxT( "B" ) )
@@ -221,6 +345,11 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCB_EXPR_UCODE::CreateVarRef( const wxString&
             return nullptr;
     }
 
+    if( aVar == wxT( "L" ) )
+        m_referencedAttrs |= REF_LAYER;
+    else
+        m_referencedAttrs |= REF_OTHER;
+
     if( aVar == wxT( "A" ) || aVar == wxT( "AB" ) )
         vref = std::make_unique<PCB_EXPR_VAR_REF>( 0 );
     else if( aVar == wxT( "B" ) )
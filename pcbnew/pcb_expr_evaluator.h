@@ -26,6 +26,7 @@
 #define __PCB_EXPR_EVALUATOR_H
 
 #include <unordered_map>
+#include <vector>
 
 #include <properties/property.h>
 #include <properties/property_mgr.h>
@@ -40,12 +41,36 @@ class PCB_EXPR_VAR_REF;
 class PCB_EXPR_UCODE final : public LIBEVAL::UCODE
 {
 public:
-    PCB_EXPR_UCODE() {};
+    /**
+     * The item attributes an expression refers to, gathered as it is compiled.  Clients can
+     * use these to work out what an expression's result can depend on.
+     */
+    enum REFERENCED_ATTR
+    {
+        REF_NETCLASS = 1 << 0,      ///< A.NetClass / B.NetClass
+        REF_NETNAME  = 1 << 1,      ///< A.NetName / B.NetName
+        REF_TYPE     = 1 << 2,      ///< A.Type / B.Type
+        REF_LAYER    = 1 << 3,      ///< the layer under test (L)
+        REF_OTHER    = 1 << 4       ///< any other property, or a function call
+    };
+
+    PCB_EXPR_UCODE() :
+            m_referencedAttrs( 0 )
+    {};
+
     virtual ~PCB_EXPR_UCODE() {};
 
     virtual std::unique_ptr<LIBEVAL::VAR_REF> CreateVarRef( const wxString& aVar,
                                                             const wxString& aField ) override;
     virtual LIBEVAL::FUNC_CALL_REF CreateFuncCall( const wxString& aName ) override;
+
+    /**
+     * @return a mask of #REFERENCED_ATTR flags.
+     */
+    int GetReferencedAttrs() const { return m_referencedAttrs; }
+
+private:
+    int m_referencedAttrs;
 };
 
 
@@ -85,7 +110,8 @@ public:
     PCB_EXPR_VAR_REF( int aItemIndex ) :
         m_itemIndex( aItemIndex ),
         m_type( LIBEVAL::VT_UNDEFINED ),
-        m_isEnum( false )
+        m_isEnum( false ),
+        m_compareIsWildcard( false )
     {
         //printf("*** CreateVarRef %p %d\n", this, aItemIndex );
     }
@@ -105,13 +131,33 @@ public:
 
     LIBEVAL::VALUE* GetValue( LIBEVAL::CONTEXT* aCtx ) override;
 
+    bool PrepareCompare( const LIBEVAL::VALUE& aValue ) override;
+    int Compare( LIBEVAL::CONTEXT* aCtx ) const override;
+
     BOARD_ITEM* GetObject( const LIBEVAL::CONTEXT* aCtx ) const;
 
+protected:
+    /**
+     * Store a string constant for Compare().  Wildcards are honoured as they are by
+     * LIBEVAL::VALUE::EqualTo().
+     *
+     * @return false if \a aValue isn't a string.
+     */
+    bool setCompareValue( const LIBEVAL::VALUE& aValue );
+
+    /**
+     * Check \a aString against the constant stored by setCompareValue() without copying it.
+     */
+    bool matchesCompareValue( const wxString& aString ) const;
+
 private:
     std::unordered_map<TYPE_ID, PROPERTY_BASE*> m_matchingTypes;
     int                                         m_itemIndex;
     LIBEVAL::VAR_TYPE_T                         m_type;
     bool                                        m_isEnum;
+
+    wxString                                    m_compareValue;
+    bool                                        m_compareIsWildcard;
 };
 
 
@@ -127,6 +173,9 @@ public:
     }
 
     LIBEVAL::VALUE* GetValue( LIBEVAL::CONTEXT* aCtx ) override;
+
+    bool PrepareCompare( const LIBEVAL::VALUE& aValue ) override;
+    int Compare( LIBEVAL::CONTEXT* aCtx ) const override;
 };
 
 
@@ -142,6 +191,9 @@ public:
     }
 
     LIBEVAL::VALUE* GetValue( LIBEVAL::CONTEXT* aCtx ) override;
+
+    bool PrepareCompare( const LIBEVAL::VALUE& aValue ) override;
+    int Compare( LIBEVAL::CONTEXT* aCtx ) const override;
 };
 
 
@@ -156,6 +208,12 @@ public:
     }
 
     LIBEVAL::VALUE* GetValue( LIBEVAL::CONTEXT* aCtx ) override;
+
+    bool PrepareCompare( const LIBEVAL::VALUE& aValue ) override;
+    int Compare( LIBEVAL::CONTEXT* aCtx ) const override;
+
+private:
+    std::vector<bool> m_typeMatches;    ///< Indexed by KICAD_T: does the type name match?
 };
 
 
@@ -438,6 +438,161 @@ int PCB_PAINTER::getViaDrillSize( const PCB_VIA* aVia ) const
 }
 
 
+// Polygons with fewer vertices than this are always drawn at full detail
+static const int DETAIL_LEVELS_MIN_VERTICES = 1000;
+
+
+bool PCB_PAINTER::HasDetailLevels( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item || m_pcbSettings.m_isPrinting )
+        return false;
+
+    switch( item->Type() )
+    {
+    case PCB_ZONE_T:
+    case PCB_FP_ZONE_T:
+    {
+        const ZONE* zone = static_cast<const ZONE*>( item );
+
+        if( !IsZoneFillLayer( aLayer )
+                || m_pcbSettings.m_ZoneDisplayMode != ZONE_DISPLAY_MODE::SHOW_FILLED )
+        {
+            return false;
+        }
+
+        PCB_LAYER_ID layer = ToLAYER_ID( aLayer - LAYER_ZONE_START );
+
+        return zone->HasFilledPolysForLayer( layer )
+                && zone->GetFilledPolysList( layer )->TotalVertices() > DETAIL_LEVELS_MIN_VERTICES;
+    }
+
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    {
+        const PCB_SHAPE* shape = static_cast<const PCB_SHAPE*>( item );
+
+        return shape->GetShape() == SHAPE_T::POLY
+                && shape->GetPolyShape().TotalVertices() > DETAIL_LEVELS_MIN_VERTICES;
+    }
+
+    default:
+        return false;
+    }
+}
+
+
+const SHAPE_POLY_SET& PCB_PAINTER::detailedPolySet( const SHAPE_POLY_SET& aPolySet ) const
+{
+    if( m_detailLevel == 0 )
+        return aPolySet;
+
+    return aPolySet.GetLODApproximation( KiROUND( GetDetailTolerance( m_detailLevel ) ) );
+}
+
+
+void PCB_PAINTER::PrepareDraw( const VIEW_ITEM* aItem )
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    // Outline font glyphs are cached by the text item; stroke fonts are drawn directly.
+    auto prepareText =
+            []( const EDA_TEXT* aText )
+            {
+                KIFONT::FONT* font = aText->GetFont();
+
+                if( font && font->IsOutline() )
+                {
+                    wxString resolvedText( aText->GetShownText() );
+
+                    if( !resolvedText.IsEmpty() )
+                        aText->GetRenderCache( font, resolvedText );
+                }
+            };
+
+    switch( item->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        const PAD* pad = static_cast<const PAD*>( item );
+
+        pad->GetEffectiveShape();
+        pad->GetEffectiveHoleShape();
+        break;
+    }
+
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    {
+        const PCB_SHAPE* shape = static_cast<const PCB_SHAPE*>( item );
+
+        // See draw( const PCB_SHAPE* ): filled polygons are drawn from their triangulation
+        if( shape->GetShape() == SHAPE_T::POLY && shape->IsFilled() && m_gal->IsOpenGlEngine() )
+        {
+            SHAPE_POLY_SET& poly = const_cast<PCB_SHAPE*>( shape )->GetPolyShape();
+
+            if( !poly.IsTriangulationUpToDate() )
+                poly.CacheTriangulation( true, true );
+        }
+
+        if( HasDetailLevels( shape, shape->GetLayer() ) )
+        {
+            for( int level = 1; level < DETAIL_LEVELS; ++level )
+                shape->GetPolyShape().GetLODApproximation( KiROUND( GetDetailTolerance( level ) ) );
+        }
+
+        break;
+    }
+
+    case PCB_ZONE_T:
+    case PCB_FP_ZONE_T:
+    {
+        const ZONE* zone = static_cast<const ZONE*>( item );
+
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            if( !HasDetailLevels( zone, LAYER_ZONE_START + layer ) )
+                continue;
+
+            const std::shared_ptr<SHAPE_POLY_SET>& fill = zone->GetFilledPolysList( layer );
+
+            for( int level = 1; level < DETAIL_LEVELS; ++level )
+                fill->GetLODApproximation( KiROUND( GetDetailTolerance( level ) ) );
+        }
+
+        break;
+    }
+
+    case PCB_TEXT_T:
+        if( !static_cast<const PCB_TEXT*>( item )->IsKnockout() )
+            prepareText( static_cast<const PCB_TEXT*>( item ) );
+
+        break;
+
+    case PCB_FP_TEXT_T:
+        if( !static_cast<const FP_TEXT*>( item )->IsKnockout() )
+            prepareText( static_cast<const FP_TEXT*>( item ) );
+
+        break;
+
+    case PCB_TEXTBOX_T:
+        prepareText( static_cast<const PCB_TEXTBOX*>( item ) );
+        break;
+
+    case PCB_FP_TEXTBOX_T:
+        prepareText( static_cast<const FP_TEXTBOX*>( item ) );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
 bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 {
     const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
@@ -1668,12 +1823,14 @@ void PCB_PAINTER::draw( const PCB_SHAPE* aShape, int aLayer )
 
         case SHAPE_T::POLY:
         {
-            SHAPE_POLY_SET&  shape = const_cast<PCB_SHAPE*>( aShape )->GetPolyShape();
+            SHAPE_POLY_SET&  fullShape = const_cast<PCB_SHAPE*>( aShape )->GetPolyShape();
             const FOOTPRINT* parentFootprint = aShape->GetParentFootprint();
 
-            if( shape.OutlineCount() == 0 )
+            if( fullShape.OutlineCount() == 0 )
                 break;
 
+            const SHAPE_POLY_SET& shape = detailedPolySet( fullShape );
+
             if( parentFootprint )
             {
                 m_gal->Save();
@@ -1684,7 +1841,7 @@ void PCB_PAINTER::draw( const PCB_SHAPE* aShape, int aLayer )
             if( outline_mode )
             {
                 for( int ii = 0; ii < shape.OutlineCount(); ++ii )
-                    m_gal->DrawSegmentChain( shape.Outline( ii ), thickness );
+                    m_gal->DrawSegmentChain( shape.COutline( ii ), thickness );
             }
             else
             {
@@ -1694,7 +1851,7 @@ void PCB_PAINTER::draw( const PCB_SHAPE* aShape, int aLayer )
                 if( thickness > 0 )
                 {
                     for( int ii = 0; ii < shape.OutlineCount(); ++ii )
-                        m_gal->DrawSegmentChain( shape.Outline( ii ), thickness );
+                        m_gal->DrawSegmentChain( shape.COutline( ii ), thickness );
                 }
 
                 if( aShape->IsFilled() )
@@ -1702,9 +1859,10 @@ void PCB_PAINTER::draw( const PCB_SHAPE* aShape, int aLayer )
                     // On Opengl, a not convex filled polygon is usually drawn by using triangles
                     // as primitives. CacheTriangulation() can create basic triangle primitives to
                     // draw the polygon solid shape on Opengl.  GLU tessellation is much slower,
-                    // so currently we are using our tessellation.
-                    if( m_gal->IsOpenGlEngine() && !shape.IsTriangulationUpToDate() )
-                        shape.CacheTriangulation( true, true );
+                    // so currently we are using our tessellation.  Approximations for lower
+                    // levels of detail come already triangulated.
+                    if( m_gal->IsOpenGlEngine() && !fullShape.IsTriangulationUpToDate() )
+                        fullShape.CacheTriangulation( true, true );
 
                     m_gal->DrawPolygon( shape );
                 }
@@ -2417,7 +2575,8 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
-        m_gal->DrawPolygon( *polySet, displayMode == ZONE_DISPLAY_MODE::SHOW_TRIANGULATION );
+        m_gal->DrawPolygon( detailedPolySet( *polySet ),
+                            displayMode == ZONE_DISPLAY_MODE::SHOW_TRIANGULATION );
     }
 }
 
@@ -167,9 +167,20 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::PrepareDraw()
+    virtual void PrepareDraw( const VIEW_ITEM* aItem ) override;
+
+    /// @copydoc PAINTER::HasDetailLevels()
+    virtual bool HasDetailLevels( const VIEW_ITEM* aItem, int aLayer ) const override;
+
 protected:
     PCB_VIEWERS_SETTINGS_BASE* viewer_settings();
 
+    /**
+     * Return \a aPolySet, or its approximation for the current level of detail.
+     */
+    const SHAPE_POLY_SET& detailedPolySet( const SHAPE_POLY_SET& aPolySet ) const;
+
     // Drawing functions for various types of PCB-specific items
     void draw( const PCB_TRACK* aTrack, int aLayer );
     void draw( const PCB_ARC* aArc, int aLayer );
@@ -29,6 +29,7 @@
 #include <jobs/job_export_pcb_pos.h>
 #include <jobs/job_export_pcb_svg.h>
 #include <jobs/job_export_pcb_step.h>
+#include <jobs/job_pcb_drc.h>
 #include <cli/exit_codes.h>
 #include <plotters/plotter_dxf.h>
 #include <plotters/plotter_gerber.h>
@@ -48,6 +49,17 @@
 #include <gendrill_gerber_writer.h>
 #include <wildcards_and_files_ext.h>
 #include <plugins/kicad/pcb_plugin.h>
+#include <build_version.h>
+#include <board_commit.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <pcb_marker.h>
+#include <project.h>
+#include <thread_pool.h>
+#include <tool/tool_manager.h>
+#include <zone.h>
+#include <zone_filler.h>
+#include <nlohmann/json.hpp>
 
 #include "pcbnew_scripting_helpers.h"
 
@@ -69,6 +81,7 @@ PCBNEW_JOBS_HANDLER::PCBNEW_JOBS_HANDLER()
               std::bind( &PCBNEW_JOBS_HANDLER::JobExportFpUpgrade, this, std::placeholders::_1 ) );
     Register( "fpsvg",
               std::bind( &PCBNEW_JOBS_HANDLER::JobExportFpSvg, this, std::placeholders::_1 ) );
+    Register( "drc", std::bind( &PCBNEW_JOBS_HANDLER::JobRunDrc, this, std::placeholders::_1 ) );
 }
 
 
@@ -602,13 +615,25 @@ int PCBNEW_JOBS_HANDLER::JobExportFpUpgrade( JOB* aJob )
 
     bool shouldSave = upgradeJob->m_force;
 
-    for( const auto& footprint : fpLib.GetFootprints() )
+    try
     {
-        if( footprint.second->GetFootprint()->GetFileFormatVersionAtLoad() < SEXPR_BOARD_FILE_VERSION )
+        for( const auto& footprint : fpLib.GetFootprints() )
         {
-            shouldSave = true;
+            if( shouldSave )
+                break;
+
+            if( fpLib.GetFootprint( footprint.first )->GetFileFormatVersionAtLoad()
+                    < SEXPR_BOARD_FILE_VERSION )
+            {
+                shouldSave = true;
+            }
         }
     }
+    catch( ... )
+    {
+        wxFprintf( stderr, _( "Unable to load library\n" ) );
+        return CLI::EXIT_CODES::ERR_UNKNOWN;
+    }
 
     if( shouldSave )
     {
@@ -676,10 +701,9 @@ int PCBNEW_JOBS_HANDLER::JobExportFpSvg( JOB* aJob )
     for( FP_CACHE_FOOTPRINT_MAP::iterator it = footprintMap.begin(); it != footprintMap.end();
          ++it )
     {
-        const FOOTPRINT* fp = it->second->GetFootprint();
         if( !svgJob->m_footprint.IsEmpty() )
         {
-            if( fp->GetFPID().GetLibItemName().wx_str() != svgJob->m_footprint )
+            if( it->first != svgJob->m_footprint )
             {
                 // skip until we find the right footprint
                 continue;
@@ -690,6 +714,19 @@ int PCBNEW_JOBS_HANDLER::JobExportFpSvg( JOB* aJob )
             }
         }
 
+        const FOOTPRINT* fp = nullptr;
+
+        try
+        {
+            fp = fpLib.GetFootprint( it->first );
+        }
+        catch( ... )
+        {
+            wxFprintf( stderr, _( "Unable to load footprint '%s'\n" ), it->first );
+            exitCode = CLI::EXIT_CODES::ERR_UNKNOWN;
+            break;
+        }
+
         exitCode = doFpExportSvg( svgJob, fp );
         if( exitCode != CLI::EXIT_CODES::OK )
             break;
@@ -749,4 +786,275 @@ int PCBNEW_JOBS_HANDLER::doFpExportSvg( JOB_FP_EXPORT_SVG* aSvgJob, const FOOTPR
 
 
     return CLI::EXIT_CODES::OK;
-}
\ No newline at end of file
+}
+
+
+int PCBNEW_JOBS_HANDLER::JobRunDrc( JOB* aJob )
+{
+    JOB_PCB_DRC* drcJob = dynamic_cast<JOB_PCB_DRC*>( aJob );
+
+    if( drcJob == nullptr )
+        return CLI::EXIT_CODES::ERR_UNKNOWN;
+
+    // Each kiface has its own pool, so the thread count must be applied from here
+    if( drcJob->m_threads > 0 )
+        GetKiCadThreadPool().reset( drcJob->m_threads );
+
+    if( aJob->IsCli() )
+        wxPrintf( _( "Loading board\n" ) );
+
+    BOARD* brd = LoadBoard( drcJob->m_filename );
+
+    if( !brd )
+        return CLI::EXIT_CODES::ERR_INVALID_INPUT_FILE;
+
+    if( drcJob->m_outputFile.IsEmpty() )
+    {
+        wxFileName fn = brd->GetFileName();
+        fn.SetName( fn.GetName() + wxS( "-drc" ) );
+
+        if( drcJob->m_format == JOB_PCB_DRC::OUTPUT_FORMAT::JSON )
+            fn.SetExt( JsonFileExtension );
+        else
+            fn.SetExt( ReportFileExtension );
+
+        drcJob->m_outputFile = fn.GetFullName();
+    }
+
+    EDA_UNITS   units;
+    std::string unitsName;
+
+    switch( drcJob->m_units )
+    {
+    case JOB_PCB_DRC::UNITS::INCHES: units = EDA_UNITS::INCHES;      unitsName = "in";   break;
+    case JOB_PCB_DRC::UNITS::MILS:   units = EDA_UNITS::MILS;        unitsName = "mils"; break;
+    default:                         units = EDA_UNITS::MILLIMETRES; unitsName = "mm";   break;
+    }
+
+    BOARD_DESIGN_SETTINGS&      bds = brd->GetDesignSettings();
+    std::shared_ptr<DRC_ENGINE> engine = bds.m_DRCEngine;
+    UNITS_PROVIDER              unitsProvider( pcbIUScale, units );
+
+    if( !engine )
+    {
+        bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( brd, &bds );
+        engine = bds.m_DRCEngine;
+    }
+
+    wxFileName fn = brd->GetFileName();
+    fn.SetExt( DesignRulesFileExtension );
+    wxString drcRulesPath = brd->GetProject()->AbsolutePath( fn.GetFullName() );
+
+    // Rebuild The Instance of ENUM_MAP<PCB_LAYER_ID> (layer names list), because the DRC
+    // engine can use layer names (canonical and/or user names)
+    ENUM_MAP<PCB_LAYER_ID>& layerEnum = ENUM_MAP<PCB_LAYER_ID>::Instance();
+    layerEnum.Choices().Clear();
+    layerEnum.Undefined( UNDEFINED_LAYER );
+
+    for( LSEQ seq = LSET::AllLayersMask().Seq(); seq; ++seq )
+    {
+        layerEnum.Map( *seq, LSET::Name( *seq ) );           // Add Canonical name
+        layerEnum.Map( *seq, brd->GetLayerName( *seq ) );    // Add User name
+    }
+
+    try
+    {
+        engine->InitEngine( drcRulesPath );
+    }
+    catch( PARSE_ERROR& err )
+    {
+        wxFprintf( stderr, _( "Error loading design rules: %s\n" ), err.What() );
+        return CLI::EXIT_CODES::ERR_INVALID_INPUT_FILE;
+    }
+
+    if( drcJob->m_refillZones )
+    {
+        if( aJob->IsCli() )
+            wxPrintf( _( "Refilling zones\n" ) );
+
+        TOOL_MANAGER toolMgr;
+        toolMgr.SetEnvironment( brd, nullptr, nullptr, nullptr, nullptr );
+
+        BOARD_COMMIT       commit( &toolMgr );
+        ZONE_FILLER        filler( brd, &commit );
+        std::vector<ZONE*> toFill;
+
+        for( ZONE* zone : brd->Zones() )
+            toFill.push_back( zone );
+
+        if( filler.Fill( toFill, false, nullptr ) )
+        {
+            commit.Push( _( "Fill Zone(s)" ),
+                         SKIP_UNDO | SKIP_SET_DIRTY | ZONE_FILL_OP | SKIP_CONNECTIVITY );
+        }
+
+        brd->BuildConnectivity();
+    }
+
+    // Excluded violations are only stored in their serialized form; wrapping each violation
+    // in a marker lets us match them up without touching the board itself.  The markers are
+    // not added to the board, but are parented to it as PCB_MARKER::GetSeverity() falls back
+    // to the board's design settings for violations without a rule severity.
+    std::set<wxString>                       exclusions = bds.m_DrcExclusions;
+    std::vector<std::unique_ptr<PCB_MARKER>> violations;
+    std::vector<std::unique_ptr<PCB_MARKER>> unconnected;
+    std::vector<std::unique_ptr<PCB_MARKER>> footprints;
+
+    engine->SetProgressReporter( nullptr );
+
+    engine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                std::unique_ptr<PCB_MARKER> marker = std::make_unique<PCB_MARKER>( aItem, aPos,
+                                                                                   aLayer );
+
+                marker->SetParent( brd );
+
+                if( exclusions.count( marker->Serialize() ) )
+                    marker->SetExcluded( true );
+
+                if( aItem->GetErrorCode() == DRCE_MISSING_FOOTPRINT
+                    || aItem->GetErrorCode() == DRCE_DUPLICATE_FOOTPRINT
+                    || aItem->GetErrorCode() == DRCE_EXTRA_FOOTPRINT
+                    || aItem->GetErrorCode() == DRCE_NET_CONFLICT )
+                {
+                    footprints.push_back( std::move( marker ) );
+                }
+                else if( aItem->GetErrorCode() == DRCE_UNCONNECTED_ITEMS )
+                {
+                    unconnected.push_back( std::move( marker ) );
+                }
+                else
+                {
+                    violations.push_back( std::move( marker ) );
+                }
+            } );
+
+    if( aJob->IsCli() )
+        wxPrintf( _( "Running DRC\n" ) );
+
+    engine->RunTests( units, drcJob->m_reportAllTrackErrors, false );
+    engine->ClearViolationHandler();
+
+    std::map<KIID, EDA_ITEM*> itemMap;
+    brd->FillItemMap( itemMap );
+
+    int errors = 0;
+    int warnings = 0;
+
+    auto isReported =
+            [&]( const std::unique_ptr<PCB_MARKER>& aMarker ) -> bool
+            {
+                SEVERITY severity = aMarker->GetSeverity();
+
+                if( !( severity & drcJob->m_severity ) )
+                    return false;
+
+                if( severity == RPT_SEVERITY_ERROR )
+                    errors++;
+                else if( severity == RPT_SEVERITY_WARNING )
+                    warnings++;
+
+                return true;
+            };
+
+    FILE* fp = wxFopen( drcJob->m_outputFile, wxT( "w" ) );
+
+    if( fp == nullptr )
+    {
+        wxFprintf( stderr, _( "Unable to open report file %s\n" ), drcJob->m_outputFile );
+        return CLI::EXIT_CODES::ERR_INVALID_OUTPUT_CONFLICT;
+    }
+
+    if( drcJob->m_format == JOB_PCB_DRC::OUTPUT_FORMAT::JSON )
+    {
+        nlohmann::json report;
+
+        report["$schema"] = "https://schemas.kicad.org/drc.v1.json";
+        report["source"] = TO_UTF8( brd->GetFileName() );
+        report["date"] = TO_UTF8( wxDateTime::Now().FormatISOCombined() );
+        report["kicad_version"] = TO_UTF8( GetMajorMinorVersion() );
+        report["coordinate_units"] = unitsName;
+
+        auto writeList =
+                [&]( const std::vector<std::unique_ptr<PCB_MARKER>>& aMarkers,
+                     const std::string& aKey )
+                {
+                    nlohmann::json list = nlohmann::json::array();
+
+                    for( const std::unique_ptr<PCB_MARKER>& marker : aMarkers )
+                    {
+                        if( !isReported( marker ) )
+                            continue;
+
+                        nlohmann::json violation;
+                        marker->GetRCItem()->GetJsonViolation( violation, &unitsProvider,
+                                                               marker->GetSeverity(), itemMap );
+                        list.push_back( violation );
+                    }
+
+                    report[aKey] = list;
+                };
+
+        writeList( violations, "violations" );
+        writeList( unconnected, "unconnected_items" );
+        writeList( footprints, "schematic_parity" );
+
+        std::string data = report.dump( 2 );
+        fprintf( fp, "%s\n", data.c_str() );
+    }
+    else
+    {
+        auto writeList =
+                [&]( const std::vector<std::unique_ptr<PCB_MARKER>>& aMarkers,
+                     const char* aHeading )
+                {
+                    std::vector<PCB_MARKER*> reported;
+
+                    for( const std::unique_ptr<PCB_MARKER>& marker : aMarkers )
+                    {
+                        if( isReported( marker ) )
+                            reported.push_back( marker.get() );
+                    }
+
+                    fprintf( fp, aHeading, static_cast<int>( reported.size() ) );
+
+                    for( PCB_MARKER* marker : reported )
+                    {
+                        wxString msg = marker->GetRCItem()->ShowReport( &unitsProvider,
+                                                                        marker->GetSeverity(),
+                                                                        itemMap );
+                        fprintf( fp, "%s", TO_UTF8( msg ) );
+                    }
+                };
+
+        fprintf( fp, "** Drc report for %s **\n", TO_UTF8( brd->GetFileName() ) );
+        fprintf( fp, "** Created on %s **\n",
+                 TO_UTF8( wxDateTime::Now().Format( wxT( "%F %T" ) ) ) );
+
+        writeList( violations, "\n** Found %d DRC violations **\n" );
+        writeList( unconnected, "\n** Found %d unconnected pads **\n" );
+        writeList( footprints, "\n** Found %d Footprint errors **\n" );
+
+        fprintf( fp, "\n** End of Report **\n" );
+    }
+
+    fclose( fp );
+
+    if( aJob->IsCli() )
+    {
+        wxPrintf( _( "Found %d violations (%d errors, %d warnings)\n" ),
+                  errors + warnings, errors, warnings );
+        wxPrintf( _( "Saved DRC Report to %s\n" ), drcJob->m_outputFile );
+    }
+
+    if( drcJob->m_exitCodeViolations )
+    {
+        if( errors > 0 )
+            return CLI::EXIT_CODES::ERR_RC_VIOLATIONS_ERROR;
+        else if( warnings > 0 )
+            return CLI::EXIT_CODES::ERR_RC_VIOLATIONS_WARNING;
+    }
+
+    return CLI::EXIT_CODES::OK;
+}
@@ -42,6 +42,7 @@ public:
     int JobExportPos( JOB* aJob );
     int JobExportFpUpgrade( JOB* aJob );
     int JobExportFpSvg( JOB* aJob );
+    int JobRunDrc( JOB* aJob );
 
 private:
     void populateGerberPlotOptionsFromJob( PCB_PLOT_PARAMS&       aPlotOpts,
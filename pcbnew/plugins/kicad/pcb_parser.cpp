@@ -63,6 +63,7 @@
 #include <string_utils.h>
 #include <wx/log.h>
 #include <progress_reporter.h>
+#include <thread_pool.h>
 #include <board_stackup_manager/stackup_predefined_prms.h>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
@@ -78,6 +79,8 @@ void PCB_PARSER::init()
 {
     m_showLegacySegmentZoneWarning = true;
     m_showLegacy5ZoneWarning = true;
+    m_parallelLoadTried = false;
+    m_isParallelWorker = false;
     m_tooRecent = false;
     m_requiredVersion = 0;
     m_layerIndices.clear();
@@ -134,7 +137,7 @@ void PCB_PARSER::checkpoint()
                                                             / std::max( 1U, m_lineCount ) );
 
             if( !m_progressReporter->KeepRefreshing() )
-                THROW_IO_ERROR( ( "Open cancelled by user." ) );
+                THROW_IO_ERROR( _( "Open cancelled by user." ) );
 
             m_lastProgressTime = curTime;
         }
@@ -818,86 +821,19 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
             m_board->m_LegacyNetclassesLoaded = true;
             break;
 
-        case T_gr_arc:
-        case T_gr_curve:
-        case T_gr_line:
-        case T_gr_poly:
-        case T_gr_circle:
-        case T_gr_rect:
-            item = parsePCB_SHAPE();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_image:
-            item = parsePCB_BITMAP( m_board );
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_gr_text:
-            item = parsePCB_TEXT();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_gr_text_box:
-            item = parsePCB_TEXTBOX();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_dimension:
-            item = parseDIMENSION( m_board, false );
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_module:      // legacy token
-        case T_footprint:
-            item = parseFOOTPRINT();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_segment:
-            item = parsePCB_TRACK();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_arc:
-            item = parseARC();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
-
-        case T_group:
-            parseGROUP( m_board );
-            break;
+        default:
+            if( parseBoardItemsInParallel( bulkAddedItems ) )
+                break;
 
-        case T_via:
-            item = parsePCB_VIA();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
+            item = parseBoardItem( token );
 
-        case T_zone:
-            item = parseZONE( m_board );
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
-            break;
+            if( item )
+            {
+                m_board->Add( item, ADD_MODE::BULK_APPEND, true );
+                bulkAddedItems.push_back( item );
+            }
 
-        case T_target:
-            item = parsePCB_TARGET();
-            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
-            bulkAddedItems.push_back( item );
             break;
-
-        default:
-            wxString err;
-            err.Printf( _( "Unknown token '%s'" ), FromUTF8() );
-            THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
         }
     }
 
@@ -1000,6 +936,473 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+BOARD_ITEM* PCB_PARSER::parseBoardItem( T aToken )
+{
+    switch( aToken )
+    {
+    case T_gr_arc:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+    case T_gr_circle:
+    case T_gr_rect:
+        return parsePCB_SHAPE();
+
+    case T_image:
+        return parsePCB_BITMAP( m_board );
+
+    case T_gr_text:
+        return parsePCB_TEXT();
+
+    case T_gr_text_box:
+        return parsePCB_TEXTBOX();
+
+    case T_dimension:
+        return parseDIMENSION( m_board, false );
+
+    case T_module:      // legacy token
+    case T_footprint:
+        return parseFOOTPRINT();
+
+    case T_segment:
+        return parsePCB_TRACK();
+
+    case T_arc:
+        return parseARC();
+
+    case T_group:
+        parseGROUP( m_board );
+        return nullptr;
+
+    case T_via:
+        return parsePCB_VIA();
+
+    case T_zone:
+        return parseZONE( m_board );
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        wxString err;
+        err.Printf( _( "Unknown token '%s'" ), FromUTF8() );
+        THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+}
+
+
+/**
+ * The text of a top-level board item, as found by scanBoardItems().
+ */
+struct BOARD_ITEM_TEXT
+{
+    const char* m_Begin;    ///< The item's '(', or the start of its line if only whitespace
+                            ///< precedes it (so that error offsets are right).
+    const char* m_End;      ///< Past the item's closing ')'.
+    unsigned    m_Line;     ///< The line number before m_Begin's line, see BUFFER_LINE_READER.
+    std::string m_Keyword;
+};
+
+
+/**
+ * Find the boundaries of the board items from \a aPos (which must be the opening parenthesis
+ * of an item) to the closing parenthesis of the board.  Only parentheses and quoted strings
+ * are understood; the items themselves are left to the parser.
+ *
+ * @param aLine is the line number of the line holding \a aPos.
+ * @param aTail receives the text from the board's closing parenthesis to the end of the buffer.
+ * @return false if the text isn't well formed (the serial parser will report the error).
+ */
+static bool scanBoardItems( const char* aBuffer, size_t aLength, size_t aPos, unsigned aLine,
+                            std::vector<BOARD_ITEM_TEXT>& aItems, BOARD_ITEM_TEXT& aTail )
+{
+    const char* p = aBuffer + aPos;
+    const char* end = aBuffer + aLength;
+    const char* lineStart = p;
+    unsigned    line = aLine;
+    bool        lineIsBlank = true;
+
+    while( lineStart > aBuffer && lineStart[-1] != '\n' )
+    {
+        if( !isspace( (unsigned char) lineStart[-1] ) )
+            lineIsBlank = false;
+
+        --lineStart;
+    }
+
+    auto newLine =
+            [&]( const char* aNewLine )
+            {
+                ++line;
+                lineStart = aNewLine + 1;
+                lineIsBlank = true;
+            };
+
+    while( p < end )
+    {
+        if( isspace( (unsigned char) *p ) )
+        {
+            if( *p == '\n' )
+                newLine( p );
+
+            ++p;
+            continue;
+        }
+
+        BOARD_ITEM_TEXT item;
+
+        item.m_Begin = lineIsBlank ? lineStart : p;
+        item.m_Line = line - 1;
+
+        if( *p == ')' )
+        {
+            item.m_End = end;
+            aTail = item;
+            return true;
+        }
+        else if( *p != '(' )
+        {
+            return false;
+        }
+
+        const char* keyword = p + 1;
+        const char* keywordEnd = keyword;
+
+        while( keywordEnd < end && !isspace( (unsigned char) *keywordEnd )
+                && *keywordEnd != '(' && *keywordEnd != ')' )
+        {
+            ++keywordEnd;
+        }
+
+        item.m_Keyword.assign( keyword, keywordEnd );
+
+        int depth = 0;
+
+        for( ; p < end; ++p )
+        {
+            if( *p == '"' )
+            {
+                for( ++p; p < end && *p != '"'; ++p )
+                {
+                    if( *p == '\\' )
+                        ++p;
+                    else if( *p == '\n' )
+                        newLine( p );
+                }
+            }
+            else if( *p == '(' )
+            {
+                ++depth;
+            }
+            else if( *p == ')' )
+            {
+                if( --depth == 0 )
+                    break;
+            }
+            else if( *p == '\n' )
+            {
+                newLine( p );
+            }
+        }
+
+        if( p >= end )
+            return false;
+
+        item.m_End = ++p;
+        lineIsBlank = false;
+        aItems.push_back( std::move( item ) );
+    }
+
+    return false;
+}
+
+
+bool PCB_PARSER::parseBoardItemsInParallel( std::vector<BOARD_ITEM*>& aBulkAddedItems )
+{
+    if( m_parallelLoadTried )
+        return false;
+
+    m_parallelLoadTried = true;
+
+    BUFFER_LINE_READER* bufferReader = dynamic_cast<BUFFER_LINE_READER*>( reader );
+    thread_pool&        tp = GetKiCadThreadPool();
+
+    // Older formats can require user interaction and board changes while parsing zones.
+    if( !bufferReader || m_appendToExisting || m_isParallelWorker
+            || m_requiredVersion < 20220211 || tp.get_thread_count() < 2 )
+    {
+        return false;
+    }
+
+    // Find the opening parenthesis of the current item
+    const char* buffer = bufferReader->Buffer();
+    size_t      pos = bufferReader->LineOffset() + CurOffset() - 1;
+
+    while( pos > 0 && isspace( (unsigned char) buffer[pos - 1] ) )
+        --pos;
+
+    if( pos == 0 || buffer[--pos] != '(' )
+        return false;
+
+    unsigned line = CurLineNumber() - std::count( buffer + pos,
+                                                  buffer + bufferReader->LineOffset(), '\n' );
+
+    std::vector<BOARD_ITEM_TEXT> items;
+    BOARD_ITEM_TEXT              tail;
+
+    if( !scanBoardItems( buffer, bufferReader->BufferLength(), pos, line, items, tail ) )
+    {
+        return false;
+    }
+
+    std::vector<T> tokens( items.size() );
+    std::vector<bool> isParallel( items.size() );
+    size_t         parallelBytes = 0;
+    size_t         parallelCount = 0;
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        tokens[ii] = (T) findToken( items[ii].m_Keyword );
+
+        switch( tokens[ii] )
+        {
+        case T_module:
+        case T_footprint:
+        case T_segment:
+        case T_arc:
+        case T_via:
+        case T_zone:
+            isParallel[ii] = true;
+            parallelBytes += items[ii].m_End - items[ii].m_Begin;
+            parallelCount++;
+            break;
+
+        // Images create bitmaps, which can only be done on the main thread.  Graphics are
+        // left there too as they are usually few and small.
+        case T_gr_arc:
+        case T_gr_curve:
+        case T_gr_line:
+        case T_gr_poly:
+        case T_gr_circle:
+        case T_gr_rect:
+        case T_image:
+        case T_gr_text:
+        case T_gr_text_box:
+        case T_dimension:
+        case T_group:
+        case T_target:
+            isParallel[ii] = false;
+            break;
+
+        default:
+            // Something other than a board item; leave the board to the serial parser.
+            return false;
+        }
+    }
+
+    if( parallelCount < 2 )
+        return false;
+
+    // Split the parallel items into runs of roughly equal size.  Each run is parsed from a
+    // single reader, skipping any serial items in between.
+    struct PARSE_TASK
+    {
+        size_t                                   m_First;
+        size_t                                   m_Last;
+        std::vector<std::unique_ptr<BOARD_ITEM>> m_Items;
+        std::vector<GROUP_INFO>                  m_GroupInfos;
+        std::vector<std::pair<ZONE*, wxString>>  m_DeferredZoneNets;
+        std::set<wxString>                       m_UndefinedLayers;
+        std::exception_ptr                       m_Error;
+    };
+
+    std::vector<PARSE_TASK> tasks;
+    size_t                  taskBytes = parallelBytes / ( tp.get_thread_count() * 4 ) + 1;
+    size_t                  currentBytes = 0;
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        if( !isParallel[ii] )
+            continue;
+
+        if( tasks.empty() || currentBytes >= taskBytes )
+        {
+            tasks.emplace_back();
+            tasks.back().m_First = ii;
+            currentBytes = 0;
+        }
+
+        tasks.back().m_Last = ii;
+        currentBytes += items[ii].m_End - items[ii].m_Begin;
+    }
+
+    std::atomic<bool>   cancelled( false );
+    std::atomic<size_t> tasksDone( 0 );
+
+    auto parseTask =
+            [&]( PARSE_TASK* aTask ) -> size_t
+            {
+                const BOARD_ITEM_TEXT& first = items[aTask->m_First];
+                const BOARD_ITEM_TEXT& last = items[aTask->m_Last];
+                BUFFER_LINE_READER     taskReader( first.m_Begin, last.m_End - first.m_Begin,
+                                                   CurSource(), first.m_Line );
+                PCB_PARSER             parser( &taskReader, nullptr, nullptr );
+
+                parser.m_board = m_board;
+                parser.m_isParallelWorker = true;
+                parser.m_layerIndices = m_layerIndices;
+                parser.m_layerMasks = m_layerMasks;
+                parser.m_netCodes = m_netCodes;
+                parser.m_tooRecent = m_tooRecent;
+                parser.m_requiredVersion = m_requiredVersion;
+
+                try
+                {
+                    for( T token = parser.NextTok(); token != T_EOF; token = parser.NextTok() )
+                    {
+                        if( cancelled )
+                            break;
+
+                        if( token != T_LEFT )
+                            parser.Expecting( T_LEFT );
+
+                        token = parser.NextTok();
+
+                        if( token == T_module || token == T_footprint || token == T_segment
+                                || token == T_arc || token == T_via || token == T_zone )
+                        {
+                            aTask->m_Items.emplace_back( parser.parseBoardItem( token ) );
+                        }
+                        else
+                        {
+                            parser.skipCurrent();
+                        }
+                    }
+                }
+                catch( ... )
+                {
+                    aTask->m_Error = std::current_exception();
+                }
+
+                aTask->m_GroupInfos = std::move( parser.m_groupInfos );
+                aTask->m_DeferredZoneNets = std::move( parser.m_deferredZoneNets );
+                aTask->m_UndefinedLayers = std::move( parser.m_undefinedLayers );
+                tasksDone++;
+                return 1;
+            };
+
+    std::vector<std::future<size_t>> returns;
+    returns.reserve( tasks.size() );
+
+    for( PARSE_TASK& task : tasks )
+        returns.emplace_back( tp.submit( parseTask, &task ) );
+
+    unsigned firstLine = CurLineNumber();
+
+    for( std::future<size_t>& ret : returns )
+    {
+        while( ret.wait_for( std::chrono::milliseconds( 250 ) ) != std::future_status::ready )
+        {
+            if( m_progressReporter )
+            {
+                double done = (double) tasksDone / tasks.size();
+
+                m_progressReporter->SetCurrentProgress(
+                        ( firstLine + done * ( m_lineCount - firstLine ) )
+                                / std::max( 1U, m_lineCount ) );
+
+                if( !m_progressReporter->KeepRefreshing() )
+                    cancelled = true;
+            }
+        }
+    }
+
+    if( cancelled )
+        THROW_IO_ERROR( _( "Open cancelled by user." ) );
+
+    // Add everything to the board in file order, parsing the serial items as they come.
+    size_t taskIdx = 0;
+    size_t itemIdx = 0;
+    size_t groupIdx = 0;
+    size_t zoneNetIdx = 0;
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        BOARD_ITEM* item = nullptr;
+
+        if( isParallel[ii] )
+        {
+            PARSE_TASK& task = tasks[taskIdx];
+
+            if( itemIdx >= task.m_Items.size() )
+                std::rethrow_exception( task.m_Error );
+
+            item = task.m_Items[itemIdx++].release();
+
+            while( groupIdx < task.m_GroupInfos.size()
+                    && task.m_GroupInfos[groupIdx].parent == item )
+            {
+                m_groupInfos.push_back( std::move( task.m_GroupInfos[groupIdx++] ) );
+            }
+
+            if( zoneNetIdx < task.m_DeferredZoneNets.size()
+                    && task.m_DeferredZoneNets[zoneNetIdx].first == item )
+            {
+                resolveZoneNet( static_cast<ZONE*>( item ),
+                                task.m_DeferredZoneNets[zoneNetIdx++].second );
+            }
+
+            if( ii == task.m_Last )
+            {
+                if( task.m_Error )
+                    std::rethrow_exception( task.m_Error );
+
+                m_undefinedLayers.insert( task.m_UndefinedLayers.begin(),
+                                          task.m_UndefinedLayers.end() );
+                taskIdx++;
+                itemIdx = 0;
+                groupIdx = 0;
+                zoneNetIdx = 0;
+            }
+        }
+        else
+        {
+            BUFFER_LINE_READER itemReader( items[ii].m_Begin,
+                                           items[ii].m_End - items[ii].m_Begin,
+                                           CurSource(), items[ii].m_Line );
+
+            PushReader( &itemReader );
+
+            try
+            {
+                NeedLEFT();
+                item = parseBoardItem( (T) NextTok() );
+            }
+            catch( ... )
+            {
+                PopReader();
+                throw;
+            }
+
+            PopReader();
+        }
+
+        if( item )
+        {
+            m_board->Add( item, ADD_MODE::BULK_APPEND, true );
+            aBulkAddedItems.push_back( item );
+        }
+    }
+
+    // Hand the board's closing parenthesis back to parseBOARD_unchecked()
+    m_tailReader = std::make_unique<BUFFER_LINE_READER>( tail.m_Begin, tail.m_End - tail.m_Begin,
+                                                         CurSource(), tail.m_Line );
+    PushReader( m_tailReader.get() );
+
+    return true;
+}
+
+
 void PCB_PARSER::resolveGroups( BOARD_ITEM* aParent )
 {
     auto getItem = [&]( const KIID& aId )
@@ -6108,25 +6511,12 @@ ZONE* PCB_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
     {
         // Can happens which old boards, with nonexistent nets ...
         // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-        {
-            zone->SetNetCode( net->GetNetCode() );
-        }
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net, ADD_MODE::INSERT, true );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNetCode() );
-
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNetCode() );
-        }
+        // We try to fix the mismatch.  Parallel workers can't touch the board's nets, so they
+        // leave this to the main thread.
+        if( m_isParallelWorker )
+            m_deferredZoneNets.emplace_back( zone.get(), netnameFromfile );
+        else
+            resolveZoneNet( zone.get(), netnameFromfile );
     }
 
     // Clear flags used in zone edition:
@@ -6136,6 +6526,29 @@ ZONE* PCB_PARSER::parseZONE( BOARD_ITEM_CONTAINER* aParent )
 }
 
 
+void PCB_PARSER::resolveZoneNet( ZONE* aZone, const wxString& aNetname )
+{
+    NETINFO_ITEM* net = m_board->FindNet( aNetname );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+    {
+        aZone->SetNetCode( net->GetNetCode() );
+    }
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetname, newnetcode );
+        m_board->Add( net, ADD_MODE::INSERT, true );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNetCode() );
+
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNetCode() );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, nullptr,
@@ -38,6 +38,7 @@
 #include <math/box2.h>
 
 #include <chrono>
+#include <memory>
 #include <unordered_map>
 
 
@@ -203,6 +204,30 @@ private:
     // Parse a board, but do not replace PARSE_ERROR with FUTURE_FORMAT_ERROR automatically.
     BOARD*              parseBOARD_unchecked();
 
+    /**
+     * Parse a board-level item (graphic, footprint, track, zone, etc.) whose keyword is
+     * \a aToken.  Groups are only recorded for resolveGroups(), for which nullptr is returned.
+     */
+    BOARD_ITEM*         parseBoardItem( PCB_KEYS_T::T aToken );
+
+    /**
+     * Parse the current and all following board items, footprints, tracks and zones being
+     * parsed in parallel on the thread pool.
+     *
+     * This is only possible when the whole file is available in a #BUFFER_LINE_READER, and
+     * when the rest of the board holds nothing but items.  The items are added to the board
+     * in file order, so the result is the same as for a serial load.
+     *
+     * @return false if the board can't be parsed in parallel, in which case nothing has been
+     *         consumed.
+     */
+    bool                parseBoardItemsInParallel( std::vector<BOARD_ITEM*>& aBulkAddedItems );
+
+    /**
+     * Fix up a copper zone whose net code doesn't match the net name found in the file.
+     */
+    void                resolveZoneNet( ZONE* aZone, const wxString& aNetname );
+
     /**
      * Parse the current token for the layer definition of a #BOARD_ITEM object.
      *
@@ -369,6 +394,17 @@ private:
 
     std::vector<GROUP_INFO> m_groupInfos;
 
+    ///< Parallel loading is attempted once, at the first board item.
+    bool                m_parallelLoadTried;
+
+    ///< Set for the parsers which load board items on the thread pool.  These can't modify
+    ///< the board, so zone net fixes are deferred to the merge done by the main parser.
+    bool                m_isParallelWorker;
+    std::vector<std::pair<ZONE*, wxString>> m_deferredZoneNets;
+
+    ///< The end of the board, which the main parser reads after parallel loading.
+    std::unique_ptr<BUFFER_LINE_READER>     m_tailReader;
+
     std::function<bool( wxString aTitle, int aIcon, wxString aMsg, wxString aAction )>* m_queryUserCallback;
 };
 
@@ -52,6 +52,7 @@
 #include <progress_reporter.h>
 #include <wildcards_and_files_ext.h>
 #include <wx/dir.h>
+#include <wx/filefn.h>
 #include <wx/log.h>
 #include <zone.h>
 #include <zones.h>
@@ -68,10 +69,31 @@ using namespace PCB_KEYS_T;
 
 FP_CACHE_ITEM::FP_CACHE_ITEM( FOOTPRINT* aFootprint, const WX_FILENAME& aFileName ) :
         m_filename( aFileName ),
+        m_sourceFile( aFileName ),
+        m_modTime( 0 ),
+        m_size( -1 ),
         m_footprint( aFootprint )
 { }
 
 
+/**
+ * Fetch the modification time and size of a footprint file.
+ *
+ * @return false if the file cannot be stat'ed.
+ */
+static bool getFileStats( const wxString& aFileName, long long& aModTime, long long& aSize )
+{
+    wxStructStat st;
+
+    if( wxStat( aFileName, &st ) != 0 )
+        return false;
+
+    aModTime = st.st_mtime;
+    aSize = st.st_size;
+    return true;
+}
+
+
 FP_CACHE::FP_CACHE( PCB_PLUGIN* aOwner, const wxString& aLibraryPath )
 {
     m_owner = aOwner;
@@ -100,10 +122,15 @@ void FP_CACHE::Save( FOOTPRINT* aFootprint )
 
     for( FP_CACHE_FOOTPRINT_MAP::iterator it = m_footprints.begin(); it != m_footprints.end(); ++it )
     {
-        if( aFootprint && aFootprint != it->second->GetFootprint() )
+        FP_CACHE_ITEM* item = it->second;
+
+        if( aFootprint && aFootprint != item->GetFootprint() )
             continue;
 
-        WX_FILENAME fn = it->second->GetFileName();
+        // Footprints which aren't resident are parsed from their source file first.
+        const FOOTPRINT* footprint = aFootprint ? aFootprint : GetFootprint( it->first );
+
+        WX_FILENAME fn = item->GetFileName();
 
         wxString tempFileName =
 #ifdef USE_TMP_FILE
@@ -120,7 +147,7 @@ void FP_CACHE::Save( FOOTPRINT* aFootprint )
             FILE_OUTPUTFORMATTER formatter( tempFileName );
 
             m_owner->SetOutputFormatter( &formatter );
-            m_owner->Format( (BOARD_ITEM*) it->second->GetFootprint() );
+            m_owner->Format( (BOARD_ITEM*) footprint );
         }
 
 #ifdef USE_TMP_FILE
@@ -139,6 +166,10 @@ void FP_CACHE::Save( FOOTPRINT* aFootprint )
         }
 #endif
         m_cache_timestamp += fn.GetTimestamp();
+
+        // The footprint can now be evicted and parsed again from the file it was saved to.
+        item->m_sourceFile = fn;
+        getFileStats( fn.GetFullPath(), item->m_modTime, item->m_size );
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
@@ -163,6 +194,14 @@ void FP_CACHE::Load()
         THROW_IO_ERROR( msg );
     }
 
+    // Footprints are parsed on demand by GetFootprint().  Those already parsed are kept if
+    // their file hasn't changed.
+    FP_CACHE_FOOTPRINT_MAP    previous;
+    std::list<FP_CACHE_ITEM*> previousResident;
+
+    previous.swap( m_footprints );
+    previousResident.swap( m_resident );
+
     wxString fullName;
     wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
 
@@ -172,44 +211,127 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
-            {
-                FILE_LINE_READER reader( fn.GetFullPath() );
-                PCB_PARSER       parser( &reader, nullptr, nullptr );
-
-                FOOTPRINT* footprint = (FOOTPRINT*) parser.Parse();
-                wxString   fpName = fn.GetName();
-
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_footprints.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += wxT( "\n\n" );
+            FP_CACHE_ITEM* item = new FP_CACHE_ITEM( nullptr, fn );
+            wxString       fpName = fn.GetName();
 
-                cacheError += ioe.What();
-            }
+            getFileStats( fn.GetFullPath(), item->m_modTime, item->m_size );
+            m_footprints.insert( fpName, item );
         } while( dir.GetNext( &fullName ) );
 
         m_cache_timestamp = GetTimestamp( m_lib_raw_path );
+    }
+
+    for( FP_CACHE_ITEM* oldItem : previousResident )
+    {
+        FP_CACHE_FOOTPRINT_MAP::iterator it = m_footprints.find( oldItem->m_filename.GetName() );
+
+        if( it == m_footprints.end() )
+            continue;
+
+        FP_CACHE_ITEM* item = it->second;
+
+        if( item->m_sourceFile.GetFullPath() == oldItem->m_sourceFile.GetFullPath()
+                && item->m_modTime == oldItem->m_modTime && item->m_size == oldItem->m_size )
+        {
+            item->m_footprint = std::move( oldItem->m_footprint );
+            item->m_residentEntry = m_resident.insert( m_resident.end(), item );
+        }
+    }
+}
+
+
+const FOOTPRINT* FP_CACHE::GetFootprint( const wxString& aFootprintName )
+{
+    FP_CACHE_FOOTPRINT_MAP::iterator it = m_footprints.find( aFootprintName );
+
+    if( it == m_footprints.end() )
+        return nullptr;
+
+    return loadFootprint( *it->second );
+}
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+
+const FOOTPRINT* FP_CACHE::loadFootprint( FP_CACHE_ITEM& aItem )
+{
+    if( !aItem.m_footprint )
+    {
+        wxString fileName = aItem.m_sourceFile.GetFullPath();
+
+        MAPPED_FILE_LINE_READER     reader( fileName );
+        PCB_PARSER                  parser( &reader, nullptr, nullptr );
+        std::unique_ptr<BOARD_ITEM> parsed( parser.Parse() );
+
+        if( !dynamic_cast<FOOTPRINT*>( parsed.get() ) )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "File '%s' does not contain a footprint." ),
+                                              fileName ) );
+        }
+
+        aItem.m_footprint.reset( static_cast<FOOTPRINT*>( parsed.release() ) );
+        aItem.m_footprint->SetFPID( LIB_ID( wxEmptyString, aItem.m_filename.GetName() ) );
+        aItem.m_residentEntry = m_resident.insert( m_resident.begin(), &aItem );
     }
+
+    touch( aItem );
+
+    return aItem.m_footprint.get();
+}
+
+
+void FP_CACHE::touch( FP_CACHE_ITEM& aItem )
+{
+    m_resident.splice( m_resident.begin(), m_resident, aItem.m_residentEntry );
+
+    // aItem is at the front, so it can't be evicted here.
+    size_t limit = std::max( 0, ADVANCED_CFG::GetCfg().m_FootprintCacheSize );
+
+    while( limit > 0 && m_resident.size() > limit )
+    {
+        FP_CACHE_ITEM* lru = m_resident.back();
+
+        m_resident.pop_back();
+        lru->m_footprint.reset();
+    }
+}
+
+
+void FP_CACHE::release( FP_CACHE_ITEM& aItem )
+{
+    if( aItem.m_footprint )
+    {
+        m_resident.erase( aItem.m_residentEntry );
+        aItem.m_footprint.reset();
+    }
+}
+
+
+void FP_CACHE::Insert( const wxString& aFootprintName, FOOTPRINT* aFootprint,
+                       const WX_FILENAME& aFileName )
+{
+    FP_CACHE_FOOTPRINT_MAP::iterator it = m_footprints.find( aFootprintName );
+
+    if( it != m_footprints.end() )
+    {
+        release( *it->second );
+        m_footprints.erase( it );
+    }
+
+    wxString       fpName = aFootprintName;
+    FP_CACHE_ITEM* item = new FP_CACHE_ITEM( aFootprint, aFileName );
+
+    m_footprints.insert( fpName, item );
+    item->m_residentEntry = m_resident.insert( m_resident.begin(), item );
+    touch( *item );
 }
 
 
 void FP_CACHE::Remove( const wxString& aFootprintName )
 {
-    FP_CACHE_FOOTPRINT_MAP::const_iterator it = m_footprints.find( aFootprintName );
+    FP_CACHE_FOOTPRINT_MAP::iterator it = m_footprints.find( aFootprintName );
 
     if( it == m_footprints.end() )
     {
@@ -221,6 +343,7 @@ void FP_CACHE::Remove( const wxString& aFootprintName )
 
     // Remove the footprint from the cache and delete the footprint file from the library.
     wxString fullPath = it->second->GetFileName().GetFullPath();
+    release( *it->second );
     m_footprints.erase( aFootprintName );
     wxRemoveFile( fullPath );
 }
@@ -2363,7 +2486,9 @@ BOARD* PCB_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
                          const STRING_UTF8_MAP* aProperties, PROJECT* aProject,
                          PROGRESS_REPORTER* aProgressReporter )
 {
-    FILE_LINE_READER reader( aFileName );
+    // Parsing from memory lets the parser hand the bulk of the board items out to worker
+    // threads.
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     unsigned lineCount = 0;
 
@@ -2374,10 +2499,7 @@ BOARD* PCB_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
         if( !aProgressReporter->KeepRefreshing() )
             THROW_IO_ERROR( _( "Open cancelled by user." ) );
 
-        while( reader.ReadLine() )
-            lineCount++;
-
-        reader.Rewind();
+        lineCount = std::count( reader.Buffer(), reader.Buffer() + reader.BufferLength(), '\n' );
     }
 
     BOARD* board = DoLoad( reader, aAppendToMe, aProperties, aProgressReporter, lineCount );
@@ -2436,13 +2558,18 @@ void PCB_PLUGIN::init( const STRING_UTF8_MAP* aProperties )
 
 void PCB_PLUGIN::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
         m_cache = new FP_CACHE( this, aLibraryPath );
         m_cache->Load();
     }
+    else if( checkModified && m_cache->IsModified() )
+    {
+        // Re-index the library, keeping any parsed footprints whose files haven't changed.
+        m_cache->Load();
+    }
 }
 
 
@@ -2493,13 +2620,7 @@ const FOOTPRINT* PCB_PLUGIN::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    FP_CACHE_FOOTPRINT_MAP&       footprints = m_cache->GetFootprints();
-    FP_CACHE_FOOTPRINT_MAP::const_iterator it = footprints.find( aFootprintName );
-
-    if( it == footprints.end() )
-        return nullptr;
-
-    return it->second->GetFootprint();
+    return m_cache->GetFootprint( aFootprintName );
 }
 
 
@@ -2615,7 +2736,6 @@ void PCB_PLUGIN::FootprintSave( const wxString& aLibraryPath, const FOOTPRINT* a
     if( it != footprints.end() )
     {
         wxLogTrace( traceKicadPcbPlugin, wxT( "Removing footprint file '%s'." ), fullPath );
-        footprints.erase( footprintName );
         wxRemoveFile( fullPath );
     }
 
@@ -2639,8 +2759,7 @@ void PCB_PLUGIN::FootprintSave( const wxString& aLibraryPath, const FOOTPRINT* a
     footprint->SetParent( nullptr );
 
     wxLogTrace( traceKicadPcbPlugin, wxT( "Creating s-expr footprint file '%s'." ), fullPath );
-    footprints.insert( footprintName,
-                       new FP_CACHE_ITEM( footprint, WX_FILENAME( fn.GetPath(), fullName ) ) );
+    m_cache->Insert( footprintName, footprint, WX_FILENAME( fn.GetPath(), fullName ) );
     m_cache->Save( footprint );
 }
 
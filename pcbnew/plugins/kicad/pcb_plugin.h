@@ -29,6 +29,7 @@
 #include <string>
 #include <layer_ids.h>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <list>
 #include <wx_filename.h>
 #include "widgets/report_severity.h"
 
@@ -172,14 +173,26 @@ class PCB_PLUGIN;   // forward decl
  */
 class FP_CACHE_ITEM
 {
-    WX_FILENAME                m_filename;
-    std::unique_ptr<FOOTPRINT> m_footprint;
+    WX_FILENAME                m_filename;     // Where the footprint is saved to.
+    WX_FILENAME                m_sourceFile;   // Where the footprint is (re)parsed from.
+    long long                  m_modTime;      // Modification time of m_sourceFile.
+    long long                  m_size;         // Size of m_sourceFile.
+    std::unique_ptr<FOOTPRINT> m_footprint;    // Null until parsed, and once evicted.
+
+    std::list<FP_CACHE_ITEM*>::iterator m_residentEntry;   // Position in FP_CACHE's LRU list
+
+    friend class FP_CACHE;
 
 public:
     FP_CACHE_ITEM( FOOTPRINT* aFootprint, const WX_FILENAME& aFileName );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     void               SetFilePath( const wxString& aFilePath ) { m_filename.SetPath( aFilePath ); }
+
+    /**
+     * @return the parsed footprint, or nullptr if it has not been parsed (or has been evicted).
+     *         Use FP_CACHE::GetFootprint() to parse it on demand.
+     */
     const FOOTPRINT*   GetFootprint() const { return m_footprint.get(); }
 };
 
@@ -192,6 +205,9 @@ class FP_CACHE
     wxString      m_lib_raw_path; // For quick comparisons.
     FP_CACHE_FOOTPRINT_MAP m_footprints;   // Map of footprint filename to FOOTPRINT*.
 
+    std::list<FP_CACHE_ITEM*> m_resident;  // Items with a parsed footprint, most recently
+                                           // used first.
+
     bool m_cache_dirty;          // Stored separately because it's expensive to check
                                  // m_cache_timestamp against all the files.
     long long m_cache_timestamp; // A hash of the timestamps for all the footprint
@@ -219,8 +235,30 @@ public:
      */
     void Save( FOOTPRINT* aFootprint = nullptr );
 
+    /**
+     * Index the footprint files of the library.  Footprints are not parsed until they are
+     * asked for by GetFootprint(); those already parsed are kept if their file is unchanged.
+     */
     void Load();
 
+    /**
+     * Return the footprint \a aFootprintName, parsing it from its file if it isn't resident.
+     *
+     * Only the most recently used footprints (see ADVANCED_CFG::m_FootprintCacheSize) are kept
+     * in memory, so the returned footprint is only valid until the next call.
+     *
+     * @return nullptr if the library has no such footprint.
+     * @throw IO_ERROR if the footprint file cannot be parsed.
+     */
+    const FOOTPRINT* GetFootprint( const wxString& aFootprintName );
+
+    /**
+     * Add a footprint to the cache, replacing any footprint of the same name.  The cache takes
+     * ownership of \a aFootprint.
+     */
+    void Insert( const wxString& aFootprintName, FOOTPRINT* aFootprint,
+                 const WX_FILENAME& aFileName );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -249,6 +287,20 @@ public:
     bool IsPath( const wxString& aPath ) const;
 
     void SetPath( const wxString& aPath );
+
+private:
+    const FOOTPRINT* loadFootprint( FP_CACHE_ITEM& aItem );
+
+    /**
+     * Move a resident item to the front of the LRU list and evict any footprints beyond the
+     * cache size.
+     */
+    void touch( FP_CACHE_ITEM& aItem );
+
+    /**
+     * Drop an item's parsed footprint (if any).
+     */
+    void release( FP_CACHE_ITEM& aItem );
 };
 
 
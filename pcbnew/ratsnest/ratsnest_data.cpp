@@ -39,8 +39,11 @@
 using namespace std::placeholders;
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <tuple>
 
 #include <delaunator.hpp>
 
@@ -107,158 +110,1011 @@ private:
 };
 
 
-void RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
+namespace
 {
-    disjoint_set dset( m_nodes.size() );
 
-    m_rnEdges.clear();
+/**
+ * A signed integer wide enough to evaluate the orientation and in-circle determinants of
+ * 32-bit coordinates exactly.  Only used when the floating point evaluation is too close
+ * to call.
+ */
+class EXACT_INT
+{
+public:
+    EXACT_INT( int64_t aValue = 0 ) :
+            m_negative( aValue < 0 )
+    {
+        uint64_t mag = m_negative ? uint64_t( 0 ) - uint64_t( aValue ) : uint64_t( aValue );
 
-    int i = 0;
+        m_limbs.fill( 0 );
+        m_limbs[0] = uint32_t( mag );
+        m_limbs[1] = uint32_t( mag >> 32 );
+    }
 
-    for( const std::shared_ptr<CN_ANCHOR>& node : m_nodes )
-        node->SetTag( i++ );
+    EXACT_INT operator*( const EXACT_INT& aOther ) const
+    {
+        EXACT_INT result;
+
+        for( int i = 0; i < LIMBS; ++i )
+        {
+            uint64_t carry = 0;
+
+            for( int j = 0; i + j < LIMBS; ++j )
+            {
+                uint64_t t = result.m_limbs[i + j] + uint64_t( m_limbs[i] ) * aOther.m_limbs[j]
+                             + carry;
+
+                result.m_limbs[i + j] = uint32_t( t );
+                carry = t >> 32;
+            }
+        }
+
+        result.m_negative = m_negative != aOther.m_negative && !result.isZero();
+        return result;
+    }
 
-    for( const CN_EDGE& tmp : aEdges )
+    EXACT_INT operator+( const EXACT_INT& aOther ) const
     {
-        const std::shared_ptr<const CN_ANCHOR>& source = tmp.GetSourceNode();
-        const std::shared_ptr<const CN_ANCHOR>& target = tmp.GetTargetNode();
+        EXACT_INT result;
 
-        if( dset.unite( source->GetTag(), target->GetTag() ) )
+        if( m_negative == aOther.m_negative )
         {
-            if( tmp.GetWeight() > 0 )
-                m_rnEdges.push_back( tmp );
+            uint64_t carry = 0;
+
+            for( int i = 0; i < LIMBS; ++i )
+            {
+                uint64_t t = uint64_t( m_limbs[i] ) + aOther.m_limbs[i] + carry;
+                result.m_limbs[i] = uint32_t( t );
+                carry = t >> 32;
+            }
+
+            result.m_negative = m_negative && !result.isZero();
+            return result;
+        }
+
+        int cmp = compareMagnitude( aOther );
+
+        if( cmp == 0 )
+            return result;
+
+        const EXACT_INT& big = cmp > 0 ? *this : aOther;
+        const EXACT_INT& small = cmp > 0 ? aOther : *this;
+        int64_t          borrow = 0;
+
+        for( int i = 0; i < LIMBS; ++i )
+        {
+            int64_t t = int64_t( big.m_limbs[i] ) - small.m_limbs[i] - borrow;
+            borrow = t < 0;
+            result.m_limbs[i] = uint32_t( t + ( borrow << 32 ) );
         }
+
+        result.m_negative = big.m_negative;
+        return result;
     }
+
+    EXACT_INT operator-( const EXACT_INT& aOther ) const
+    {
+        EXACT_INT negated = aOther;
+        negated.m_negative = !aOther.m_negative && !aOther.isZero();
+
+        return *this + negated;
+    }
+
+    int Sign() const
+    {
+        return isZero() ? 0 : ( m_negative ? -1 : 1 );
+    }
+
+private:
+    static constexpr int LIMBS = 6;
+
+    bool isZero() const
+    {
+        return std::all_of( m_limbs.begin(), m_limbs.end(), []( uint32_t l ) { return l == 0; } );
+    }
+
+    int compareMagnitude( const EXACT_INT& aOther ) const
+    {
+        for( int i = LIMBS - 1; i >= 0; --i )
+        {
+            if( m_limbs[i] != aOther.m_limbs[i] )
+                return m_limbs[i] < aOther.m_limbs[i] ? -1 : 1;
+        }
+
+        return 0;
+    }
+
+    std::array<uint32_t, LIMBS> m_limbs;
+    bool                        m_negative;
+};
+
+
+/**
+ * @return the sign of the orientation of the triangle aA, aB, aC (positive when the points
+ *         are in counter-clockwise order in a y-up frame).
+ */
+int orient2d( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC )
+{
+    // Coordinate differences are exact in a double; only the products can be rounded.
+    double detLeft = ( double( aA.x ) - aC.x ) * ( double( aB.y ) - aC.y );
+    double detRight = ( double( aA.y ) - aC.y ) * ( double( aB.x ) - aC.x );
+    double det = detLeft - detRight;
+    double errBound = 3.3306690738754716e-16 * ( std::abs( detLeft ) + std::abs( detRight ) );
+
+    if( det > errBound || -det > errBound )
+        return det > 0 ? 1 : -1;
+
+    EXACT_INT exact = EXACT_INT( int64_t( aA.x ) - aC.x ) * EXACT_INT( int64_t( aB.y ) - aC.y )
+                      - EXACT_INT( int64_t( aA.y ) - aC.y ) * EXACT_INT( int64_t( aB.x ) - aC.x );
+
+    return exact.Sign();
+}
+
+
+/**
+ * @return a positive value if aD lies inside the circle through aA, aB and aC (which must
+ *         have a positive orientation), negative if it lies outside and zero if on it.
+ */
+int inCircle( const VECTOR2I& aA, const VECTOR2I& aB, const VECTOR2I& aC, const VECTOR2I& aD )
+{
+    double adx = double( aA.x ) - aD.x;
+    double ady = double( aA.y ) - aD.y;
+    double bdx = double( aB.x ) - aD.x;
+    double bdy = double( aB.y ) - aD.y;
+    double cdx = double( aC.x ) - aD.x;
+    double cdy = double( aC.y ) - aD.y;
+
+    double bdxcdy = bdx * cdy;
+    double cdxbdy = cdx * bdy;
+    double alift = adx * adx + ady * ady;
+    double cdxady = cdx * ady;
+    double adxcdy = adx * cdy;
+    double blift = bdx * bdx + bdy * bdy;
+    double adxbdy = adx * bdy;
+    double bdxady = bdx * ady;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * ( bdxcdy - cdxbdy ) + blift * ( cdxady - adxcdy )
+                 + clift * ( adxbdy - bdxady );
+    double permanent = ( std::abs( bdxcdy ) + std::abs( cdxbdy ) ) * alift
+                       + ( std::abs( cdxady ) + std::abs( adxcdy ) ) * blift
+                       + ( std::abs( adxbdy ) + std::abs( bdxady ) ) * clift;
+    double errBound = 1.1102230246251577e-15 * permanent;
+
+    if( det > errBound || -det > errBound )
+        return det > 0 ? 1 : -1;
+
+    EXACT_INT eadx( int64_t( aA.x ) - aD.x );
+    EXACT_INT eady( int64_t( aA.y ) - aD.y );
+    EXACT_INT ebdx( int64_t( aB.x ) - aD.x );
+    EXACT_INT ebdy( int64_t( aB.y ) - aD.y );
+    EXACT_INT ecdx( int64_t( aC.x ) - aD.x );
+    EXACT_INT ecdy( int64_t( aC.y ) - aD.y );
+
+    EXACT_INT exact = ( eadx * eadx + eady * eady ) * ( ebdx * ecdy - ecdx * ebdy )
+                      + ( ebdx * ebdx + ebdy * ebdy ) * ( ecdx * eady - eadx * ecdy )
+                      + ( ecdx * ecdx + ecdy * ecdy ) * ( eadx * ebdy - ebdx * eady );
+
+    return exact.Sign();
+}
+
+
+bool lexLess( const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    return aA.x < aB.x || ( aA.x == aB.x && aA.y < aB.y );
 }
 
+} // namespace
+
 
+/**
+ * A Delaunay triangulation of the distinct anchor positions of a net, kept between ratsnest
+ * updates so that only the anchors which were added or removed since the last update need
+ * to be inserted into (Bowyer-Watson) or deleted from (ear clipping of the star polygon) the
+ * triangulation.  The edges of the triangulation are kept sorted by length for the MST.
+ *
+ * The hull is closed with "ghost" triangles sharing a vertex at infinity so that points
+ * outside the hull need no special treatment.
+ */
 class RN_NET::TRIANGULATOR_STATE
 {
-private:
-    std::multiset<std::shared_ptr<CN_ANCHOR>, CN_PTR_CMP> m_allNodes;
+public:
+    struct EDGE
+    {
+        unsigned m_Weight;
+        int      m_A;
+        int      m_B;
 
+        bool operator<( const EDGE& aOther ) const
+        {
+            return std::tie( m_Weight, m_A, m_B )
+                   < std::tie( aOther.m_Weight, aOther.m_A, aOther.m_B );
+        }
+    };
 
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<std::shared_ptr<CN_ANCHOR>>& aNodes ) const
+    TRIANGULATOR_STATE() :
+            m_valid( false ),
+            m_hint( -1 ),
+            m_realTriangles( 0 ),
+            m_trackEdges( true )
     {
-        if ( aNodes.size() <= 2 )
-            return true;
+        m_vertices.emplace_back(); // INFINITE
+    }
 
-        const VECTOR2I p0( aNodes[0]->Pos() );
-        const VECTOR2I v0( aNodes[1]->Pos() - p0 );
+    /**
+     * Bring the triangulation in line with \a aNodes.
+     *
+     * Edges which are not part of the triangulation are added to \a aEdges: edges between
+     * anchors sharing a position and, if the positions are colinear (or the triangulation
+     * could not be updated), the edges joining the positions.
+     */
+    void Update( const std::multiset<std::shared_ptr<CN_ANCHOR>, CN_PTR_CMP>& aNodes,
+                 std::vector<CN_EDGE>& aEdges )
+    {
+        std::vector<std::pair<VECTOR2I, int>>   positions;
+        std::vector<std::shared_ptr<CN_ANCHOR>> chain;
+        std::vector<int>                        removed;
+        std::vector<int>                        added;
+        auto                                    old = m_positions.begin();
+
+        positions.reserve( aNodes.size() );
 
-        for( unsigned i = 2; i < aNodes.size(); i++ )
+        for( auto it = aNodes.begin(); it != aNodes.end(); )
         {
-            const VECTOR2I v1 = aNodes[i]->Pos() - p0;
+            const VECTOR2I pos = ( *it )->Pos();
 
-            if( v0.Cross( v1 ) != 0 )
-                return false;
+            chain.clear();
+
+            for( ; it != aNodes.end() && ( *it )->Pos() == pos; ++it )
+                chain.push_back( *it );
+
+            addChainEdges( chain, aEdges );
+
+            while( old != m_positions.end() && lexLess( old->first, pos ) )
+                removed.push_back( ( old++ )->second );
+
+            int v;
+
+            if( old != m_positions.end() && old->first == pos )
+            {
+                v = ( old++ )->second;
+            }
+            else
+            {
+                v = allocVertex( pos );
+                added.push_back( v );
+            }
+
+            m_vertices[v].m_Anchor = chain.front();
+            positions.emplace_back( pos, v );
         }
 
-        return true;
+        for( ; old != m_positions.end(); ++old )
+            removed.push_back( old->second );
+
+        m_positions.swap( positions );
+
+        bool ok = true;
+
+        if( m_positions.size() < 3 )
+        {
+            reset();
+        }
+        else if( !m_valid || ( removed.size() + added.size() ) * 4 > m_positions.size() )
+        {
+            ok = rebuild();
+        }
+        else
+        {
+            for( int v : removed )
+            {
+                if( !( ok = remove( v ) ) )
+                    break;
+            }
+
+            for( size_t ii = 0; ok && ii < added.size(); ++ii )
+                ok = insert( added[ii] );
+
+            // Either something went wrong or the remaining positions are colinear
+            if( !ok || m_realTriangles == 0 )
+                ok = rebuild();
+        }
+
+        for( int v : removed )
+            freeVertex( v );
+
+        if( !ok )
+        {
+            wxFAIL_MSG( wxT( "Ratsnest triangulation could not be updated" ) );
+            reset();
+            triangulateStatic( aEdges );
+        }
+        else if( !m_valid )
+        {
+            // All positions lie on a single line: there's no triangulation for such a set, so
+            // chain them together in order.
+            for( size_t ii = 1; ii < m_positions.size(); ++ii )
+            {
+                const std::shared_ptr<CN_ANCHOR>& src = GetAnchor( m_positions[ii - 1].second );
+                const std::shared_ptr<CN_ANCHOR>& dst = GetAnchor( m_positions[ii].second );
+
+                aEdges.emplace_back( src, dst, src->Dist( *dst ) );
+            }
+        }
     }
 
-public:
+    /**
+     * @return the edges of the triangulation, shortest first.
+     */
+    const std::set<EDGE>& GetEdges() const { return m_edges; }
 
-    void Clear()
+    /**
+     * @return the first anchor at the position of \a aVertex.
+     */
+    const std::shared_ptr<CN_ANCHOR>& GetAnchor( int aVertex ) const
     {
-        m_allNodes.clear();
+        return m_vertices[aVertex].m_Anchor;
     }
 
-    void AddNode( std::shared_ptr<CN_ANCHOR> aNode )
+private:
+    static constexpr int INFINITE = 0;
+
+    struct VERTEX
     {
-        m_allNodes.insert( aNode );
+        VECTOR2I                   m_Pos;
+        std::shared_ptr<CN_ANCHOR> m_Anchor;        ///< The first anchor at m_Pos
+        int                        m_Triangle = -1; ///< A triangle incident to the vertex
+    };
+
+    ///< An edge of the cavity of an insertion and the triangle beyond it
+    struct BOUNDARY
+    {
+        int m_A;
+        int m_B;
+        int m_Outer;
+    };
+
+    struct TRIANGLE
+    {
+        int  m_V[3];     ///< Vertices, in positive orientation
+        int  m_N[3];     ///< m_N[i] is the neighbour across the edge m_V[i] -> m_V[i + 1]
+        bool m_Alive;
+    };
+
+    const VECTOR2I& pos( int aVertex ) const { return m_vertices[aVertex].m_Pos; }
+
+    void addChainEdges( std::vector<std::shared_ptr<CN_ANCHOR>>& aChain,
+                        std::vector<CN_EDGE>& aEdges ) const
+    {
+        if( aChain.size() < 2 )
+            return;
+
+        std::sort( aChain.begin(), aChain.end(),
+                [] ( const std::shared_ptr<CN_ANCHOR>& a, const std::shared_ptr<CN_ANCHOR>& b )
+                {
+                    return a->GetCluster().get() < b->GetCluster().get();
+                } );
+
+        for( unsigned int j = 1; j < aChain.size(); j++ )
+        {
+            const std::shared_ptr<CN_ANCHOR>& prevNode = aChain[j - 1];
+            const std::shared_ptr<CN_ANCHOR>& curNode  = aChain[j];
+            int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
+            aEdges.emplace_back( prevNode, curNode, weight );
+        }
     }
 
-    void Triangulate( std::vector<CN_EDGE>& mstEdges )
+    /**
+     * Triangulate the positions from scratch with delaunator.  Only used if the incremental
+     * triangulation fails.
+     */
+    void triangulateStatic( std::vector<CN_EDGE>& aEdges ) const
     {
-        std::vector<double>                                    node_pts;
-        std::vector<std::shared_ptr<CN_ANCHOR>>                anchors;
-        std::vector< std::vector<std::shared_ptr<CN_ANCHOR>> > anchorChains( m_allNodes.size() );
+        std::vector<double> node_pts;
 
-        node_pts.reserve( 2 * m_allNodes.size() );
-        anchors.reserve( m_allNodes.size() );
+        node_pts.reserve( 2 * m_positions.size() );
+
+        for( const std::pair<VECTOR2I, int>& p : m_positions )
+        {
+            node_pts.push_back( p.first.x );
+            node_pts.push_back( p.first.y );
+        }
 
         auto addEdge =
-                [&]( const std::shared_ptr<CN_ANCHOR>& src, const std::shared_ptr<CN_ANCHOR>& dst )
+                [&]( size_t aSrc, size_t aDst )
                 {
-                    mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
+                    const std::shared_ptr<CN_ANCHOR>& src = GetAnchor( m_positions[aSrc].second );
+                    const std::shared_ptr<CN_ANCHOR>& dst = GetAnchor( m_positions[aDst].second );
+
+                    aEdges.emplace_back( src, dst, src->Dist( *dst ) );
                 };
 
-        std::shared_ptr<CN_ANCHOR> prev = nullptr;
+        delaunator::Delaunator delaunator( node_pts );
+        auto& triangles = delaunator.triangles;
+
+        for( size_t i = 0; i < triangles.size(); i += 3 )
+        {
+            addEdge( triangles[i],     triangles[i + 1] );
+            addEdge( triangles[i + 1], triangles[i + 2] );
+            addEdge( triangles[i + 2], triangles[i]     );
+        }
+    }
+
+    int allocVertex( const VECTOR2I& aPos )
+    {
+        int v;
+
+        if( !m_freeVertices.empty() )
+        {
+            v = m_freeVertices.back();
+            m_freeVertices.pop_back();
+        }
+        else
+        {
+            v = m_vertices.size();
+            m_vertices.emplace_back();
+        }
+
+        m_vertices[v].m_Pos = aPos;
+        m_vertices[v].m_Triangle = -1;
+        return v;
+    }
+
+    void freeVertex( int aVertex )
+    {
+        m_vertices[aVertex].m_Anchor.reset();
+        m_freeVertices.push_back( aVertex );
+    }
+
+    EDGE makeEdge( int aA, int aB ) const
+    {
+        return { (unsigned) ( pos( aB ) - pos( aA ) ).EuclideanNorm(), aA, aB };
+    }
+
+    bool isGhost( int aTri ) const
+    {
+        const TRIANGLE& t = m_triangles[aTri];
+        return t.m_V[0] == INFINITE || t.m_V[1] == INFINITE || t.m_V[2] == INFINITE;
+    }
+
+    /**
+     * @return the index k such that the triangle is ( m_V[k + 1], m_V[k + 2], INFINITE ).
+     */
+    int ghostIndex( int aTri ) const
+    {
+        const TRIANGLE& t = m_triangles[aTri];
+        return t.m_V[0] == INFINITE ? 0 : t.m_V[1] == INFINITE ? 1 : 2;
+    }
+
+    int createTriangle( int aA, int aB, int aC )
+    {
+        int t;
+
+        if( !m_freeTriangles.empty() )
+        {
+            t = m_freeTriangles.back();
+            m_freeTriangles.pop_back();
+        }
+        else
+        {
+            t = m_triangles.size();
+            m_triangles.emplace_back();
+        }
+
+        TRIANGLE& tri = m_triangles[t];
+        tri.m_V[0] = aA;
+        tri.m_V[1] = aB;
+        tri.m_V[2] = aC;
+        tri.m_N[0] = tri.m_N[1] = tri.m_N[2] = -1;
+        tri.m_Alive = true;
+
+        // Each edge is owned by the triangle which has it running from the lower index to
+        // the higher one.  On the hull that may be the ghost triangle.
+        for( int i = 0; i < 3; ++i )
+        {
+            int u = tri.m_V[i];
+            int w = tri.m_V[( i + 1 ) % 3];
+
+            if( u != INFINITE )
+            {
+                m_vertices[u].m_Triangle = t;
+
+                if( w != INFINITE && u < w && m_trackEdges )
+                    m_edges.insert( makeEdge( u, w ) );
+            }
+        }
+
+        if( !isGhost( t ) )
+            m_realTriangles++;
+
+        m_hint = t;
+        return t;
+    }
+
+    void killTriangle( int aTri )
+    {
+        TRIANGLE& tri = m_triangles[aTri];
+
+        for( int i = 0; i < 3; ++i )
+        {
+            int u = tri.m_V[i];
+            int w = tri.m_V[( i + 1 ) % 3];
+
+            if( u != INFINITE && w != INFINITE && u < w && m_trackEdges )
+                m_edges.erase( makeEdge( u, w ) );
+        }
+
+        if( !isGhost( aTri ) )
+            m_realTriangles--;
 
-        for( const std::shared_ptr<CN_ANCHOR>& n : m_allNodes )
+        tri.m_Alive = false;
+        m_freeTriangles.push_back( aTri );
+    }
+
+    /**
+     * Set the neighbour of \a aTri across its edge \a aEdge to \a aOther, and vice versa.
+     */
+    bool link( int aTri, int aEdge, int aOther )
+    {
+        TRIANGLE& tri = m_triangles[aTri];
+        TRIANGLE& other = m_triangles[aOther];
+        int       u = tri.m_V[aEdge];
+        int       w = tri.m_V[( aEdge + 1 ) % 3];
+
+        for( int j = 0; j < 3; ++j )
         {
-            if( !prev || prev->Pos() != n->Pos() )
+            if( other.m_V[j] == w && other.m_V[( j + 1 ) % 3] == u )
             {
-                node_pts.push_back( n->Pos().x );
-                node_pts.push_back( n->Pos().y );
-                anchors.push_back( n );
-                prev = n;
+                tri.m_N[aEdge] = aOther;
+                other.m_N[j] = aTri;
+                return true;
             }
+        }
+
+        return false;
+    }
+
+    /**
+     * @return true if \a aPos lies in the circumcircle of \a aTri.  The circumcircle of a
+     *         ghost triangle is the open half-plane beyond its hull edge, plus the open edge.
+     */
+    bool conflicts( int aTri, const VECTOR2I& aPos ) const
+    {
+        const TRIANGLE& tri = m_triangles[aTri];
 
-            anchorChains[anchors.size() - 1].push_back( n );
+        if( isGhost( aTri ) )
+        {
+            int k = ghostIndex( aTri );
+            return ghostConflicts( tri.m_V[( k + 1 ) % 3], tri.m_V[( k + 2 ) % 3], aPos );
         }
 
-        if( anchors.size() < 2 )
+        return inCircle( pos( tri.m_V[0] ), pos( tri.m_V[1] ), pos( tri.m_V[2] ), aPos ) > 0;
+    }
+
+    bool ghostConflicts( int aU, int aW, const VECTOR2I& aPos ) const
+    {
+        const VECTOR2I& u = pos( aU );
+        const VECTOR2I& w = pos( aW );
+        int             o = orient2d( u, w, aPos );
+
+        if( o != 0 )
+            return o > 0;
+
+        return ( lexLess( u, aPos ) && lexLess( aPos, w ) )
+               || ( lexLess( w, aPos ) && lexLess( aPos, u ) );
+    }
+
+    /**
+     * Walk from the last triangle created towards \a aPos.
+     *
+     * @return the triangle containing \a aPos, or the ghost triangle whose hull edge it lies
+     *         beyond, or -1 if the walk failed.
+     */
+    int locate( const VECTOR2I& aPos ) const
+    {
+        int t = m_hint;
+
+        if( t < 0 || !m_triangles[t].m_Alive )
+            return -1;
+
+        if( isGhost( t ) )
+            t = m_triangles[t].m_N[( ghostIndex( t ) + 1 ) % 3];
+
+        for( size_t steps = 0; steps <= m_triangles.size(); ++steps )
         {
-            return;
+            if( isGhost( t ) )
+                return t;
+
+            const TRIANGLE& tri = m_triangles[t];
+            int             next = -1;
+
+            for( int j = 0; j < 3 && next < 0; ++j )
+            {
+                int i = ( j + steps ) % 3;
+
+                if( orient2d( pos( tri.m_V[i] ), pos( tri.m_V[( i + 1 ) % 3] ), aPos ) < 0 )
+                    next = tri.m_N[i];
+            }
+
+            if( next < 0 )
+                return t;
+
+            t = next;
         }
-        else if( areNodesColinear( anchors ) )
+
+        return -1;
+    }
+
+    bool insert( int aVertex )
+    {
+        const VECTOR2I& p = pos( aVertex );
+        int             start = locate( p );
+
+        if( start < 0 || !conflicts( start, p ) )
+            return false;
+
+        // Cavities are small, so linear searches beat hashing.  The scratch vectors are members
+        // to save allocating them for each insertion.
+        std::vector<int>&      cavity = m_cavity;
+        std::vector<BOUNDARY>& boundary = m_boundary;
+        std::vector<int>&      created = m_created;
+
+        cavity.assign( 1, start );
+        boundary.clear();
+        created.clear();
+
+        auto inCavity =
+                [&]( int aTri )
+                {
+                    return std::find( cavity.begin(), cavity.end(), aTri ) != cavity.end();
+                };
+
+        for( size_t ii = 0; ii < cavity.size(); ++ii )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for( size_t i = 0; i < anchors.size() - 1; i++ )
-                addEdge( anchors[i], anchors[i + 1] );
+            for( int n : m_triangles[cavity[ii]].m_N )
+            {
+                if( !inCavity( n ) && conflicts( n, p ) )
+                    cavity.push_back( n );
+            }
         }
-        else
+
+        for( int t : cavity )
+        {
+            const TRIANGLE& tri = m_triangles[t];
+
+            for( int i = 0; i < 3; ++i )
+            {
+                if( !inCavity( tri.m_N[i] ) )
+                    boundary.push_back( { tri.m_V[i], tri.m_V[( i + 1 ) % 3], tri.m_N[i] } );
+            }
+        }
+
+        for( int t : cavity )
+            killTriangle( t );
+
+        for( const BOUNDARY& edge : boundary )
+        {
+            created.push_back( createTriangle( edge.m_A, edge.m_B, aVertex ) );
+
+            if( !link( created.back(), 0, edge.m_Outer ) )
+                return false;
+        }
+
+        // The boundary is a cycle: link each new triangle to the one starting where it ends
+        for( size_t ii = 0; ii < created.size(); ++ii )
+        {
+            int  end = boundary[ii].m_B;
+            auto next = std::find_if( boundary.begin(), boundary.end(),
+                                      [&]( const BOUNDARY& aEdge )
+                                      {
+                                          return aEdge.m_A == end;
+                                      } );
+
+            if( next == boundary.end() || !link( created[ii], 1, created[next - boundary.begin()] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @return true if ( \a aA, \a aB, \a aC ) is a Delaunay triangle of the vertices of
+     *         \a aPolygon (and so can be clipped from it).
+     */
+    bool isDelaunayEar( int aA, int aB, int aC, const std::vector<int>& aPolygon ) const
+    {
+        if( aA != INFINITE && aB != INFINITE && aC != INFINITE )
         {
-            delaunator::Delaunator delaunator( node_pts );
-            auto& triangles = delaunator.triangles;
+            if( orient2d( pos( aA ), pos( aB ), pos( aC ) ) <= 0 )
+                return false;
 
-            for( size_t i = 0; i < triangles.size(); i += 3 )
+            for( int d : aPolygon )
             {
-                addEdge( anchors[triangles[i]],     anchors[triangles[i + 1]] );
-                addEdge( anchors[triangles[i + 1]], anchors[triangles[i + 2]] );
-                addEdge( anchors[triangles[i + 2]], anchors[triangles[i]]     );
+                if( d != aA && d != aB && d != aC && d != INFINITE
+                        && inCircle( pos( aA ), pos( aB ), pos( aC ), pos( d ) ) > 0 )
+                {
+                    return false;
+                }
             }
 
-            for( size_t i = 0; i < delaunator.halfedges.size(); i++ )
+            return true;
+        }
+
+        // Ghost triangle: rotate to ( u, w, INFINITE )
+        int u = aB == INFINITE ? aC : aC == INFINITE ? aA : aB;
+        int w = aB == INFINITE ? aA : aC == INFINITE ? aB : aC;
+
+        for( int d : aPolygon )
+        {
+            if( d != u && d != w && d != INFINITE && ghostConflicts( u, w, pos( d ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool remove( int aVertex )
+    {
+        int start = m_vertices[aVertex].m_Triangle;
+
+        if( start < 0 || !m_triangles[start].m_Alive )
+            return false;
+
+        // Gather the star of the vertex, in positive order
+        std::vector<int> star;
+        std::vector<int> polygon;
+        std::vector<int> outer;
+        int              t = start;
+
+        do
+        {
+            const TRIANGLE& tri = m_triangles[t];
+            int             i = std::find( tri.m_V, tri.m_V + 3, aVertex ) - tri.m_V;
+
+            if( i == 3 || star.size() > m_triangles.size() )
+                return false;
+
+            star.push_back( t );
+            polygon.push_back( tri.m_V[( i + 1 ) % 3] );
+            outer.push_back( tri.m_N[( i + 1 ) % 3] );
+            t = tri.m_N[( i + 2 ) % 3];
+        } while( t != start );
+
+        for( int s : star )
+            killTriangle( s );
+
+        // Clip Delaunay ears from the star polygon until a single triangle remains
+        while( polygon.size() > 3 )
+        {
+            size_t n = polygon.size();
+            bool   clipped = false;
+
+            for( size_t k = 0; k < n && !clipped; ++k )
             {
-                if( delaunator.halfedges[i] == delaunator::INVALID_INDEX )
+                int a = polygon[k];
+                int b = polygon[( k + 1 ) % n];
+                int c = polygon[( k + 2 ) % n];
+
+                if( !isDelaunayEar( a, b, c, polygon ) )
                     continue;
 
-                addEdge( anchors[triangles[i]], anchors[triangles[delaunator.halfedges[i]]] );
+                int ear = createTriangle( a, b, c );
+
+                if( !link( ear, 0, outer[k] ) || !link( ear, 1, outer[( k + 1 ) % n] ) )
+                    return false;
+
+                outer[k] = ear;
+                polygon.erase( polygon.begin() + ( k + 1 ) % n );
+                outer.erase( outer.begin() + ( k + 1 ) % n );
+                clipped = true;
             }
+
+            if( !clipped )
+                return false;
         }
 
-        for( size_t i = 0; i < anchorChains.size(); i++ )
+        if( !isDelaunayEar( polygon[0], polygon[1], polygon[2], polygon ) )
+            return false;
+
+        int last = createTriangle( polygon[0], polygon[1], polygon[2] );
+
+        return link( last, 0, outer[0] ) && link( last, 1, outer[1] ) && link( last, 2, outer[2] );
+    }
+
+    void reset()
+    {
+        m_triangles.clear();
+        m_freeTriangles.clear();
+        m_edges.clear();
+        m_realTriangles = 0;
+        m_hint = -1;
+        m_valid = false;
+    }
+
+    /**
+     * Triangulate m_positions from scratch.
+     *
+     * @return false on failure.  The positions are colinear if m_valid is false on success.
+     */
+    bool rebuild()
+    {
+        reset();
+
+        if( m_positions.size() < 3 )
+            return true;
+
+        int    a = m_positions[0].second;
+        int    b = m_positions[1].second;
+        size_t third = 2;
+        int    o = 0;
+
+        for( ; third < m_positions.size(); ++third )
         {
-            std::vector<std::shared_ptr<CN_ANCHOR>>& chain = anchorChains[i];
+            if( ( o = orient2d( pos( a ), pos( b ), pos( m_positions[third].second ) ) ) != 0 )
+                break;
+        }
 
-            if( chain.size() < 2 )
-                continue;
+        if( o == 0 )
+            return true;
 
-            std::sort( chain.begin(), chain.end(),
-                    [] ( const std::shared_ptr<CN_ANCHOR>& a, const std::shared_ptr<CN_ANCHOR>& b )
-                    {
-                        return a->GetCluster().get() < b->GetCluster().get();
-                    } );
+        int c = m_positions[third].second;
+
+        if( o < 0 )
+            std::swap( b, c );
+
+        // Collect the edges once at the end rather than tracking them through every insertion
+        m_trackEdges = false;
 
-            for( unsigned int j = 1; j < chain.size(); j++ )
+        int tris[4] = { createTriangle( a, b, c ), createTriangle( b, a, INFINITE ),
+                        createTriangle( c, b, INFINITE ), createTriangle( a, c, INFINITE ) };
+
+        for( int s : tris )
+        {
+            for( int i = 0; i < 3; ++i )
             {
-                const std::shared_ptr<CN_ANCHOR>& prevNode = chain[j - 1];
-                const std::shared_ptr<CN_ANCHOR>& curNode  = chain[j];
-                int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.emplace_back( prevNode, curNode, weight );
+                for( int t : tris )
+                {
+                    if( t != s && m_triangles[s].m_N[i] < 0 )
+                        link( s, i, t );
+                }
             }
         }
+
+        m_valid = true;
+
+        // Insert in vertical strips running alternately up and down (the positions are already
+        // sorted along x), so that each position is close to the last triangle created and
+        // the walks are short.
+        std::vector<int> order;
+        size_t           stripSize = std::max<size_t>( 16, std::sqrt( m_positions.size() ) * 2 );
+
+        for( size_t ii = 2; ii < m_positions.size(); ++ii )
+        {
+            if( ii != third )
+                order.push_back( m_positions[ii].second );
+        }
+
+        for( size_t start = 0; start < order.size(); start += stripSize )
+        {
+            bool up = ( start / stripSize ) % 2;
+
+            std::sort( order.begin() + start,
+                       order.begin() + std::min( start + stripSize, order.size() ),
+                       [&]( int aA, int aB )
+                       {
+                           return up ? pos( aB ).y < pos( aA ).y : pos( aA ).y < pos( aB ).y;
+                       } );
+        }
+
+        for( int v : order )
+        {
+            if( !insert( v ) )
+            {
+                m_trackEdges = true;
+                reset();
+                return false;
+            }
+        }
+
+        m_trackEdges = true;
+
+        std::vector<EDGE> edges;
+
+        for( const TRIANGLE& tri : m_triangles )
+        {
+            for( int i = 0; tri.m_Alive && i < 3; ++i )
+            {
+                int u = tri.m_V[i];
+                int w = tri.m_V[( i + 1 ) % 3];
+
+                if( u != INFINITE && w != INFINITE && u < w )
+                    edges.push_back( makeEdge( u, w ) );
+            }
+        }
+
+        std::sort( edges.begin(), edges.end() );
+        m_edges.insert( edges.begin(), edges.end() );
+
+        return true;
     }
+
+    bool                                  m_valid;    ///< False if the positions are colinear
+    int                                   m_hint;     ///< Starting point for walks
+    int                                   m_realTriangles;
+    bool                                  m_trackEdges; ///< Keep m_edges up to date
+
+    std::vector<VERTEX>                   m_vertices; ///< Vertex 0 is at infinity
+    std::vector<int>                      m_freeVertices;
+    std::vector<std::pair<VECTOR2I, int>> m_positions; ///< Live vertices, sorted by position
+    std::vector<TRIANGLE>                 m_triangles;
+    std::vector<int>                      m_freeTriangles;
+    std::set<EDGE>                        m_edges;
+
+    std::vector<int>                      m_cavity;
+    std::vector<BOUNDARY>                 m_boundary;
+    std::vector<int>                      m_created;
 };
 
 
+void RN_NET::kruskalMST( const std::vector<CN_EDGE> &aEdges )
+{
+    disjoint_set dset( m_nodes.size() );
+
+    m_rnEdges.clear();
+
+    int i = 0;
+
+    for( const std::shared_ptr<CN_ANCHOR>& node : m_nodes )
+        node->SetTag( i++ );
+
+    size_t united = 0;
+
+    // Merge the (sorted) edges with the triangulation edges, which are kept sorted.  Stop as
+    // soon as the tree spans all the nodes.
+    const std::set<TRIANGULATOR_STATE::EDGE>& triangEdges = m_triangulator->GetEdges();
+
+    auto edgeIt = aEdges.begin();
+    auto triangIt = triangEdges.begin();
+
+    while( united + 1 < m_nodes.size() )
+    {
+        if( edgeIt != aEdges.end()
+                && ( triangIt == triangEdges.end() || edgeIt->GetWeight() <= triangIt->m_Weight ) )
+        {
+            const CN_EDGE&                          tmp = *edgeIt++;
+            const std::shared_ptr<const CN_ANCHOR>& source = tmp.GetSourceNode();
+            const std::shared_ptr<const CN_ANCHOR>& target = tmp.GetTargetNode();
+
+            if( dset.unite( source->GetTag(), target->GetTag() ) )
+            {
+                if( tmp.GetWeight() > 0 )
+                    m_rnEdges.push_back( tmp );
+
+                united++;
+            }
+        }
+        else if( triangIt != triangEdges.end() )
+        {
+            // Most triangulation edges are rejected, so only make CN_EDGEs of those which
+            // aren't.
+            const TRIANGULATOR_STATE::EDGE&   tmp = *triangIt++;
+            const std::shared_ptr<CN_ANCHOR>& source = m_triangulator->GetAnchor( tmp.m_A );
+            const std::shared_ptr<CN_ANCHOR>& target = m_triangulator->GetAnchor( tmp.m_B );
+
+            if( dset.unite( source->GetTag(), target->GetTag() ) )
+            {
+                m_rnEdges.emplace_back( source, target, tmp.m_Weight );
+                united++;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
 RN_NET::RN_NET() : m_dirty( true )
 {
     m_triangulator.reset( new TRIANGULATOR_STATE );
@@ -295,33 +1151,27 @@ void RN_NET::compute()
         return;
     }
 
-
-    m_triangulator->Clear();
-
-    for( const std::shared_ptr<CN_ANCHOR>& n : m_nodes )
-        m_triangulator->AddNode( n );
-
-    std::vector<CN_EDGE> triangEdges;
-    triangEdges.reserve( m_nodes.size() + m_boardEdges.size() );
+    std::vector<CN_EDGE> edges;
+    edges.reserve( m_boardEdges.size() );
 
 #ifdef PROFILE
     PROF_TIMER cnt( "triangulate" );
 #endif
-    m_triangulator->Triangulate( triangEdges );
+    m_triangulator->Update( m_nodes, edges );
 #ifdef PROFILE
     cnt.Show();
 #endif
 
     for( const CN_EDGE& e : m_boardEdges )
-        triangEdges.emplace_back( e );
+        edges.emplace_back( e );
 
-    std::sort( triangEdges.begin(), triangEdges.end() );
+    std::sort( edges.begin(), edges.end() );
 
 // Get the minimal spanning tree
 #ifdef PROFILE
     PROF_TIMER cnt2( "mst" );
 #endif
-    kruskalMST( triangEdges );
+    kruskalMST( edges );
 #ifdef PROFILE
     cnt2.Show();
 #endif
@@ -88,10 +88,11 @@ public:
     bool NearestBicoloredPair( RN_NET* aOtherNet, VECTOR2I& aPos1, VECTOR2I& aPos2 ) const;
 
 protected:
-    ///< Recompute ratsnest from scratch.
+    ///< Recompute ratsnest.  The triangulation of the nodes is updated incrementally.
     void compute();
 
-    ///< Compute the minimum spanning tree using Kruskal's algorithm
+    ///< Compute the minimum spanning tree using Kruskal's algorithm over the sorted edges
+    ///< \a aEdges and the (already sorted) edges of the triangulation.
     void kruskalMST( const std::vector<CN_EDGE> &aEdges );
 
     ///< Find optimal ends of RNEdges.  The MST will have found the closest anchors, but when
@@ -113,6 +114,7 @@ protected:
 
     class TRIANGULATOR_STATE;
 
+    ///< Triangulation of the nodes, kept between updates
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
 };
 
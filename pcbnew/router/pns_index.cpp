@@ -22,10 +22,53 @@
 #include "pns_index.h"
 #include "pns_router.h"
 
+#include <core/kicad_algo.h>
+
 namespace PNS {
 
 
-void INDEX::Add( ITEM* aItem )
+INDEX::INDEX() :
+        m_items( std::make_shared<ITEMS>() ),
+        m_hasSubIndices( false )
+{
+}
+
+
+INDEX::INDEX( const INDEX& aOther ) :
+        m_items( aOther.m_items ),
+        m_hasSubIndices( false )
+{
+    if( m_items->m_items.size() > SUBINDEX_THRESHOLD )
+        buildSubIndices();
+}
+
+
+INDEX& INDEX::operator=( const INDEX& aOther )
+{
+    if( this == &aOther )
+        return *this;
+
+    m_items = aOther.m_items;
+    m_subIndices.clear();
+    m_hasSubIndices = false;
+
+    if( m_items->m_items.size() > SUBINDEX_THRESHOLD )
+        buildSubIndices();
+
+    return *this;
+}
+
+
+INDEX::ITEMS& INDEX::mutableItems()
+{
+    if( m_items.use_count() > 1 )
+        m_items = std::make_shared<ITEMS>( *m_items );
+
+    return *m_items;
+}
+
+
+void INDEX::addToSubIndices( ITEM* aItem )
 {
     const LAYER_RANGE& range = aItem->Layers();
 
@@ -34,30 +77,82 @@ void INDEX::Add( ITEM* aItem )
 
     for( int i = range.Start(); i <= range.End(); ++i )
         m_subIndices[i].Add( aItem );
+}
+
+
+void INDEX::buildSubIndices()
+{
+    m_subIndices.clear();
+
+    for( ITEM* item : m_items->m_items )
+        addToSubIndices( item );
+
+    m_hasSubIndices = true;
+}
+
+
+void INDEX::Add( ITEM* aItem )
+{
+    ITEMS& items = mutableItems();
+
+    if( !items.m_positions.emplace( aItem, items.m_items.size() ).second )
+        return;
+
+    const LAYER_RANGE& range = aItem->Layers();
+    BOX2I              bbox = boundingBox( aItem );
+
+    items.m_items.push_back( aItem );
+    items.m_entries.push_back( { bbox.GetX(), bbox.GetY(), bbox.GetRight(), bbox.GetBottom(),
+                                 range.Start(), range.End() } );
 
-    m_allItems.insert( aItem );
     int net = aItem->Net();
 
     if( net >= 0 )
-        m_netMap[net].push_back( aItem );
+        items.m_netMap[net].push_back( aItem );
+
+    if( m_hasSubIndices )
+        addToSubIndices( aItem );
+    else if( items.m_items.size() > SUBINDEX_THRESHOLD )
+        buildSubIndices();
 }
 
 
 void INDEX::Remove( ITEM* aItem )
 {
-    const LAYER_RANGE& range = aItem->Layers();
-
-    if( m_subIndices.size() <= static_cast<size_t>( range.End() ) )
+    if( !Contains( aItem ) )
         return;
 
-    for( int i = range.Start(); i <= range.End(); ++i )
-        m_subIndices[i].Remove( aItem );
+    ITEMS& items = mutableItems();
 
-    m_allItems.erase( aItem );
-    int net = aItem->Net();
+    auto   it = items.m_positions.find( aItem );
+    size_t pos = it->second;
+    size_t last = items.m_items.size() - 1;
 
-    if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
+    // Fill the hole with the last item
+    if( pos != last )
+    {
+        items.m_items[pos] = items.m_items[last];
+        items.m_entries[pos] = items.m_entries[last];
+        items.m_positions[ items.m_items[pos] ] = pos;
+    }
+
+    items.m_items.pop_back();
+    items.m_entries.pop_back();
+    items.m_positions.erase( it );
+
+    int  net = aItem->Net();
+    auto netIt = items.m_netMap.find( net );
+
+    if( net >= 0 && netIt != items.m_netMap.end() )
+        alg::delete_matching( netIt->second, aItem );
+
+    if( m_hasSubIndices )
+    {
+        const LAYER_RANGE& range = aItem->Layers();
+
+        for( int i = range.Start(); i <= range.End() && i < (int) m_subIndices.size(); ++i )
+            m_subIndices[i].Remove( aItem );
+    }
 }
 
 
@@ -68,12 +163,14 @@ void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
 }
 
 
-INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
+const INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet ) const
 {
-    if( m_netMap.find( aNet ) == m_netMap.end() )
+    auto it = m_items->m_netMap.find( aNet );
+
+    if( it == m_items->m_netMap.end() )
         return nullptr;
 
-    return &m_netMap[aNet];
+    return &it->second;
 }
 
 };
@@ -22,10 +22,12 @@
 #ifndef __PNS_INDEX_H
 #define __PNS_INDEX_H
 
+#include <climits>
 #include <deque>
-#include <list>
 #include <map>
-#include <unordered_set>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <layer_ids.h>
 #include <geometry/shape_index.h>
@@ -38,18 +40,32 @@ namespace PNS {
 /**
  * INDEX
  *
- * Custom spatial index, holding our board items and allowing for very fast searches. Items
- * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
- * overlap and improving search time.
+ * Custom spatial index, holding our board items and allowing for very fast searches.
+ *
+ * Items are kept in a flat array along with their bounding boxes and layers.  The array is
+ * shared between copies of an index until one of them is modified, so that branching a NODE
+ * doesn't need to copy the items of its parent.  Small indices (like the ones of the branches
+ * made while shoving) are searched by scanning the array; larger ones also assign the items to
+ * separate R-Tree subindices depending on their type and spanned layers, reducing overlap and
+ * improving search time.
+ *
+ * Queries don't modify the index, so they can run from several threads at once.
  **/
 class INDEX
 {
 public:
-    typedef std::list<ITEM*>            NET_ITEMS_LIST;
+    typedef std::vector<ITEM*>          NET_ITEMS_LIST;
     typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
-    typedef std::unordered_set<ITEM*>   ITEM_SET;
+    typedef std::vector<ITEM*>          ITEM_LIST;
+
+    INDEX();
+
+    /**
+     * Make a copy of \a aOther which shares its items until either of them is modified.
+     */
+    INDEX( const INDEX& aOther );
 
-    INDEX(){};
+    INDEX& operator=( const INDEX& aOther );
 
     /**
      * Adds item to the spatial index.
@@ -97,7 +113,7 @@ public:
     /**
      * Returns list of all items in a given net.
      */
-    NET_ITEMS_LIST* GetItemsForNet( int aNet );
+    const NET_ITEMS_LIST* GetItemsForNet( int aNet ) const;
 
     /**
      * Function Contains()
@@ -106,28 +122,109 @@ public:
      */
     bool Contains( ITEM* aItem ) const
     {
-        return m_allItems.find( aItem ) != m_allItems.end();
+        return m_items->m_positions.find( aItem ) != m_items->m_positions.end();
     }
 
     /**
      * Returns number of items stored in the index.
      */
-    int Size() const { return m_allItems.size(); }
+    int Size() const { return m_items->m_items.size(); }
 
-    ITEM_SET::iterator begin() { return m_allItems.begin(); }
-    ITEM_SET::iterator end() { return m_allItems.end(); }
+    /**
+     * Returns true if the index is searched through its R-Tree subindices rather than by
+     * scanning all its items.
+     */
+    bool HasSubIndices() const { return m_hasSubIndices; }
+
+    ITEM_LIST::const_iterator begin() const { return m_items->m_items.begin(); }
+    ITEM_LIST::const_iterator end() const { return m_items->m_items.end(); }
+
+    /// Number of items above which the R-Tree subindices are built
+    static constexpr size_t SUBINDEX_THRESHOLD = 128;
 
 private:
+    /// The bounding box and layers of an item, as needed by a search
+    struct ENTRY
+    {
+        int m_minX;
+        int m_minY;
+        int m_maxX;
+        int m_maxY;
+        int m_layerStart;
+        int m_layerEnd;
+    };
+
+    /// The items of the index, shared by copies of the index until they are modified
+    struct ITEMS
+    {
+        ITEM_LIST                               m_items;
+        std::vector<ENTRY>                      m_entries;    ///< Same order as m_items
+        std::unordered_map<const ITEM*, size_t> m_positions;  ///< Position in m_items
+        std::map<int, NET_ITEMS_LIST>           m_netMap;
+    };
+
+    /**
+     * Return the items, first making a private copy if they are shared with another index.
+     */
+    ITEMS& mutableItems();
+
+    void addToSubIndices( ITEM* aItem );
+
+    void buildSubIndices();
+
+    template <class Visitor>
+    int queryItems( const SHAPE* aShape, int aLayerStart, int aLayerEnd, int aMinDistance,
+                    Visitor& aVisitor ) const;
+
     template <class Visitor>
     int querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
 private:
+    std::shared_ptr<ITEMS>        m_items;
     std::deque<ITEM_SHAPE_INDEX>  m_subIndices;
-    std::map<int, NET_ITEMS_LIST> m_netMap;
-    ITEM_SET                      m_allItems;
+    bool                          m_hasSubIndices;
 };
 
 
+template <class Visitor>
+int INDEX::queryItems( const SHAPE* aShape, int aLayerStart, int aLayerEnd, int aMinDistance,
+                       Visitor& aVisitor ) const
+{
+    BOX2I box = aShape->BBox();
+    box.Inflate( aMinDistance );
+
+    const int minX = box.GetX();
+    const int minY = box.GetY();
+    const int maxX = box.GetRight();
+    const int maxY = box.GetBottom();
+
+    const ITEM_LIST&          items = m_items->m_items;
+    const std::vector<ENTRY>& entries = m_items->m_entries;
+    int                       total = 0;
+
+    for( size_t ii = 0; ii < entries.size(); ++ii )
+    {
+        const ENTRY& entry = entries[ii];
+
+        if( entry.m_layerEnd < aLayerStart || entry.m_layerStart > aLayerEnd )
+            continue;
+
+        if( entry.m_maxX < minX || entry.m_minX > maxX || entry.m_maxY < minY
+                || entry.m_minY > maxY )
+        {
+            continue;
+        }
+
+        if( !aVisitor( items[ii] ) )
+            break;
+
+        total++;
+    }
+
+    return total;
+}
+
+
 template<class Visitor>
 int INDEX::querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
 {
@@ -140,10 +237,13 @@ int INDEX::querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistanc
 template<class Visitor>
 int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor ) const
 {
-    int total = 0;
-
     const LAYER_RANGE& layers = aItem->Layers();
 
+    if( !m_hasSubIndices )
+        return queryItems( aItem->Shape(), layers.Start(), layers.End(), aMinDistance, aVisitor );
+
+    int total = 0;
+
     for( int i = layers.Start(); i <= layers.End(); ++i )
         total += querySingle( i, aItem->Shape(), aMinDistance, aVisitor );
 
@@ -153,6 +253,9 @@ int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor ) const
 template<class Visitor>
 int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
 {
+    if( !m_hasSubIndices )
+        return queryItems( aShape, INT_MIN, INT_MAX, aMinDistance, aVisitor );
+
     int total = 0;
 
     for( std::size_t i = 0; i < m_subIndices.size(); ++i )
@@ -101,13 +101,13 @@ bool ITEM::collideSimple( const ITEM* aOther, const NODE* aNode, bool aDifferent
 
         if( holeClearance >= 0 && holeA && holeA->Collide( shapeB, holeClearance + lineWidthB ) )
         {
-            Mark( Marker() | MK_HOLE );
+            addMarker( MK_HOLE );
             return true;
         }
 
         if( holeB && holeClearance >= 0 && holeB->Collide( shapeA, holeClearance + lineWidthA ) )
         {
-            aOther->Mark( aOther->Marker() | MK_HOLE );
+            aOther->addMarker( MK_HOLE );
             return true;
         }
 
@@ -117,8 +117,8 @@ bool ITEM::collideSimple( const ITEM* aOther, const NODE* aNode, bool aDifferent
 
             if( holeToHoleClearance >= 0 && holeA->Collide( holeB, holeToHoleClearance ) )
             {
-                Mark( Marker() | MK_HOLE );
-                aOther->Mark( aOther->Marker() | MK_HOLE );
+                addMarker( MK_HOLE );
+                aOther->addMarker( MK_HOLE );
                 return true;
             }
         }
@@ -23,6 +23,7 @@
 #ifndef __PNS_ITEM_H
 #define __PNS_ITEM_H
 
+#include <atomic>
 #include <memory>
 #include <math/vector2d.h>
 
@@ -93,7 +94,7 @@ public:
         m_kind = aOther.m_kind;
         m_parent = aOther.m_parent;
         m_owner = aOther.m_owner; // fixme: wtf this was null?
-        m_marker = aOther.m_marker;
+        m_marker = aOther.m_marker.load();
         m_rank = aOther.m_rank;
         m_routable = aOther.m_routable;
         m_isVirtual = aOther.m_isVirtual;
@@ -101,6 +102,24 @@ public:
         m_isCompoundShapePrimitive = aOther.m_isCompoundShapePrimitive;
     }
 
+    ITEM& operator=( const ITEM& aOther )
+    {
+        m_layers = aOther.m_layers;
+        m_net = aOther.m_net;
+        m_movable = aOther.m_movable;
+        m_kind = aOther.m_kind;
+        m_parent = aOther.m_parent;
+        m_owner = aOther.m_owner;
+        m_marker = aOther.m_marker.load();
+        m_rank = aOther.m_rank;
+        m_routable = aOther.m_routable;
+        m_isVirtual = aOther.m_isVirtual;
+        m_isFreePad = aOther.m_isFreePad;
+        m_isCompoundShapePrimitive = aOther.m_isCompoundShapePrimitive;
+
+        return *this;
+    }
+
     virtual ~ITEM();
 
     /**
@@ -250,6 +269,10 @@ public:
 private:
     bool collideSimple( const ITEM* aOther, const NODE* aNode, bool aDifferentNetsOnly, int aOverrideClearance ) const;
 
+    /// Set \a aMarker bits in one atomic step, as the walkaround threads may collide
+    /// against the same item.
+    void addMarker( int aMarker ) const { m_marker.fetch_or( aMarker ); }
+
 protected:
     PnsKind       m_kind;
 
@@ -259,7 +282,7 @@ protected:
 
     bool          m_movable;
     int           m_net;
-    mutable int   m_marker;
+    mutable std::atomic<int> m_marker;  ///< atomic: collision queries may run on several threads
     int           m_rank;
     bool          m_routable;
     bool          m_isVirtual;
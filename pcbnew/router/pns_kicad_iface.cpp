@@ -51,7 +51,11 @@
 
 #include <wx/log.h>
 
+#include <map>
 #include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
 
 #include <advanced_config.h>
 #include <pcbnew_settings.h>
@@ -131,8 +135,30 @@ public:
     void ClearCaches() override;
 
 private:
+    /**
+     * Board items standing in for the router items which have no parent yet, when evaluating
+     * the DRC rules.  Each thread querying the resolver gets its own.
+     */
+    struct DUMMY_ITEMS
+    {
+        DUMMY_ITEMS( BOARD* aBoard ) :
+                m_tracks{ { aBoard }, { aBoard } },
+                m_arcs{ { aBoard }, { aBoard } },
+                m_vias{ { aBoard }, { aBoard } }
+        { }
+
+        PCB_TRACK m_tracks[2];
+        PCB_ARC   m_arcs[2];
+        PCB_VIA   m_vias[2];
+    };
+
+    DUMMY_ITEMS& dummyItems();
+
     int holeRadius( const PNS::ITEM* aItem ) const;
 
+    std::optional<int> findCached( const std::unordered_map<CLEARANCE_CACHE_KEY, int>& aCache,
+                                   const CLEARANCE_CACHE_KEY& aKey );
+
     /**
      * Checks for netnamed differential pairs.
      * This accepts nets named suffixed by 'P', 'N', '+', '-', as well as additional
@@ -147,24 +173,24 @@ private:
 private:
     PNS::ROUTER_IFACE* m_routerIface;
     BOARD*             m_board;
-    PCB_TRACK          m_dummyTracks[2];
-    PCB_ARC            m_dummyArcs[2];
-    PCB_VIA            m_dummyVias[2];
     int                m_clearanceEpsilon;
 
+    // The walkaround queries from several threads.  The caches are shared, and written to
+    // only on a miss; the dummy items are per thread.
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_clearanceCache;
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_holeClearanceCache;
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_holeToHoleClearanceCache;
+    std::shared_mutex                            m_cacheLock;
+
+    std::map<std::thread::id, std::unique_ptr<DUMMY_ITEMS>> m_dummyItems;
+    std::shared_mutex                                       m_dummyItemsLock;
 };
 
 
 PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
                                                     PNS::ROUTER_IFACE* aRouterIface ) :
     m_routerIface( aRouterIface ),
-    m_board( aBoard ),
-    m_dummyTracks{ { aBoard }, { aBoard } },
-    m_dummyArcs{ { aBoard }, { aBoard } },
-    m_dummyVias{ { aBoard }, { aBoard } }
+    m_board( aBoard )
 {
     if( aBoard )
         m_clearanceEpsilon = aBoard->GetDesignSettings().GetDRCEpsilon();
@@ -178,6 +204,44 @@ PNS_PCBNEW_RULE_RESOLVER::~PNS_PCBNEW_RULE_RESOLVER()
 }
 
 
+PNS_PCBNEW_RULE_RESOLVER::DUMMY_ITEMS& PNS_PCBNEW_RULE_RESOLVER::dummyItems()
+{
+    std::thread::id threadId = std::this_thread::get_id();
+
+    {
+        std::shared_lock<std::shared_mutex> readLock( m_dummyItemsLock );
+
+        auto it = m_dummyItems.find( threadId );
+
+        if( it != m_dummyItems.end() )
+            return *it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock( m_dummyItemsLock );
+    std::unique_ptr<DUMMY_ITEMS>&       items = m_dummyItems[ threadId ];
+
+    if( !items )
+        items = std::make_unique<DUMMY_ITEMS>( m_board );
+
+    return *items;
+}
+
+
+std::optional<int>
+PNS_PCBNEW_RULE_RESOLVER::findCached( const std::unordered_map<CLEARANCE_CACHE_KEY, int>& aCache,
+                                      const CLEARANCE_CACHE_KEY& aKey )
+{
+    std::shared_lock<std::shared_mutex> readLock( m_cacheLock );
+
+    auto it = aCache.find( aKey );
+
+    if( it == aCache.end() )
+        return std::nullopt;
+
+    return it->second;
+}
+
+
 int PNS_PCBNEW_RULE_RESOLVER::holeRadius( const PNS::ITEM* aItem ) const
 {
     if( aItem->Kind() == PNS::ITEM::SOLID_T )
@@ -308,6 +372,7 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
     default:                                      return false; // should not happen
     }
 
+    DUMMY_ITEMS&   dummies = dummyItems();
     BOARD_ITEM*    parentA = aItemA ? aItemA->Parent() : nullptr;
     BOARD_ITEM*    parentB = aItemB ? aItemB->Parent() : nullptr;
     DRC_CONSTRAINT hostConstraint;
@@ -317,10 +382,10 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
     {
         switch( aItemA->Kind() )
         {
-        case PNS::ITEM::ARC_T:     parentA = &m_dummyArcs[0];   break;
-        case PNS::ITEM::VIA_T:     parentA = &m_dummyVias[0];   break;
-        case PNS::ITEM::SEGMENT_T: parentA = &m_dummyTracks[0]; break;
-        case PNS::ITEM::LINE_T:    parentA = &m_dummyTracks[0]; break;
+        case PNS::ITEM::ARC_T:     parentA = &dummies.m_arcs[0];   break;
+        case PNS::ITEM::VIA_T:     parentA = &dummies.m_vias[0];   break;
+        case PNS::ITEM::SEGMENT_T: parentA = &dummies.m_tracks[0]; break;
+        case PNS::ITEM::LINE_T:    parentA = &dummies.m_tracks[0]; break;
         default: break;
         }
 
@@ -335,10 +400,10 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
     {
         switch( aItemB->Kind() )
         {
-        case PNS::ITEM::ARC_T:     parentB = &m_dummyArcs[1];   break;
-        case PNS::ITEM::VIA_T:     parentB = &m_dummyVias[1];   break;
-        case PNS::ITEM::SEGMENT_T: parentB = &m_dummyTracks[1]; break;
-        case PNS::ITEM::LINE_T:    parentB = &m_dummyTracks[1]; break;
+        case PNS::ITEM::ARC_T:     parentB = &dummies.m_arcs[1];   break;
+        case PNS::ITEM::VIA_T:     parentB = &dummies.m_vias[1];   break;
+        case PNS::ITEM::SEGMENT_T: parentB = &dummies.m_tracks[1]; break;
+        case PNS::ITEM::LINE_T:    parentB = &dummies.m_tracks[1]; break;
         default: break;
         }
 
@@ -386,6 +451,8 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
 
 void PNS_PCBNEW_RULE_RESOLVER::ClearCacheForItem( const PNS::ITEM* aItem )
 {
+    std::unique_lock<std::shared_mutex> writeLock( m_cacheLock );
+
     CLEARANCE_CACHE_KEY key = { aItem, nullptr, false };
     m_clearanceCache.erase( key );
 
@@ -396,6 +463,8 @@ void PNS_PCBNEW_RULE_RESOLVER::ClearCacheForItem( const PNS::ITEM* aItem )
 
 void PNS_PCBNEW_RULE_RESOLVER::ClearCaches()
 {
+    std::unique_lock<std::shared_mutex> writeLock( m_cacheLock );
+
     m_clearanceCache.clear();
     m_holeClearanceCache.clear();
     m_holeToHoleClearanceCache.clear();
@@ -406,10 +475,9 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
                                          bool aUseClearanceEpsilon )
 {
     CLEARANCE_CACHE_KEY key = { aA, aB, aUseClearanceEpsilon };
-    auto it = m_clearanceCache.find( key );
 
-    if( it != m_clearanceCache.end() )
-        return it->second;
+    if( std::optional<int> cached = findCached( m_clearanceCache, key ) )
+        return *cached;
 
     PNS::CONSTRAINT constraint;
     int             rv = 0;
@@ -451,6 +519,7 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
     if( aUseClearanceEpsilon && rv > 0 )
         rv = std::max( 0, rv - m_clearanceEpsilon );
 
+    std::unique_lock<std::shared_mutex> writeLock( m_cacheLock );
     m_clearanceCache[ key ] = rv;
     return rv;
 }
@@ -460,10 +529,9 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITE
                                              bool aUseClearanceEpsilon )
 {
     CLEARANCE_CACHE_KEY key = { aA, aB, aUseClearanceEpsilon };
-    auto it = m_holeClearanceCache.find( key );
 
-    if( it != m_holeClearanceCache.end() )
-        return it->second;
+    if( std::optional<int> cached = findCached( m_holeClearanceCache, key ) )
+        return *cached;
 
     PNS::CONSTRAINT constraint;
     int rv = 0;
@@ -490,6 +558,7 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITE
     if( aUseClearanceEpsilon && rv > 0 )
         rv = std::max( 0, rv - m_clearanceEpsilon );
 
+    std::unique_lock<std::shared_mutex> writeLock( m_cacheLock );
     m_holeClearanceCache[ key ] = rv;
     return rv;
 }
@@ -499,10 +568,9 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PN
                                                    bool aUseClearanceEpsilon )
 {
     CLEARANCE_CACHE_KEY key = { aA, aB, aUseClearanceEpsilon };
-    auto it = m_holeToHoleClearanceCache.find( key );
 
-    if( it != m_holeToHoleClearanceCache.end() )
-        return it->second;
+    if( std::optional<int> cached = findCached( m_holeToHoleClearanceCache, key ) )
+        return *cached;
 
     PNS::CONSTRAINT constraint;
     int rv = 0;
@@ -519,6 +587,7 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PN
     if( aUseClearanceEpsilon && rv > 0 )
         rv = std::max( 0, rv - m_clearanceEpsilon );
 
+    std::unique_lock<std::shared_mutex> writeLock( m_cacheLock );
     m_holeToHoleClearanceCache[ key ] = rv;
     return rv;
 }
@@ -44,7 +44,7 @@ LINE::LINE( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_blockingObstacle = aOther.m_blockingObstacle;
 
@@ -66,7 +66,7 @@ LINE& LINE::operator=( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_owner = aOther.m_owner;
     m_snapThreshhold = aOther.m_snapThreshhold;
@@ -125,7 +125,7 @@ SEGMENT* SEGMENT::Clone() const
     s->m_seg = m_seg;
     s->m_net = m_net;
     s->m_layers = m_layers;
-    s->m_marker = m_marker;
+    s->m_marker = m_marker.load();
     s->m_rank = m_rank;
 
     return s;
@@ -140,6 +140,9 @@ NODE* NODE::Branch()
 {
     NODE* child = new NODE;
 
+    if( ROUTER* router = ROUTER::GetInstance() )
+        router->Counters().m_NodeBranches++;
+
     m_children.insert( child );
 
     child->m_depth = m_depth + 1;
@@ -150,13 +153,11 @@ NODE* NODE::Branch()
     child->m_collisionQueryScope = m_collisionQueryScope;
 
     // Immediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // joints and overridden item maps.  The index shares the stored items with ours until
+    // either branch changes them.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( ITEM* item : *m_index )
-            child->m_index->Add( item );
+        *child->m_index = *m_index;
 
         child->m_joints = m_joints;
         child->m_override = m_override;
@@ -256,6 +257,7 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
         obs.m_item = aCandidate;
         obs.m_head = m_item;
         obs.m_distFirst = INT_MAX;
+        obs.m_isHole = false;
         m_tab.push_back( obs );
 
         m_matchCount++;
@@ -324,6 +326,7 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine, int aKindMask,
     OBSTACLE nearest;
     nearest.m_item = nullptr;
     nearest.m_distFirst = INT_MAX;
+    nearest.m_isHole = false;
 
     auto updateNearest =
             [&]( const SHAPE_LINE_CHAIN::INTERSECTION& pt, ITEM* obstacle,
@@ -337,9 +340,7 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine, int aKindMask,
                     nearest.m_ipFirst = pt.p;
                     nearest.m_item = obstacle;
                     nearest.m_hull = hull;
-
-                    obstacle->Mark( isHole ? obstacle->Marker() | MK_HOLE
-                                           : obstacle->Marker() & ~MK_HOLE );
+                    nearest.m_isHole = isHole;
                 }
             };
 
@@ -1403,8 +1404,8 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     for( ITEM* item : m_override )
         aRemoved.push_back( item );
 
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-        aAdded.push_back( *i );
+    for( ITEM* item : *m_index )
+        aAdded.push_back( item );
 }
 
 
@@ -1464,7 +1465,7 @@ void NODE::KillChildren()
 
 void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems, int aKindMask )
 {
-    INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aNet );
+    const INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aNet );
 
     if( l_cur )
     {
@@ -1477,7 +1478,7 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems, int aKindMask )
 
     if( !isRoot() )
     {
-        INDEX::NET_ITEMS_LIST* l_root = m_root->m_index->GetItemsForNet( aNet );
+        const INDEX::NET_ITEMS_LIST* l_root = m_root->m_index->GetItemsForNet( aNet );
 
         if( l_root )
         {
@@ -1630,7 +1631,7 @@ ITEM *NODE::FindItemByParent( const BOARD_ITEM* aParent )
     {
         const BOARD_CONNECTED_ITEM* cItem = static_cast<const BOARD_CONNECTED_ITEM*>( aParent );
 
-        INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( cItem->GetNetCode() );
+        const INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( cItem->GetNetCode() );
 
         if( l_cur )
         {
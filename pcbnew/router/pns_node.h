@@ -118,6 +118,7 @@ struct OBSTACLE
     VECTOR2I         m_ipFirst;        ///< First intersection between m_head and m_hull
     int              m_distFirst;      ///< ... and the distance thereof
     int              m_maxFanoutWidth; ///< worst case (largest) width of the tracks connected to the item
+    bool             m_isHole;         ///< m_hull is the hull of the hole of m_item
 };
 
 class OBSTACLE_VISITOR
@@ -40,6 +40,13 @@
 namespace PNS {
 
 
+static void countOptimizerStep()
+{
+    if( ROUTER* router = ROUTER::GetInstance() )
+        router->Counters().m_OptimizerSteps++;
+}
+
+
 int COST_ESTIMATOR::CornerCost( const SEG& aA, const SEG& aB )
 {
     DIRECTION_45 dir_a( aA ), dir_b( aB );
@@ -470,6 +477,8 @@ bool OPTIMIZER::mergeObtuse( LINE* aLine )
     while( 1 )
     {
         iter++;
+        countOptimizerStep();
+
         int n_segs = current_path.SegmentCount();
         int max_step = n_segs - 2;
 
@@ -688,6 +697,8 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult, LINE* aRoot )
 
 bool OPTIMIZER::mergeStep( LINE* aLine, SHAPE_LINE_CHAIN& aCurrentPath, int step )
 {
+    countOptimizerStep();
+
     int n_segs = aCurrentPath.SegmentCount();
 
     int cost_orig = COST_ESTIMATOR::CornerCost( aCurrentPath );
@@ -1268,6 +1279,8 @@ bool checkDpColliding( NODE* aNode, DIFF_PAIR* aPair, bool aIsP, const SHAPE_LIN
 
 bool OPTIMIZER::mergeDpStep( DIFF_PAIR* aPair, bool aTryP, int step )
 {
+    countOptimizerStep();
+
     int n = 1;
 
     SHAPE_LINE_CHAIN currentPath = aTryP ? aPair->CP() : aPair->CN();
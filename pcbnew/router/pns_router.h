@@ -26,6 +26,7 @@
 #include <memory>
 #include <optional>
 #include <math/box2.h>
+#include <profile.h>
 
 #include "pns_routing_settings.h"
 #include "pns_sizes_settings.h"
@@ -123,6 +124,15 @@ public:
         ROUTE_TRACK
     };
 
+    /**
+     * Counts of the work done by the router, for benchmarking.  The router never resets them.
+     */
+    struct COUNTERS
+    {
+        PROF_COUNTER m_NodeBranches;     ///< NODE::Branch() calls
+        PROF_COUNTER m_OptimizerSteps;   ///< merge steps tried by the OPTIMIZER
+    };
+
 public:
     ROUTER();
     ~ROUTER();
@@ -213,6 +223,8 @@ public:
     void SetVisibleViewArea( const BOX2I& aExtents ) { m_visibleViewArea = aExtents; }
     const BOX2I& VisibleViewArea() const { return m_visibleViewArea; }
 
+    COUNTERS& Counters() { return m_counters; }
+
 private:
     bool movePlacing( const VECTOR2I& aP, ITEM* aItem );
     bool moveDragging( const VECTOR2I& aP, ITEM* aItem );
@@ -250,6 +262,8 @@ private:
 
     wxString          m_toolStatusbarName;
     wxString          m_failureReason;
+
+    COUNTERS          m_counters;
 };
 
 }
@@ -154,6 +154,10 @@ public:
 
     double WalkaroundHugLengthThreshold() const { return m_walkaroundHugLengthThreshold; }
 
+    ///< Walk around obstacles in both directions at once, on separate threads.
+    bool GetParallelWalkaround() const { return m_parallelWalkaround; }
+    void SetParallelWalkaround( bool aEnable ) { m_parallelWalkaround = aEnable; }
+
     int ViaForcePropIterationLimit() const { return m_viaForcePropIterationLimit; }
     void SetViaForcePropIterationLimit(int aLimit) { m_viaForcePropIterationLimit = aLimit; }
 
@@ -173,6 +177,7 @@ private:
     bool m_optimizeEntireDraggedTrack;
     bool m_autoPosture;
     bool m_fixAllSegments;
+    bool m_parallelWalkaround;
 
     DIRECTION_45::CORNER_MODE m_cornerMode;
 
@@ -19,9 +19,11 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <future>
 #include <optional>
 
 #include <geometry/shape_line_chain.h>
+#include <thread_pool.h>
 
 #include "pns_walkaround.h"
 #include "pns_optimizer.h"
@@ -149,12 +151,42 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
     const int maxWalkDistFactor = 10;
     long long lengthLimit       = aInitialPath.CLine().Length() * maxWalkDistFactor;
 
+    // The two winding directions don't depend on each other, so while both are in progress the
+    // ccw step can be taken on another thread.  Debug output isn't thread safe, so keep to one
+    // thread when it's on.
+    thread_pool& tp = GetKiCadThreadPool();
+    bool         parallel = Settings().GetParallelWalkaround() && tp.get_thread_count() > 1
+                                && !( Dbg() && Dbg()->IsDebugEnabled() );
+
     while( m_iteration < m_iterationLimit )
     {
-        if( s_cw != STUCK && s_cw != ALMOST_DONE )
-            s_cw = singleStep( path_cw, true );
+        std::future<WALKAROUND_STATUS> ccwStep;
+
+        if( parallel && s_cw == IN_PROGRESS && s_ccw == IN_PROGRESS )
+        {
+            ccwStep = tp.submit(
+                    [&]()
+                    {
+                        return singleStep( path_ccw, false );
+                    } );
+        }
+
+        try
+        {
+            if( s_cw != STUCK && s_cw != ALMOST_DONE )
+                s_cw = singleStep( path_cw, true );
+        }
+        catch( ... )
+        {
+            if( ccwStep.valid() )
+                ccwStep.wait();
+
+            throw;
+        }
 
-        if( s_ccw != STUCK && s_ccw != ALMOST_DONE )
+        if( ccwStep.valid() )
+            s_ccw = ccwStep.get();
+        else if( s_ccw != STUCK && s_ccw != ALMOST_DONE )
             s_ccw = singleStep( path_ccw, false );
 
         if( s_cw != IN_PROGRESS )
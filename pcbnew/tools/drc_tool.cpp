@@ -29,12 +29,16 @@
 #include <tools/pcb_selection_tool.h>
 #include <tools/drc_tool.h>
 #include <kiface_base.h>
+#include <advanced_config.h>
 #include <dialog_drc.h>
 #include <board_commit.h>
 #include <board_design_settings.h>
+#include <footprint.h>
+#include <pcb_group.h>
 #include <progress_reporter.h>
 #include <drc/drc_engine.h>
 #include <drc/drc_item.h>
+#include <drc/drc_test_provider.h>
 #include <netlist_reader/pcb_netlist.h>
 
 DRC_TOOL::DRC_TOOL() :
@@ -42,7 +46,8 @@ DRC_TOOL::DRC_TOOL() :
         m_editFrame( nullptr ),
         m_pcb( nullptr ),
         m_drcDialog( nullptr ),
-        m_drcRunning( false )
+        m_drcRunning( false ),
+        m_fullDrcRun( false )
 {
 }
 
@@ -63,6 +68,9 @@ void DRC_TOOL::Reset( RESET_REASON aReason )
 
         m_pcb = m_editFrame->GetBoard();
         m_drcEngine = m_pcb->GetDesignSettings().m_DRCEngine;
+        m_fullDrcRun = false;
+        m_dirtyItemIDs.clear();
+        m_staleItems.clear();
     }
 }
 
@@ -177,8 +185,13 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
                 commit.Add( marker );
             } );
 
+    m_drcEngine->ClearTestScope();
     m_drcEngine->RunTests( m_editFrame->GetUserUnits(), aReportAllTrackErrors, aTestFootprints );
 
+    m_fullDrcRun = true;
+    m_dirtyItemIDs.clear();
+    m_staleItems.clear();
+
     m_drcEngine->SetProgressReporter( nullptr );
     m_drcEngine->ClearViolationHandler();
 
@@ -201,6 +214,130 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
 }
 
 
+void DRC_TOOL::DirtyItem( BOARD_ITEM* aItem )
+{
+    std::function<void( BOARD_ITEM* )> addStale =
+            [&]( BOARD_ITEM* aChild )
+            {
+                m_staleItems.insert( aChild );
+
+                if( aChild->Type() == PCB_FOOTPRINT_T )
+                    static_cast<FOOTPRINT*>( aChild )->RunOnChildren( addStale );
+                else if( aChild->Type() == PCB_GROUP_T )
+                    static_cast<PCB_GROUP*>( aChild )->RunOnChildren( addStale );
+            };
+
+    m_dirtyItemIDs.insert( aItem->m_Uuid );
+    addStale( aItem );
+}
+
+
+bool DRC_TOOL::CanRunIncrementalTests() const
+{
+    return m_fullDrcRun && ADVANCED_CFG::GetCfg().m_IncrementalDRC;
+}
+
+
+void DRC_TOOL::RunIncrementalTests( PROGRESS_REPORTER* aProgressReporter )
+{
+    if( m_drcRunning || !CanRunIncrementalTests() || m_dirtyItemIDs.empty() )
+        return;
+
+    BOARD_COMMIT              commit( m_editFrame );
+    std::map<KIID, EDA_ITEM*> itemMap;
+    std::vector<BOARD_ITEM*>  dirtyItems;
+    std::vector<PCB_MARKER*>  newMarkers;
+
+    // Deleted items can't be re-tested, but their markers still have to go
+    std::set<KIID>            scopeIDs = m_dirtyItemIDs;
+
+    m_drcRunning = true;
+
+    m_pcb->FillItemMap( itemMap );
+
+    for( const KIID& id : m_dirtyItemIDs )
+    {
+        auto it = itemMap.find( id );
+
+        if( it != itemMap.end() )
+            dirtyItems.push_back( static_cast<BOARD_ITEM*>( it->second ) );
+    }
+
+    std::unordered_set<const BOARD_ITEM*> staleItems = std::move( m_staleItems );
+
+    m_dirtyItemIDs.clear();
+    m_staleItems.clear();
+
+    m_drcEngine->SetDrawingSheet( m_editFrame->GetCanvas()->GetDrawingSheet() );
+    m_drcEngine->SetProgressReporter( aProgressReporter );
+
+    m_drcEngine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                PCB_MARKER* marker = new PCB_MARKER( aItem, aPos, aLayer );
+                newMarkers.push_back( marker );
+                commit.Add( marker );
+            } );
+
+    m_drcEngine->SetTestScope( dirtyItems, staleItems );
+    m_drcEngine->RunTests( m_editFrame->GetUserUnits(), m_drcEngine->GetReportAllTrackErrors(),
+                           false );
+
+    // The scope also holds the children of dirty footprints and groups
+    for( const BOARD_ITEM* item : m_drcEngine->GetTestScope() )
+        scopeIDs.insert( item->m_Uuid );
+
+    m_drcEngine->ClearTestScope();
+    m_drcEngine->SetProgressReporter( nullptr );
+    m_drcEngine->ClearViolationHandler();
+
+    // Replace the markers which the re-run providers would have produced for the re-tested
+    // items.  Markers we can't attribute to a provider (such as those loaded with the board)
+    // are left for the next full run.  The exclusions of the replaced markers carry over to
+    // the new markers for the same violations.
+    std::set<wxString> exclusions;
+
+    for( PCB_MARKER* marker : m_pcb->Markers() )
+    {
+        std::shared_ptr<DRC_ITEM> drcItem = std::dynamic_pointer_cast<DRC_ITEM>( marker->GetRCItem() );
+
+        if( !drcItem || !drcItem->GetViolatingTest()
+                || !drcItem->GetViolatingTest()->SupportsTestScope() )
+        {
+            continue;
+        }
+
+        if( scopeIDs.count( drcItem->GetMainItemID() ) || scopeIDs.count( drcItem->GetAuxItemID() ) )
+        {
+            if( marker->IsExcluded() )
+                exclusions.insert( marker->Serialize() );
+
+            commit.Remove( marker );
+        }
+    }
+
+    for( PCB_MARKER* marker : newMarkers )
+    {
+        if( exclusions.count( marker->Serialize() ) )
+            marker->SetExcluded( true );
+    }
+
+    commit.Push( _( "DRC" ), SKIP_UNDO | SKIP_SET_DIRTY );
+
+    m_drcRunning = false;
+
+    // update the m_drcDialog listboxes
+    updatePointers();
+}
+
+
+int DRC_TOOL::RunIncrementalTests( const TOOL_EVENT& aEvent )
+{
+    RunIncrementalTests( nullptr );
+    return 0;
+}
+
+
 void DRC_TOOL::updatePointers()
 {
     // update my pointers, m_editFrame is the only unchangeable one
@@ -288,6 +425,7 @@ int DRC_TOOL::ExcludeMarker( const TOOL_EVENT& aEvent )
 void DRC_TOOL::setTransitions()
 {
     Go( &DRC_TOOL::ShowDRCDialog,              PCB_ACTIONS::runDRC.MakeEvent() );
+    Go( &DRC_TOOL::RunIncrementalTests,        PCB_ACTIONS::runIncrementalDRC.MakeEvent() );
     Go( &DRC_TOOL::PrevMarker,                 ACTIONS::prevMarker.MakeEvent() );
     Go( &DRC_TOOL::NextMarker,                 ACTIONS::nextMarker.MakeEvent() );
     Go( &DRC_TOOL::ExcludeMarker,              ACTIONS::excludeMarker.MakeEvent() );
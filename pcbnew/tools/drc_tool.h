@@ -30,6 +30,8 @@
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 #include <memory>
+#include <set>
+#include <unordered_set>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
@@ -83,6 +85,26 @@ public:
     void RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones,
                    bool aReportAllTrackErrors, bool aTestFootprints );
 
+    /**
+     * Record an item touched by a commit (or undo/redo) so that it is re-tested by the next
+     * incremental run.
+     */
+    void DirtyItem( BOARD_ITEM* aItem );
+
+    /**
+     * Incremental runs are enabled through the IncrementalDRC advanced config setting, and
+     * require a full run on the current board to have produced the marker set they update.
+     */
+    bool CanRunIncrementalTests() const;
+
+    /**
+     * Re-run the DRC providers which support a test scope on the items dirtied since the last
+     * run, replacing those providers' markers on the dirtied items.
+     */
+    void RunIncrementalTests( PROGRESS_REPORTER* aProgressReporter );
+
+    int RunIncrementalTests( const TOOL_EVENT& aEvent );
+
     int PrevMarker( const TOOL_EVENT& aEvent );
     int NextMarker( const TOOL_EVENT& aEvent );
     int CrossProbe( const TOOL_EVENT& aEvent );
@@ -111,6 +133,12 @@ private:
     BOARD*                      m_pcb;
     DIALOG_DRC*                 m_drcDialog;
     bool                        m_drcRunning;
+    bool                        m_fullDrcRun;       // a full DRC has been run on m_pcb
+    std::set<KIID>              m_dirtyItemIDs;     // items to re-test incrementally
+
+    // The dirty items and their children when they were dirtied, whose DRC caches have to be
+    // rebuilt.  They may have been deleted since, so they're only used as keys.
+    std::unordered_set<const BOARD_ITEM*> m_staleItems;
     std::shared_ptr<DRC_ENGINE> m_drcEngine;
 };
 
@@ -240,6 +240,9 @@ TOOL_ACTION PCB_ACTIONS::runDRC( "pcbnew.DRCTool.runDRC",
         _( "Design Rules Checker" ), _( "Show the design rules checker window" ),
         BITMAPS::erc );
 
+TOOL_ACTION PCB_ACTIONS::runIncrementalDRC( "pcbnew.DRCTool.runIncrementalDRC",
+        AS_CONTEXT );
+
 
 // EDIT_TOOL
 //
@@ -382,6 +382,7 @@ public:
 
     static TOOL_ACTION listNets;
     static TOOL_ACTION runDRC;
+    static TOOL_ACTION runIncrementalDRC;
 
     static TOOL_ACTION editFpInFpEditor;
     static TOOL_ACTION editLibFpInFpEditor;
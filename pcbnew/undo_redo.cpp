@@ -42,6 +42,8 @@ using namespace std::placeholders;
 #include <tools/pcb_selection_tool.h>
 #include <tools/pcb_control.h>
 #include <tools/board_editor_control.h>
+#include <tools/drc_tool.h>
+#include <tools/pcb_actions.h>
 #include <drawing_sheet/ds_proxy_undo_item.h>
 #include <wx/msgdlg.h>
 
@@ -380,6 +382,10 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
     auto connectivity = GetBoard()->GetConnectivity();
 
     PCB_GROUP* group = nullptr;
+    DRC_TOOL*  incrementalDrcTool = m_toolManager->GetTool<DRC_TOOL>();
+
+    if( incrementalDrcTool && !incrementalDrcTool->CanRunIncrementalTests() )
+        incrementalDrcTool = nullptr;
 
     GetBoard()->IncrementTimeStamp();   // clear caches
 
@@ -445,6 +451,14 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
             break;
         }
 
+        if( incrementalDrcTool
+                && ( status == UNDO_REDO::CHANGED
+                        || status == UNDO_REDO::NEWITEM
+                        || status == UNDO_REDO::DELETED ) )
+        {
+            incrementalDrcTool->DirtyItem( static_cast<BOARD_ITEM*>( eda_item ) );
+        }
+
         switch( aList->GetPickedItemStatus( ii ) )
         {
         case UNDO_REDO::CHANGED:    /* Exchange old and new data for each item */
@@ -557,6 +571,9 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList )
     selTool->RebuildSelection();
 
     GetBoard()->SanitizeNetcodes();
+
+    if( incrementalDrcTool )
+        m_toolManager->RunAction( PCB_ACTIONS::runIncrementalDRC );
 }
 
 
@@ -274,6 +274,7 @@ void ZONE::SetLayerSet( LSET aLayerSet )
         m_FilledPolysList.clear();
         m_filledPolysHash.clear();
         m_insulatedIslands.clear();
+        m_fillCache.clear();
 
         for( PCB_LAYER_ID layer : aLayerSet.Seq() )
         {
@@ -625,6 +625,33 @@ public:
         m_FilledPolysList[aLayer] = std::make_shared<SHAPE_POLY_SET>( aPolysList );
     }
 
+    /**
+     * Store the fill of a layer as computed by the zone filler (ie: before any islands are
+     * removed), along with a hash of the inputs it was computed from.
+     */
+    void SetFillCache( PCB_LAYER_ID aLayer, size_t aInputsHash, const SHAPE_POLY_SET& aFill )
+    {
+        m_fillCache[aLayer] = std::make_pair( aInputsHash, aFill );
+    }
+
+    /**
+     * Fetch the cached fill of a layer if it was computed from inputs with the given hash.
+     *
+     * @return true if a matching fill was found and copied to \a aFill.
+     */
+    bool GetFillCache( PCB_LAYER_ID aLayer, size_t aInputsHash, SHAPE_POLY_SET& aFill ) const
+    {
+        auto it = m_fillCache.find( aLayer );
+
+        if( it == m_fillCache.end() || it->second.first != aInputsHash )
+            return false;
+
+        aFill = it->second.second;
+        return true;
+    }
+
+    void ClearFillCache() { m_fillCache.clear(); }
+
     /**
      * Check if a given filled polygon is an insulated island.
      *
@@ -888,6 +915,10 @@ protected:
     /// A hash value used in zone filling calculations to see if the filled areas are up to date
     std::map<PCB_LAYER_ID, MD5_HASH>       m_filledPolysHash;
 
+    /// The zone filler's output for each layer, keyed by a hash of its inputs.  Not copied
+    /// with the zone; a missing entry just means the next fill of that layer starts from scratch.
+    std::map<PCB_LAYER_ID, std::pair<size_t, SHAPE_POLY_SET>> m_fillCache;
+
     ZONE_BORDER_DISPLAY_STYLE m_borderStyle;       // border display style, see enum above
     int                       m_borderHatchPitch;  // for DIAGONAL_EDGE, distance between 2 lines
     std::vector<SEG>          m_borderHatchLines;  // hatch lines
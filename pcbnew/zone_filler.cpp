@@ -24,6 +24,7 @@
  */
 
 #include <future>
+#include <numeric>
 #include <core/kicad_algo.h>
 #include <advanced_config.h>
 #include <board.h>
@@ -31,6 +32,7 @@
 #include <zone.h>
 #include <footprint.h>
 #include <pad.h>
+#include <pcb_dimension.h>
 #include <pcb_target.h>
 #include <pcb_track.h>
 #include <pcb_text.h>
@@ -47,6 +49,8 @@
 #include <confirm.h>
 #include <thread_pool.h>
 #include <math/util.h>      // for KiROUND
+#include <hash.h>
+#include <drc/drc_engine.h>
 #include "zone_filler.h"
 
 
@@ -56,10 +60,14 @@ ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
         m_commit( aCommit ),
         m_progressReporter( nullptr ),
         m_maxError( ARC_HIGH_DEF ),
-        m_worstClearance( 0 )
+        m_worstClearance( 0 ),
+        m_fillInputsSeed( 0 )
 {
     // To enable add "DebugZoneFiller=1" to kicad_advanced settings file.
     m_debugZoneFiller = ADVANCED_CFG::GetCfg().m_DebugZoneFiller;
+
+    // Debug fills are partial, so never reuse them
+    m_incremental = ADVANCED_CFG::GetCfg().m_IncrementalZoneFill && !m_debugZoneFiller;
 }
 
 
@@ -156,6 +164,9 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
             static_cast<PCB_VIA*>( track )->ClearZoneConnectionCache();
     }
 
+    if( m_incremental )
+        buildFillInputs();
+
     // Sort by priority to reduce deferrals waiting on higher priority zones.
     //
     std::sort( aZones.begin(), aZones.end(),
@@ -197,38 +208,11 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
     auto check_fill_dependency =
             [&]( ZONE* aZone, PCB_LAYER_ID aLayer, ZONE* aOtherZone ) -> bool
             {
-                // Check to see if we have to knock-out the filled areas of a higher-priority
-                // zone.  If so we have to wait until said zone is filled before we can fill.
-
                 // If the other zone is already filled then we're good-to-go
                 if( aOtherZone->GetFillFlag( aLayer ) )
                     return false;
 
-                // Even if keepouts exclude copper pours the exclusion is by outline, not by
-                // filled area, so we're good-to-go here too.
-                if( aOtherZone->GetIsRuleArea() )
-                    return false;
-
-                // If the zones share no common layers
-                if( !aOtherZone->GetLayerSet().test( aLayer ) )
-                    return false;
-
-                if( aZone->HigherPriority( aOtherZone ) )
-                    return false;
-
-                // Same-net zones always use outline to produce predictable results
-                if( aOtherZone->SameNet( aZone ) )
-                    return false;
-
-                // A higher priority zone is found: if we intersect and it's not filled yet
-                // then we have to wait.
-                BOX2I inflatedBBox = aZone->GetBoundingBox();
-                inflatedBBox.Inflate( m_worstClearance );
-
-                if( !inflatedBBox.Intersects( aOtherZone->GetBoundingBox() ) )
-                    return false;
-
-                return aZone->Outline()->Collide( aOtherZone->Outline(), m_worstClearance );
+                return hasFillDependency( aZone, aLayer, aOtherZone );
             };
 
     auto fill_lambda =
@@ -268,8 +252,22 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
 
                 SHAPE_POLY_SET fillPolys;
 
-                if( !fillSingleZone( zone, layer, fillPolys ) )
+                if( m_incremental )
+                {
+                    size_t inputsHash = fillInputsHash( zone, layer );
+
+                    if( !zone->GetFillCache( layer, inputsHash, fillPolys ) )
+                    {
+                        if( !fillSingleZone( zone, layer, fillPolys ) )
+                            return 0;
+
+                        zone->SetFillCache( layer, inputsHash, fillPolys );
+                    }
+                }
+                else if( !fillSingleZone( zone, layer, fillPolys ) )
+                {
                     return 0;
+                }
 
                 zone->SetFilledPolysList( layer, fillPolys );
 
@@ -366,75 +364,81 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
 
     // Calculate the copper fills (NB: this is multi-threaded)
     //
-    std::vector<std::pair<std::future<int>, int>> returns;
-    returns.reserve( toFill.size() );
-    size_t finished = 0;
-    bool cancelled = false;
+    // Fills run in rounds.  A zone layer which can't be filled yet (because it depends on the
+    // fill of another zone) is retried in the next round; one which has been filled is
+    // tessellated in the next round.
+    std::vector<size_t> toRun( toFill.size() );     // Index into toFill
+    std::vector<int>    stage( toFill.size(), 0 );  // 0: to fill, 1: to tessellate, 2: done
+    std::vector<int>    results( toFill.size() );
+    bool                cancelled = false;
 
-    thread_pool& tp = GetKiCadThreadPool();
+    std::iota( toRun.begin(), toRun.end(), 0 );
 
-    for( const std::pair<ZONE*, PCB_LAYER_ID>& fillItem : toFill )
-        returns.emplace_back( std::make_pair( tp.submit( fill_lambda, fillItem ), 0 ) );
+    std::function<bool( size_t )> report_progress;
 
-    while( !cancelled && finished != 2 * toFill.size() )
+    if( m_progressReporter )
     {
-        for( size_t ii = 0; ii < returns.size(); ++ii )
-        {
-            auto& ret = returns[ii];
-
-            if( ret.second > 1 )
-                continue;
-
-            std::future_status status = ret.first.wait_for( std::chrono::seconds( 0 ) );
-
-            if( status == std::future_status::ready )
-            {
-                if( ret.first.get() )
+        report_progress =
+                [&]( size_t ) -> bool
                 {
-                    ++finished;
-
-                    if( !cancelled && ret.second == 0 )
-                        returns[ii].first = tp.submit( tesselate_lambda, toFill[ii] );
+                    return m_progressReporter->KeepRefreshing();
+                };
+    }
 
-                    ret.second++;
-                }
-                else if( !cancelled )
-                {
-                    returns[ii].first = tp.submit( fill_lambda, toFill[ii] );
-                }
-            }
+    while( !toRun.empty() && !cancelled )
+    {
+        for( size_t ii : toRun )
+            results[ii] = 0;
+
+        size_t done = ParallelFor( toRun.size(),
+                                   [&]( size_t aTask )
+                                   {
+                                       size_t ii = toRun[aTask];
+
+                                       if( stage[ii] == 0 )
+                                           results[ii] = fill_lambda( toFill[ii] );
+                                       else
+                                           results[ii] = tesselate_lambda( toFill[ii] );
+                                   },
+                                   report_progress );
+
+        // A cancelled round leaves some zones unfilled; don't move any zone on to its next stage.
+        if( done < toRun.size() || ( m_progressReporter && m_progressReporter->IsCancelled() ) )
+        {
+            cancelled = true;
+            break;
         }
 
-        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        std::vector<size_t> nextRound;
+        bool                progress = false;
 
-
-        if( m_progressReporter )
+        for( size_t ii : toRun )
         {
-            m_progressReporter->KeepRefreshing();
+            if( results[ii] )
+            {
+                stage[ii]++;
+                progress = true;
+            }
 
-            if( m_progressReporter->IsCancelled() )
-                cancelled = true;
+            if( stage[ii] < 2 )
+                nextRound.push_back( ii );
         }
-    }
 
-    // Make sure that all futures have finished.
-    // This can happen when the user cancels the above operation
-    for( auto& ret : returns )
-    {
-        if( ret.first.valid() )
-        {
-            std::future_status status = ret.first.wait_for( std::chrono::seconds( 0 ) );
+        toRun = std::move( nextRound );
 
-            while( status != std::future_status::ready )
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        // Zones which are locked elsewhere are retried after a pause, as before.
+        if( !progress )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
 
-                status = ret.first.wait_for( std::chrono::milliseconds( 100 ) );
-            }
+            if( m_progressReporter )
+                m_progressReporter->KeepRefreshing();
         }
     }
 
+    if( cancelled )
+        return false;
+
     // Now update the connectivity to check for isolated copper islands
     // (NB: FindIsolatedCopperIslands() is multi-threaded)
     //
@@ -596,6 +600,316 @@ bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aPare
 }
 
 
+bool ZONE_FILLER::hasFillDependency( const ZONE* aZone, PCB_LAYER_ID aLayer,
+                                     ZONE* aOtherZone ) const
+{
+    // Check to see if we have to knock-out the filled areas of a higher-priority zone.  If so
+    // we have to wait until said zone is filled before we can fill.
+
+    // Even if keepouts exclude copper pours the exclusion is by outline, not by filled area,
+    // so we're good-to-go here.
+    if( aOtherZone->GetIsRuleArea() )
+        return false;
+
+    // If the zones share no common layers
+    if( !aOtherZone->GetLayerSet().test( aLayer ) )
+        return false;
+
+    if( aZone->HigherPriority( aOtherZone ) )
+        return false;
+
+    // Same-net zones always use outline to produce predictable results
+    if( aOtherZone->SameNet( aZone ) )
+        return false;
+
+    // A higher priority zone is found: if we intersect then we depend on its fill.
+    BOX2I inflatedBBox = aZone->GetBoundingBox();
+    inflatedBBox.Inflate( m_worstClearance );
+
+    if( !inflatedBBox.Intersects( aOtherZone->GetBoundingBox() ) )
+        return false;
+
+    return aZone->Outline()->Collide( aOtherZone->Outline(), m_worstClearance );
+}
+
+
+/**
+ * Hash what a zone fill may depend on in \a aItem: its geometry, layers and net, and the
+ * properties looked at by the zone connection settings and by the design rules.  This is
+ * done field by field as it runs for every item of the board before each fill.
+ */
+static void hashFillInput( size_t& aHash, const BOARD_ITEM* aItem )
+{
+    hash_combine( aHash, static_cast<int>( aItem->Type() ),
+                  static_cast<const BASE_SET&>( aItem->GetLayerSet() ) );
+
+    if( aItem->IsConnected() )
+    {
+        const BOARD_CONNECTED_ITEM* item = static_cast<const BOARD_CONNECTED_ITEM*>( aItem );
+
+        hash_combine( aHash, item->GetNetCode(), item->GetNetname(),
+                      item->GetNetClassName() );
+    }
+
+    switch( aItem->Type() )
+    {
+    case PCB_ARC_T:
+        hash_combine( aHash, static_cast<const PCB_ARC*>( aItem )->GetMid() );
+        KI_FALLTHROUGH;
+
+    case PCB_TRACE_T:
+    {
+        const PCB_TRACK* track = static_cast<const PCB_TRACK*>( aItem );
+
+        hash_combine( aHash, track->GetStart(), track->GetEnd(), track->GetWidth() );
+        break;
+    }
+
+    case PCB_VIA_T:
+    {
+        const PCB_VIA* via = static_cast<const PCB_VIA*>( aItem );
+
+        hash_combine( aHash, via->GetStart(), via->GetWidth(), via->GetDrillValue(),
+                      static_cast<int>( via->GetViaType() ), via->GetRemoveUnconnected(),
+                      via->GetKeepStartEnd() );
+        break;
+    }
+
+    case PCB_PAD_T:
+    {
+        const PAD* pad = static_cast<const PAD*>( aItem );
+
+        // The effective polygon covers the shape, size, offset and orientation of the pad
+        hash_combine( aHash, pad->GetPosition(), pad->GetOrientation().AsDegrees(),
+                      pad->GetEffectivePolygon()->GetHash().Format( true ),
+                      static_cast<int>( pad->GetDrillShape() ), pad->GetDrillSize(),
+                      pad->GetOffset(), static_cast<int>( pad->GetAttribute() ),
+                      static_cast<int>( pad->GetProperty() ), pad->GetNumber(),
+                      static_cast<int>( pad->GetZoneConnection() ),
+                      pad->GetThermalSpokeWidth(), pad->GetThermalSpokeAngle().AsDegrees(),
+                      pad->GetThermalGap(), pad->GetLocalClearance(),
+                      static_cast<int>( pad->GetCustomShapeInZoneOpt() ),
+                      pad->GetRemoveUnconnected(), pad->GetKeepTopBottom() );
+        break;
+    }
+
+    case PCB_FOOTPRINT_T:
+    {
+        const FOOTPRINT* footprint = static_cast<const FOOTPRINT*>( aItem );
+
+        hash_combine( aHash, footprint->GetPosition(), footprint->GetOrientation().AsDegrees(),
+                      footprint->GetAttributes(),
+                      static_cast<int>( footprint->GetZoneConnection() ),
+                      footprint->GetLocalClearance(), footprint->GetFPIDAsString() );
+
+        for( const wxString& group : footprint->GetNetTiePadGroups() )
+            hash_combine( aHash, group );
+
+        hashFillInput( aHash, &footprint->Reference() );
+        hashFillInput( aHash, &footprint->Value() );
+
+        for( const PAD* pad : footprint->Pads() )
+            hashFillInput( aHash, pad );
+
+        for( const BOARD_ITEM* item : footprint->GraphicalItems() )
+            hashFillInput( aHash, item );
+
+        // Footprint zones are hashed as zones
+        break;
+    }
+
+    case PCB_DIM_ALIGNED_T:
+    case PCB_DIM_LEADER_T:
+    case PCB_DIM_CENTER_T:
+    case PCB_DIM_RADIAL_T:
+    case PCB_DIM_ORTHOGONAL_T:
+    case PCB_FP_DIM_ALIGNED_T:
+    case PCB_FP_DIM_LEADER_T:
+    case PCB_FP_DIM_CENTER_T:
+    case PCB_FP_DIM_RADIAL_T:
+    case PCB_FP_DIM_ORTHOGONAL_T:
+    {
+        const PCB_DIMENSION_BASE* dimension = static_cast<const PCB_DIMENSION_BASE*>( aItem );
+
+        hash_combine( aHash, dimension->GetLineThickness() );
+
+        for( const std::shared_ptr<SHAPE>& shape : dimension->GetShapes() )
+            hash_combine( aHash, shape->BBox().GetOrigin(), shape->BBox().GetEnd() );
+
+        hashFillInput( aHash, &dimension->Text() );
+        break;
+    }
+
+    case PCB_TARGET_T:
+    {
+        const PCB_TARGET* target = static_cast<const PCB_TARGET*>( aItem );
+
+        hash_combine( aHash, target->GetPosition(), target->GetShape(), target->GetSize(),
+                      target->GetWidth() );
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if( const PCB_SHAPE* shape = dynamic_cast<const PCB_SHAPE*>( aItem ) )
+    {
+        hash_combine( aHash, static_cast<int>( shape->GetShape() ), shape->GetStart(),
+                      shape->GetEnd(), shape->GetWidth(), shape->IsFilled() );
+
+        if( shape->GetShape() == SHAPE_T::ARC )
+            hash_combine( aHash, shape->GetArcMid() );
+        else if( shape->GetShape() == SHAPE_T::BEZIER )
+            hash_combine( aHash, shape->GetBezierC1(), shape->GetBezierC2() );
+        else if( shape->GetShape() == SHAPE_T::POLY )
+            hash_combine( aHash, shape->GetPolyShape().GetHash().Format( true ) );
+    }
+
+    // Text variables are resolved when knocking out text
+    if( const EDA_TEXT* text = dynamic_cast<const EDA_TEXT*>( aItem ) )
+    {
+        const TEXT_ATTRIBUTES& attrs = text->GetAttributes();
+
+        hash_combine( aHash, text->GetShownText(), text->GetTextPos(), attrs.m_Font,
+                      static_cast<int>( attrs.m_Halign ), static_cast<int>( attrs.m_Valign ),
+                      attrs.m_Angle.AsDegrees(), attrs.m_LineSpacing, attrs.m_StrokeWidth,
+                      attrs.m_Italic, attrs.m_Bold, attrs.m_Visible, attrs.m_Mirrored,
+                      attrs.m_Multiline, attrs.m_Size, attrs.m_KeepUpright );
+    }
+}
+
+
+void ZONE_FILLER::buildFillInputs()
+{
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+
+    auto itemHash =
+            []( const BOARD_ITEM* aItem ) -> size_t
+            {
+                size_t hash = 0;
+                hashFillInput( hash, aItem );
+                return hash;
+            };
+
+    // Inputs which affect every zone.  The rules generation covers both custom rules and the
+    // implicit ones derived from the board setup (netclasses, constraints, etc.).
+    m_fillInputsSeed = 0;
+    hash_combine( m_fillInputsSeed, bds.m_MaxError, m_worstClearance, m_brdOutlinesValid,
+                  m_boardOutline.GetHash().Format( true ),
+                  bds.m_DRCEngine ? bds.m_DRCEngine->GetRulesGeneration() : 0 );
+
+    m_fillInputs.clear();
+    m_zoneInputs.clear();
+    m_zoneHashes.clear();
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+    {
+        // Via holes are knocked out of every copper layer, flashed or not
+        LSET layers = track->Type() == PCB_VIA_T ? LSET::AllCuMask() : track->GetLayerSet();
+
+        m_fillInputs.push_back( { track->GetBoundingBox(), layers, itemHash( track ) } );
+    }
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        // Footprints are hashed as a whole (including their texts and courtyards) on each
+        // layer any of their items live on.
+        LSET layers = footprint->GetLayerSet();
+
+        for( PAD* pad : footprint->Pads() )
+        {
+            layers |= pad->GetLayerSet();
+
+            if( pad->HasHole() )
+                layers |= LSET::AllCuMask();
+        }
+
+        for( BOARD_ITEM* item : footprint->GraphicalItems() )
+            layers |= item->GetLayerSet();
+
+        layers.set( footprint->Reference().GetLayer() );
+        layers.set( footprint->Value().GetLayer() );
+
+        m_fillInputs.push_back( { footprint->GetBoundingBox(), layers, itemHash( footprint ) } );
+
+        for( ZONE* zone : footprint->Zones() )
+            m_zoneInputs.emplace_back( zone, 0 );
+    }
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+    {
+        if( item->Type() == PCB_BITMAP_T )
+            continue;
+
+        m_fillInputs.push_back( { item->GetBoundingBox(), item->GetLayerSet(), itemHash( item ) } );
+    }
+
+    for( ZONE* zone : m_board->Zones() )
+        m_zoneInputs.emplace_back( zone, 0 );
+
+    // A zone's definition, sans fill
+    for( std::pair<ZONE*, size_t>& zoneInput : m_zoneInputs )
+    {
+        ZONE*   zone = zoneInput.first;
+        size_t& hash = zoneInput.second;
+
+        hashFillInput( hash, zone );
+        hash_combine( hash, zone->Outline()->GetHash().Format( true ), zone->GetZoneName(),
+                      zone->GetAssignedPriority(), zone->GetLocalClearance(),
+                      zone->GetMinThickness(), static_cast<int>( zone->GetPadConnection() ),
+                      zone->GetThermalReliefGap(), zone->GetThermalReliefSpokeWidth(),
+                      zone->GetCornerSmoothingType(), zone->GetCornerRadius(),
+                      static_cast<int>( zone->GetIslandRemovalMode() ),
+                      zone->GetMinIslandArea(), static_cast<int>( zone->GetTeardropAreaType() ),
+                      zone->GetIsRuleArea(), zone->GetDoNotAllowCopperPour(),
+                      zone->GetDoNotAllowVias(), zone->GetDoNotAllowTracks(),
+                      zone->GetDoNotAllowPads(), zone->GetDoNotAllowFootprints() );
+
+        hash_combine( hash, static_cast<int>( zone->GetFillMode() ), zone->GetHatchThickness(),
+                      zone->GetHatchGap(), zone->GetHatchOrientation().AsDegrees(),
+                      zone->GetHatchSmoothingLevel(), zone->GetHatchSmoothingValue(),
+                      zone->GetHatchHoleMinArea(), zone->GetHatchBorderAlgorithm() );
+
+        m_zoneHashes[ zone ] = hash;
+    }
+}
+
+
+size_t ZONE_FILLER::fillInputsHash( const ZONE* aZone, PCB_LAYER_ID aLayer ) const
+{
+    size_t hash = m_fillInputsSeed;
+    BOX2I  inflatedBBox = aZone->GetBoundingBox();
+
+    inflatedBBox.Inflate( m_worstClearance );
+
+    hash_combine( hash, static_cast<int>( aLayer ), m_zoneHashes.at( aZone ) );
+
+    for( const FILL_INPUT& input : m_fillInputs )
+    {
+        if( input.m_Layers.test( aLayer ) && input.m_BBox.Intersects( inflatedBBox ) )
+            hash_combine( hash, input.m_Hash );
+    }
+
+    for( const auto& [ otherZone, otherHash ] : m_zoneInputs )
+    {
+        if( otherZone == aZone || !otherZone->GetLayerSet().test( aLayer ) )
+            continue;
+
+        if( !otherZone->GetBoundingBox().Intersects( inflatedBBox ) )
+            continue;
+
+        hash_combine( hash, otherHash );
+
+        // Higher-priority zones of other nets are knocked out by their filled areas
+        if( hasFillDependency( aZone, aLayer, otherZone ) )
+            hash_combine( hash, otherZone->GetFilledPolysList( aLayer )->GetHash().Format( true ) );
+    }
+
+    return hash;
+}
+
+
 /**
  * Add a knockout for a pad.  The knockout is 'aGap' larger than the pad (which might be
  * either the thermal clearance or the electrical clearance).
@@ -851,8 +1165,11 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
         knockoutPadClearance( pad );
     }
 
-    // Add non-connected track clearances
+    // Add non-connected track clearances.  There are usually a great many of these, so they are
+    // collected as primitives and merged in a single pass with the rest of the holes at the end.
     //
+    SHAPE_POLY_SET::PRIMITIVE_BATCH trackKnockouts;
+
     auto knockoutTrackClearance =
             [&]( PCB_TRACK* aTrack )
             {
@@ -884,8 +1201,9 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
 
                         if( via->FlashLayer( aLayer ) && gap > 0 )
                         {
-                            via->TransformShapeToPolygon( aHoles, aLayer, gap + extra_margin,
-                                                          m_maxError, ERROR_OUTSIDE );
+                            trackKnockouts.AddCircle( via->GetPosition(),
+                                                      via->GetWidth() / 2 + gap + extra_margin,
+                                                      m_maxError, ERROR_OUTSIDE );
                         }
 
                         gap = std::max( gap, evalRulesForItems( PHYSICAL_HOLE_CLEARANCE_CONSTRAINT,
@@ -901,11 +1219,21 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
                         {
                             int radius = via->GetDrillValue() / 2;
 
-                            TransformCircleToPolygon( aHoles, via->GetPosition(),
+                            trackKnockouts.AddCircle( via->GetPosition(),
                                                       radius + gap + extra_margin,
                                                       m_maxError, ERROR_OUTSIDE );
                         }
                     }
+                    else if( aTrack->Type() == PCB_TRACE_T )
+                    {
+                        if( gap > 0 )
+                        {
+                            trackKnockouts.AddSegment( aTrack->GetStart(), aTrack->GetEnd(),
+                                                       aTrack->GetWidth()
+                                                            + 2 * ( gap + extra_margin ),
+                                                       m_maxError, ERROR_OUTSIDE );
+                        }
+                    }
                     else
                     {
                         if( gap > 0 )
@@ -1104,7 +1432,7 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
         }
     }
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aHoles.BooleanAdd( trackKnockouts );
 }
 
 
@@ -27,6 +27,7 @@
 #define ZONE_FILLER_H
 
 #include <vector>
+#include <map>
 #include <zone.h>
 
 class PROGRESS_REPORTER;
@@ -61,6 +62,25 @@ public:
 
 private:
 
+    /**
+     * Hash each item which can affect a zone fill so that a zone whose inputs haven't changed
+     * since it was last filled can reuse that fill.  Must be called from the main thread.
+     */
+    void buildFillInputs();
+
+    /**
+     * Return a hash of everything the fill of \a aZone on \a aLayer depends on: the zone
+     * itself, the items within clearance of it on that layer, and the fills of the zones it
+     * must wait on (see hasFillDependency()).  Those zones must already have been filled.
+     */
+    size_t fillInputsHash( const ZONE* aZone, PCB_LAYER_ID aLayer ) const;
+
+    /**
+     * Return true if \a aZone is knocked out by the (filled) copper of \a aOtherZone on
+     * \a aLayer, so that it can't be filled until \a aOtherZone has been.
+     */
+    bool hasFillDependency( const ZONE* aZone, PCB_LAYER_ID aLayer, ZONE* aOtherZone ) const;
+
     void addKnockout( PAD* aPad, PCB_LAYER_ID aLayer, int aGap, SHAPE_POLY_SET& aHoles );
 
     void addKnockout( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap, bool aIgnoreLineWidth,
@@ -138,6 +158,19 @@ private:
     int                   m_worstClearance;
 
     bool                  m_debugZoneFiller;
+
+    struct FILL_INPUT
+    {
+        BOX2I   m_BBox;
+        LSET    m_Layers;
+        size_t  m_Hash;
+    };
+
+    bool                                  m_incremental;       // reuse fills via the hashes below
+    size_t                                m_fillInputsSeed;    // hash of board-wide inputs
+    std::vector<FILL_INPUT>               m_fillInputs;        // tracks, footprints and drawings
+    std::vector<std::pair<ZONE*, size_t>> m_zoneInputs;        // zone definitions (sans fills)
+    std::map<const ZONE*, size_t>         m_zoneHashes;
 };
 
 #endif
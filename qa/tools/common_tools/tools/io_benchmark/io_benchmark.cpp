@@ -22,6 +22,7 @@
  */
 
 #include <wx/wx.h>
+#include <lib_table_lexer.h>
 #include <richio.h>
 
 #include <chrono>
@@ -203,6 +204,56 @@ static void bench_string_lr_reuse( const wxFileName& aFile, int aReps, BENCH_REP
 }
 
 
+/**
+ * Benchmark using MAPPED_FILE_LINE_READER, reading lines in place as DSNLEXER does.
+ * The LINE_READER (and so the mapping) is recreated for each cycle.
+ */
+static void bench_mapped_lr( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        MAPPED_FILE_LINE_READER fstr( aFile.GetFullPath() );
+        unsigned                len;
+        const char*             line;
+
+        while( ( line = fstr.ReadLineInPlace( &len ) ), len )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+    }
+}
+
+
+/**
+ * Benchmark tokenizing the file with a DSNLEXER reading from a given LINE_READER
+ * implementation.  The library table lexer is used to get a keyword lookup for every
+ * symbol.  Lines are counted at each new line number, and the accumulator gets the first
+ * character of each token.
+ */
+template<typename LR>
+static void bench_dsnlexer( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR              fstr( aFile.GetFullPath() );
+        LIB_TABLE_LEXER lexer( &fstr );
+        int             lastLine = 0;
+
+        while( lexer.NextTok() != LIB_TABLE_T::T_EOF )
+        {
+            if( lexer.CurLineNumber() != lastLine )
+            {
+                lastLine = lexer.CurLineNumber();
+                report.linesRead++;
+            }
+
+            report.charAcc += (unsigned char) lexer.CurText()[0];
+        }
+    }
+}
+
+
 /**
  * Benchmark using an INPUTSTREAM_LINE_READER with a given
  * wxInputStream implementation.
@@ -314,6 +365,9 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'R', bench_line_reader_reuse<FILE_LINE_READER>, "RichIO FILE_L_R, reused" },
     { 'n', bench_line_reader<IFSTREAM_LINE_READER>, "std::ifstream L_R" },
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
+    { 'm', bench_mapped_lr, "RichIO MAPPED_FILE_L_R, in place"},
+    { 'l', bench_dsnlexer<FILE_LINE_READER>, "DSNLEXER on FILE_L_R"},
+    { 'L', bench_dsnlexer<MAPPED_FILE_LINE_READER>, "DSNLEXER on MAPPED_FILE_L_R"},
     { 's', bench_string_lr, "RichIO STRING_L_R"},
     { 'S', bench_string_lr_reuse, "RichIO STRING_L_R, reused"},
     { 'w', bench_wxis<wxFileInputStream>, "wxFileIStream" },
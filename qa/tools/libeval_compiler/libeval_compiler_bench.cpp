@@ -0,0 +1,176 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Measures how many DRC rule conditions can be evaluated per second, and how many heap
+ * allocations each evaluation makes, for a set of typical rule conditions.
+ *
+ * Usage: libeval_compiler_bench [evaluations per condition]
+ */
+
+#include <wx/wx.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <board.h>
+#include <netclass.h>
+#include <netinfo.h>
+#include <pcb_track.h>
+#include <profile.h>
+#include <drc/drc_rule.h>
+#include <drc/drc_rule_condition.h>
+
+
+static std::atomic<size_t> g_allocations( 0 );
+
+
+void* operator new( std::size_t aSize )
+{
+    g_allocations.fetch_add( 1, std::memory_order_relaxed );
+
+    if( void* p = std::malloc( aSize ? aSize : 1 ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete( void* aPtr, std::size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+static const char* g_conditions[] = {
+    "A.NetClass == 'HV'",
+    "A.NetClass == 'HV' && B.NetClass != 'HV'",
+    "A.NetClass == 'DDR*' || B.NetClass == 'DDR*'",
+    "A.NetName == 'GND'",
+    "A.Type == 'Via' && B.Type == 'Track'",
+    "A.Type == 'Track' && L == 'F.Cu'",
+    "A.Width > 0.2mm && A.NetClass == 'HV'",
+    "1mm + 2mm > 2.5mm && A.Type == 'Track'",
+    "A.isMicroVia()"
+};
+
+
+int main( int argc, char* argv[] )
+{
+    long evaluations = 1000000;
+
+    if( argc > 1 )
+        evaluations = std::max( 1L, std::atol( argv[1] ) );
+
+    PROPERTY_MANAGER::Instance().Rebuild();
+
+    BOARD brd;
+
+    const wxString netclassNames[] = { wxT( "HV" ), wxT( "DDR_DATA" ), wxT( "Signal" ) };
+    const wxString netNames[] = { wxT( "GND" ), wxT( "+48V" ), wxT( "DQ0" ), wxT( "DQ1" ),
+                                  wxT( "CLK" ), wxT( "SDA" ), wxT( "SCL" ), wxT( "+3V3" ) };
+
+    std::vector<std::shared_ptr<NETCLASS>> netclasses;
+    std::vector<NETINFO_ITEM*>             nets;
+    std::vector<BOARD_ITEM*>               items;
+
+    for( const wxString& name : netclassNames )
+        netclasses.push_back( std::make_shared<NETCLASS>( name ) );
+
+    for( int ii = 0; ii < (int) ( sizeof( netNames ) / sizeof( netNames[0] ) ); ++ii )
+    {
+        NETINFO_ITEM* net = new NETINFO_ITEM( &brd, netNames[ii], ii + 1 );
+
+        net->SetNetClass( netclasses[ii % netclasses.size()] );
+        brd.Add( net );
+        nets.push_back( net );
+    }
+
+    for( int ii = 0; ii < 64; ++ii )
+    {
+        BOARD_CONNECTED_ITEM* item;
+
+        if( ii % 4 == 0 )
+        {
+            PCB_VIA* via = new PCB_VIA( &brd );
+            via->SetViaType( ii % 8 == 0 ? VIATYPE::THROUGH : VIATYPE::MICROVIA );
+            item = via;
+        }
+        else
+        {
+            PCB_TRACK* track = new PCB_TRACK( &brd );
+            track->SetWidth( pcbIUScale.mmToIU( 0.1 * ( ii % 5 + 1 ) ) );
+            track->SetLayer( ii % 3 ? F_Cu : B_Cu );
+            item = track;
+        }
+
+        item->SetNet( nets[ii % nets.size()] );
+        brd.Add( item );
+        items.push_back( item );
+    }
+
+    printf( "%-48s %12s %12s %10s\n", "condition", "evals/s", "allocs/eval", "matches" );
+
+    for( const char* expr : g_conditions )
+    {
+        DRC_RULE_CONDITION condition( expr );
+
+        if( !condition.Compile( nullptr ) )
+        {
+            printf( "%-48s failed to compile\n", expr );
+            return 1;
+        }
+
+        size_t     matches = 0;
+        size_t     allocationsBefore = g_allocations.load();
+        PROF_TIMER timer;
+
+        for( long ii = 0; ii < evaluations; ++ii )
+        {
+            BOARD_ITEM* a = items[ii % items.size()];
+            BOARD_ITEM* b = items[( ii / items.size() + ii * 7 ) % items.size()];
+
+            if( condition.EvaluateFor( a, b, NULL_CONSTRAINT, F_Cu, nullptr ) )
+                matches++;
+        }
+
+        timer.Stop();
+
+        double allocations = double( g_allocations.load() - allocationsBefore ) / evaluations;
+
+        printf( "%-48s %12.0f %12.2f %10zu\n", expr, evaluations / ( timer.msecs() / 1000.0 ),
+                allocations, matches );
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "pcb_track.h"
 
 #include <pcb_expr_evaluator.h>
+#include <drc/drc_rule.h>
 
 #include <io_mgr.h>
 #include <plugins/kicad/pcb_plugin.h>
@@ -20,7 +21,8 @@ bool testEvalExpr( const std::string expr, LIBEVAL::VALUE expectedResult, bool e
     PCB_EXPR_UCODE ucode;
     bool ok = true;
 
-    PCB_EXPR_CONTEXT  context, preflightContext;
+    PCB_EXPR_CONTEXT  context( NULL_CONSTRAINT, UNDEFINED_LAYER );
+    PCB_EXPR_CONTEXT  preflightContext( NULL_CONSTRAINT, UNDEFINED_LAYER );
 
     context.SetItems( itemA, itemB );
 
@@ -45,7 +47,7 @@ bool testEvalExpr( const std::string expr, LIBEVAL::VALUE expectedResult, bool e
     if( ok )
     {
         result = *ucode.Run( &context );
-        ok = (result.EqualTo( &expectedResult) );
+        ok = (result.EqualTo( &context, &expectedResult) );
     }
 
     return ok;
@@ -73,14 +75,14 @@ int main( int argc, char *argv[] )
 
     NETINFO_LIST& netInfo = brd.GetNetInfo();
 
-    NETCLASSPTR netclass1( new NETCLASS("HV") );
-    NETCLASSPTR netclass2( new NETCLASS("otherClass" ) );
+    std::shared_ptr<NETCLASS> netclass1( new NETCLASS("HV") );
+    std::shared_ptr<NETCLASS> netclass2( new NETCLASS("otherClass" ) );
 
     auto net1info = new NETINFO_ITEM( &brd, "net1", 1);
     auto net2info = new NETINFO_ITEM( &brd, "net2", 2);
 
-    net1info->SetClass( netclass1 );
-    net2info->SetClass( netclass2 );
+    net1info->SetNetClass( netclass1 );
+    net2info->SetNetClass( netclass2 );
 
     PCB_TRACK trackA( &brd );
     PCB_TRACK trackB( &brd );
@@ -90,8 +92,8 @@ int main( int argc, char *argv[] )
 
     trackB.SetLayer( F_Cu );
 
-    trackA.SetWidth( Mils2iu( 10 ) );
-    trackB.SetWidth( Mils2iu( 20 ) );
+    trackA.SetWidth( pcbIUScale.MilsToIU( 10 ) );
+    trackB.SetWidth( pcbIUScale.MilsToIU( 20 ) );
 
     testEvalExpr( "A.fromTo('U1', 'U3') && A.NetClass == 'DDR3_A' ", VAL(0), false, &trackA, &trackB );
 
@@ -101,7 +103,7 @@ int main( int argc, char *argv[] )
     testEvalExpr( "A.type == 'Pad' && B.type == 'Pad' && (A.existsOnLayer('F.Cu'))", VAL( 0.0 ), false, &trackA, &trackB );
         return 0;
     testEvalExpr( "A.Width > B.Width", VAL( 0.0 ), false, &trackA, &trackB );
-    testEvalExpr( "A.Width + B.Width", VAL( Mils2iu(10) + Mils2iu(20) ), false, &trackA, &trackB );
+    testEvalExpr( "A.Width + B.Width", VAL( pcbIUScale.MilsToIU(10) + pcbIUScale.MilsToIU(20) ), false, &trackA, &trackB );
 
     testEvalExpr( "A.Netclass", VAL( (const char*) trackA.GetNetClassName().c_str() ), false, &trackA, &trackB );
     testEvalExpr( "(A.Netclass == 'HV') && (B.netclass == 'otherClass') && (B.netclass != 'F.Cu')", VAL( 1.0 ), false, &trackA, &trackB );
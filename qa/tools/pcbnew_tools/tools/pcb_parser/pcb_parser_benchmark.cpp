@@ -0,0 +1,175 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <common.h>
+#include <profile.h>
+#include <thread_pool.h>
+
+#include <wx/cmdline.h>
+
+#include <board.h>
+#include <plugins/kicad/pcb_plugin.h>
+#include <plugins/kicad/pcb_parser.h>
+#include <richio.h>
+
+
+using PARSE_DURATION = std::chrono::microseconds;
+
+
+/**
+ * Parse a board from \a aReader.
+ *
+ * @return the board (or nullptr on error) and the time taken.
+ */
+static std::unique_ptr<BOARD> parse( LINE_READER& aReader, PARSE_DURATION& aDuration )
+{
+    PCB_PARSER             parser( &aReader, nullptr, nullptr );
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        PROF_TIMER timer;
+        board.reset( dynamic_cast<BOARD*>( parser.Parse() ) );
+        aDuration = timer.SinceStart<PARSE_DURATION>();
+    }
+    catch( const IO_ERROR& e )
+    {
+        std::cerr << e.What().ToStdString() << std::endl;
+    }
+
+    return board;
+}
+
+
+static std::string format( const BOARD& aBoard )
+{
+    PCB_PLUGIN plugin;
+
+    plugin.Format( &aBoard );
+    return plugin.GetStringOutput( true );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "r", "repeat", _( "number of times to parse each file" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum PARSER_BENCHMARK_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    OUTPUT_MISMATCH
+};
+
+
+int pcb_parser_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program compares the serial and the multi-threaded board "
+                               "parsers, both for speed and for identical results." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 5;
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( 1L, repeat );
+
+    int ret = KI_TEST::RET_CODES::OK;
+
+    std::cout << "Threads: " << GetKiCadThreadPool().get_thread_count() << std::endl;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        const wxString    filename = cl_parser.GetParam( i );
+        std::ifstream     fin( filename.ToStdString(), std::ios::binary );
+        std::stringstream contents;
+
+        contents << fin.rdbuf();
+
+        const std::string text = contents.str();
+        PARSE_DURATION    serialTotal{};
+        PARSE_DURATION    parallelTotal{};
+        std::string       serialOutput;
+        std::string       parallelOutput;
+
+        for( long run = 0; run < repeat; ++run )
+        {
+            PARSE_DURATION     serialTime{};
+            PARSE_DURATION     parallelTime{};
+            STRING_LINE_READER serialReader( text, filename );
+            BUFFER_LINE_READER parallelReader( text.data(), text.size(), filename );
+
+            std::unique_ptr<BOARD> serialBoard = parse( serialReader, serialTime );
+            std::unique_ptr<BOARD> parallelBoard = parse( parallelReader, parallelTime );
+
+            if( !serialBoard || !parallelBoard )
+                return PARSER_BENCHMARK_RET_CODES::PARSE_FAILED;
+
+            serialTotal += serialTime;
+            parallelTotal += parallelTime;
+
+            if( run == 0 )
+            {
+                serialOutput = format( *serialBoard );
+                parallelOutput = format( *parallelBoard );
+            }
+        }
+
+        bool match = serialOutput == parallelOutput;
+
+        std::cout << filename.ToStdString() << ": "
+                  << "serial " << serialTotal.count() / repeat << "us, "
+                  << "parallel " << parallelTotal.count() / repeat << "us, "
+                  << "output " << ( match ? "identical" : "DIFFERS" ) << std::endl;
+
+        if( !match )
+            ret = PARSER_BENCHMARK_RET_CODES::OUTPUT_MISMATCH;
+    }
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "pcb_parser_benchmark",
+                                                       "Benchmark the multi-threaded PCB parser",
+                                                       pcb_parser_benchmark_main_func } );
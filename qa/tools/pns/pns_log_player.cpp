@@ -26,12 +26,16 @@
 #include "pns_log_player.h"
 
 #include <pcbnew_utils/board_test_utils.h>
+#include <profile.h>
 
 #define PNSLOGINFO PNS::DEBUG_DECORATOR::SRC_LOCATION_INFO( __FILE__, __FUNCTION__, __LINE__ )
 
 using namespace PNS;
 
-PNS_LOG_PLAYER::PNS_LOG_PLAYER()
+PNS_LOG_PLAYER::PNS_LOG_PLAYER() :
+        m_debugDecorator( nullptr ),
+        m_timeLimitUs( 0 ),
+        m_debugEnabled( true )
 {
     SetReporter( &NULL_REPORTER::GetInstance() );
 }
@@ -60,6 +64,7 @@ void PNS_LOG_PLAYER::createRouter()
 
     m_debugDecorator = new PNS_TEST_DEBUG_DECORATOR;
     m_debugDecorator->Clear();
+    m_debugDecorator->SetDebugEnabled( m_debugEnabled );
     m_iface->SetDebugDecorator( m_debugDecorator );
 }
 
@@ -91,10 +96,16 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
     createRouter();
 
     m_router->LoadSettings( aLog->GetRoutingSettings() );
+    m_router->SetMode( aLog->GetMode() );
 
     int eventIdx = 0;
     int totalEvents = aLog->Events().size();
 
+    PNS::ROUTER::COUNTERS& counters = m_router->Counters();
+    PROF_TIMER             timer( "", false );
+
+    m_eventStats.clear();
+
     for( auto evt : aLog->Events() )
     {
         if( eventIdx < aFrom || ( aTo >= 0 && eventIdx > aTo ) )
@@ -105,6 +116,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
 
         eventIdx++;
 
+        unsigned long long branches = counters.m_NodeBranches.Count();
+        unsigned long long optimizerSteps = counters.m_OptimizerSteps.Count();
+
         switch( evt.type )
         {
         case LOGGER::EVT_START_ROUTE:
@@ -117,7 +131,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             m_router->StartRouting( evt.p, ritem, ritem ? ritem->Layers().Start() : F_Cu );
+            timer.Stop();
             break;
         }
 
@@ -131,7 +147,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool rv = m_router->StartDragging( evt.p, ritem, 0 );
+            timer.Stop();
             break;
         }
 
@@ -140,7 +158,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->NewStage( "fix", 0, PNSLOGINFO );
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "fix (%d, %d)", evt.p.x, evt.p.y ) );
+            timer.Start();
             bool rv = m_router->FixRoute( evt.p, ritem );
+            timer.Stop();
             printf( "  fix -> (%d, %d) ret %d\n", evt.p.x, evt.p.y, rv ? 1 : 0 );
             break;
         }
@@ -151,7 +171,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "unfix (%d, %d)", evt.p.x, evt.p.y ) );
             printf( "  unfix\n" );
+            timer.Start();
             m_router->UndoLastSegment();
+            timer.Stop();
             break;
         }
 
@@ -165,7 +187,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool ret = m_router->Move( evt.p, ritem );
+            timer.Stop();
             m_debugDecorator->SetCurrentStageStatus( ret );
             break;
         }
@@ -180,13 +204,22 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_reporter->Report( msg );
 
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
+            timer.Start();
             m_router->ToggleViaPlacement();
+            timer.Stop();
             break;
         }
 
-        default: break;
+        default: continue;
         }
 
+        EVENT_STATS stats;
+        stats.m_Type = evt.type;
+        stats.m_TimeUs = timer.SinceStart<std::chrono::duration<double, std::micro>>().count();
+        stats.m_NodeBranches = counters.m_NodeBranches.Count() - branches;
+        stats.m_OptimizerSteps = counters.m_OptimizerSteps.Count() - optimizerSteps;
+        m_eventStats.push_back( stats );
+
         PNS::NODE* node = nullptr;
 
 #if 0
@@ -24,6 +24,7 @@
 #define __PNS_LOG_PLAYER_H
 
 #include <map>
+#include <vector>
 #include <pcbnew/board.h>
 
 #include <router/pns_routing_settings.h>
@@ -79,6 +80,17 @@ private:
 class PNS_LOG_PLAYER
 {
 public:
+    /**
+     * Router work done for a single replayed event.
+     */
+    struct EVENT_STATS
+    {
+        PNS::LOGGER::EVENT_TYPE m_Type;
+        double                  m_TimeUs;           ///< time spent in the router
+        unsigned long long      m_NodeBranches;
+        unsigned long long      m_OptimizerSteps;
+    };
+
     PNS_LOG_PLAYER();
     ~PNS_LOG_PLAYER();
 
@@ -91,6 +103,14 @@ public:
 
     void SetTimeLimit( uint64_t microseconds ) { m_timeLimitUs = microseconds; }
 
+    /**
+     * Enable or disable the collection of router debug output during replay (enabled by default).
+     * Benchmarks turn it off as it is far slower than the routing itself.
+     */
+    void SetDebugEnabled( bool aEnabled ) { m_debugEnabled = aEnabled; }
+
+    const std::vector<EVENT_STATS>& GetEventStats() const { return m_eventStats; }
+
     bool CompareResults( PNS_LOG_FILE* aLog );
     const PNS_LOG_FILE::COMMIT_STATE GetRouterUpdatedItems();
 
@@ -104,6 +124,9 @@ private:
     std::unique_ptr<PNS::ROUTER>          m_router;
     uint64_t m_timeLimitUs;
     REPORTER* m_reporter;
+    bool      m_debugEnabled;
+
+    std::vector<EVENT_STATS>              m_eventStats;
 };
 
 #endif
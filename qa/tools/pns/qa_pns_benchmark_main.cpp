@@ -0,0 +1,386 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Replays recorded router sessions and reports how long the router took to handle each event,
+ * along with the number of node branches and optimizer steps it needed.  The results can be
+ * saved as a baseline and later runs compared against it, failing when a session got slower or
+ * needed more work than the baseline allows.
+ *
+ * The event counts are deterministic; the latencies are the fastest of several replays of each
+ * session to keep the timer noise down.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <wx/cmdline.h>
+#include <wx/textfile.h>
+
+#include <reporter.h>
+#include <qa_utils/utility_program.h>
+#include <pcbnew_utils/board_file_utils.h>
+
+#include "pns_log_file.h"
+#include "pns_log_player.h"
+
+
+enum PNS_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULT_MISMATCH,
+    REGRESSION
+};
+
+
+/// Latency differences below this are put down to timer noise when comparing with a baseline
+static const double LATENCY_SLACK_US = 50.0;
+
+
+struct SESSION_RESULT
+{
+    size_t             m_Events = 0;
+    double             m_P50Us = 0.0;
+    double             m_P90Us = 0.0;
+    double             m_P99Us = 0.0;
+    double             m_MaxUs = 0.0;
+    unsigned long long m_NodeBranches = 0;
+    unsigned long long m_OptimizerSteps = 0;
+};
+
+
+static double percentile( const std::vector<double>& aSorted, double aPercent )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    size_t rank = (size_t) std::ceil( aPercent / 100.0 * aSorted.size() );
+
+    return aSorted[ std::clamp<size_t>( rank, 1, aSorted.size() ) - 1 ];
+}
+
+
+/**
+ * Replay the session logged in \a aLogPath \a aRepeat times.
+ *
+ * @return false if the log could not be loaded.
+ */
+static bool runSession( const wxString& aLogPath, long aRepeat, SESSION_RESULT& aResult,
+                        bool& aResultsMatch )
+{
+    std::vector<double> fastest;
+
+    aResultsMatch = true;
+
+    for( long run = 0; run < aRepeat; ++run )
+    {
+        // A fresh log and player for every run: the player's router can only replay once
+        PNS_LOG_FILE   logFile;
+        PNS_LOG_PLAYER player;
+
+        if( !logFile.Load( wxFileName( aLogPath ), &NULL_REPORTER::GetInstance() ) )
+            return false;
+
+        player.SetDebugEnabled( false );
+        player.ReplayLog( &logFile, 0 );
+
+        const std::vector<PNS_LOG_PLAYER::EVENT_STATS>& stats = player.GetEventStats();
+
+        if( run == 0 )
+        {
+            aResultsMatch = player.CompareResults( &logFile );
+            fastest.resize( stats.size() );
+
+            for( size_t ii = 0; ii < stats.size(); ++ii )
+            {
+                fastest[ii] = stats[ii].m_TimeUs;
+                aResult.m_NodeBranches += stats[ii].m_NodeBranches;
+                aResult.m_OptimizerSteps += stats[ii].m_OptimizerSteps;
+            }
+        }
+        else
+        {
+            for( size_t ii = 0; ii < stats.size() && ii < fastest.size(); ++ii )
+                fastest[ii] = std::min( fastest[ii], stats[ii].m_TimeUs );
+        }
+    }
+
+    std::sort( fastest.begin(), fastest.end() );
+
+    aResult.m_Events = fastest.size();
+    aResult.m_P50Us = percentile( fastest, 50.0 );
+    aResult.m_P90Us = percentile( fastest, 90.0 );
+    aResult.m_P99Us = percentile( fastest, 99.0 );
+    aResult.m_MaxUs = fastest.empty() ? 0.0 : fastest.back();
+
+    return true;
+}
+
+
+/**
+ * Baseline files hold one line per session: the session name followed by the fields of its
+ * SESSION_RESULT.  Lines starting with '#' are comments.
+ */
+static bool readBaseline( const wxString& aFileName, std::map<wxString, SESSION_RESULT>& aBaseline )
+{
+    std::ifstream file( aFileName.fn_str() );
+
+    if( !file )
+        return false;
+
+    std::string line;
+
+    while( std::getline( file, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+
+        std::istringstream str( line );
+        std::string        name;
+        SESSION_RESULT     result;
+
+        if( str >> name >> result.m_Events >> result.m_P50Us >> result.m_P90Us >> result.m_P99Us
+                >> result.m_MaxUs >> result.m_NodeBranches >> result.m_OptimizerSteps )
+        {
+            aBaseline[ wxString::FromUTF8( name.c_str() ) ] = result;
+        }
+    }
+
+    return true;
+}
+
+
+static bool writeBaseline( const wxString& aFileName,
+                           const std::vector<std::pair<wxString, SESSION_RESULT>>& aResults )
+{
+    std::ofstream file( aFileName.fn_str() );
+
+    if( !file )
+        return false;
+
+    file << "# session events p50_us p90_us p99_us max_us node_branches optimizer_steps\n";
+
+    for( const auto& [ name, result ] : aResults )
+    {
+        file << name.ToStdString() << " " << result.m_Events << " " << result.m_P50Us << " "
+             << result.m_P90Us << " " << result.m_P99Us << " " << result.m_MaxUs << " "
+             << result.m_NodeBranches << " " << result.m_OptimizerSteps << "\n";
+    }
+
+    return file.good();
+}
+
+
+/**
+ * Compare \a aResult with \a aBaseline, reporting anything which is more than \a aThreshold
+ * percent worse.
+ *
+ * @return true if there is no regression.
+ */
+static bool checkRegression( const wxString& aName, const SESSION_RESULT& aResult,
+                             const SESSION_RESULT& aBaseline, double aThreshold )
+{
+    double factor = 1.0 + aThreshold / 100.0;
+    bool   ok = true;
+
+    auto checkLatency =
+            [&]( const char* aWhat, double aValue, double aBaselineValue )
+            {
+                if( aValue > aBaselineValue * factor && aValue - aBaselineValue > LATENCY_SLACK_US )
+                {
+                    printf( "REGRESSION %s: %s latency %.1fus, baseline %.1fus\n",
+                            (const char*) aName.c_str(), aWhat, aValue, aBaselineValue );
+                    ok = false;
+                }
+            };
+
+    auto checkCount =
+            [&]( const char* aWhat, unsigned long long aValue, unsigned long long aBaselineValue )
+            {
+                if( aValue > aBaselineValue * factor )
+                {
+                    printf( "REGRESSION %s: %llu %s, baseline %llu\n",
+                            (const char*) aName.c_str(), aValue, aWhat, aBaselineValue );
+                    ok = false;
+                }
+            };
+
+    checkLatency( "p50", aResult.m_P50Us, aBaseline.m_P50Us );
+    checkLatency( "p90", aResult.m_P90Us, aBaseline.m_P90Us );
+    checkLatency( "p99", aResult.m_P99Us, aBaseline.m_P99Us );
+    checkCount( "node branches", aResult.m_NodeBranches, aBaseline.m_NodeBranches );
+    checkCount( "optimizer steps", aResult.m_OptimizerSteps, aBaseline.m_OptimizerSteps );
+
+    return ok;
+}
+
+
+/**
+ * @return the names of the sessions listed in the tests.lst file of \a aCorpusDir.
+ */
+static std::vector<wxString> readSessionList( const wxString& aCorpusDir )
+{
+    std::vector<wxString> sessions;
+    wxTextFile            fp( aCorpusDir + wxT( "/tests.lst" ) );
+
+    if( !fp.Open() )
+        return sessions;
+
+    for( size_t ii = 0; ii < fp.GetLineCount(); ++ii )
+    {
+        wxString line = fp.GetLine( ii );
+        line.Trim().Trim( false );
+
+        if( !line.IsEmpty() )
+            sessions.push_back( line );
+    }
+
+    return sessions;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "c", "corpus", "directory of recorded sessions (default: the router "
+            "regression tests)", wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "r", "repeat", "number of times to replay each session (default 5)",
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "b", "baseline", "compare the results with this baseline file",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "t", "threshold", "allowed regression in percent (default 20)",
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, "s", "save", "save the results as a baseline file",
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, "session (default: all sessions in the corpus)",
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+int main( int argc, char* argv[] )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "Replays recorded router sessions (a directory holding pns.log, "
+                            "pns.dump, pns.settings and pns.kicad_pro each) and reports the "
+                            "router latency per event." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString corpusDir = KI_TEST::GetPcbnewTestDataDir() + std::string( "/pns_regressions" );
+    long     repeat = 5;
+    double   threshold = 20.0;
+    wxString baselineFile;
+    wxString saveFile;
+
+    cl_parser.Found( "corpus", &corpusDir );
+    cl_parser.Found( "repeat", &repeat );
+    cl_parser.Found( "threshold", &threshold );
+    repeat = std::max( 1L, repeat );
+
+    std::map<wxString, SESSION_RESULT> baseline;
+
+    if( cl_parser.Found( "baseline", &baselineFile ) && !readBaseline( baselineFile, baseline ) )
+    {
+        std::cerr << "Failed to read baseline '" << baselineFile.ToStdString() << "'" << std::endl;
+        return PNS_BENCHMARK_RET_CODES::LOAD_FAILED;
+    }
+
+    std::vector<wxString> sessions;
+
+    for( size_t ii = 0; ii < cl_parser.GetParamCount(); ++ii )
+        sessions.push_back( cl_parser.GetParam( ii ) );
+
+    if( sessions.empty() )
+        sessions = readSessionList( corpusDir );
+
+    if( sessions.empty() )
+    {
+        std::cerr << "No sessions found in '" << corpusDir.ToStdString() << "'" << std::endl;
+        return PNS_BENCHMARK_RET_CODES::LOAD_FAILED;
+    }
+
+    std::vector<std::pair<wxString, SESSION_RESULT>> results;
+    int                                               ret = KI_TEST::RET_CODES::OK;
+
+    for( const wxString& name : sessions )
+    {
+        SESSION_RESULT result;
+        bool           resultsMatch;
+
+        if( !runSession( corpusDir + wxT( "/" ) + name + wxT( "/pns" ), repeat, result,
+                         resultsMatch ) )
+        {
+            std::cerr << "Failed to load session '" << name.ToStdString() << "'" << std::endl;
+            return PNS_BENCHMARK_RET_CODES::LOAD_FAILED;
+        }
+
+        results.emplace_back( name, result );
+
+        if( !resultsMatch )
+        {
+            printf( "MISMATCH %s: replay results differ from the recorded ones\n",
+                    (const char*) name.c_str() );
+            ret = PNS_BENCHMARK_RET_CODES::RESULT_MISMATCH;
+        }
+
+        auto it = baseline.find( name );
+
+        if( it != baseline.end() && !checkRegression( name, result, it->second, threshold )
+                && ret == KI_TEST::RET_CODES::OK )
+        {
+            ret = PNS_BENCHMARK_RET_CODES::REGRESSION;
+        }
+    }
+
+    printf( "%-30s %7s %10s %10s %10s %10s %10s %10s\n", "session", "events", "p50 [us]",
+            "p90 [us]", "p99 [us]", "max [us]", "branches", "opt steps" );
+
+    for( const auto& [ name, result ] : results )
+    {
+        printf( "%-30s %7zu %10.1f %10.1f %10.1f %10.1f %10llu %10llu\n",
+                (const char*) name.c_str(), result.m_Events, result.m_P50Us, result.m_P90Us,
+                result.m_P99Us, result.m_MaxUs, result.m_NodeBranches, result.m_OptimizerSteps );
+    }
+
+    if( cl_parser.Found( "save", &saveFile ) && !writeBaseline( saveFile, results ) )
+    {
+        std::cerr << "Failed to write baseline '" << saveFile.ToStdString() << "'" << std::endl;
+        return PNS_BENCHMARK_RET_CODES::LOAD_FAILED;
+    }
+
+    return ret;
+}
@@ -0,0 +1,215 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <3d_rendering/raytracing/accelerators/bvh_packet_simd.h>
+#include <3d_rendering/raytracing/shapes3D/bbox_3d.h>
+#include <3d_rendering/raytracing/shapes3D/triangle_3d.h>
+
+#include <limits>
+#include <random>
+
+
+struct PACKET_SIMD_FIXTURE
+{
+    PACKET_SIMD_FIXTURE() :
+            m_rng( 1234 )
+    { }
+
+    float randFloat( float aMin, float aMax )
+    {
+        return std::uniform_real_distribution<float>( aMin, aMax )( m_rng );
+    }
+
+    SFVEC3F randVector( float aMin, float aMax )
+    {
+        return SFVEC3F( randFloat( aMin, aMax ), randFloat( aMin, aMax ),
+                        randFloat( aMin, aMax ) );
+    }
+
+    /**
+     * Make a packet of random rays, some of them along an axis or a plane, and some of them
+     * with a hit already.
+     */
+    void initRays()
+    {
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            SFVEC3F dir = randVector( -1.0f, 1.0f );
+
+            for( unsigned int axis = 0; axis < 3; ++axis )
+            {
+                if( randFloat( 0.0f, 1.0f ) < 0.05f )
+                    dir[axis] = 0.0f;
+            }
+
+            if( glm::length( dir ) < 0.01f )
+                dir = SFVEC3F( 0.0f, 0.0f, 1.0f );
+
+            m_rays[i].Init( randVector( -3.0f, 3.0f ), glm::normalize( dir ) );
+
+            for( unsigned int axis = 0; axis < 3; ++axis )
+            {
+                m_soa.m_origin[axis][i] = m_rays[i].m_Origin[axis];
+                m_soa.m_dir[axis][i] = m_rays[i].m_Dir[axis];
+                m_soa.m_invDir[axis][i] = m_rays[i].m_InvDir[axis];
+            }
+
+            m_soa.m_tHit[i] = randFloat( 0.0f, 1.0f ) < 0.3f
+                                      ? std::numeric_limits<float>::infinity()
+                                      : randFloat( 0.0f, 6.0f );
+        }
+    }
+
+    std::vector<RAYPACKET_KERNEL> supportedKernels() const
+    {
+        std::vector<RAYPACKET_KERNEL> kernels;
+
+        for( RAYPACKET_KERNEL kernel : { RAYPACKET_KERNEL::SCALAR, RAYPACKET_KERNEL::SSE2,
+                                         RAYPACKET_KERNEL::AVX2 } )
+        {
+            if( IsRayPacketKernelSupported( kernel ) )
+                kernels.push_back( kernel );
+        }
+
+        return kernels;
+    }
+
+    std::mt19937  m_rng;
+    RAY           m_rays[RAYPACKET_RAYS_PER_PACKET];
+    RAYPACKET_SOA m_soa;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PacketSimd, PACKET_SIMD_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( BBox )
+{
+    // BBOX_3D::Intersect() uses slopes rather than slabs, so the two tests round differently
+    // for rays grazing the box.  Away from its faces, the kernels must report every hit closer
+    // than the current hit, and no other one.
+    const float margin = 1.0e-3f;
+
+    for( RAYPACKET_KERNEL kernel : supportedKernels() )
+    {
+        BOOST_TEST_CONTEXT( "Kernel " << (int) kernel )
+        {
+            int hits = 0;
+            int missed = 0;
+            int extra = 0;
+
+            for( int ii = 0; ii < 2000; ++ii )
+            {
+                initRays();
+
+                SFVEC3F center = randVector( -2.0f, 2.0f );
+                SFVEC3F size = randVector( 0.01f, 1.5f );
+                BBOX_3D bbox( center - size, center + size );
+                BBOX_3D inner( center - size + margin, center + size - margin );
+                BBOX_3D outer( center - size - margin, center + size + margin );
+
+                for( unsigned int group = 0; group < RAYPACKET_RAYS_PER_PACKET;
+                     group += RAYPACKET_SIMD_WIDTH )
+                {
+                    unsigned int mask = IntersectBBoxPacket8( m_soa, group, bbox, kernel );
+
+                    for( unsigned int lane = 0; lane < RAYPACKET_SIMD_WIDTH; ++lane )
+                    {
+                        unsigned int i = group + lane;
+                        const RAY&   ray = m_rays[i];
+                        float        t;
+                        bool         reported = ( mask >> lane ) & 1;
+
+                        if( inner.Intersect( ray, &t ) && t < m_soa.m_tHit[i] )
+                        {
+                            hits++;
+                            missed += !reported;
+                        }
+                        else if( !( outer.Intersect( ray, &t ) && t < m_soa.m_tHit[i] ) )
+                        {
+                            extra += reported;
+                        }
+                    }
+                }
+            }
+
+            BOOST_CHECK_GT( hits, 0 );
+            BOOST_CHECK_EQUAL( missed, 0 );
+            BOOST_CHECK_EQUAL( extra, 0 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Triangle )
+{
+    // The kernels must report every hit TRIANGLE::Intersect() finds closer than the current
+    // hit.  They also report the back faces, which TRIANGLE::Intersect() rejects.
+    for( RAYPACKET_KERNEL kernel : supportedKernels() )
+    {
+        BOOST_TEST_CONTEXT( "Kernel " << (int) kernel )
+        {
+            int hits = 0;
+            int missed = 0;
+
+            for( int ii = 0; ii < 2000; ++ii )
+            {
+                initRays();
+
+                TRIANGLE triangle( randVector( -2.0f, 2.0f ), randVector( -2.0f, 2.0f ),
+                                   randVector( -2.0f, 2.0f ) );
+                TRIANGLE_PACKET_DATA data;
+
+                triangle.GetPacketData( data );
+
+                for( unsigned int group = 0; group < RAYPACKET_RAYS_PER_PACKET;
+                     group += RAYPACKET_SIMD_WIDTH )
+                {
+                    unsigned int mask = IntersectTrianglePacket8( m_soa, group, data, kernel );
+
+                    for( unsigned int lane = 0; lane < RAYPACKET_SIMD_WIDTH; ++lane )
+                    {
+                        unsigned int i = group + lane;
+                        HITINFO      hitInfo;
+
+                        hitInfo.m_tHit = m_soa.m_tHit[i];
+
+                        bool hit = triangle.Intersect( m_rays[i], hitInfo );
+                        bool reported = ( mask >> lane ) & 1;
+
+                        hits += hit;
+                        missed += hit && !reported;
+                    }
+                }
+            }
+
+            BOOST_CHECK_GT( hits, 0 );
+            BOOST_CHECK_EQUAL( missed, 0 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,320 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <3d_cache/3d_mesh_cache.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+
+struct MESH_CACHE_FIXTURE
+{
+    MESH_CACHE_FIXTURE()
+    {
+        wxFileName dir;
+        dir.AssignDir( wxFileName::GetTempDir() );
+        dir.AppendDir( wxString::Format( wxT( "qa_mesh_cache_%lu" ), wxGetProcessId() ) );
+        m_dir = dir.GetPath() + wxFileName::GetPathSeparator();
+
+        wxFileName::Mkdir( m_dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+        m_positions = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+        m_normals = { { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 }, { 1, 0, 0 } };
+        m_colors = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 1, 1 } };
+        m_indices = { 0, 1, 2, 0, 2, 3 };
+
+        m_materials.resize( 2 );
+
+        for( size_t ii = 0; ii < m_materials.size(); ++ii )
+        {
+            SMATERIAL& mat = m_materials[ii];
+
+            mat.m_Ambient = SFVEC3F( 0.1f * ii );
+            mat.m_Diffuse = SFVEC3F( 0.2f, 0.3f, 0.4f );
+            mat.m_Emissive = SFVEC3F( 0.0f );
+            mat.m_Specular = SFVEC3F( 0.5f );
+            mat.m_Shininess = 0.25f;
+            mat.m_Transparency = 0.5f * ii;
+        }
+
+        // One mesh with normals and colors and one with positions and indices only
+        m_meshes.resize( 2 );
+
+        for( SMESH& mesh : m_meshes )
+        {
+            mesh.m_VertexSize = m_positions.size();
+            mesh.m_Positions = m_positions.data();
+            mesh.m_Normals = nullptr;
+            mesh.m_Texcoords = nullptr;
+            mesh.m_Color = nullptr;
+            mesh.m_FaceIdxSize = m_indices.size();
+            mesh.m_FaceIdx = m_indices.data();
+            mesh.m_MaterialIdx = 0;
+        }
+
+        m_meshes[0].m_Normals = m_normals.data();
+        m_meshes[0].m_Color = m_colors.data();
+        m_meshes[1].m_MaterialIdx = 1;
+
+        m_model.m_MeshesSize = m_meshes.size();
+        m_model.m_Meshes = m_meshes.data();
+        m_model.m_MaterialsSize = m_materials.size();
+        m_model.m_Materials = m_materials.data();
+    }
+
+    ~MESH_CACHE_FIXTURE()
+    {
+        wxFileName::Rmdir( m_dir, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    std::string readFile( const wxString& aFileName )
+    {
+        wxFFile file( aFileName, wxT( "rb" ) );
+
+        BOOST_REQUIRE( file.IsOpened() );
+
+        std::string data( file.Length(), '\0' );
+
+        BOOST_REQUIRE_EQUAL( file.Read( data.data(), data.size() ), data.size() );
+        return data;
+    }
+
+    void writeFile( const wxString& aFileName, const std::string& aData )
+    {
+        wxFFile file( aFileName, wxT( "wb" ) );
+
+        BOOST_REQUIRE( file.IsOpened() );
+        BOOST_REQUIRE_EQUAL( file.Write( aData.data(), aData.size() ), aData.size() );
+    }
+
+    template <typename T>
+    void checkArray( const T* aRead, const T* aWritten, size_t aCount )
+    {
+        if( !aWritten )
+        {
+            BOOST_CHECK( aRead == nullptr );
+            return;
+        }
+
+        BOOST_REQUIRE( aRead != nullptr );
+        BOOST_CHECK( memcmp( aRead, aWritten, aCount * sizeof( T ) ) == 0 );
+    }
+
+    wxString                  m_dir;
+    std::vector<SFVEC3F>      m_positions;
+    std::vector<SFVEC3F>      m_normals;
+    std::vector<SFVEC3F>      m_colors;
+    std::vector<unsigned int> m_indices;
+    std::vector<SMATERIAL>    m_materials;
+    std::vector<SMESH>        m_meshes;
+    S3DMODEL                  m_model;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( MeshCache, MESH_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    wxString fileName = m_dir + wxT( "model.3dm" );
+
+    BOOST_REQUIRE( WriteMeshCache( fileName, m_model ) );
+
+    std::unique_ptr<MESH_CACHE_MODEL> cache = ReadMeshCache( fileName );
+    BOOST_REQUIRE( cache );
+
+    const S3DMODEL* model = cache->GetModel();
+
+    BOOST_REQUIRE_EQUAL( model->m_MaterialsSize, m_model.m_MaterialsSize );
+    checkArray( model->m_Materials, m_model.m_Materials, m_model.m_MaterialsSize );
+
+    BOOST_REQUIRE_EQUAL( model->m_MeshesSize, m_model.m_MeshesSize );
+
+    for( unsigned int ii = 0; ii < model->m_MeshesSize; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Mesh " << ii )
+        {
+            const SMESH& read = model->m_Meshes[ii];
+            const SMESH& written = m_model.m_Meshes[ii];
+
+            BOOST_CHECK_EQUAL( read.m_MaterialIdx, written.m_MaterialIdx );
+            BOOST_REQUIRE_EQUAL( read.m_VertexSize, written.m_VertexSize );
+            BOOST_REQUIRE_EQUAL( read.m_FaceIdxSize, written.m_FaceIdxSize );
+
+            checkArray( read.m_Positions, written.m_Positions, written.m_VertexSize );
+            checkArray( read.m_Normals, written.m_Normals, written.m_VertexSize );
+            checkArray( read.m_Texcoords, written.m_Texcoords, written.m_VertexSize );
+            checkArray( read.m_Color, written.m_Color, written.m_VertexSize );
+            checkArray( read.m_FaceIdx, written.m_FaceIdx, written.m_FaceIdxSize );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( EmptyModel )
+{
+    wxString fileName = m_dir + wxT( "empty.3dm" );
+    S3DMODEL empty = { 0, nullptr, 0, nullptr };
+
+    BOOST_REQUIRE( WriteMeshCache( fileName, empty ) );
+
+    std::unique_ptr<MESH_CACHE_MODEL> cache = ReadMeshCache( fileName );
+    BOOST_REQUIRE( cache );
+    BOOST_CHECK_EQUAL( cache->GetModel()->m_MeshesSize, 0u );
+    BOOST_CHECK_EQUAL( cache->GetModel()->m_MaterialsSize, 0u );
+}
+
+
+BOOST_AUTO_TEST_CASE( MissingFile )
+{
+    BOOST_CHECK( !ReadMeshCache( m_dir + wxT( "missing.3dm" ) ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Truncated )
+{
+    wxString fileName = m_dir + wxT( "model.3dm" );
+
+    BOOST_REQUIRE( WriteMeshCache( fileName, m_model ) );
+
+    std::string data = readFile( fileName );
+
+    for( size_t length = 0; length < data.size(); ++length )
+    {
+        BOOST_TEST_CONTEXT( "Length " << length )
+        {
+            writeFile( fileName, data.substr( 0, length ) );
+            BOOST_CHECK( !ReadMeshCache( fileName ) );
+        }
+    }
+
+    // Trailing data is as bad as missing data
+    writeFile( fileName, data + std::string( 4, '\0' ) );
+    BOOST_CHECK( !ReadMeshCache( fileName ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Corrupt )
+{
+    wxString fileName = m_dir + wxT( "model.3dm" );
+
+    BOOST_REQUIRE( WriteMeshCache( fileName, m_model ) );
+
+    const std::string data = readFile( fileName );
+    std::string       bad;
+
+    // Magic
+    bad = data;
+    bad[0] = 'X';
+    writeFile( fileName, bad );
+    BOOST_CHECK( !ReadMeshCache( fileName ) );
+
+    // Version
+    bad = data;
+    bad[8] ^= 0x7f;
+    writeFile( fileName, bad );
+    BOOST_CHECK( !ReadMeshCache( fileName ) );
+
+    // A mesh count too large for the file
+    bad = data;
+    memset( &bad[16], 0xff, sizeof( uint32_t ) );
+    writeFile( fileName, bad );
+    BOOST_CHECK( !ReadMeshCache( fileName ) );
+
+    // A face index past the vertices; the indices of the last mesh end the file
+    bad = data;
+    uint32_t index = m_positions.size();
+    memcpy( &bad[bad.size() - sizeof( index )], &index, sizeof( index ) );
+    writeFile( fileName, bad );
+    BOOST_CHECK( !ReadMeshCache( fileName ) );
+
+    // The file is still readable when it is intact
+    writeFile( fileName, data );
+    BOOST_CHECK( ReadMeshCache( fileName ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( ModelFileStamp )
+{
+    wxString         stampFile = m_dir + wxT( "stamp.3di" );
+    wxString         modelFile = wxT( "/models/part.step" );
+    MODEL_FILE_STAMP stamp;
+
+    stamp.m_Size = 12345;
+    stamp.m_ModTime = 1690000000;
+
+    for( size_t ii = 0; ii < sizeof( stamp.m_SHA1 ); ++ii )
+        stamp.m_SHA1[ii] = ii * 7;
+
+    WriteModelFileStamp( stampFile, modelFile, stamp );
+
+    MODEL_FILE_STAMP current;
+    current.m_Size = stamp.m_Size;
+    current.m_ModTime = stamp.m_ModTime;
+
+    BOOST_REQUIRE( ReadModelFileStamp( stampFile, modelFile, current ) );
+    BOOST_CHECK( memcmp( current.m_SHA1, stamp.m_SHA1, sizeof( stamp.m_SHA1 ) ) == 0 );
+
+    // Another model file whose name hashed to the same stamp file
+    BOOST_CHECK( !ReadModelFileStamp( stampFile, wxT( "/models/other.step" ), current ) );
+
+    // The model file changed since it was stamped
+    MODEL_FILE_STAMP stale;
+
+    stale.m_Size = stamp.m_Size + 1;
+    stale.m_ModTime = stamp.m_ModTime;
+    BOOST_CHECK( !ReadModelFileStamp( stampFile, modelFile, stale ) );
+
+    stale.m_Size = stamp.m_Size;
+    stale.m_ModTime = stamp.m_ModTime + 1;
+    BOOST_CHECK( !ReadModelFileStamp( stampFile, modelFile, stale ) );
+
+    // The hash of a stale stamp is not used
+    for( unsigned char byte : stale.m_SHA1 )
+        BOOST_CHECK_EQUAL( byte, 0 );
+
+    // Truncated stamps
+    const std::string data = readFile( stampFile );
+
+    for( size_t length = 0; length < data.size(); ++length )
+    {
+        BOOST_TEST_CONTEXT( "Length " << length )
+        {
+            writeFile( stampFile, data.substr( 0, length ) );
+            BOOST_CHECK( !ReadModelFileStamp( stampFile, modelFile, current ) );
+        }
+    }
+
+    BOOST_CHECK( !ReadModelFileStamp( m_dir + wxT( "missing.3di" ), modelFile, current ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for DSNLEXER and its keyword map
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+// Code under test
+#include <dsnlexer.h>
+
+
+static const KEYWORD testKeywords[] = {
+    { "at", 0 },
+    { "footprint", 1 },
+    { "layer", 2 },
+    { "net", 3 },
+    { "pad", 4 },
+    { "uuid", 5 }
+};
+
+static const KEYWORD_MAP testKeywordMap( { { "at", 0 },
+                                           { "footprint", 1 },
+                                           { "layer", 2 },
+                                           { "net", 3 },
+                                           { "pad", 4 },
+                                           { "uuid", 5 } } );
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+BOOST_AUTO_TEST_CASE( KeywordMap )
+{
+    for( const KEYWORD& keyword : testKeywords )
+        BOOST_CHECK_EQUAL( testKeywordMap.Find( keyword.name, strlen( keyword.name ) ),
+                           keyword.token );
+
+    for( const char* text : { "", "a", "ats", "Footprint", "pads", "uui", "layers" } )
+        BOOST_CHECK_EQUAL( testKeywordMap.Find( text, strlen( text ) ), -1 );
+
+    // Keywords followed by more text; the length decides
+    BOOST_CHECK_EQUAL( testKeywordMap.Find( "netclass", 3 ), 3 );
+    BOOST_CHECK_EQUAL( testKeywordMap.Find( "netclass", 5 ), -1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( LargeKeywordMap )
+{
+    std::vector<std::string> names;
+
+    for( int ii = 0; ii < 2000; ++ii )
+        names.push_back( "keyword_" + std::to_string( ii ) );
+
+    std::vector<std::pair<const char*, int>> entries;
+
+    for( size_t ii = 0; ii < names.size(); ++ii )
+        entries.emplace_back( names[ii].c_str(), (int) ii );
+
+    KEYWORD_MAP map( entries );
+
+    BOOST_CHECK_EQUAL( map.size(), names.size() );
+
+    for( size_t ii = 0; ii < names.size(); ++ii )
+        BOOST_CHECK_EQUAL( map.Find( names[ii].c_str(), names[ii].size() ), (int) ii );
+
+    BOOST_CHECK_EQUAL( map.Find( "keyword_2000", 12 ), -1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( InPlaceReaders )
+{
+    // The input ends in an unterminated string, with no newline, so the escape at the very
+    // end must not read past the end of the input
+    const std::string text = "(footprint \"R\\x41\\101\" (layer F.Cu)\n"
+                             "  (pad 1 (at 1.5 -2) (net 3 \"GND\"))\n"
+                             "\n"
+                             "  (uuid 1234-abcd) \"\\x4";
+
+    STRING_LINE_READER stringReader( text, wxT( "test" ) );
+    BUFFER_LINE_READER bufferReader( text.data(), text.size(), wxT( "test" ) );
+    DSNLEXER           stringLexer( testKeywords, 6, &testKeywordMap, &stringReader );
+    DSNLEXER           bufferLexer( testKeywords, 6, &testKeywordMap, &bufferReader );
+
+    const std::vector<std::pair<int, std::string>> expected = {
+        { DSN_LEFT, "(" }, { 1, "footprint" }, { DSN_STRING, "RAA" },
+        { DSN_LEFT, "(" }, { 2, "layer" }, { DSN_SYMBOL, "F.Cu" }, { DSN_RIGHT, ")" },
+        { DSN_LEFT, "(" }, { 4, "pad" }, { DSN_NUMBER, "1" },
+        { DSN_LEFT, "(" }, { 0, "at" }, { DSN_NUMBER, "1.5" }, { DSN_NUMBER, "-2" },
+        { DSN_RIGHT, ")" },
+        { DSN_LEFT, "(" }, { 3, "net" }, { DSN_NUMBER, "3" }, { DSN_STRING, "GND" },
+        { DSN_RIGHT, ")" }, { DSN_RIGHT, ")" },
+        { DSN_LEFT, "(" }, { 5, "uuid" }, { DSN_SYMBOL, "1234-abcd" }, { DSN_RIGHT, ")" }
+    };
+
+    for( DSNLEXER* lexer : { &stringLexer, &bufferLexer } )
+    {
+        for( const std::pair<int, std::string>& token : expected )
+        {
+            BOOST_CHECK_EQUAL( lexer->NextTok(), token.first );
+            BOOST_CHECK_EQUAL( lexer->CurStr(), token.second );
+
+            if( token.second == "pad" )
+            {
+                BOOST_CHECK_EQUAL( lexer->CurLineNumber(), 2 );
+                BOOST_CHECK_EQUAL( std::string( lexer->CurLine() ),
+                                   "  (pad 1 (at 1.5 -2) (net 3 \"GND\"))\n" );
+            }
+        }
+
+        BOOST_CHECK_THROW( lexer->NextTok(), IO_ERROR );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( InPlaceReadersMaxLineLength )
+{
+    // Reading in place must enforce the same line length limit as ReadLine()
+    const std::string text = "(short)\n(" + std::string( LINE_READER_LINE_DEFAULT_MAX, 'x' )
+                             + ")\n";
+
+    STRING_LINE_READER stringReader( text, wxT( "test" ) );
+    BUFFER_LINE_READER bufferReader( text.data(), text.size(), wxT( "test" ) );
+
+    for( LINE_READER* reader : { (LINE_READER*) &stringReader, (LINE_READER*) &bufferReader } )
+    {
+        unsigned length = 0;
+
+        reader->ReadLineInPlace( &length );
+        BOOST_CHECK_EQUAL( length, 8 );
+
+        BOOST_CHECK_THROW( reader->ReadLineInPlace( &length ), IO_ERROR );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for ParallelFor()
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+// Code under test
+#include <thread_pool.h>
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( ParallelForTests )
+
+
+BOOST_AUTO_TEST_CASE( EachItemOnce )
+{
+    for( size_t count : { 0, 1, 2, 7, 1000, 100003 } )
+    {
+        for( size_t minBlock : { 1, 3, 64 } )
+        {
+            for( bool withCallback : { false, true } )
+            {
+                BOOST_TEST_CONTEXT( "count " << count << " block " << minBlock
+                                             << " callback " << withCallback )
+                {
+                    std::vector<std::atomic<int>> hits( count );
+                    std::function<bool( size_t )> callback;
+
+                    if( withCallback )
+                        callback = []( size_t aDone ) { return true; };
+
+                    size_t done = ParallelFor( count,
+                                               [&]( size_t aItem )
+                                               {
+                                                   hits[aItem]++;
+                                               },
+                                               callback, minBlock );
+
+                    BOOST_CHECK_EQUAL( done, count );
+
+                    size_t wrong = 0;
+
+                    for( const std::atomic<int>& hit : hits )
+                        wrong += hit != 1;
+
+                    BOOST_CHECK_EQUAL( wrong, 0 );
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Cancel )
+{
+    std::atomic<size_t> calls( 0 );
+
+    size_t done = ParallelFor( 100000,
+                               [&]( size_t )
+                               {
+                                   calls++;
+                                   std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+                               },
+                               []( size_t aDone )
+                               {
+                                   return false;
+                               } );
+
+    BOOST_CHECK_LT( done, 100000 );
+    BOOST_CHECK_EQUAL( done, calls.load() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    // An exception thrown by an item is rethrown by the caller once the started items are done.
+    for( bool withCallback : { false, true } )
+    {
+        std::function<bool( size_t )> callback;
+
+        if( withCallback )
+            callback = []( size_t ) { return true; };
+
+        BOOST_CHECK_THROW( ParallelFor( 10000,
+                                        []( size_t aItem )
+                                        {
+                                            if( aItem == 100 )
+                                                throw std::runtime_error( "item failed" );
+                                        },
+                                        callback ),
+                           std::runtime_error );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( NestedInPool )
+{
+    // A ParallelFor() run from a pool thread must finish even if the pool is otherwise busy.
+    std::future<size_t> result = GetKiCadThreadPool().submit(
+            []()
+            {
+                return ParallelFor( 1000, []( size_t ) {}, []( size_t ) { return true; } );
+            } );
+
+    BOOST_CHECK_EQUAL( result.get(), 1000 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,249 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one at
+ * http://www.gnu.org/licenses/
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <schematic_utils/schematic_file_util.h>
+
+#include <connection_graph.h>
+#include <schematic.h>
+#include <sch_label.h>
+#include <sch_line.h>
+#include <sch_pin.h>
+#include <sch_screen.h>
+#include <sch_symbol.h>
+#include <settings/settings_manager.h>
+#include <locale_io.h>
+
+
+struct INCREMENTAL_CONNECTIVITY_FIXTURE
+{
+    INCREMENTAL_CONNECTIVITY_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    /**
+     * @return the net name of every connectable item (and symbol pin) on every sheet, keyed by
+     *         sheet path and item uuid.
+     */
+    std::map<wxString, wxString> getNetNames()
+    {
+        std::map<wxString, wxString> names;
+
+        auto addItem =
+                [&]( SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet )
+                {
+                    SCH_CONNECTION* connection = aItem->Connection( &aSheet );
+
+                    names[ aSheet.PathAsString() + aItem->m_Uuid.AsString() ] =
+                            connection ? connection->Name() : wxString( wxEmptyString );
+                };
+
+        for( const SCH_SHEET_PATH& sheet : m_schematic->GetSheets() )
+        {
+            for( SCH_ITEM* item : sheet.LastScreen()->Items() )
+            {
+                if( !item->IsConnectable() )
+                    continue;
+
+                if( item->Type() == SCH_SYMBOL_T )
+                {
+                    for( SCH_PIN* pin : static_cast<SCH_SYMBOL*>( item )->GetPins( &sheet ) )
+                        addItem( pin, sheet );
+                }
+                else
+                {
+                    addItem( item, sheet );
+                }
+            }
+        }
+
+        return names;
+    }
+
+    /**
+     * Update the graph for the latest edit and check the result against a full recalculation.
+     */
+    void checkIncremental( const wxString& aEdit )
+    {
+        CONNECTION_GRAPH* graph = m_schematic->ConnectionGraph();
+
+        graph->Recalculate( m_schematic->GetSheets(), false );
+        std::map<wxString, wxString> incremental = getNetNames();
+
+        graph->Recalculate( m_schematic->GetSheets(), true );
+        std::map<wxString, wxString> full = getNetNames();
+
+        BOOST_CHECK_MESSAGE( incremental == full,
+                             "Incremental connectivity differs after " << aEdit.ToStdString() );
+    }
+
+    SETTINGS_MANAGER           m_settingsManager;
+    std::unique_ptr<SCHEMATIC> m_schematic;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( IncrementalConnectivity, INCREMENTAL_CONNECTIVITY_FIXTURE )
+{
+    LOCALE_IO dummy;
+
+    KI_TEST::LoadSchematic( m_settingsManager, "netlists/complex_hierarchy/complex_hierarchy",
+                            m_schematic );
+
+    SCH_SCREEN* screen = nullptr;
+    SCH_LINE*   wire = nullptr;
+    SCH_LABEL*  label = nullptr;
+
+    for( const SCH_SHEET_PATH& sheet : m_schematic->GetSheets() )
+    {
+        for( SCH_ITEM* item : sheet.LastScreen()->Items().OfType( SCH_LABEL_T ) )
+        {
+            screen = sheet.LastScreen();
+            label = static_cast<SCH_LABEL*>( item );
+            break;
+        }
+
+        if( !screen )
+            continue;
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_LINE_T ) )
+        {
+            if( static_cast<SCH_LINE*>( item )->IsWire() )
+            {
+                wire = static_cast<SCH_LINE*>( item );
+                break;
+            }
+        }
+
+        break;
+    }
+
+    BOOST_REQUIRE( screen && wire && label );
+
+    // Breaking a net in two
+    screen->Remove( wire );
+    checkIncremental( "removing a wire" );
+
+    screen->Append( wire );
+    checkIncremental( "restoring a wire" );
+
+    // Renaming a net, which may now be joined to another one elsewhere in the hierarchy
+    wxString oldText = label->GetText();
+
+    label->SetText( wxT( "INCREMENTAL_TEST" ) );
+    label->SetConnectivityDirty();
+    checkIncremental( "renaming a label" );
+
+    label->SetText( oldText );
+    label->SetConnectivityDirty();
+    checkIncremental( "restoring a label" );
+
+    // Moving a wire onto different items
+    screen->Remove( wire );
+    wire->Move( VECTOR2I( schIUScale.MilsToIU( 100 ), 0 ) );
+    wire->SetConnectivityDirty();
+    screen->Append( wire );
+    checkIncremental( "moving a wire" );
+
+    // The wire is no longer owned by the screen
+    screen->Remove( wire );
+    delete wire;
+    checkIncremental( "deleting a wire" );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( IncrementalConnectivityUndoRedo, INCREMENTAL_CONNECTIVITY_FIXTURE )
+{
+    LOCALE_IO dummy;
+
+    KI_TEST::LoadSchematic( m_settingsManager, "netlists/complex_hierarchy/complex_hierarchy",
+                            m_schematic );
+
+    SCH_SCREEN* screen = nullptr;
+    SCH_LINE*   wire = nullptr;
+    SCH_SYMBOL* symbol = nullptr;
+
+    for( const SCH_SHEET_PATH& sheet : m_schematic->GetSheets() )
+    {
+        screen = sheet.LastScreen();
+        wire = nullptr;
+        symbol = nullptr;
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_LINE_T ) )
+        {
+            if( static_cast<SCH_LINE*>( item )->IsWire() )
+            {
+                wire = static_cast<SCH_LINE*>( item );
+                break;
+            }
+        }
+
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_SYMBOL_T ) )
+        {
+            if( !static_cast<SCH_SYMBOL*>( item )->GetPins( &sheet ).empty() )
+            {
+                symbol = static_cast<SCH_SYMBOL*>( item );
+                break;
+            }
+        }
+
+        if( wire && symbol )
+            break;
+    }
+
+    BOOST_REQUIRE( screen && wire && symbol );
+
+    // Undo and redo swap the data of each changed item with its copy in the undo list, as
+    // SCH_EDIT_FRAME::PutDataInPreviousState() does.
+    auto swapWithCopy =
+            [&]( SCH_ITEM* aItem, SCH_ITEM* aCopy )
+            {
+                screen->Remove( aItem );
+                aItem->SwapData( aCopy );
+
+                if( aItem->Type() == SCH_SYMBOL_T )
+                    static_cast<SCH_SYMBOL*>( aItem )->UpdatePins();
+
+                aItem->SetConnectivityDirty();
+                screen->Append( aItem );
+            };
+
+    std::unique_ptr<SCH_ITEM> wireCopy( wire->Duplicate( true ) );
+    std::unique_ptr<SCH_ITEM> symbolCopy( symbol->Duplicate( true ) );
+
+    screen->Remove( wire );
+    wire->Move( VECTOR2I( schIUScale.MilsToIU( 100 ), 0 ) );
+    wire->SetConnectivityDirty();
+    screen->Append( wire );
+
+    screen->Remove( symbol );
+    symbol->Move( VECTOR2I( 0, schIUScale.MilsToIU( 200 ) ) );
+    symbol->SetConnectivityDirty();
+    screen->Append( symbol );
+
+    checkIncremental( "moving a wire and a symbol" );
+
+    swapWithCopy( wire, wireCopy.get() );
+    swapWithCopy( symbol, symbolCopy.get() );
+    checkIncremental( "undoing the moves" );
+
+    swapWithCopy( wire, wireCopy.get() );
+    swapWithCopy( symbol, symbolCopy.get() );
+    checkIncremental( "redoing the moves" );
+}
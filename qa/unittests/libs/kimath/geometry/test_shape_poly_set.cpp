@@ -16,6 +16,7 @@
  */
 
 #include <geometry/shape_poly_set.h>
+#include <convert_basic_shapes_to_polygon.h>
 #include <trigo.h>
 
 #include <qa_utils/geometry/geometry.h>
@@ -64,4 +65,119 @@ BOOST_AUTO_TEST_CASE( RemoveNullSegments )
 
 }
 
+
+BOOST_AUTO_TEST_CASE( PrimitiveBatch )
+{
+    // Merging a batch of primitives must give the same result as transforming each primitive
+    // to a polygon and simplifying the lot.
+    const int maxError = 5000;
+
+    SHAPE_POLY_SET                  expected;
+    SHAPE_POLY_SET                  batched;
+    SHAPE_POLY_SET::PRIMITIVE_BATCH batch;
+
+    expected.NewOutline();
+    expected.Append( -2000000, -2000000 );
+    expected.Append( 2000000, -2000000 );
+    expected.Append( 2000000, 2000000 );
+    expected.Append( -2000000, 2000000 );
+    batched = expected;
+
+    for( int ii = 0; ii < 20; ++ii )
+    {
+        VECTOR2I start( ii * 1500000, ( ii % 3 ) * 700000 );
+        VECTOR2I end( start.x + 1000000 + ii * 90000, start.y - 3000000 + ii * 250000 );
+        int      width = 200000 + ii * 10000;
+
+        TransformOvalToPolygon( expected, start, end, width, maxError, ERROR_OUTSIDE );
+        batch.AddSegment( start, end, width, maxError, ERROR_OUTSIDE );
+
+        // Narrow segments whose ends need more segments than their error alone requires
+        TransformOvalToPolygon( expected, start, end + VECTOR2I( 0, 400000 ), 20000, maxError,
+                                ERROR_OUTSIDE, 16 );
+        batch.AddSegment( start, end + VECTOR2I( 0, 400000 ), 20000, maxError, ERROR_OUTSIDE,
+                          16 );
+
+        TransformCircleToPolygon( expected, end, width, maxError, ERROR_OUTSIDE );
+        batch.AddCircle( end, width, maxError, ERROR_OUTSIDE );
+    }
+
+    expected.Simplify( SHAPE_POLY_SET::PM_FAST );
+    batched.BooleanAdd( batch );
+
+    BOOST_CHECK_EQUAL( batched.OutlineCount(), expected.OutlineCount() );
+    BOOST_CHECK_CLOSE( batched.Area(), expected.Area(), 0.001 );
+
+    // A segment knocked out of a larger square
+    SHAPE_POLY_SET square;
+    square.NewOutline();
+    square.Append( -5000000, -5000000 );
+    square.Append( 5000000, -5000000 );
+    square.Append( 5000000, 5000000 );
+    square.Append( -5000000, 5000000 );
+
+    SHAPE_POLY_SET knockout;
+    TransformOvalToPolygon( knockout, VECTOR2I( -2000000, -1000000 ), VECTOR2I( 2000000, 1000000 ),
+                            1000000, maxError, ERROR_OUTSIDE );
+
+    double knockoutArea = knockout.Area();
+
+    batch.Clear();
+    batch.AddSegment( VECTOR2I( -2000000, -1000000 ), VECTOR2I( 2000000, 1000000 ), 1000000,
+                      maxError, ERROR_OUTSIDE );
+    square.BooleanSubtract( batch );
+
+    BOOST_CHECK_EQUAL( square.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( square.HoleCount( 0 ), 1 );
+    BOOST_CHECK_CLOSE( square.Area(), 1e14 - knockoutArea, 0.001 );
+}
+
+
+BOOST_AUTO_TEST_CASE( LODApproximation )
+{
+    // A finely approximated disc with a grid of small and large holes
+    SHAPE_POLY_SET poly;
+    SHAPE_POLY_SET holes;
+
+    TransformCircleToPolygon( poly, VECTOR2I( 0, 0 ), 20000000, 100, ERROR_INSIDE );
+
+    for( int ii = -4; ii <= 4; ++ii )
+    {
+        for( int jj = -4; jj <= 4; ++jj )
+        {
+            int radius = ( ( ii + jj ) % 2 ) ? 20000 : 500000;
+
+            TransformCircleToPolygon( holes, VECTOR2I( ii * 3000000, jj * 3000000 ), radius, 100,
+                                      ERROR_INSIDE );
+        }
+    }
+
+    poly.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    poly.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    const int             maxError = 100000;
+    const SHAPE_POLY_SET& lod = poly.GetLODApproximation( maxError );
+
+    BOOST_CHECK( &lod != &poly );
+    BOOST_CHECK( lod.IsTriangulationUpToDate() );
+    BOOST_CHECK_LT( lod.TotalVertices(), poly.TotalVertices() / 4 );
+
+    // Only the small holes may be dropped; everything else stays within the error
+    double smallHolesArea = 40 * M_PI * 20000.0 * 20000.0;
+    double perimeter = 2 * M_PI * ( 20000000.0 + 41 * 500000.0 );
+
+    double lodArea = SHAPE_POLY_SET( lod ).Area();
+
+    BOOST_CHECK_LT( std::abs( lodArea - poly.Area() ), smallHolesArea + perimeter * maxError );
+
+    // Cached until the polygon set changes
+    BOOST_CHECK( &poly.GetLODApproximation( maxError ) == &lod );
+
+    poly.Move( VECTOR2I( 1000000, 0 ) );
+
+    BOOST_CHECK_LE( std::abs( poly.GetLODApproximation( maxError ).BBox().GetX()
+                              - poly.BBox().GetX() ), maxError );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
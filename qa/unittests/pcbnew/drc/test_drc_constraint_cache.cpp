@@ -0,0 +1,153 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <board_design_settings.h>
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <zone.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_rule.h>
+#include <reporter.h>
+#include <settings/settings_manager.h>
+
+
+struct DRC_CONSTRAINT_CACHE_TEST_FIXTURE
+{
+    DRC_CONSTRAINT_CACHE_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+static void checkSameConstraint( const DRC_CONSTRAINT& aCached, const DRC_CONSTRAINT& aUncached )
+{
+    BOOST_CHECK_EQUAL( aCached.m_Type, aUncached.m_Type );
+    BOOST_CHECK_EQUAL( aCached.GetParentRule(), aUncached.GetParentRule() );
+    BOOST_CHECK_EQUAL( aCached.GetName(), aUncached.GetName() );
+    BOOST_CHECK_EQUAL( aCached.GetSeverity(), aUncached.GetSeverity() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().HasMin(), aUncached.GetValue().HasMin() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().HasOpt(), aUncached.GetValue().HasOpt() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().HasMax(), aUncached.GetValue().HasMax() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().Min(), aUncached.GetValue().Min() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().Opt(), aUncached.GetValue().Opt() );
+    BOOST_CHECK_EQUAL( aCached.GetValue().Max(), aUncached.GetValue().Max() );
+    BOOST_CHECK_EQUAL( aCached.m_DisallowFlags, aUncached.m_DisallowFlags );
+    BOOST_CHECK( aCached.m_ZoneConnection == aUncached.m_ZoneConnection );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( DRCConstraintCache, DRC_CONSTRAINT_CACHE_TEST_FIXTURE )
+{
+    // EvalRules() caches the constraints resolved for a null REPORTER, and never for another
+    // one.  The cached results (both when the cache is filled and when it is hit) must be the
+    // same as the uncached ones.
+
+    std::vector<wxString> tests =
+    {
+        "connection_width_rules",
+        "issue2512",
+        "issue6945",
+        "issue7567",
+        "severities"
+    };
+
+    std::vector<DRC_CONSTRAINT_T> constraintTypes =
+    {
+        CLEARANCE_CONSTRAINT,
+        HOLE_CLEARANCE_CONSTRAINT,
+        EDGE_CLEARANCE_CONSTRAINT,
+        COURTYARD_CLEARANCE_CONSTRAINT,
+        SILK_CLEARANCE_CONSTRAINT,
+        TRACK_WIDTH_CONSTRAINT,
+        VIA_DIAMETER_CONSTRAINT,
+        HOLE_SIZE_CONSTRAINT,
+        ZONE_CONNECTION_CONSTRAINT
+    };
+
+    // Keeps the number of item pairs reasonable
+    const size_t maxItems = 40;
+
+    for( const wxString& relPath : tests )
+    {
+        KI_TEST::LoadBoard( m_settingsManager, relPath, m_board );
+
+        std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
+        std::vector<BOARD_ITEM*>    items;
+
+        for( PCB_TRACK* track : m_board->Tracks() )
+            items.push_back( track );
+
+        for( FOOTPRINT* footprint : m_board->Footprints() )
+        {
+            items.push_back( footprint );
+
+            for( PAD* pad : footprint->Pads() )
+                items.push_back( pad );
+        }
+
+        for( ZONE* zone : m_board->Zones() )
+            items.push_back( zone );
+
+        if( items.size() > maxItems )
+        {
+            // Sample the items evenly so that every kind of item is kept
+            std::vector<BOARD_ITEM*> sample;
+
+            for( size_t ii = 0; ii < maxItems; ++ii )
+                sample.push_back( items[ ii * items.size() / maxItems ] );
+
+            items = sample;
+        }
+
+        BOOST_TEST_MESSAGE( wxString::Format( "DRC constraint cache: %s, %d items", relPath,
+                                              (int) items.size() ) );
+
+        for( DRC_CONSTRAINT_T constraintType : constraintTypes )
+        {
+            for( BOARD_ITEM* a : items )
+            {
+                for( BOARD_ITEM* b : items )
+                {
+                    PCB_LAYER_ID layer = a->GetLayerSet().Seq().empty()
+                                                ? F_Cu
+                                                : a->GetLayerSet().Seq().front();
+
+                    DRC_CONSTRAINT uncached = drcEngine->EvalRules( constraintType, a, b, layer,
+                                                                    &NULL_REPORTER::GetInstance() );
+                    DRC_CONSTRAINT filled = drcEngine->EvalRules( constraintType, a, b, layer );
+                    DRC_CONSTRAINT hit = drcEngine->EvalRules( constraintType, a, b, layer );
+
+                    checkSameConstraint( filled, uncached );
+                    checkSameConstraint( hit, uncached );
+                }
+            }
+        }
+    }
+}
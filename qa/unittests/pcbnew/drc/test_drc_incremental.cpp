@@ -0,0 +1,218 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2022 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <board_design_settings.h>
+#include <pcb_track.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
+#include <drc/drc_rtree.h>
+#include <drc/drc_test_provider.h>
+#include <settings/settings_manager.h>
+
+
+struct DRC_INCREMENTAL_TEST_FIXTURE
+{
+    DRC_INCREMENTAL_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( DRCIncrementalScope, DRC_INCREMENTAL_TEST_FIXTURE )
+{
+    // A run scoped to a single item must report exactly the violations of a full run which
+    // come from scope-aware providers and involve that item.
+
+    std::vector<wxString> tests =
+    {
+        "issue2512",
+        "issue5854",
+        "issue7267",
+        "reverse_via"
+    };
+
+    typedef std::tuple<int, KIID, KIID> VIOLATION_KEY;
+
+    for( const wxString& relPath : tests )
+    {
+        KI_TEST::LoadBoard( m_settingsManager, relPath, m_board );
+        KI_TEST::FillZones( m_board.get() );
+
+        BOARD_DESIGN_SETTINGS&       bds = m_board->GetDesignSettings();
+        std::vector<DRC_ITEM>        fullViolations;
+        std::multiset<VIOLATION_KEY> scopedViolations;
+
+        bds.m_DRCEngine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+                {
+                    if( aItem->GetViolatingTest() && aItem->GetViolatingTest()->SupportsTestScope() )
+                        fullViolations.push_back( *aItem );
+                } );
+
+        bds.m_DRCEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+        BOOST_REQUIRE_MESSAGE( !fullViolations.empty(),
+                               wxString::Format( "DRC incremental: %s has no violations", relPath ) );
+
+        BOARD_ITEM* dirtyItem = m_board->GetItem( fullViolations.front().GetMainItemID() );
+
+        bds.m_DRCEngine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+                {
+                    scopedViolations.emplace( aItem->GetErrorCode(), aItem->GetMainItemID(),
+                                              aItem->GetAuxItemID() );
+                } );
+
+        bds.m_DRCEngine->SetTestScope( { dirtyItem } );
+        bds.m_DRCEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+        std::set<KIID> scopeIDs;
+
+        for( const BOARD_ITEM* item : bds.m_DRCEngine->GetTestScope() )
+            scopeIDs.insert( item->m_Uuid );
+
+        bds.m_DRCEngine->ClearTestScope();
+        bds.m_DRCEngine->ClearViolationHandler();
+
+        BOOST_CHECK( scopeIDs.count( dirtyItem->m_Uuid ) );
+
+        std::multiset<VIOLATION_KEY> expected;
+
+        for( const DRC_ITEM& item : fullViolations )
+        {
+            if( scopeIDs.count( item.GetMainItemID() ) || scopeIDs.count( item.GetAuxItemID() ) )
+                expected.emplace( item.GetErrorCode(), item.GetMainItemID(), item.GetAuxItemID() );
+        }
+
+        BOOST_CHECK_MESSAGE( expected == scopedViolations,
+                             wxString::Format( "DRC incremental: %s, found %d expected %d",
+                                               relPath,
+                                               (int) scopedViolations.size(),
+                                               (int) expected.size() ) );
+    }
+}
+
+
+BOOST_FIXTURE_TEST_CASE( DRCIncrementalCaches, DRC_INCREMENTAL_TEST_FIXTURE )
+{
+    // A scoped run after a full one only rebuilds the cached data of the changed items: the
+    // board's timestamp (and so the constraint cache keyed on it) and the copper item R-tree
+    // are kept.  The results must still match a full run on the changed board.
+
+    typedef std::tuple<int, KIID, KIID> VIOLATION_KEY;
+
+    KI_TEST::LoadBoard( m_settingsManager, "issue2512", m_board );
+    KI_TEST::FillZones( m_board.get() );
+
+    BOARD_DESIGN_SETTINGS&       bds = m_board->GetDesignSettings();
+    std::shared_ptr<DRC_ENGINE>  drcEngine = bds.m_DRCEngine;
+    std::vector<DRC_ITEM>        fullViolations;
+    std::multiset<VIOLATION_KEY> scopedViolations;
+
+    drcEngine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                if( aItem->GetViolatingTest() && aItem->GetViolatingTest()->SupportsTestScope() )
+                    fullViolations.push_back( *aItem );
+            } );
+
+    drcEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+    BOOST_REQUIRE( !fullViolations.empty() );
+    BOOST_REQUIRE( m_board->Tracks().size() > 1 );
+
+    BOARD_ITEM* movedItem = m_board->GetItem( fullViolations.front().GetMainItemID() );
+    PCB_TRACK*  deletedTrack = nullptr;
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+    {
+        if( track != movedItem )
+        {
+            deletedTrack = track;
+            break;
+        }
+    }
+
+    // The constraint cache is flushed whenever the board's timestamp moves
+    int        timeStamp = m_board->GetTimeStamp();
+    DRC_RTREE* copperTree = m_board->m_CopperItemRTreeCache.get();
+
+    movedItem->Move( VECTOR2I( pcbIUScale.mmToIU( 0.5 ), pcbIUScale.mmToIU( 0.3 ) ) );
+
+    m_board->Remove( deletedTrack );
+    std::unique_ptr<PCB_TRACK> deletedTrackOwner( deletedTrack );
+
+    drcEngine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                scopedViolations.emplace( aItem->GetErrorCode(), aItem->GetMainItemID(),
+                                          aItem->GetAuxItemID() );
+            } );
+
+    drcEngine->SetTestScope( { movedItem }, { deletedTrack } );
+    drcEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+    std::set<KIID> scopeIDs;
+
+    for( const BOARD_ITEM* item : drcEngine->GetTestScope() )
+        scopeIDs.insert( item->m_Uuid );
+
+    drcEngine->ClearTestScope();
+
+    BOOST_CHECK_EQUAL( m_board->GetTimeStamp(), timeStamp );
+    BOOST_CHECK( m_board->m_CopperItemRTreeCache.get() == copperTree );
+
+    // Now compare with a full run on the changed board
+    fullViolations.clear();
+
+    drcEngine->SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, VECTOR2I aPos, int aLayer )
+            {
+                if( aItem->GetViolatingTest() && aItem->GetViolatingTest()->SupportsTestScope() )
+                    fullViolations.push_back( *aItem );
+            } );
+
+    drcEngine->RunTests( EDA_UNITS::MILLIMETRES, true, false );
+    drcEngine->ClearViolationHandler();
+
+    BOOST_CHECK_NE( m_board->GetTimeStamp(), timeStamp );
+
+    std::multiset<VIOLATION_KEY> expected;
+
+    for( const DRC_ITEM& item : fullViolations )
+    {
+        if( scopeIDs.count( item.GetMainItemID() ) || scopeIDs.count( item.GetAuxItemID() ) )
+            expected.emplace( item.GetErrorCode(), item.GetMainItemID(), item.GetAuxItemID() );
+    }
+
+    BOOST_CHECK_MESSAGE( expected == scopedViolations,
+                         wxString::Format( "DRC incremental caches: found %d expected %d",
+                                           (int) scopedViolations.size(),
+                                           (int) expected.size() ) );
+}
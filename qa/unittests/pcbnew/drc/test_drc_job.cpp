@@ -0,0 +1,109 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <boost/filesystem.hpp>
+#include <board.h>
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <cli/exit_codes.h>
+#include <jobs/job_pcb_drc.h>
+#include <pcbnew_jobs_handler.h>
+#include <settings/settings_manager.h>
+
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+
+struct DRC_JOB_TEST_FIXTURE
+{
+    DRC_JOB_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( DRCJobUnconnectedItems, DRC_JOB_TEST_FIXTURE )
+{
+    // The DRC job reports violations which have no rule severity (such as unconnected items)
+    // with the severity from the board's design settings.
+
+    KI_TEST::LoadBoard( m_settingsManager, "issue5990", m_board );
+
+    PAD* netPad = nullptr;
+
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+        {
+            if( !netPad && pad->GetNetCode() > 0 && pad->IsOnLayer( F_Cu ) )
+                netPad = pad;
+        }
+    }
+
+    BOOST_REQUIRE( netPad );
+
+    // A track far from the pad on the same net leaves them unconnected
+    PCB_TRACK* track = new PCB_TRACK( m_board.get() );
+    VECTOR2I   start = m_board->GetBoundingBox().GetOrigin()
+                               - VECTOR2I( pcbIUScale.mmToIU( 20 ), pcbIUScale.mmToIU( 20 ) );
+
+    track->SetLayer( F_Cu );
+    track->SetStart( start );
+    track->SetEnd( start + VECTOR2I( pcbIUScale.mmToIU( 5 ), 0 ) );
+    track->SetWidth( pcbIUScale.mmToIU( 0.25 ) );
+    track->SetNetCode( netPad->GetNetCode() );
+    m_board->Add( track );
+
+    boost::filesystem::path boardPath = boost::filesystem::temp_directory_path()
+                                        / "drc_job_tst.kicad_pcb";
+    boost::filesystem::path reportPath = boost::filesystem::temp_directory_path()
+                                         / "drc_job_tst.json";
+
+    KI_TEST::DumpBoardToFile( *m_board.get(), boardPath.string() );
+
+    JOB_PCB_DRC job( false );
+    job.m_filename = boardPath.string();
+    job.m_outputFile = reportPath.string();
+    job.m_format = JOB_PCB_DRC::OUTPUT_FORMAT::JSON;
+    job.m_severity = RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING | RPT_SEVERITY_EXCLUSION;
+
+    PCBNEW_JOBS_HANDLER handler;
+
+    BOOST_CHECK_EQUAL( handler.JobRunDrc( &job ), CLI::EXIT_CODES::OK );
+
+    std::ifstream  reportFile( reportPath.string() );
+    nlohmann::json report = nlohmann::json::parse( reportFile );
+
+    BOOST_REQUIRE( report.contains( "unconnected_items" ) );
+    BOOST_CHECK( !report["unconnected_items"].empty() );
+
+    // Unconnected items are errors by default
+    for( const nlohmann::json& violation : report["unconnected_items"] )
+        BOOST_CHECK_EQUAL( violation.value( "severity", "" ), "error" );
+}
@@ -0,0 +1,222 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <connectivity/connectivity_rtree.h>
+
+#include <array>
+#include <random>
+#include <set>
+
+
+/**
+ * The bounds of a connectivity item, as CN_RTREE reads them.
+ */
+struct RTREE_TEST_ITEM
+{
+    const BOX2I& BBox() const { return m_bbox; }
+    LAYER_RANGE  Layers() const { return m_layers; }
+
+    BOX2I       m_bbox;
+    LAYER_RANGE m_layers;
+};
+
+
+struct CONNECTIVITY_RTREE_FIXTURE
+{
+    CONNECTIVITY_RTREE_FIXTURE() :
+            m_rng( 1234 )
+    {
+        m_items.resize( 4000 );
+
+        for( RTREE_TEST_ITEM& item : m_items )
+        {
+            int      layer = randInt( 0, 31 );
+            VECTOR2I pos( randInt( -1000000, 1000000 ), randInt( -1000000, 1000000 ) );
+            VECTOR2I size( randInt( 0, 20000 ), randInt( 0, 20000 ) );
+
+            item.m_bbox = BOX2I( pos, size );
+            item.m_layers = LAYER_RANGE( layer, std::min( 31, layer + randInt( 0, 3 ) ) );
+        }
+    }
+
+    int randInt( int aMin, int aMax )
+    {
+        return std::uniform_int_distribution<int>( aMin, aMax )( m_rng );
+    }
+
+    void insert( RTREE_TEST_ITEM* aItem )
+    {
+        m_index.Insert( aItem );
+        m_reference.Insert( boundsMin( aItem ).data(), boundsMax( aItem ).data(), aItem );
+    }
+
+    void remove( RTREE_TEST_ITEM* aItem )
+    {
+        m_index.Remove( aItem );
+        m_reference.Remove( boundsMin( aItem ).data(), boundsMax( aItem ).data(), aItem );
+    }
+
+    /**
+     * Check that the index finds the same items as the reference RTree with each kernel of
+     * the static tree built in.
+     */
+    void checkQueries( const std::string& aStep )
+    {
+        using KERNEL = CN_STATIC_RTREE::KERNEL;
+
+        for( int ii = 0; ii < 200; ++ii )
+        {
+            VECTOR2I    pos( randInt( -1100000, 1100000 ), randInt( -1100000, 1100000 ) );
+            VECTOR2I    size( randInt( 0, 200000 ), randInt( 0, 200000 ) );
+            BOX2I       bounds( pos, size );
+            int         layer = randInt( 0, 31 );
+            LAYER_RANGE range( layer, std::min( 31, layer + randInt( 0, 2 ) ) );
+
+            const int qmin[3] = { range.Start(), bounds.GetX(), bounds.GetY() };
+            const int qmax[3] = { range.End(), bounds.GetRight(), bounds.GetBottom() };
+
+            std::set<RTREE_TEST_ITEM*> expected;
+
+            auto collectExpected =
+                    [&]( RTREE_TEST_ITEM* aItem ) -> bool
+                    {
+                        expected.insert( aItem );
+                        return true;
+                    };
+
+            m_reference.Search( qmin, qmax, collectExpected );
+
+            BOOST_CHECK_MESSAGE( query<KERNEL::SCALAR>( bounds, range ) == expected,
+                                 "Scalar query differs after " << aStep );
+#if defined( CN_RTREE_SSE2 )
+            BOOST_CHECK_MESSAGE( query<KERNEL::SSE2>( bounds, range ) == expected,
+                                 "SSE2 query differs after " << aStep );
+#endif
+#if defined( CN_RTREE_AVX2 )
+            BOOST_CHECK_MESSAGE( query<KERNEL::AVX2>( bounds, range ) == expected,
+                                 "AVX2 query differs after " << aStep );
+#endif
+        }
+    }
+
+    template <CN_STATIC_RTREE::KERNEL K>
+    std::set<RTREE_TEST_ITEM*> query( const BOX2I& aBounds, const LAYER_RANGE& aRange )
+    {
+        std::set<RTREE_TEST_ITEM*> found;
+
+        auto collect =
+                [&]( RTREE_TEST_ITEM* aItem ) -> bool
+                {
+                    BOOST_CHECK( found.insert( aItem ).second );
+                    return true;
+                };
+
+        m_index.Query<K>( aBounds, aRange, collect );
+
+        return found;
+    }
+
+    static std::array<int, 3> boundsMin( const RTREE_TEST_ITEM* aItem )
+    {
+        return { aItem->m_layers.Start(), aItem->m_bbox.GetX(), aItem->m_bbox.GetY() };
+    }
+
+    static std::array<int, 3> boundsMax( const RTREE_TEST_ITEM* aItem )
+    {
+        return { aItem->m_layers.End(), aItem->m_bbox.GetRight(), aItem->m_bbox.GetBottom() };
+    }
+
+    std::mt19937                            m_rng;
+    std::vector<RTREE_TEST_ITEM>            m_items;
+    CN_RTREE<RTREE_TEST_ITEM*>              m_index;
+    RTree<RTREE_TEST_ITEM*, int, 3, double> m_reference;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityRTree, CONNECTIVITY_RTREE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( QueryMatchesRTree )
+{
+    std::vector<RTREE_TEST_ITEM*> built;
+
+    for( size_t ii = 0; ii < 2000; ++ii )
+    {
+        built.push_back( &m_items[ii] );
+        m_reference.Insert( boundsMin( &m_items[ii] ).data(), boundsMax( &m_items[ii] ).data(),
+                            &m_items[ii] );
+    }
+
+    m_index.Build( built );
+    checkQueries( "Build()" );
+
+    // A few inserts go to the dynamic overlay
+    for( size_t ii = 2000; ii < 2100; ++ii )
+        insert( &m_items[ii] );
+
+    m_index.Commit();
+    checkQueries( "inserting into the overlay" );
+
+    // Remove items from both the static tree and the overlay
+    for( size_t ii = 0; ii < 2100; ii += 7 )
+        remove( &m_items[ii] );
+
+    m_index.Commit();
+    checkQueries( "removing items" );
+
+    // Items inserted and removed before a Commit() are never seen
+    for( size_t ii = 2100; ii < 2150; ++ii )
+        insert( &m_items[ii] );
+
+    for( size_t ii = 2100; ii < 2150; ii += 2 )
+        remove( &m_items[ii] );
+
+    m_index.Commit();
+    checkQueries( "removing pending items" );
+
+    // Many inserts rebuild the static tree
+    for( size_t ii = 2150; ii < 3500; ++ii )
+        insert( &m_items[ii] );
+
+    m_index.Commit();
+    checkQueries( "rebuilding for inserts" );
+
+    // So do many removals
+    for( size_t ii = 1; ii < 3500; ii += 3 )
+    {
+        if( ii % 7 != 0 && ( ii < 2100 || ii >= 2150 || ii % 2 != 0 ) )
+            remove( &m_items[ii] );
+    }
+
+    m_index.Commit();
+    checkQueries( "rebuilding for removals" );
+
+    m_index.RemoveAll();
+    m_reference.RemoveAll();
+    checkQueries( "RemoveAll()" );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
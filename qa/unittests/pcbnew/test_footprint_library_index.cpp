@@ -0,0 +1,160 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <footprint_library_index.h>
+#include <pcbnew/plugins/kicad/pcb_plugin.h>
+
+#include <footprint.h>
+
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+
+struct FOOTPRINT_LIBRARY_INDEX_FIXTURE
+{
+    FOOTPRINT_LIBRARY_INDEX_FIXTURE()
+    {
+        m_sourcePath = KI_TEST::GetPcbnewTestDataDir() + "plugins/eagle/lbr/SparkFun-GPS.pretty";
+
+        wxFileName libPath;
+        libPath.AssignDir( wxFileName::GetTempDir() );
+        libPath.AppendDir( wxString::Format( wxT( "qa_fp_index_%lu" ), wxGetProcessId() ) );
+        m_libPath = libPath.GetPath();
+
+        // Keep the index out of the user cache directory
+        libPath.AppendDir( wxT( "fp-index" ) );
+        m_indexDir = libPath.GetPath();
+
+        wxFileName::Mkdir( m_libPath, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+        wxDir    dir( m_sourcePath );
+        wxString fullName;
+
+        for( bool more = dir.GetFirst( &fullName, wxT( "*.kicad_mod" ) ); more;
+             more = dir.GetNext( &fullName ) )
+        {
+            wxCopyFile( m_sourcePath + wxFileName::GetPathSeparator() + fullName,
+                        m_libPath + wxFileName::GetPathSeparator() + fullName );
+        }
+    }
+
+    ~FOOTPRINT_LIBRARY_INDEX_FIXTURE()
+    {
+        wxFileName::Rmdir( m_libPath, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    /**
+     * Check the index against the footprints loaded by the KiCad plugin.
+     */
+    void checkIndex( const FOOTPRINT_LIBRARY_INDEX& aIndex )
+    {
+        PCB_PLUGIN    plugin;
+        wxArrayString names;
+
+        plugin.FootprintEnumerate( names, m_libPath, true, nullptr );
+
+        BOOST_REQUIRE_EQUAL( aIndex.GetEntries().size(), names.size() );
+
+        for( const FOOTPRINT_LIBRARY_INDEX::ENTRY& entry : aIndex.GetEntries() )
+        {
+            BOOST_TEST_CONTEXT( entry.m_Name )
+            {
+                std::unique_ptr<FOOTPRINT> footprint( plugin.FootprintLoad( m_libPath,
+                                                                            entry.m_Name ) );
+
+                BOOST_REQUIRE( footprint );
+                BOOST_CHECK_EQUAL( entry.m_PadCount,
+                                   footprint->GetPadCount( DO_NOT_INCLUDE_NPTH ) );
+                BOOST_CHECK_EQUAL( entry.m_UniquePadCount,
+                                   footprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH ) );
+                BOOST_CHECK( entry.m_Keywords == footprint->GetKeywords() );
+                BOOST_CHECK( entry.m_Description == footprint->GetDescription() );
+            }
+        }
+    }
+
+    wxString m_sourcePath;
+    wxString m_libPath;
+    wxString m_indexDir;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintLibraryIndex, FOOTPRINT_LIBRARY_INDEX_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( BuildAndReuse )
+{
+    FOOTPRINT_LIBRARY_INDEX index( m_libPath, m_indexDir );
+
+    wxRemoveFile( index.GetIndexFileName() );
+    index.Update();
+
+    BOOST_CHECK( wxFileName::FileExists( index.GetIndexFileName() ) );
+    checkIndex( index );
+
+    // A second index must come back identical from the saved file
+    FOOTPRINT_LIBRARY_INDEX reread( m_libPath, m_indexDir );
+    reread.Update();
+
+    BOOST_REQUIRE_EQUAL( reread.GetEntries().size(), index.GetEntries().size() );
+
+    for( size_t ii = 0; ii < index.GetEntries().size(); ++ii )
+    {
+        const FOOTPRINT_LIBRARY_INDEX::ENTRY& a = index.GetEntries()[ii];
+        const FOOTPRINT_LIBRARY_INDEX::ENTRY& b = reread.GetEntries()[ii];
+
+        BOOST_CHECK( a.m_Name == b.m_Name );
+        BOOST_CHECK_EQUAL( a.m_ModTime, b.m_ModTime );
+        BOOST_CHECK_EQUAL( a.m_Size, b.m_Size );
+        BOOST_CHECK_EQUAL( a.m_PadCount, b.m_PadCount );
+        BOOST_CHECK_EQUAL( a.m_UniquePadCount, b.m_UniquePadCount );
+        BOOST_CHECK( a.m_Keywords == b.m_Keywords );
+        BOOST_CHECK( a.m_Description == b.m_Description );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ChangedFiles )
+{
+    FOOTPRINT_LIBRARY_INDEX index( m_libPath, m_indexDir );
+    index.Update();
+
+    wxString sep = wxFileName::GetPathSeparator();
+
+    // Replace one footprint with another (changing its size) and remove a second one
+    wxCopyFile( m_sourcePath + sep + wxT( "NEO-M8P.kicad_mod" ),
+                m_libPath + sep + wxT( "W3011.kicad_mod" ), true );
+    wxRemoveFile( m_libPath + sep + wxT( "GP3906-TLP.kicad_mod" ) );
+
+    FOOTPRINT_LIBRARY_INDEX updated( m_libPath, m_indexDir );
+    updated.Update();
+
+    BOOST_CHECK_EQUAL( updated.GetEntries().size(), index.GetEntries().size() - 1 );
+    checkIndex( updated );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <pcbnew/plugins/kicad/pcb_plugin.h>
+
+#include <footprint.h>
+#include <locale_io.h>
+
+
+BOOST_AUTO_TEST_SUITE( FpCache )
+
+
+BOOST_AUTO_TEST_CASE( LazyLoad )
+{
+    LOCALE_IO  toggle;
+    wxString   libPath = KI_TEST::GetPcbnewTestDataDir() + "plugins/eagle/lbr/SparkFun-GPS.pretty";
+    PCB_PLUGIN plugin( CTL_FOR_LIBRARY );
+    FP_CACHE   cache( &plugin, libPath );
+
+    cache.Load();
+
+    BOOST_REQUIRE( !cache.GetFootprints().empty() );
+
+    // Indexing the library must not parse any footprints
+    for( const auto& item : cache.GetFootprints() )
+        BOOST_CHECK( item.second->GetFootprint() == nullptr );
+
+    const FOOTPRINT* footprint = cache.GetFootprint( wxT( "NEO-M8P" ) );
+
+    BOOST_REQUIRE( footprint );
+    BOOST_CHECK( footprint->GetFPID().GetLibItemName() == wxT( "NEO-M8P" ) );
+    BOOST_CHECK( footprint->GetPadCount() > 0 );
+
+    int resident = 0;
+
+    for( const auto& item : cache.GetFootprints() )
+    {
+        if( item.second->GetFootprint() )
+            resident++;
+    }
+
+    BOOST_CHECK_EQUAL( resident, 1 );
+
+    // Re-indexing an unchanged library keeps the parsed footprint
+    cache.Load();
+    BOOST_CHECK( cache.GetFootprints().find( wxT( "NEO-M8P" ) )->second->GetFootprint() );
+
+    BOOST_CHECK( cache.GetFootprint( wxT( "NoSuchFootprint" ) ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -181,4 +181,99 @@ BOOST_AUTO_TEST_CASE( IntrospectedProperties )
     }
 }
 
+
+BOOST_AUTO_TEST_CASE( TypedComparisons )
+{
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+    propMgr.Rebuild();
+
+    BOARD brd;
+
+    std::shared_ptr<NETCLASS> netclass( new NETCLASS( "HV" ) );
+
+    auto netinfo = new NETINFO_ITEM( &brd, "net1", 1 );
+    netinfo->SetNetClass( netclass );
+
+    PCB_TRACK track( &brd );
+    track.SetNet( netinfo );
+
+    // Typed comparisons must give the same results as comparing the fetched values,
+    // including case-insensitivity, wildcards and undefined items
+    const std::vector<EXPR_TO_TEST> expressions = {
+        { "A.NetClass == 'hv'", false, VAL( 1.0 ) },
+        { "A.NetClass == 'H*'", false, VAL( 1.0 ) },
+        { "A.NetClass != 'H?'", false, VAL( 0.0 ) },
+        { "'hv' == A.NetClass", false, VAL( 1.0 ) },
+        { "A.NetName == 'NET1'", false, VAL( 1.0 ) },
+        { "A.NetName != 'net*'", false, VAL( 0.0 ) },
+        { "A.Type == 'track'", false, VAL( 1.0 ) },
+        { "A.Type == 'Tr*'", false, VAL( 1.0 ) },
+        { "A.Type != 'Via'", false, VAL( 1.0 ) },
+        { "B.NetClass == 'HV'", false, VAL( 0.0 ) },
+        { "B.NetClass != 'HV'", false, VAL( 0.0 ) },
+        { "B.Type != 'Via'", false, VAL( 0.0 ) }
+    };
+
+    for( const auto& expr : expressions )
+        testEvalExpr( expr.expression, expr.expectedResult, expr.expectError, &track, nullptr );
+
+    // Check what the expressions compile to (without the operands)
+    const std::vector<std::pair<wxString, wxString>> opcodes = {
+        { "1mm + 2mm",                           "PUSH NUM" },
+        { "!(1mm > 2mm) && A.NetClass == 'HV'",  "PUSH NUM|VAR EQUAL|AND 523" },
+        { "'HV' == A.NetClass",                  "PUSH STR|PUSH VAR|EQUAL 521" }
+    };
+
+    for( const auto& [ expr, expectedOpcodes ] : opcodes )
+    {
+        PCB_EXPR_COMPILER compiler( new PCB_UNIT_RESOLVER() );
+        PCB_EXPR_UCODE    ucode;
+        PCB_EXPR_CONTEXT  preflightContext( NULL_CONSTRAINT, UNDEFINED_LAYER );
+        wxArrayString     ops;
+
+        BOOST_TEST_MESSAGE( "Expr: '" << expr.c_str() << "'" );
+
+        BOOST_CHECK( compiler.Compile( expr, &ucode, &preflightContext ) );
+
+        for( wxString line : wxSplit( ucode.Dump(), '\n' ) )
+        {
+            if( !line.IsEmpty() )
+                ops.Add( line.BeforeFirst( '[' ).Trim() );
+        }
+
+        BOOST_CHECK_EQUAL( wxJoin( ops, '|' ), expectedOpcodes );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ReferencedAttributes )
+{
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+    propMgr.Rebuild();
+
+    const std::vector<std::pair<wxString, int>> cases = {
+        { "1mm + 2mm",                                     0 },
+        { "A.NetClass == 'HV' || B.NetClass == 'HV'",      PCB_EXPR_UCODE::REF_NETCLASS },
+        { "A.NetName == 'GND'",                            PCB_EXPR_UCODE::REF_NETNAME },
+        { "A.type == 'Pad' && B.Type == 'Via'",            PCB_EXPR_UCODE::REF_TYPE },
+        { "A.NetClass == 'HV' && A.Type == 'Track'",       PCB_EXPR_UCODE::REF_NETCLASS
+                                                                | PCB_EXPR_UCODE::REF_TYPE },
+        { "A.Width > 1mm",                                 PCB_EXPR_UCODE::REF_OTHER },
+        { "A.NetClass == 'HV' && A.isMicroVia()",          PCB_EXPR_UCODE::REF_NETCLASS
+                                                                | PCB_EXPR_UCODE::REF_OTHER }
+    };
+
+    for( const auto& [ expr, expectedAttrs ] : cases )
+    {
+        PCB_EXPR_COMPILER compiler( new PCB_UNIT_RESOLVER() );
+        PCB_EXPR_UCODE    ucode;
+        PCB_EXPR_CONTEXT  preflightContext( NULL_CONSTRAINT, UNDEFINED_LAYER );
+
+        BOOST_TEST_MESSAGE( "Expr: '" << expr.c_str() << "'" );
+
+        BOOST_CHECK( compiler.Compile( expr, &ucode, &preflightContext ) );
+        BOOST_CHECK_EQUAL( ucode.GetReferencedAttrs(), expectedAttrs );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
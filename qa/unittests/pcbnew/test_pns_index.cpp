@@ -0,0 +1,172 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <pns_index.h>
+#include <pns_segment.h>
+
+
+struct PNS_INDEX_FIXTURE
+{
+    PNS_INDEX_FIXTURE()
+    {
+        // A grid of segments on alternating layers and nets
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            for( int jj = 0; jj < 20; ++jj )
+            {
+                VECTOR2I start( ii * 1000000, jj * 1000000 );
+                auto     seg = std::make_unique<PNS::SEGMENT>( SEG( start, start + VECTOR2I( 500000, 0 ) ),
+                                                               ( ii + jj ) % 7 );
+
+                seg->SetLayer( ( ii + jj ) % 2 ? B_Cu : F_Cu );
+                seg->SetWidth( 200000 );
+                m_segments.push_back( std::move( seg ) );
+            }
+        }
+    }
+
+    /**
+     * @return the items of \a aIndex on \a aLayer whose bounding boxes are within \a aDistance
+     *         of \a aSeg, found by a query and by checking every item.
+     */
+    std::pair<std::set<PNS::ITEM*>, std::set<PNS::ITEM*>> query( const PNS::INDEX& aIndex,
+                                                                 const PNS::SEGMENT& aSeg,
+                                                                 int aDistance )
+    {
+        std::set<PNS::ITEM*> found;
+        std::set<PNS::ITEM*> expected;
+
+        auto visitor =
+                [&]( PNS::ITEM* aItem ) -> bool
+                {
+                    found.insert( aItem );
+                    return true;
+                };
+
+        aIndex.Query( &aSeg, aDistance, visitor );
+
+        BOX2I box = aSeg.Shape()->BBox();
+        box.Inflate( aDistance );
+
+        for( PNS::ITEM* item : aIndex )
+        {
+            if( item->Layers().Overlaps( aSeg.Layers() ) && item->Shape()->BBox().Intersects( box ) )
+                expected.insert( item );
+        }
+
+        return { found, expected };
+    }
+
+    std::vector<std::unique_ptr<PNS::SEGMENT>> m_segments;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PNSIndex, PNS_INDEX_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( Query )
+{
+    PNS::SEGMENT probe( SEG( VECTOR2I( 3200000, 2500000 ), VECTOR2I( 7100000, 6400000 ) ), 3 );
+    probe.SetLayer( F_Cu );
+    probe.SetWidth( 100000 );
+
+    // Small indices are scanned, large ones searched through their R-trees
+    for( size_t count : { (size_t) 100, m_segments.size() } )
+    {
+        PNS::INDEX index;
+
+        for( size_t ii = 0; ii < count; ++ii )
+            index.Add( m_segments[ii].get() );
+
+        BOOST_CHECK_EQUAL( index.HasSubIndices(), count > PNS::INDEX::SUBINDEX_THRESHOLD );
+        BOOST_CHECK_EQUAL( index.Size(), (int) count );
+
+        auto [ found, expected ] = query( index, probe, 400000 );
+
+        BOOST_CHECK( !expected.empty() );
+        BOOST_CHECK( found == expected );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( CopyOnWrite )
+{
+    PNS::INDEX parent;
+
+    for( int ii = 0; ii < 50; ++ii )
+        parent.Add( m_segments[ii].get() );
+
+    PNS::INDEX child( parent );
+
+    BOOST_CHECK_EQUAL( child.Size(), parent.Size() );
+
+    // Changes to the copy must not show in the original, and the other way round
+    child.Remove( m_segments[0].get() );
+    child.Add( m_segments[100].get() );
+    parent.Add( m_segments[200].get() );
+
+    BOOST_CHECK( parent.Contains( m_segments[0].get() ) );
+    BOOST_CHECK( !parent.Contains( m_segments[100].get() ) );
+    BOOST_CHECK( !child.Contains( m_segments[0].get() ) );
+    BOOST_CHECK( child.Contains( m_segments[100].get() ) );
+    BOOST_CHECK( !child.Contains( m_segments[200].get() ) );
+    BOOST_CHECK_EQUAL( parent.Size(), 51 );
+    BOOST_CHECK_EQUAL( child.Size(), 50 );
+
+    int net = m_segments[0]->Net();
+
+    auto countInNet =
+            [&]( const PNS::INDEX& aIndex, PNS::ITEM* aItem )
+            {
+                const PNS::INDEX::NET_ITEMS_LIST* items = aIndex.GetItemsForNet( net );
+
+                return items ? std::count( items->begin(), items->end(), aItem ) : 0;
+            };
+
+    BOOST_CHECK_EQUAL( countInNet( parent, m_segments[0].get() ), 1 );
+    BOOST_CHECK_EQUAL( countInNet( child, m_segments[0].get() ), 0 );
+
+    // Items moved to fill the holes left by removed ones must still be found
+    for( int ii = 1; ii < 50; ii += 3 )
+        child.Remove( m_segments[ii].get() );
+
+    for( PNS::ITEM* item : child )
+    {
+        std::set<PNS::ITEM*> found;
+
+        auto visitor =
+                [&]( PNS::ITEM* aItem ) -> bool
+                {
+                    found.insert( aItem );
+                    return true;
+                };
+
+        child.Query( item, 0, visitor );
+        BOOST_CHECK( found.count( item ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
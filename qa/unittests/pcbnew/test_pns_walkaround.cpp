@@ -0,0 +1,121 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <pcb_track.h>
+#include <settings/settings_manager.h>
+
+#include <pns_kicad_iface.h>
+#include <pns_line.h>
+#include <pns_router.h>
+#include <pns_routing_settings.h>
+#include <pns_walkaround.h>
+
+
+struct PNS_WALKAROUND_FIXTURE
+{
+    PNS_WALKAROUND_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    void createRouter()
+    {
+        m_iface = std::make_unique<PNS_KICAD_IFACE_BASE>();
+        m_router = std::make_unique<PNS::ROUTER>();
+        m_routingSettings = std::make_unique<PNS::ROUTING_SETTINGS>( nullptr, "" );
+
+        m_iface->SetBoard( m_board.get() );
+        m_router->SetInterface( m_iface.get() );
+        m_router->ClearWorld();
+        m_router->SyncWorld();
+        m_router->LoadSettings( m_routingSettings.get() );
+        m_router->Settings().SetMode( PNS::RM_Walkaround );
+    }
+
+    SETTINGS_MANAGER                        m_settingsManager;
+    std::unique_ptr<BOARD>                  m_board;
+    std::unique_ptr<PNS_KICAD_IFACE_BASE>   m_iface;
+    std::unique_ptr<PNS::ROUTER>            m_router;
+    std::unique_ptr<PNS::ROUTING_SETTINGS>  m_routingSettings;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( PNSWalkaroundParallel, PNS_WALKAROUND_FIXTURE )
+{
+    // Walking around in both directions at once must find the very paths the serial walkaround
+    // finds.  (With a single thread in the pool both runs are serial, and trivially agree.)
+    KI_TEST::LoadBoard( m_settingsManager, "issue7325", m_board );
+    createRouter();
+
+    int count = 0;
+
+    for( PCB_TRACK* track : m_board->Tracks() )
+    {
+        if( track->Type() != PCB_TRACE_T || track->GetNetCode() <= 0
+                || track->GetStart() == track->GetEnd() )
+        {
+            continue;
+        }
+
+        if( ++count > 100 )
+            break;
+
+        // A line with no net crossing the middle of the track at right angles
+        VECTOR2I  mid = ( track->GetStart() + track->GetEnd() ) / 2;
+        VECTOR2I  dir = ( track->GetEnd() - track->GetStart() ).Perpendicular();
+        PNS::LINE line;
+
+        dir = dir.Resize( pcbIUScale.mmToIU( 3 ) );
+        line.SetShape( SHAPE_LINE_CHAIN( std::vector<VECTOR2I>{ mid - dir, mid + dir } ) );
+        line.SetLayer( track->GetLayer() );
+        line.SetWidth( pcbIUScale.mmToIU( 0.2 ) );
+        line.SetNet( 0 );
+
+        PNS::WALKAROUND::RESULT results[2];
+
+        for( bool parallel : { false, true } )
+        {
+            m_router->Settings().SetParallelWalkaround( parallel );
+
+            PNS::WALKAROUND walkaround( m_router->GetWorld(), m_router.get() );
+
+            walkaround.SetSolidsOnly( false );
+            walkaround.SetIterationLimit( m_router->Settings().WalkaroundIterationLimit() );
+            results[parallel] = walkaround.Route( line );
+        }
+
+        BOOST_TEST_CONTEXT( "Crossing track " << track->m_Uuid.AsString() )
+        {
+            BOOST_CHECK( results[0].statusCw == results[1].statusCw );
+            BOOST_CHECK( results[0].statusCcw == results[1].statusCcw );
+            BOOST_CHECK( results[0].lineCw.CLine().CompareGeometry( results[1].lineCw.CLine() ) );
+            BOOST_CHECK( results[0].lineCcw.CLine().CompareGeometry( results[1].lineCcw.CLine() ) );
+        }
+    }
+
+    BOOST_CHECK_GT( count, 0 );
+}
+
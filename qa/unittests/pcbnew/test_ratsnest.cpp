@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <footprint.h>
+#include <connectivity/connectivity_data.h>
+#include <ratsnest/ratsnest_data.h>
+#include <settings/settings_manager.h>
+
+
+struct RATSNEST_TEST_FIXTURE
+{
+    RATSNEST_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+static std::vector<std::pair<size_t, long long>> ratsnestSizes( CONNECTIVITY_DATA* aConnectivity )
+{
+    std::vector<std::pair<size_t, long long>> sizes;
+
+    for( int net = 1; net < aConnectivity->GetNetCount(); ++net )
+    {
+        long long length = 0;
+
+        for( const CN_EDGE& edge : aConnectivity->GetRatsnestForNet( net )->GetEdges() )
+            length += edge.GetWeight();
+
+        sizes.emplace_back( aConnectivity->GetRatsnestForNet( net )->GetEdges().size(), length );
+    }
+
+    return sizes;
+}
+
+
+BOOST_FIXTURE_TEST_CASE( RatsnestIncrementalUpdate, RATSNEST_TEST_FIXTURE )
+{
+    // Moving footprints updates the triangulation of the ratsnest incrementally.  The result
+    // must match a ratsnest computed from scratch.
+
+    std::vector<wxString> tests = { "complex_hierarchy", "issue5854", "tracks_arcs_vias" };
+
+    for( const wxString& relPath : tests )
+    {
+        KI_TEST::LoadBoard( m_settingsManager, relPath, m_board );
+
+        std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
+
+        for( int pass = 0; pass < 3; ++pass )
+        {
+            int ii = 0;
+
+            for( FOOTPRINT* footprint : m_board->Footprints() )
+            {
+                if( ( ii++ + pass ) % 3 )
+                    continue;
+
+                footprint->Move( VECTOR2I( pcbIUScale.mmToIU( 1.27 * ( pass + 1 ) ),
+                                           pcbIUScale.mmToIU( -2.54 ) ) );
+                connectivity->Update( footprint );
+            }
+
+            connectivity->RecalculateRatsnest();
+
+            std::shared_ptr<CONNECTIVITY_DATA> reference = std::make_shared<CONNECTIVITY_DATA>();
+            reference->Build( m_board.get() );
+
+            BOOST_CHECK_MESSAGE( ratsnestSizes( connectivity.get() )
+                                         == ratsnestSizes( reference.get() ),
+                                 wxString::Format( "Ratsnest: %s differs after pass %d",
+                                                   relPath, pass ) );
+        }
+    }
+}
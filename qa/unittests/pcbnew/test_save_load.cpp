@@ -27,6 +27,11 @@
 #include <boost/filesystem.hpp>
 #include <board.h>
 #include <settings/settings_manager.h>
+#include <plugins/kicad/pcb_parser.h>
+#include <plugins/kicad/pcb_plugin.h>
+#include <richio.h>
+
+#include <fstream>
 
 
 struct SAVE_LOAD_TEST_FIXTURE
@@ -63,3 +68,40 @@ BOOST_FIXTURE_TEST_CASE( RegressionSaveLoadTests, SAVE_LOAD_TEST_FIXTURE )
     }
 }
 
+
+
+BOOST_FIXTURE_TEST_CASE( ParallelLoadMatchesSerialLoad, SAVE_LOAD_TEST_FIXTURE )
+{
+    // Boards read from a BUFFER_LINE_READER are parsed on multiple threads; the result must
+    // be the same as a plain serial parse.
+    std::vector<wxString> tests = { "issue9870",
+                                    "issue12609",
+                                    "reverse_via",
+                                    "solder_mask_bridge_test" };
+
+    for( const wxString& relPath : tests )
+    {
+        wxString      path = KI_TEST::GetPcbnewTestDataDir() + relPath + ".kicad_pcb";
+        std::ifstream fin( path.ToStdString(), std::ios::binary );
+        std::string   text( ( std::istreambuf_iterator<char>( fin ) ),
+                            std::istreambuf_iterator<char>() );
+
+        STRING_LINE_READER     serialReader( text, path );
+        BUFFER_LINE_READER     parallelReader( text.data(), text.size(), path );
+        PCB_PARSER             serialParser( &serialReader, nullptr, nullptr );
+        PCB_PARSER             parallelParser( &parallelReader, nullptr, nullptr );
+        std::unique_ptr<BOARD> serialBoard( static_cast<BOARD*>( serialParser.Parse() ) );
+        std::unique_ptr<BOARD> parallelBoard( static_cast<BOARD*>( parallelParser.Parse() ) );
+
+        PCB_PLUGIN plugin;
+
+        plugin.Format( serialBoard.get() );
+        std::string serialOutput = plugin.GetStringOutput( true );
+
+        plugin.Format( parallelBoard.get() );
+        std::string parallelOutput = plugin.GetStringOutput( true );
+
+        BOOST_CHECK_MESSAGE( serialOutput == parallelOutput,
+                             wxString::Format( "Parallel load of %s differs", relPath ) );
+    }
+}
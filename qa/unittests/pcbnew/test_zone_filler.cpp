@@ -28,6 +28,7 @@
 #include <pad.h>
 #include <pcb_track.h>
 #include <footprint.h>
+#include <fp_text.h>
 #include <zone.h>
 #include <drc/drc_item.h>
 #include <settings/settings_manager.h>
@@ -39,6 +40,19 @@ struct ZONE_FILL_TEST_FIXTURE
             m_settingsManager( true /* headless */ )
     { }
 
+    std::map<std::pair<KIID, PCB_LAYER_ID>, MD5_HASH> collectFills()
+    {
+        std::map<std::pair<KIID, PCB_LAYER_ID>, MD5_HASH> fills;
+
+        for( ZONE* zone : m_board->Zones() )
+        {
+            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+                fills[ { zone->m_Uuid, layer } ] = zone->GetFilledPolysList( layer )->GetHash();
+        }
+
+        return fills;
+    }
+
     SETTINGS_MANAGER       m_settingsManager;
     std::unique_ptr<BOARD> m_board;
 };
@@ -176,6 +190,85 @@ BOOST_FIXTURE_TEST_CASE( NotchedZones, ZONE_FILL_TEST_FIXTURE )
 }
 
 
+BOOST_FIXTURE_TEST_CASE( IncrementalZoneFills, ZONE_FILL_TEST_FIXTURE )
+{
+    // A refill which reuses cached fills for untouched zones must give the same result as
+    // filling the edited board from scratch.
+
+    auto editBoard =
+            [&]()
+            {
+                for( PCB_TRACK* track : m_board->Tracks() )
+                {
+                    if( track->Type() == PCB_VIA_T )
+                    {
+                        track->Move( VECTOR2I( delta * 50, delta * 50 ) );
+                        break;
+                    }
+                }
+
+                for( PAD* pad : m_board->Footprints()[0]->Pads() )
+                {
+                    if( pad->GetNumber() == "2" )
+                        pad->SetSize( pad->GetSize() + wxSize( delta, delta ) );
+                }
+            };
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+    KI_TEST::FillZones( m_board.get() );
+
+    editBoard();
+    KI_TEST::FillZones( m_board.get() );
+
+    std::map<std::pair<KIID, PCB_LAYER_ID>, MD5_HASH> incrementalFills = collectFills();
+
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+
+    editBoard();
+    KI_TEST::FillZones( m_board.get() );
+
+    BOOST_CHECK( incrementalFills == collectFills() );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( IncrementalZoneFillsTextVars, ZONE_FILL_TEST_FIXTURE )
+{
+    // Copper text in a footprint is knocked out as shown, so a change to a text variable it
+    // refers to must refill the zones around it even though the text item itself is unchanged.
+
+    auto loadBoard =
+            [&]( const wxString& aVarValue )
+            {
+                KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+
+                FOOTPRINT* footprint = m_board->Footprints()[0];
+                FP_TEXT*   text = new FP_TEXT( footprint );
+
+                text->SetText( wxT( "${FILL_TEST}" ) );
+                text->SetLayer( F_Cu );
+                text->SetTextSize( VECTOR2I( pcbIUScale.mmToIU( 1 ), pcbIUScale.mmToIU( 1 ) ) );
+                text->SetTextThickness( pcbIUScale.mmToIU( 0.15 ) );
+                text->SetPosition( footprint->GetPosition() );
+                footprint->Add( text );
+
+                m_board->SetProperties( { { wxT( "FILL_TEST" ), aVarValue } } );
+            };
+
+    loadBoard( wxT( "I" ) );
+    KI_TEST::FillZones( m_board.get() );
+
+    m_board->SetProperties( { { wxT( "FILL_TEST" ), wxT( "WWWWWWWW" ) } } );
+    KI_TEST::FillZones( m_board.get() );
+
+    std::map<std::pair<KIID, PCB_LAYER_ID>, MD5_HASH> incrementalFills = collectFills();
+
+    loadBoard( wxT( "WWWWWWWW" ) );
+    KI_TEST::FillZones( m_board.get() );
+
+    BOOST_CHECK( incrementalFills == collectFills() );
+}
+
+
 BOOST_FIXTURE_TEST_CASE( RegressionZoneFillTests, ZONE_FILL_TEST_FIXTURE )
 {
     std::vector<wxString> tests = { "issue18",